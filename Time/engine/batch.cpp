@@ -0,0 +1,183 @@
+#include "batch.h"
+#include "commands.h"
+#include "mapped_file.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <utility>
+
+namespace {
+
+uint64_t HashBytes(std::string_view bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::wstring_view Trim(std::wstring_view text) {
+    size_t first = text.find_first_not_of(L" \t");
+    if (first == std::wstring_view::npos) return std::wstring_view();
+    return text.substr(first, text.find_last_not_of(L" \t") - first + 1);
+}
+
+// Erstes Wort und Rest (ohne fuehrenden Leerraum)
+std::wstring_view FirstWord(std::wstring_view text, std::wstring_view& rest) {
+    size_t end = std::min(text.find_first_of(L" \t"), text.size());
+    rest = Trim(text.substr(end));
+    return text.substr(0, end);
+}
+
+std::wstring FoldLabel(std::wstring_view label) {
+    label = Trim(label);
+    label = label.substr(0, std::min(label.find_first_of(L" \t"), label.size()));
+    std::wstring folded(label);
+    for (wchar_t& c : folded) c = static_cast<wchar_t>(std::towupper(c));
+    return folded;
+}
+
+// %0..%9 als Parameter, %% als einzelnes %, alles andere bleibt Text
+void SplitParameters(std::wstring_view text, std::vector<BatchStatement::Segment>& segments) {
+    std::wstring literal;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == L'%' && i + 1 < text.size()) {
+            wchar_t next = text[i + 1];
+            if (next >= L'0' && next <= L'9') {
+                if (!literal.empty()) segments.push_back({ std::move(literal), -1 });
+                literal.clear();
+                segments.push_back({ std::wstring(), next - L'0' });
+                ++i;
+                continue;
+            }
+            if (next == L'%') ++i;
+        }
+        literal += text[i];
+    }
+    if (!literal.empty()) segments.push_back({ std::move(literal), -1 });
+}
+
+} // namespace
+
+std::shared_ptr<const BatchScript> BatchScript::Compile(std::string_view bytes, std::wstring& error) {
+    auto script = std::make_shared<BatchScript>();
+    std::vector<std::pair<std::wstring, size_t>> labels; // Marke -> naechste Anweisung
+    std::vector<std::pair<size_t, std::wstring>> jumps;  // GOTO-Anweisung -> Marke
+
+    std::wstring decoded;
+    uint32_t lineNumber = 0;
+    for (size_t pos = 0; pos <= bytes.size();) {
+        size_t end = std::min(bytes.find('\n', pos), bytes.size());
+        DecodeTextLine(bytes.substr(pos, end - pos), decoded);
+        pos = end + 1;
+        ++lineNumber;
+
+        std::wstring_view text = Trim(decoded);
+        if (lineNumber == 1 && text.starts_with(L'\xFEFF')) text.remove_prefix(1); // BOM
+        if (text.empty() || text.starts_with(L"::")) continue;
+        if (text[0] == L':') {
+            labels.emplace_back(FoldLabel(text.substr(1)), script->m_statements.size());
+            continue;
+        }
+
+        BatchStatement statement;
+        statement.line = lineNumber;
+        if (text[0] == L'@') {
+            statement.quiet = true;
+            text = Trim(text.substr(1));
+            if (text.empty()) continue;
+        }
+        std::wstring_view rest;
+        std::wstring_view verb = FirstWord(text, rest);
+        if (EqualsIgnoreCase(verb, L"REM")) continue;
+        if (EqualsIgnoreCase(verb, L"ECHO") && (EqualsIgnoreCase(rest, L"ON") || EqualsIgnoreCase(rest, L"OFF"))) {
+            statement.kind = EqualsIgnoreCase(rest, L"ON") ? BatchStatement::Kind::EchoOn : BatchStatement::Kind::EchoOff;
+        }
+        else if (EqualsIgnoreCase(verb, L"EXIT") && StartsWithIgnoreCase(rest, L"/B")) {
+            statement.kind = BatchStatement::Kind::Return;
+        }
+        else if (EqualsIgnoreCase(verb, L"GOTO")) {
+            std::wstring label = FoldLabel(rest.starts_with(L':') ? rest.substr(1) : rest);
+            if (label.empty() || label.find(L'%') != std::wstring::npos) {
+                error = L"GOTO braucht eine feste Sprungmarke (Zeile " + std::to_wstring(lineNumber) + L").";
+                return nullptr;
+            }
+            if (label == L"EOF") statement.kind = BatchStatement::Kind::Return;
+            else {
+                statement.kind = BatchStatement::Kind::Goto;
+                jumps.emplace_back(script->m_statements.size(), std::move(label));
+            }
+        }
+        else {
+            SplitParameters(text, statement.segments);
+        }
+        script->m_statements.push_back(std::move(statement));
+    }
+
+    for (auto& [index, label] : jumps) {
+        auto target = std::find_if(labels.begin(), labels.end(), [&label](const auto& entry) { return entry.first == label; });
+        BatchStatement& statement = script->m_statements[index];
+        if (target == labels.end()) {
+            error = L"Sprungmarke '" + label + L"' nicht gefunden (Zeile " + std::to_wstring(statement.line) + L").";
+            return nullptr;
+        }
+        statement.target = target->second;
+    }
+    return script;
+}
+
+std::wstring BatchScript::Expand(const BatchStatement& statement, const std::vector<std::wstring>& arguments) {
+    std::wstring text;
+    for (const BatchStatement::Segment& segment : statement.segments) {
+        if (segment.parameter < 0) text += segment.text;
+        else if (static_cast<size_t>(segment.parameter) < arguments.size()) text += arguments[static_cast<size_t>(segment.parameter)];
+    }
+    return text;
+}
+
+std::shared_ptr<const BatchScript> ScriptCache::Load(const std::wstring& path, std::wstring& error) {
+    MappedFile file;
+    if (!file.Open(path, error)) return nullptr;
+    std::string_view bytes(file.Data(), static_cast<size_t>(file.Size()));
+    uint64_t hash = HashBytes(bytes);
+
+    ++m_clock;
+    for (Entry& entry : m_entries) {
+        if (entry.hash == hash && entry.size == bytes.size()) {
+            entry.lastUse = m_clock;
+            ++m_hits;
+            return entry.script;
+        }
+    }
+
+    ++m_misses;
+    std::shared_ptr<const BatchScript> script = BatchScript::Compile(bytes, error);
+    if (!script) return nullptr;
+    if (m_entries.size() == MAX_SCRIPTS) {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+            [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; });
+        m_entries.erase(oldest);
+    }
+    m_entries.push_back({ hash, bytes.size(), m_clock, script });
+    return script;
+}
+
+std::vector<std::wstring> SplitBatchArguments(std::wstring_view text) {
+    std::vector<std::wstring> arguments;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        if (std::iswspace(text[pos])) {
+            ++pos;
+            continue;
+        }
+        size_t start = pos;
+        bool inQuotes = false;
+        for (; pos < text.size() && (inQuotes || !std::iswspace(text[pos])); ++pos) {
+            if (text[pos] == L'"') inQuotes = !inQuotes;
+        }
+        arguments.emplace_back(text.substr(start, pos - start));
+    }
+    return arguments;
+}
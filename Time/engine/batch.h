@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Eine Anweisung einer uebersetzten Batchdatei. Befehle sind in Text und Parameter (%0..%9)
+ * zerlegt, Sprungziele von GOTO sind bereits Anweisungsnummern.
+ */
+struct BatchStatement {
+    enum class Kind : uint8_t { Command, Goto, Return, EchoOn, EchoOff };
+
+    struct Segment {
+        std::wstring text;
+        int parameter = -1; // >= 0: statt text das Argument mit dieser Nummer
+    };
+
+    Kind kind = Kind::Command;
+    bool quiet = false;     // mit @: wird nicht angezeigt
+    uint32_t line = 0;      // Zeile in der Datei (1-basiert)
+    size_t target = 0;      // Goto
+    std::vector<Segment> segments;
+};
+
+/**
+ * Uebersetzte Batchdatei fuer CALL: Kommentare (REM, ::), Leerzeilen und Sprungmarken sind
+ * entfernt, ECHO ON/OFF, GOTO und EXIT /B sind eigene Anweisungen. Unveraenderlich, kann daher
+ * von mehreren laufenden Aufrufen gleichzeitig benutzt werden.
+ */
+class BatchScript {
+public:
+    // Liefert nullptr und eine Fehlermeldung (mit Zeilennummer), z.B. bei unbekannter Sprungmarke.
+    static std::shared_ptr<const BatchScript> Compile(std::string_view bytes, std::wstring& error);
+
+    size_t Size() const { return m_statements.size(); }
+    const BatchStatement& operator[](size_t index) const { return m_statements[index]; }
+
+    // Befehlstext mit eingesetzten Argumenten; fehlende Argumente sind leer.
+    static std::wstring Expand(const BatchStatement& statement, const std::vector<std::wstring>& arguments);
+
+private:
+    std::vector<BatchStatement> m_statements;
+};
+
+/**
+ * Uebersetzte Batchdateien, nach Inhalt gefunden (FNV-1a ueber die Bytes und Laenge): eine
+ * unveraenderte Datei wird bei jedem CALL nur gelesen und gehasht, nicht neu zerlegt. Eine
+ * geaenderte Datei hat einen neuen Hash und wird neu uebersetzt; die aelteste Fassung faellt
+ * heraus, wenn mehr als MAX_SCRIPTS gespeichert sind.
+ */
+class ScriptCache {
+public:
+    static constexpr size_t MAX_SCRIPTS = 32;
+
+    // Liest und uebersetzt path (bzw. holt die Uebersetzung aus dem Cache).
+    std::shared_ptr<const BatchScript> Load(const std::wstring& path, std::wstring& error);
+
+    uint64_t Hits() const { return m_hits; }
+    uint64_t Misses() const { return m_misses; }
+    size_t Size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint64_t size;
+        uint64_t lastUse;
+        std::shared_ptr<const BatchScript> script;
+    };
+
+    std::vector<Entry> m_entries;
+    uint64_t m_clock = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+// Argumente von CALL: durch Leerraum getrennt, Anfuehrungszeichen bleiben erhalten (wie %1).
+std::vector<std::wstring> SplitBatchArguments(std::wstring_view text);
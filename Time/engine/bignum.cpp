@@ -0,0 +1,329 @@
+#include "bignum.h"
+
+#include <algorithm>
+#include <cwchar>
+
+namespace {
+
+using Limbs = std::vector<uint32_t>;
+
+// Unterhalb dieser Laenge (in 32-Bit-Woertern) ist die Schulmethode schneller als Karatsuba
+const size_t KARATSUBA_THRESHOLD = 32;
+
+// Dezimal: 10^9 passt in ein Wort; bis zu dieser Laenge wird direkt durch 10^9 geteilt
+const uint32_t CHUNK = 1000000000;
+const size_t CHUNK_DIGITS = 9;
+const size_t SCHOOL_LIMBS = 40;
+const size_t SCHOOL_DIGITS = 360;
+
+// Woerter zur Basis 2^32 (Binaer) oder 10^9 (Dezimal); die Rechenwege sind fuer beide gleich
+const uint64_t BINARY = 1ull << 32;
+const uint64_t DECIMAL = CHUNK;
+
+void Trim(Limbs& a) {
+    while (!a.empty() && a.back() == 0) a.pop_back();
+}
+
+size_t TrimmedLength(const uint32_t* a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) n--;
+    return n;
+}
+
+// a += b * Radix^shift
+template <uint64_t Radix>
+void AddAt(Limbs& a, const uint32_t* b, size_t n, size_t shift) {
+    if (a.size() < shift + n + 1) a.resize(shift + n + 1, 0);
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < n; ++i) {
+        uint64_t sum = static_cast<uint64_t>(a[shift + i]) + b[i] + carry;
+        carry = sum >= Radix;
+        a[shift + i] = static_cast<uint32_t>(carry ? sum - Radix : sum);
+    }
+    for (size_t j = shift + i; carry; ++j) {
+        if (j == a.size()) a.push_back(0);
+        uint64_t sum = static_cast<uint64_t>(a[j]) + carry;
+        carry = sum >= Radix;
+        a[j] = static_cast<uint32_t>(carry ? sum - Radix : sum);
+    }
+}
+
+// a -= b, Voraussetzung a >= b
+template <uint64_t Radix>
+void Subtract(Limbs& a, const Limbs& b) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (i >= b.size() && !borrow) break;
+        uint64_t sub = (i < b.size() ? b[i] : 0) + borrow;
+        borrow = a[i] < sub;
+        a[i] = static_cast<uint32_t>(a[i] + (borrow ? Radix : 0) - sub);
+    }
+    Trim(a);
+}
+
+void MultiplyAddSmall(Limbs& a, uint32_t factor, uint32_t add) {
+    uint64_t carry = add;
+    for (uint32_t& limb : a) {
+        uint64_t product = static_cast<uint64_t>(limb) * factor + carry;
+        limb = static_cast<uint32_t>(product);
+        carry = product >> 32;
+    }
+    if (carry) a.push_back(static_cast<uint32_t>(carry));
+    Trim(a);
+}
+
+template <uint64_t Radix>
+Limbs Sum(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    Limbs sum(a, a + na);
+    AddAt<Radix>(sum, b, nb, 0);
+    Trim(sum);
+    return sum;
+}
+
+template <uint64_t Radix>
+Limbs Multiply(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    na = TrimmedLength(a, na);
+    nb = TrimmedLength(b, nb);
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb == 0) return Limbs();
+
+    if (nb < KARATSUBA_THRESHOLD) {
+        Limbs out(na + nb, 0);
+        for (size_t j = 0; j < nb; ++j) {
+            uint64_t carry = 0;
+            for (size_t i = 0; i < na; ++i) {
+                uint64_t t = static_cast<uint64_t>(a[i]) * b[j] + out[i + j] + carry;
+                out[i + j] = static_cast<uint32_t>(t % Radix);
+                carry = t / Radix;
+            }
+            out[na + j] = static_cast<uint32_t>(carry);
+        }
+        Trim(out);
+        return out;
+    }
+
+    // Sehr ungleiche Laengen: den laengeren Faktor in Stuecke der kuerzeren Laenge zerlegen
+    if (na >= 2 * nb) {
+        Limbs out(na + nb + 1, 0);
+        for (size_t pos = 0; pos < na; pos += nb) {
+            Limbs part = Multiply<Radix>(a + pos, std::min(nb, na - pos), b, nb);
+            AddAt<Radix>(out, part.data(), part.size(), pos);
+        }
+        Trim(out);
+        return out;
+    }
+
+    // Karatsuba: (a1 X + a0)(b1 X + b0) mit drei statt vier Multiplikationen, X = Radix^half
+    size_t half = (na + 1) / 2;
+    Limbs low = Multiply<Radix>(a, half, b, half);
+    Limbs high = Multiply<Radix>(a + half, na - half, b + half, nb - half);
+    Limbs sumA = Sum<Radix>(a, half, a + half, na - half);
+    Limbs sumB = Sum<Radix>(b, half, b + half, nb - half);
+    Limbs middle = Multiply<Radix>(sumA.data(), sumA.size(), sumB.data(), sumB.size());
+    Subtract<Radix>(middle, low);
+    Subtract<Radix>(middle, high);
+
+    Limbs out(na + nb + 1, 0);
+    AddAt<Radix>(out, low.data(), low.size(), 0);
+    AddAt<Radix>(out, middle.data(), middle.size(), half);
+    AddAt<Radix>(out, high.data(), high.size(), 2 * half);
+    Trim(out);
+    return out;
+}
+
+template <uint64_t Radix>
+Limbs Multiply(const Limbs& a, const Limbs& b) {
+    return Multiply<Radix>(a.data(), a.size(), b.data(), b.size());
+}
+
+/**
+ * Potenzen fuer die Dezimalumwandlung, jeweils durch Quadrieren der vorigen: Einlesen braucht
+ * 10^(9 * 2^k) binaer, Ausgeben 2^(32 * 2^k) zur Basis 10^9.
+ */
+class PowerTable {
+public:
+    PowerTable(uint64_t radix, Limbs first)
+        : m_radix(radix) {
+        m_powers.push_back(std::move(first));
+    }
+
+    const Limbs& Power(size_t k) {
+        while (m_powers.size() <= k) {
+            const Limbs& last = m_powers.back();
+            m_powers.push_back(m_radix == BINARY ? Multiply<BINARY>(last, last) : Multiply<DECIMAL>(last, last));
+        }
+        return m_powers[k];
+    }
+
+private:
+    uint64_t m_radix;
+    std::vector<Limbs> m_powers;
+};
+
+// Dezimalziffern [begin, end) ohne Vorzeichen, alle gueltig; Ergebnis binaer
+Limbs ParseDecimal(const wchar_t* begin, const wchar_t* end, PowerTable& powers) {
+    size_t count = static_cast<size_t>(end - begin);
+    if (count <= SCHOOL_DIGITS) {
+        Limbs value;
+        size_t first = count % CHUNK_DIGITS ? count % CHUNK_DIGITS : CHUNK_DIGITS;
+        for (const wchar_t* group = begin; group < end; group += first, first = CHUNK_DIGITS) {
+            uint32_t chunk = 0;
+            uint32_t scale = 1;
+            for (const wchar_t* p = group; p < group + first; ++p) {
+                chunk = chunk * 10 + static_cast<uint32_t>(*p - L'0');
+                scale *= 10;
+            }
+            MultiplyAddSmall(value, scale, chunk);
+        }
+        return value;
+    }
+
+    // Groesste Potenz 10^(9 * 2^k) mit weniger Stellen als die Eingabe: oben * P + unten
+    size_t k = 0;
+    while ((CHUNK_DIGITS << (k + 1)) < count) k++;
+    const wchar_t* split = end - (CHUNK_DIGITS << k);
+    Limbs value = Multiply<BINARY>(ParseDecimal(begin, split, powers), powers.Power(k));
+    Limbs low = ParseDecimal(split, end, powers);
+    AddAt<BINARY>(value, low.data(), low.size(), 0);
+    Trim(value);
+    return value;
+}
+
+// Binaere Woerter [0, n) in Woerter zur Basis 10^9: oben * 2^(32 h) + unten, h = 2^k Woerter
+Limbs ToDecimalLimbs(const uint32_t* x, size_t n, PowerTable& powers) {
+    n = TrimmedLength(x, n);
+    if (n <= SCHOOL_LIMBS) {
+        Limbs rest(x, x + n);
+        Limbs result;
+        while (!rest.empty()) {
+            uint64_t remainder = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint64_t current = remainder << 32 | rest[i];
+                rest[i] = static_cast<uint32_t>(current / CHUNK);
+                remainder = current % CHUNK;
+            }
+            Trim(rest);
+            result.push_back(static_cast<uint32_t>(remainder));
+        }
+        return result;
+    }
+
+    size_t k = 0;
+    while ((size_t(1) << (k + 1)) < n) k++;
+    size_t half = size_t(1) << k;
+    Limbs value = Multiply<DECIMAL>(ToDecimalLimbs(x + half, n - half, powers), powers.Power(k));
+    Limbs low = ToDecimalLimbs(x, half, powers);
+    AddAt<DECIMAL>(value, low.data(), low.size(), 0);
+    Trim(value);
+    return value;
+}
+
+int DigitValue(wchar_t c) {
+    if (c >= L'0' && c <= L'9') return c - L'0';
+    if (c >= L'a' && c <= L'f') return c - L'a' + 10;
+    if (c >= L'A' && c <= L'F') return c - L'A' + 10;
+    return 99;
+}
+
+unsigned BitsPerDigit(unsigned radix) {
+    return radix == 2 ? 1 : radix == 8 ? 3 : radix == 16 ? 4 : 0;
+}
+
+} // namespace
+
+BigInteger::BigInteger(std::vector<uint32_t> magnitude, bool negative)
+    : m_magnitude(std::move(magnitude)) {
+    Trim(m_magnitude);
+    m_negative = negative && !m_magnitude.empty();
+}
+
+bool BigInteger::Parse(std::wstring_view text, unsigned radix, BigInteger& value) {
+    bool negative = !text.empty() && text[0] == L'-';
+    if (negative) text.remove_prefix(1);
+    if (text.empty() || (radix != 10 && !BitsPerDigit(radix))) return false;
+    for (wchar_t c : text) {
+        if (DigitValue(c) >= static_cast<int>(radix)) return false;
+    }
+
+    Limbs magnitude;
+    if (radix == 10) {
+        PowerTable powers(BINARY, Limbs{ CHUNK });
+        magnitude = ParseDecimal(text.data(), text.data() + text.size(), powers);
+    }
+    else {
+        // Von der niedrigsten Ziffer an Bits einsammeln
+        unsigned bits = BitsPerDigit(radix);
+        magnitude.assign((text.size() * bits + 31) / 32, 0);
+        size_t position = 0;
+        for (size_t i = text.size(); i-- > 0; position += bits) {
+            uint64_t digit = static_cast<uint64_t>(DigitValue(text[i])) << (position % 32);
+            magnitude[position / 32] |= static_cast<uint32_t>(digit);
+            if (digit >> 32) magnitude[position / 32 + 1] |= static_cast<uint32_t>(digit >> 32);
+        }
+    }
+    value = BigInteger(std::move(magnitude), negative);
+    return true;
+}
+
+bool BigInteger::ParseLiteral(std::wstring_view text, BigInteger& value, unsigned& radix) {
+    bool negative = !text.empty() && text[0] == L'-';
+    std::wstring_view digits = negative ? text.substr(1) : text;
+    radix = 10;
+    if (digits.size() > 2 && digits[0] == L'0') {
+        wchar_t prefix = digits[1];
+        if (prefix == L'x' || prefix == L'X') radix = 16;
+        else if (prefix == L'o' || prefix == L'O') radix = 8;
+        else if (prefix == L'b' || prefix == L'B') radix = 2;
+        if (radix != 10) digits.remove_prefix(2);
+    }
+    if (!Parse(digits, radix, value)) return false;
+    value.m_negative = negative && !value.m_magnitude.empty();
+    return true;
+}
+
+std::wstring BigInteger::ToString(unsigned radix) const {
+    std::wstring out;
+    if (m_negative) out += L'-';
+    if (m_magnitude.empty()) return L"0";
+
+    if (radix == 10 && m_magnitude.size() <= 2) {
+        uint64_t value = m_magnitude[0];
+        if (m_magnitude.size() == 2) value |= static_cast<uint64_t>(m_magnitude[1]) << 32;
+        return out + std::to_wstring(value);
+    }
+    if (radix == 10) {
+        // 2^32 zur Basis 10^9
+        PowerTable powers(DECIMAL, Limbs{ 294967296, 4 });
+        Limbs decimal = ToDecimalLimbs(m_magnitude.data(), m_magnitude.size(), powers);
+        out += std::to_wstring(decimal.back());
+        wchar_t chunk[CHUNK_DIGITS + 1];
+        for (size_t i = decimal.size() - 1; i-- > 0;) {
+            swprintf(chunk, CHUNK_DIGITS + 1, L"%09u", decimal[i]);
+            out.append(chunk, CHUNK_DIGITS);
+        }
+        return out;
+    }
+
+    unsigned bits = BitsPerDigit(radix);
+    if (!bits) return std::wstring();
+    const wchar_t* DIGITS = L"0123456789ABCDEF";
+    size_t digits = (BitLength() + bits - 1) / bits;
+    out.reserve(out.size() + digits);
+    for (size_t i = digits; i-- > 0;) {
+        size_t position = i * bits;
+        uint64_t word = m_magnitude[position / 32];
+        if (position / 32 + 1 < m_magnitude.size()) word |= static_cast<uint64_t>(m_magnitude[position / 32 + 1]) << 32;
+        out += DIGITS[(word >> (position % 32)) & (radix - 1)];
+    }
+    return out;
+}
+
+size_t BigInteger::BitLength() const {
+    if (m_magnitude.empty()) return 0;
+    size_t bits = 32 * (m_magnitude.size() - 1);
+    for (uint32_t top = m_magnitude.back(); top; top >>= 1) bits++;
+    return bits;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Ganze Zahl beliebiger Groesse fuer BASE, HEX und DEC (z.B. 256-Bit-Hashes und Schluessel).
+ *
+ * Basen 2, 8 und 16 werden bitweise in linearer Zeit umgewandelt. Dezimal teilt die Zahl rekursiv
+ * in zwei Haelften (Teile und herrsche) und setzt sie mit einer Karatsuba-Multiplikation wieder
+ * zusammen: Einlesen rechnet oben * 10^(9 * 2^k) + unten binaer, Ausgeben oben * 2^(32 * 2^k)
+ * + unten zur Basis 10^9. Beides ist subquadratisch und kommt ohne lange Division aus.
+ */
+class BigInteger {
+public:
+    BigInteger() = default;
+    // magnitude: niedrigstwertiges 32-Bit-Wort zuerst
+    explicit BigInteger(std::vector<uint32_t> magnitude, bool negative = false);
+
+    // Ziffern zur Basis 2, 8, 10 oder 16 ohne Praefix, optional mit '-'. false bei leerer
+    // Eingabe oder ungueltigen Ziffern.
+    static bool Parse(std::wstring_view text, unsigned radix, BigInteger& value);
+
+    // Wie Parse, die Basis ergibt sich aus dem Praefix: 0x (16), 0o (8), 0b (2), sonst 10.
+    static bool ParseLiteral(std::wstring_view text, BigInteger& value, unsigned& radix);
+
+    // Ziffern zur Basis 2, 8, 10 oder 16 (Grossbuchstaben), negative Zahlen mit '-'.
+    std::wstring ToString(unsigned radix) const;
+
+    bool IsZero() const { return m_magnitude.empty(); }
+    bool IsNegative() const { return m_negative; }
+    size_t BitLength() const;
+    const std::vector<uint32_t>& Magnitude() const { return m_magnitude; }
+
+private:
+    std::vector<uint32_t> m_magnitude; // ohne fuehrende Nullwoerter; 0 = leer
+    bool m_negative = false;
+};
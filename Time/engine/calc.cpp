@@ -0,0 +1,755 @@
+#include "calc.h"
+#include "table.h"
+#include "vecmath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cwchar>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+const double E = 2.71828182845904523536;
+const double RAD_TO_DEG = 57.295779513082320877;
+const double LOG10_E = 0.43429448190325182765;
+
+// Bis zu dieser Punktzahl gibt TABLE jeden Punkt aus, sonst nur die Zusammenfassung
+const uint64_t TABLE_ROW_LIMIT = 1000;
+
+// Verschachtelung von Klammern und Vorzeichen beim Zerlegen
+const int MAX_NESTING = 64;
+
+struct FunctionInfo {
+    const wchar_t* name;
+    CalcFunction function;
+};
+
+const FunctionInfo FUNCTIONS[] = {
+    { L"sqrt", CalcFunction::Sqrt }, { L"abs", CalcFunction::Abs }, { L"exp", CalcFunction::Exp },
+    { L"ln", CalcFunction::Ln }, { L"log", CalcFunction::Ln }, { L"log10", CalcFunction::Log10 },
+    { L"sin", CalcFunction::Sin }, { L"cos", CalcFunction::Cos }, { L"tan", CalcFunction::Tan },
+    { L"asin", CalcFunction::Asin }, { L"acos", CalcFunction::Acos }, { L"atan", CalcFunction::Atan },
+    { L"floor", CalcFunction::Floor }, { L"ceil", CalcFunction::Ceil }, { L"round", CalcFunction::Round },
+    { L"min", CalcFunction::Min }, { L"max", CalcFunction::Max }, { L"pow", CalcFunction::Pow },
+};
+
+// min, max und pow stehen am Ende der Aufzaehlung
+size_t Arity(CalcFunction function) {
+    return function >= CalcFunction::Min ? 2 : 1;
+}
+
+double ApplyFunction(CalcFunction function, double a, double b) {
+    switch (function) {
+    case CalcFunction::Sqrt: return std::sqrt(a);
+    case CalcFunction::Abs: return std::fabs(a);
+    case CalcFunction::Exp: return std::exp(a);
+    case CalcFunction::Ln: return std::log(a);
+    case CalcFunction::Log10: return std::log10(a);
+    case CalcFunction::Sin: return SinDegrees(a);
+    case CalcFunction::Cos: return CosDegrees(a);
+    case CalcFunction::Tan: return TanDegrees(a);
+    case CalcFunction::Asin: return std::asin(a) * RAD_TO_DEG;
+    case CalcFunction::Acos: return std::acos(a) * RAD_TO_DEG;
+    case CalcFunction::Atan: return std::atan(a) * RAD_TO_DEG;
+    case CalcFunction::Floor: return std::floor(a);
+    case CalcFunction::Ceil: return std::ceil(a);
+    case CalcFunction::Round: return std::round(a);
+    case CalcFunction::Min: return std::fmin(a, b);
+    case CalcFunction::Max: return std::fmax(a, b);
+    case CalcFunction::Pow: return std::pow(a, b);
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+double ApplyOp(CalcOp op, double a, double b) {
+    switch (op) {
+    case CalcOp::Neg: return -a;
+    case CalcOp::Add: return a + b;
+    case CalcOp::Sub: return a - b;
+    case CalcOp::Mul: return a * b;
+    case CalcOp::Div: return a / b;
+    case CalcOp::Mod: return std::fmod(a, b);
+    case CalcOp::Pow: return std::pow(a, b);
+    case CalcOp::Square: return a * a;
+    default: return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+// Funktion ueber einen ganzen Block; b ist das zweite Argument bzw. freier Platz
+void ApplyFunctionBlock(CalcFunction function, double* a, double* b, size_t count) {
+    switch (function) {
+    case CalcFunction::Sqrt: VecSqrt(a, a, count); return;
+    case CalcFunction::Abs: VecAbs(a, a, count); return;
+    case CalcFunction::Exp: VecExp(a, a, count); return;
+    case CalcFunction::Ln: VecLog(a, a, count); return;
+    case CalcFunction::Log10:
+        VecLog(a, a, count);
+        for (size_t i = 0; i < count; ++i) a[i] *= LOG10_E;
+        return;
+    case CalcFunction::Sin: VecSinCosDegrees(a, a, nullptr, count); return;
+    case CalcFunction::Cos: VecSinCosDegrees(a, nullptr, a, count); return;
+    case CalcFunction::Tan:
+        VecSinCosDegrees(a, a, b, count);
+        for (size_t i = 0; i < count; ++i) a[i] /= b[i];
+        return;
+    case CalcFunction::Floor:
+        for (size_t i = 0; i < count; ++i) a[i] = std::floor(a[i]);
+        return;
+    case CalcFunction::Ceil:
+        for (size_t i = 0; i < count; ++i) a[i] = std::ceil(a[i]);
+        return;
+    case CalcFunction::Min:
+        for (size_t i = 0; i < count; ++i) a[i] = std::fmin(a[i], b[i]);
+        return;
+    case CalcFunction::Max:
+        for (size_t i = 0; i < count; ++i) a[i] = std::fmax(a[i], b[i]);
+        return;
+    default:
+        for (size_t i = 0; i < count; ++i) a[i] = ApplyFunction(function, a[i], b[i]);
+        return;
+    }
+}
+
+bool IsNameStart(wchar_t c) {
+    return (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || c == L'_';
+}
+
+bool IsNameChar(wchar_t c) {
+    return IsNameStart(c) || (c >= L'0' && c <= L'9');
+}
+
+bool IsSpace(wchar_t c) {
+    return c == L' ' || c == L'\t';
+}
+
+std::wstring Lower(std::wstring_view text) {
+    std::wstring lower(text);
+    for (wchar_t& c : lower) {
+        if (c >= L'A' && c <= L'Z') c = static_cast<wchar_t>(c + (L'a' - L'A'));
+    }
+    return lower;
+}
+
+std::wstring_view Trim(std::wstring_view text) {
+    while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+bool IsName(std::wstring_view text) {
+    if (text.empty() || !IsNameStart(text[0])) return false;
+    return std::all_of(text.begin(), text.end(), IsNameChar);
+}
+
+bool IsConstantName(const std::wstring& lower) {
+    return lower == L"pi" || lower == L"e";
+}
+
+} // namespace
+
+/**
+ * Zerlegt einen Ausdruck (rekursiver Abstieg) in einen Baum, rechnet dabei konstante Teile aus
+ * und erzeugt daraus den Bytecode.
+ */
+class CalcCompiler {
+public:
+    CalcCompiler(std::wstring_view text, std::wstring_view input, const std::unordered_map<std::wstring, size_t>& slots)
+        : m_text(text), m_input(Lower(input)), m_slots(slots) {
+    }
+
+    bool Compile(CalcProgram& program, std::wstring& error) {
+        int root = ParseSum();
+        if (root >= 0) {
+            SkipSpace();
+            if (m_pos < m_text.size()) root = Fail(L"Unerwartetes Zeichen '" + std::wstring(1, m_text[m_pos]) + L"'");
+        }
+        if (root < 0) {
+            error = m_error;
+            return false;
+        }
+        size_t depth = 0;
+        Emit(root, program, depth);
+        if (program.m_depth > CalcProgram::MAX_DEPTH) {
+            error = L"Ausdruck zu komplex.";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Node {
+        CalcOp op;
+        CalcFunction function;
+        double value;  // Const
+        uint32_t slot; // Var
+        int left;
+        int right;
+    };
+
+    int Fail(const std::wstring& message) {
+        if (m_error.empty()) m_error = message + L" an Position " + std::to_wstring(m_pos + 1) + L".";
+        return -1;
+    }
+
+    void SkipSpace() {
+        while (m_pos < m_text.size() && IsSpace(m_text[m_pos])) m_pos++;
+    }
+
+    // Naechstes Zeichen nach Leerraum, 0 am Ende
+    wchar_t Peek() {
+        SkipSpace();
+        return m_pos < m_text.size() ? m_text[m_pos] : 0;
+    }
+
+    int Constant(double value) {
+        m_nodes.push_back({ CalcOp::Const, CalcFunction::Sqrt, value, 0, -1, -1 });
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+
+    bool IsConstant(int node, double value) const {
+        return m_nodes[node].op == CalcOp::Const && m_nodes[node].value == value;
+    }
+
+    // Neuer Knoten; sind alle Argumente konstant, wird er sofort ausgerechnet
+    int Make(CalcOp op, int left, int right, CalcFunction function = CalcFunction::Sqrt) {
+        bool binary = op == CalcOp::Call ? Arity(function) == 2 : op != CalcOp::Neg && op != CalcOp::Square;
+        if (left < 0 || (binary && right < 0)) return -1;
+
+        bool constant = m_nodes[left].op == CalcOp::Const && (!binary || m_nodes[right].op == CalcOp::Const);
+        if (constant) {
+            double a = m_nodes[left].value;
+            double b = binary ? m_nodes[right].value : 0.0;
+            return Constant(op == CalcOp::Call ? ApplyFunction(function, a, b) : ApplyOp(op, a, b));
+        }
+        if (op == CalcOp::Pow && IsConstant(right, 2.0)) return Make(CalcOp::Square, left, -1);
+        if (op == CalcOp::Pow && IsConstant(right, 1.0)) return left;
+
+        m_nodes.push_back({ op, function, 0.0, 0, left, binary ? right : -1 });
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+
+    // summe := produkt (('+' | '-') produkt)*
+    int ParseSum() {
+        int left = ParseProduct();
+        while (left >= 0) {
+            wchar_t c = Peek();
+            if (c != L'+' && c != L'-') break;
+            m_pos++;
+            left = Make(c == L'+' ? CalcOp::Add : CalcOp::Sub, left, ParseProduct());
+        }
+        return left;
+    }
+
+    // produkt := vorzeichen (('*' | '/' | '%') vorzeichen)*
+    int ParseProduct() {
+        int left = ParseUnary();
+        while (left >= 0) {
+            wchar_t c = Peek();
+            if (c != L'*' && c != L'/' && c != L'%') break;
+            m_pos++;
+            left = Make(c == L'*' ? CalcOp::Mul : c == L'/' ? CalcOp::Div : CalcOp::Mod, left, ParseUnary());
+        }
+        return left;
+    }
+
+    // vorzeichen := ('-' | '+') vorzeichen | potenz; -2^2 ist wie ueblich -(2^2)
+    int ParseUnary() {
+        wchar_t c = Peek();
+        if (c != L'-' && c != L'+') return ParsePower();
+        if (++m_nesting > MAX_NESTING) return Fail(L"Ausdruck zu tief verschachtelt");
+        m_pos++;
+        int operand = ParseUnary();
+        m_nesting--;
+        return c == L'-' ? Make(CalcOp::Neg, operand, -1) : operand;
+    }
+
+    // potenz := element ('^' vorzeichen)?, rechtsassoziativ: 2^3^2 = 2^9
+    int ParsePower() {
+        int base = ParsePrimary();
+        if (base < 0 || Peek() != L'^') return base;
+        m_pos++;
+        if (++m_nesting > MAX_NESTING) return Fail(L"Ausdruck zu tief verschachtelt");
+        int exponent = ParseUnary();
+        m_nesting--;
+        return Make(CalcOp::Pow, base, exponent);
+    }
+
+    int ParsePrimary() {
+        wchar_t c = Peek();
+        if (c == 0) return Fail(L"Ausdruck unvollstaendig");
+
+        if (c == L'(') {
+            if (++m_nesting > MAX_NESTING) return Fail(L"Ausdruck zu tief verschachtelt");
+            m_pos++;
+            int inner = ParseSum();
+            m_nesting--;
+            if (inner < 0) return -1;
+            if (Peek() != L')') return Fail(L"Fehlende ')'");
+            m_pos++;
+            return inner;
+        }
+
+        if ((c >= L'0' && c <= L'9') || c == L'.') {
+            // m_text ist nullterminiert (Kopie im Calculator); wcstod liest auch 1e-3 und 0x1F
+            const wchar_t* start = m_text.data() + m_pos;
+            wchar_t* end = nullptr;
+            double value = std::wcstod(start, &end);
+            if (end == start) return Fail(L"Ungueltige Zahl");
+            m_pos += static_cast<size_t>(end - start);
+            return Constant(value);
+        }
+
+        if (!IsNameStart(c)) return Fail(L"Unerwartetes Zeichen '" + std::wstring(1, c) + L"'");
+        size_t start = m_pos;
+        while (m_pos < m_text.size() && IsNameChar(m_text[m_pos])) m_pos++;
+        std::wstring name = Lower(m_text.substr(start, m_pos - start));
+
+        if (Peek() == L'(') return ParseCall(name, start);
+        if (!m_input.empty() && name == m_input) {
+            m_nodes.push_back({ CalcOp::Input, CalcFunction::Sqrt, 0.0, 0, -1, -1 });
+            return static_cast<int>(m_nodes.size() - 1);
+        }
+        if (name == L"pi") return Constant(PI);
+        if (name == L"e") return Constant(E);
+        auto slot = m_slots.find(name);
+        if (slot == m_slots.end()) {
+            m_pos = start;
+            return Fail(L"Unbekannte Variable '" + std::wstring(m_text.substr(start, name.size())) + L"'");
+        }
+        m_nodes.push_back({ CalcOp::Var, CalcFunction::Sqrt, 0.0, static_cast<uint32_t>(slot->second), -1, -1 });
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+
+    int ParseCall(const std::wstring& name, size_t start) {
+        auto info = std::find_if(std::begin(FUNCTIONS), std::end(FUNCTIONS),
+            [&name](const FunctionInfo& f) { return name == f.name; });
+        if (info == std::end(FUNCTIONS)) {
+            m_pos = start;
+            return Fail(L"Unbekannte Funktion '" + std::wstring(m_text.substr(start, name.size())) + L"'");
+        }
+        if (++m_nesting > MAX_NESTING) return Fail(L"Ausdruck zu tief verschachtelt");
+        m_pos++; // '('
+
+        size_t expected = Arity(info->function);
+        int args[2] = { -1, -1 };
+        size_t count = 0;
+        if (Peek() != L')') {
+            while (true) {
+                int arg = ParseSum();
+                if (arg < 0) return -1;
+                if (count < expected) args[count] = arg;
+                count++;
+                if (Peek() != L',') break;
+                m_pos++;
+            }
+        }
+        m_nesting--;
+        if (Peek() != L')') return Fail(L"Fehlende ')'");
+        if (count != expected) {
+            return Fail(L"Funktion '" + name + L"' erwartet " + std::to_wstring(expected)
+                + (expected == 1 ? L" Argument" : L" Argumente"));
+        }
+        m_pos++;
+        return Make(CalcOp::Call, args[0], args[1], info->function);
+    }
+
+    // Nachordnung: erst die Argumente, dann die Operation; depth ist die aktuelle Stapelhoehe
+    void Emit(int index, CalcProgram& program, size_t& depth) {
+        const Node& node = m_nodes[index];
+        if (node.left >= 0) Emit(node.left, program, depth);
+        if (node.right >= 0) Emit(node.right, program, depth);
+
+        CalcInstruction instruction{ node.op, node.function, 0 };
+        switch (node.op) {
+        case CalcOp::Const:
+            instruction.arg = static_cast<uint32_t>(program.m_constants.size());
+            program.m_constants.push_back(node.value);
+            depth++;
+            break;
+        case CalcOp::Var:
+            instruction.arg = node.slot;
+            depth++;
+            break;
+        case CalcOp::Input:
+            depth++;
+            break;
+        default:
+            if (node.right >= 0) depth--;
+            break;
+        }
+        program.m_depth = std::max(program.m_depth, depth);
+        program.m_code.push_back(instruction);
+    }
+
+    std::wstring_view m_text;
+    std::wstring m_input;
+    const std::unordered_map<std::wstring, size_t>& m_slots;
+    std::vector<Node> m_nodes;
+    size_t m_pos = 0;
+    int m_nesting = 0;
+    std::wstring m_error;
+};
+
+double CalcProgram::Evaluate(const double* variables, double input) const {
+    double stack[MAX_DEPTH];
+    size_t sp = 0;
+    for (const CalcInstruction& instruction : m_code) {
+        switch (instruction.op) {
+        case CalcOp::Const: stack[sp++] = m_constants[instruction.arg]; break;
+        case CalcOp::Var: stack[sp++] = variables[instruction.arg]; break;
+        case CalcOp::Input: stack[sp++] = input; break;
+        case CalcOp::Neg: stack[sp - 1] = -stack[sp - 1]; break;
+        case CalcOp::Square: stack[sp - 1] *= stack[sp - 1]; break;
+        case CalcOp::Call:
+            if (Arity(instruction.function) == 2) {
+                sp--;
+                stack[sp - 1] = ApplyFunction(instruction.function, stack[sp - 1], stack[sp]);
+            }
+            else {
+                stack[sp - 1] = ApplyFunction(instruction.function, stack[sp - 1], 0.0);
+            }
+            break;
+        default:
+            sp--;
+            stack[sp - 1] = ApplyOp(instruction.op, stack[sp - 1], stack[sp]);
+            break;
+        }
+    }
+    return sp ? stack[0] : std::numeric_limits<double>::quiet_NaN();
+}
+
+void CalcProgram::EvaluateBlock(const double* variables, const double* input, double* out, size_t count,
+    std::vector<double>& stack) const {
+    count = std::min(count, BLOCK);
+    // Ein Platz mehr als noetig: freier Zwischenspeicher fuer tan
+    if (stack.size() < (m_depth + 1) * BLOCK) stack.resize((m_depth + 1) * BLOCK);
+    double* base = stack.data();
+    size_t sp = 0;
+
+    for (const CalcInstruction& instruction : m_code) {
+        double* top = base + (sp ? sp - 1 : 0) * BLOCK;
+        switch (instruction.op) {
+        case CalcOp::Const:
+            std::fill_n(base + sp++ * BLOCK, count, m_constants[instruction.arg]);
+            continue;
+        case CalcOp::Var:
+            std::fill_n(base + sp++ * BLOCK, count, variables[instruction.arg]);
+            continue;
+        case CalcOp::Input:
+            std::copy_n(input, count, base + sp++ * BLOCK);
+            continue;
+        case CalcOp::Neg:
+            for (size_t i = 0; i < count; ++i) top[i] = -top[i];
+            continue;
+        case CalcOp::Square:
+            for (size_t i = 0; i < count; ++i) top[i] *= top[i];
+            continue;
+        case CalcOp::Call:
+            if (Arity(instruction.function) == 2) sp--;
+            ApplyFunctionBlock(instruction.function, base + (sp - 1) * BLOCK, base + sp * BLOCK, count);
+            continue;
+        default:
+            break;
+        }
+
+        sp--;
+        double* a = base + (sp - 1) * BLOCK;
+        const double* b = base + sp * BLOCK;
+        switch (instruction.op) {
+        case CalcOp::Add:
+            for (size_t i = 0; i < count; ++i) a[i] += b[i];
+            break;
+        case CalcOp::Sub:
+            for (size_t i = 0; i < count; ++i) a[i] -= b[i];
+            break;
+        case CalcOp::Mul:
+            for (size_t i = 0; i < count; ++i) a[i] *= b[i];
+            break;
+        case CalcOp::Div:
+            for (size_t i = 0; i < count; ++i) a[i] /= b[i];
+            break;
+        default:
+            for (size_t i = 0; i < count; ++i) a[i] = ApplyOp(instruction.op, a[i], b[i]);
+            break;
+        }
+    }
+    if (sp) std::copy_n(base, count, out);
+    else std::fill_n(out, count, std::numeric_limits<double>::quiet_NaN());
+}
+
+Calculator::Calculator() {
+    m_slots[L"ans"] = 0;
+    m_values.push_back(0.0);
+    m_ans = 0;
+}
+
+std::shared_ptr<const CalcProgram> Calculator::Compile(std::wstring_view text, std::wstring_view input, std::wstring& error) {
+    std::wstring key(input);
+    key += L'\x1f';
+    key += text;
+    auto cached = m_cache.find(key);
+    if (cached != m_cache.end()) return cached->second;
+
+    // Der Compiler liest Zahlen mit wcstod und braucht daher nullterminierten Text
+    std::wstring source(text);
+    auto program = std::make_shared<CalcProgram>();
+    CalcCompiler compiler(source, input, m_slots);
+    if (!compiler.Compile(*program, error)) return nullptr;
+
+    if (m_cacheOrder.size() >= CACHE_LIMIT) {
+        m_cache.erase(m_cacheOrder.front());
+        m_cacheOrder.pop_front();
+    }
+    m_cacheOrder.push_back(key);
+    m_cache.emplace(std::move(key), program);
+    return program;
+}
+
+bool Calculator::Evaluate(std::wstring_view text, double& value, std::wstring& error) {
+    std::shared_ptr<const CalcProgram> program = Compile(Trim(text), std::wstring_view(), error);
+    if (!program) return false;
+    value = program->Evaluate(m_values.data());
+    return true;
+}
+
+bool Calculator::Execute(std::wstring_view text, std::wstring& name, double& value, std::wstring& error) {
+    text = Trim(text);
+    name.clear();
+
+    // name = ausdruck
+    size_t length = 0;
+    while (length < text.size() && IsNameChar(text[length])) length++;
+    size_t pos = length;
+    while (pos < text.size() && IsSpace(text[pos])) pos++;
+    std::wstring_view expression = text;
+    if (length > 0 && IsNameStart(text[0]) && pos < text.size() && text[pos] == L'=') {
+        name = text.substr(0, length);
+        if (IsConstantName(Lower(name))) {
+            error = L"'" + name + L"' ist eine Konstante.";
+            return false;
+        }
+        expression = text.substr(pos + 1);
+    }
+
+    if (!Evaluate(expression, value, error)) return false;
+    if (!std::isfinite(value)) {
+        error = L"Ergebnis ist keine endliche Zahl (Division durch 0 oder ausserhalb des Definitionsbereichs).";
+        return false;
+    }
+    if (!name.empty()) {
+        auto slot = m_slots.emplace(Lower(name), m_values.size());
+        if (slot.second) m_values.push_back(value);
+        else m_values[slot.first->second] = value;
+    }
+    m_values[m_ans] = value;
+    return true;
+}
+
+bool Calculator::PrepareTable(std::wstring_view arguments, CalcTable& table, std::wstring& error) {
+    const wchar_t* SYNTAX = L"Syntax: TABLE <ausdruck> x=a..b [step s]";
+    arguments = Trim(arguments);
+
+    // Der Bereich beginnt mit dem Namen vor dem letzten '='
+    size_t equals = arguments.rfind(L'=');
+    if (equals == std::wstring_view::npos) {
+        error = SYNTAX;
+        return false;
+    }
+    size_t nameEnd = equals;
+    while (nameEnd > 0 && IsSpace(arguments[nameEnd - 1])) nameEnd--;
+    size_t nameStart = nameEnd;
+    while (nameStart > 0 && IsNameChar(arguments[nameStart - 1])) nameStart--;
+    std::wstring_view variable = arguments.substr(nameStart, nameEnd - nameStart);
+    std::wstring_view expression = Trim(arguments.substr(0, nameStart));
+    if (!IsName(variable) || expression.empty() || (nameStart > 0 && !IsSpace(arguments[nameStart - 1]))) {
+        error = SYNTAX;
+        return false;
+    }
+    if (IsConstantName(Lower(variable))) {
+        error = L"'" + std::wstring(variable) + L"' ist eine Konstante.";
+        return false;
+    }
+
+    std::wstring_view range = arguments.substr(equals + 1);
+    size_t dots = range.find(L"..");
+    if (dots == std::wstring_view::npos) {
+        error = SYNTAX;
+        return false;
+    }
+    std::wstring_view from = range.substr(0, dots);
+    std::wstring_view to = range.substr(dots + 2);
+    std::wstring_view step;
+    std::wstring lowerTo = Lower(to);
+    for (size_t pos = lowerTo.find(L"step"); pos != std::wstring::npos; pos = lowerTo.find(L"step", pos + 1)) {
+        bool before = pos > 0 && IsSpace(lowerTo[pos - 1]);
+        bool after = pos + 4 < lowerTo.size() && IsSpace(lowerTo[pos + 4]);
+        if (before && after) {
+            step = to.substr(pos + 4);
+            to = to.substr(0, pos);
+            break;
+        }
+    }
+
+    double a, b, s;
+    if (!Evaluate(from, a, error) || !Evaluate(to, b, error)) return false;
+    if (step.empty()) s = b >= a ? 1.0 : -1.0;
+    else if (!Evaluate(step, s, error)) return false;
+    if (!std::isfinite(a) || !std::isfinite(b) || !std::isfinite(s)) {
+        error = L"Bereich und Schrittweite muessen endliche Zahlen sein.";
+        return false;
+    }
+    if (s == 0.0) {
+        error = L"Schrittweite darf nicht 0 sein.";
+        return false;
+    }
+    if (b != a && (b > a) != (s > 0.0)) {
+        error = L"Schrittweite fuehrt nicht zum Ende des Bereichs.";
+        return false;
+    }
+    // Kleine Toleranz, damit 0..1 step 0.1 den Endpunkt trotz Rundung enthaelt
+    double points = std::floor((b - a) / s + 1e-9) + 1.0;
+    if (points > static_cast<double>(MAX_TABLE_POINTS)) {
+        error = L"Zu viele Punkte (hoechstens " + std::to_wstring(MAX_TABLE_POINTS) + L").";
+        return false;
+    }
+
+    table.program = Compile(expression, variable, error);
+    if (!table.program) return false;
+    table.variables = m_values;
+    table.expression = expression;
+    table.variable = variable;
+    table.from = a;
+    table.to = b;
+    table.step = s;
+    table.count = static_cast<uint64_t>(points);
+    return true;
+}
+
+std::wstring FormatCalcNumber(double value) {
+    wchar_t text[40];
+    swprintf(text, 40, L"%.15g", value + 0.0);
+    return text;
+}
+
+void RunCalcTable(JobContext& job, const CalcTable& table) {
+    const size_t BLOCK = CalcProgram::BLOCK;
+    auto start = std::chrono::steady_clock::now();
+    auto nextProgress = start + std::chrono::milliseconds(100);
+    std::wstring caption = L"f(" + table.variable + L") = " + table.expression + L" fuer " + table.variable + L" = "
+        + FormatCalcNumber(table.from) + L" .. " + FormatCalcNumber(table.to) + L", Schritt " + FormatCalcNumber(table.step);
+
+    std::shared_ptr<ResultTable> points;
+    if (table.count <= TABLE_ROW_LIMIT) {
+        points = std::make_shared<ResultTable>();
+        points->AddCaption(caption);
+        points->AddCaption(std::wstring());
+        points->AddRealColumn(table.variable);
+        points->AddRealColumn(table.expression);
+        points->SetIndent(2);
+        points->SetGap(3);
+        points->Reserve(static_cast<size_t>(table.count), 0);
+    }
+
+    std::vector<double> stack;
+    bool progressShown = false;
+    double input[BLOCK];
+    double output[BLOCK];
+    uint64_t invalid = 0;
+    double minimum = std::numeric_limits<double>::infinity();
+    double maximum = -minimum;
+    double minimumAt = 0.0;
+    double maximumAt = 0.0;
+    double sum = 0.0;
+    double first = 0.0;
+    double last = 0.0;
+
+    for (uint64_t done = 0; done < table.count;) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(BLOCK, table.count - done));
+        for (size_t i = 0; i < count; ++i) input[i] = table.from + static_cast<double>(done + i) * table.step;
+        table.program->EvaluateBlock(table.variables.data(), input, output, count, stack);
+
+        // Teilsumme je Block: genauer als eine einzige laufende Summe ueber Millionen Werte
+        double blockSum = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double y = output[i];
+            if (!std::isfinite(y)) {
+                invalid++;
+                continue;
+            }
+            blockSum += y;
+            if (y < minimum) {
+                minimum = y;
+                minimumAt = input[i];
+            }
+            if (y > maximum) {
+                maximum = y;
+                maximumAt = input[i];
+            }
+        }
+        sum += blockSum;
+        if (done == 0) first = output[0];
+        last = output[count - 1];
+
+        if (points) {
+            for (size_t i = 0; i < count; ++i) {
+                points->AddRow();
+                points->SetReal(0, input[i]);
+                points->SetReal(1, output[i]);
+            }
+        }
+        done += count;
+
+        if (job.Cancelled()) return;
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextProgress) {
+            job.SetLiveLine(L"TABLE: " + std::to_wstring(done * 100 / table.count) + L"% ("
+                + std::to_wstring(done) + L" von " + std::to_wstring(table.count) + L" Punkten)");
+            nextProgress = now + std::chrono::milliseconds(100);
+            progressShown = true;
+        }
+    }
+    if (progressShown) job.SetLiveLine(L"TABLE: 100% (" + std::to_wstring(table.count) + L" Punkte)");
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (points) job.AddTable(points);
+
+    auto summary = std::make_shared<ResultTable>(ResultTable::Layout::List);
+    if (points) summary->AddCaption(std::wstring());
+    else summary->AddCaption(caption);
+    summary->SetIndent(2);
+    summary->SetLabelWidth(22);
+    size_t count = summary->AddNumberColumn(L"Punkte");
+    size_t invalidColumn = summary->AddNumberColumn(L"Ungueltige Werte");
+    size_t minimumColumn = summary->AddRealColumn(L"Minimum");
+    size_t minimumAtColumn = summary->AddRealColumn(L"Minimum bei " + table.variable);
+    size_t maximumColumn = summary->AddRealColumn(L"Maximum");
+    size_t maximumAtColumn = summary->AddRealColumn(L"Maximum bei " + table.variable);
+    size_t meanColumn = summary->AddRealColumn(L"Mittelwert");
+    size_t sumColumn = summary->AddRealColumn(L"Summe");
+    size_t integralColumn = summary->AddRealColumn(L"Integral (Trapez)");
+    size_t timeColumn = summary->AddTextColumn(L"Rechenzeit");
+    size_t rateColumn = summary->AddNumberColumn(L"Punkte pro Sekunde");
+    summary->AddRow();
+
+    uint64_t valid = table.count - invalid;
+    summary->Set(count, table.count);
+    summary->Set(invalidColumn, invalid);
+    if (valid) {
+        summary->SetReal(minimumColumn, minimum);
+        summary->SetReal(minimumAtColumn, minimumAt);
+        summary->SetReal(maximumColumn, maximum);
+        summary->SetReal(maximumAtColumn, maximumAt);
+        summary->SetReal(meanColumn, sum / static_cast<double>(valid));
+        summary->SetReal(sumColumn, sum);
+    }
+    // Nur ohne Luecken: (f0 + fn) / 2 + Summe der inneren Werte, mal Schrittweite
+    if (invalid == 0 && table.count >= 2) summary->SetReal(integralColumn, table.step * (sum - 0.5 * (first + last)));
+    wchar_t time[32];
+    swprintf(time, 32, L"%.3f s", seconds);
+    summary->Set(timeColumn, std::wstring_view(time));
+    if (seconds > 0.0) summary->Set(rateColumn, static_cast<uint64_t>(static_cast<double>(table.count) / seconds));
+    job.AddTable(summary);
+}
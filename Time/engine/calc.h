@@ -0,0 +1,109 @@
+#pragma once
+
+#include "executor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class CalcOp : uint8_t { Const, Var, Input, Neg, Add, Sub, Mul, Div, Mod, Pow, Square, Call };
+
+enum class CalcFunction : uint8_t {
+    Sqrt, Abs, Exp, Ln, Log10, Sin, Cos, Tan, Asin, Acos, Atan, Floor, Ceil, Round, Min, Max, Pow
+};
+
+struct CalcInstruction {
+    CalcOp op;
+    CalcFunction function; // Call
+    uint32_t arg;          // Const: Index in die Konstanten, Var: Variablenplatz
+};
+
+/**
+ * Uebersetzter Ausdruck: Bytecode fuer eine Stapelmaschine. Konstante Teilausdruecke sind bereits
+ * ausgerechnet, x^2 ist eine Multiplikation. Ein Programm ist unveraenderlich und kann daher
+ * ohne Kopie an einen Job gegeben werden; die Variablenwerte kommen bei jeder Auswertung mit.
+ */
+class CalcProgram {
+public:
+    static constexpr size_t MAX_DEPTH = 32;
+    static constexpr size_t BLOCK = 512; // Werte je Schritt der Blockauswertung
+
+    double Evaluate(const double* variables, double input = 0.0) const;
+
+    // Wertet das Programm fuer count <= BLOCK Eingaben auf einmal aus: jede Anweisung laeuft
+    // ueber den ganzen Block (Vec*-Kerne fuer die Funktionen). stack wird bei Bedarf vergroessert.
+    void EvaluateBlock(const double* variables, const double* input, double* out, size_t count,
+        std::vector<double>& stack) const;
+
+    size_t Size() const { return m_code.size(); }
+
+private:
+    friend class CalcCompiler;
+
+    std::vector<CalcInstruction> m_code;
+    std::vector<double> m_constants;
+    size_t m_depth = 0;
+};
+
+/**
+ * Vorbereiteter TABLE-Lauf: Programm, Momentaufnahme der Variablen und Wertebereich.
+ */
+struct CalcTable {
+    std::shared_ptr<const CalcProgram> program;
+    std::vector<double> variables;
+    std::wstring expression;
+    std::wstring variable;
+    double from = 0.0;
+    double to = 0.0;
+    double step = 1.0;
+    uint64_t count = 0;
+};
+
+/**
+ * Rechner fuer CALC und TABLE: Zahlen, + - * / % ^ (rechtsassoziativ), Klammern, Funktionen
+ * (sqrt, abs, exp, ln/log, log10, sin/cos/tan und asin/acos/atan in Grad, floor, ceil, round,
+ * min, max, pow), die Konstanten pi und e sowie Variablen (name = ausdruck, ans = letztes
+ * Ergebnis). Uebersetzte Ausdruecke werden zwischengespeichert, ein wiederholter Ausdruck wird
+ * nicht erneut zerlegt.
+ */
+class Calculator {
+public:
+    static constexpr size_t CACHE_LIMIT = 64;
+    static constexpr uint64_t MAX_TABLE_POINTS = 1000000000;
+
+    Calculator();
+
+    // CALC: wertet text aus, ggf. mit Zuweisung. name ist die zugewiesene Variable oder leer.
+    bool Execute(std::wstring_view text, std::wstring& name, double& value, std::wstring& error);
+
+    // Uebersetzt einen Ausdruck (aus dem Zwischenspeicher); input ist der Name der Laufvariablen
+    // von TABLE oder leer.
+    std::shared_ptr<const CalcProgram> Compile(std::wstring_view text, std::wstring_view input, std::wstring& error);
+
+    // TABLE: zerlegt "<ausdruck> x=a..b [step s]" und prueft den Bereich.
+    bool PrepareTable(std::wstring_view arguments, CalcTable& table, std::wstring& error);
+
+    const std::vector<double>& Values() const { return m_values; }
+    size_t CachedPrograms() const { return m_cache.size(); }
+
+private:
+    bool Evaluate(std::wstring_view text, double& value, std::wstring& error);
+
+    std::vector<double> m_values;
+    std::unordered_map<std::wstring, size_t> m_slots; // Name in Kleinbuchstaben -> Platz in m_values
+    std::unordered_map<std::wstring, std::shared_ptr<const CalcProgram>> m_cache;
+    std::deque<std::wstring> m_cacheOrder;
+    size_t m_ans;
+};
+
+// Zahl fuer die Ausgabe von CALC (15 signifikante Stellen).
+std::wstring FormatCalcNumber(double value);
+
+// Fuehrt TABLE aus: bis 1000 Punkte als Tabelle x / f(x), danach immer eine Zusammenfassung
+// (Minimum, Maximum, Mittelwert, Summe, Integral). Abbrechbar, Fortschritt in der Statuszeile.
+void RunCalcTable(JobContext& job, const CalcTable& table);
@@ -0,0 +1,195 @@
+#include "clock.h"
+
+#include <chrono>
+#include <ctime>
+
+namespace {
+
+int64_t FloorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return quotient - ((value % divisor != 0) && ((value < 0) != (divisor < 0)) ? 1 : 0);
+}
+
+// Tage seit dem 1.1.1970 fuer ein Datum des gregorianischen Kalenders (H. Hinnant)
+int64_t DaysFromCivil(int64_t year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    int64_t era = FloorDiv(year, 400);
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void CivilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    int64_t era = FloorDiv(days, 146097);
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t mp = (5 * dayOfYear + 2) / 153;
+    day = static_cast<int>(dayOfYear - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+void PutTwoDigits(wchar_t* out, int value) {
+    out[0] = static_cast<wchar_t>(L'0' + value / 10);
+    out[1] = static_cast<wchar_t>(L'0' + value % 10);
+}
+
+// Zeilen der Ziffern 0-9 als Bitmaske von vier Spalten (Bit 3 = links), aus den sieben Segmenten
+// oben, rechts oben, rechts unten, unten, links unten, links oben und Mitte
+constexpr uint8_t DIGIT_PATTERN[10][ClockPanel::DIGIT_ROWS] = {
+    { 0xF, 0x9, 0x9, 0x9, 0xF }, // 0
+    { 0x1, 0x1, 0x1, 0x1, 0x1 }, // 1
+    { 0xF, 0x1, 0xF, 0x8, 0xF }, // 2
+    { 0xF, 0x1, 0xF, 0x1, 0xF }, // 3
+    { 0x9, 0x9, 0xF, 0x1, 0x1 }, // 4
+    { 0xF, 0x8, 0xF, 0x1, 0xF }, // 5
+    { 0xF, 0x8, 0xF, 0x9, 0xF }, // 6
+    { 0xF, 0x1, 0x1, 0x1, 0x1 }, // 7
+    { 0xF, 0x9, 0xF, 0x9, 0xF }, // 8
+    { 0xF, 0x9, 0xF, 0x1, 0xF }, // 9
+};
+
+constexpr int DIGIT_WIDTH = 4;
+constexpr wchar_t SEGMENT = L'\x2588'; // Vollblock
+
+// Erste Spalte der sechs Ziffern in HH:MM:SS (je eine Leerspalte Abstand, Doppelpunkte bei 10
+// und 22) und Breite der Ziffernzeilen
+constexpr int DIGIT_COLUMN[6] = { 0, 5, 12, 17, 24, 29 };
+constexpr int COLON_COLUMN[2] = { 10, 22 };
+constexpr int DIGITS_WIDTH = 33;
+
+// Glyphen aller Ziffern, einmal beim Programmstart aus den Segmentmustern erzeugt
+struct DigitGlyphs {
+    wchar_t cells[10][ClockPanel::DIGIT_ROWS][DIGIT_WIDTH];
+
+    DigitGlyphs() {
+        for (int digit = 0; digit < 10; ++digit) {
+            for (int row = 0; row < ClockPanel::DIGIT_ROWS; ++row) {
+                for (int col = 0; col < DIGIT_WIDTH; ++col) {
+                    bool set = DIGIT_PATTERN[digit][row] & (0x8 >> col);
+                    cells[digit][row][col] = set ? SEGMENT : L' ';
+                }
+            }
+        }
+    }
+};
+
+const DigitGlyphs GLYPHS;
+
+const wchar_t* const WEEKDAYS[7] = {
+    L"Sonntag", L"Montag", L"Dienstag", L"Mittwoch", L"Donnerstag", L"Freitag", L"Samstag"
+};
+
+} // namespace
+
+const LocalTime& ClockFormatter::Now() {
+    return At(static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())));
+}
+
+const LocalTime& ClockFormatter::At(int64_t unixSeconds) {
+    if (m_cached && unixSeconds == m_time.unixSeconds) return m_time;
+    m_cached = true;
+    m_time.unixSeconds = unixSeconds;
+
+    if (unixSeconds < m_zoneFrom || unixSeconds >= m_zoneUntil) {
+        m_zoneValid = ResolveZone(unixSeconds);
+        m_dayNumber = INT64_MIN;
+    }
+    m_time.valid = m_zoneValid;
+    if (!m_zoneValid) return m_time;
+
+    int64_t local = unixSeconds + m_offset;
+    int64_t days = FloorDiv(local, 86400);
+    int seconds = static_cast<int>(local - days * 86400);
+    m_time.hour = seconds / 3600;
+    m_time.minute = seconds / 60 % 60;
+    m_time.second = seconds % 60;
+    PutTwoDigits(m_time.time, m_time.hour);
+    m_time.time[2] = L':';
+    PutTwoDigits(m_time.time + 3, m_time.minute);
+    m_time.time[5] = L':';
+    PutTwoDigits(m_time.time + 6, m_time.second);
+
+    if (days != m_dayNumber) {
+        m_dayNumber = days;
+        CivilFromDays(days, m_time.year, m_time.month, m_time.day);
+        m_time.weekday = static_cast<int>(days - FloorDiv(days + 4, 7) * 7 + 4); // 1.1.1970 war ein Donnerstag
+        PutTwoDigits(m_time.date, m_time.day);
+        m_time.date[2] = L'.';
+        PutTwoDigits(m_time.date + 3, m_time.month);
+        m_time.date[5] = L'.';
+        int year = m_time.year % 10000;
+        PutTwoDigits(m_time.date + 6, year / 100);
+        PutTwoDigits(m_time.date + 8, year % 100);
+    }
+    return m_time;
+}
+
+/**
+ * Bestimmt den Abstand zu UTC fuer die Viertelstunde, in der unixSeconds liegt. Die einzige
+ * Stelle, an der die Zeitzonendaten des Systems gelesen werden.
+ */
+bool ClockFormatter::ResolveZone(int64_t unixSeconds) {
+    m_zoneFrom = FloorDiv(unixSeconds, ZONE_CHECK_SECONDS) * ZONE_CHECK_SECONDS;
+    m_zoneUntil = m_zoneFrom + ZONE_CHECK_SECONDS;
+
+    std::time_t now_c = static_cast<std::time_t>(unixSeconds);
+    std::tm tm_buf;
+#ifdef _WIN32
+    if (localtime_s(&tm_buf, &now_c) != 0) return false;
+#else
+    if (localtime_r(&now_c, &tm_buf) == nullptr) return false;
+#endif
+    int64_t local = DaysFromCivil(tm_buf.tm_year + 1900, tm_buf.tm_mon + 1, tm_buf.tm_mday) * 86400
+        + tm_buf.tm_hour * 3600 + tm_buf.tm_min * 60 + tm_buf.tm_sec;
+    m_offset = local - unixSeconds;
+    return true;
+}
+
+uint32_t ClockFormatter::MillisToNextSecond() {
+    auto since = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return static_cast<uint32_t>(1000 - (since % 1000 + 1000) % 1000);
+}
+
+ClockPanel::ClockPanel() {
+    for (int row = 0; row < DIGIT_ROWS; ++row) {
+        m_rows[row].assign(INDENT + DIGITS_WIDTH, L' ');
+        if (row == 1 || row == 3) {
+            for (int column : COLON_COLUMN) m_rows[row][INDENT + column] = SEGMENT;
+        }
+    }
+    for (int& digit : m_digits) digit = -1;
+}
+
+void ClockPanel::DrawDigit(int position, int digit) {
+    if (m_digits[position] == digit) return;
+    m_digits[position] = digit;
+    for (int row = 0; row < DIGIT_ROWS; ++row) {
+        m_rows[row].replace(INDENT + DIGIT_COLUMN[position], DIGIT_WIDTH, GLYPHS.cells[digit][row], DIGIT_WIDTH);
+    }
+}
+
+bool ClockPanel::Update(const LocalTime& time) {
+    if (!time.valid || time.unixSeconds == m_shownSecond) return false;
+    m_shownSecond = time.unixSeconds;
+
+    const int values[3] = { time.hour, time.minute, time.second };
+    for (int i = 0; i < 3; ++i) {
+        DrawDigit(i * 2, values[i] / 10);
+        DrawDigit(i * 2 + 1, values[i] % 10);
+    }
+
+    int day = time.year * 400 + time.month * 32 + time.day;
+    if (day != m_shownDay) {
+        m_shownDay = day;
+        m_rows[DIGIT_ROWS].assign(INDENT, L' ');
+        m_rows[DIGIT_ROWS] += WEEKDAYS[time.weekday];
+        m_rows[DIGIT_ROWS] += L", ";
+        m_rows[DIGIT_ROWS].append(time.date, 10);
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Lokale Zeit einer Sekunde, fertig zerlegt und formatiert.
+ */
+struct LocalTime {
+    int64_t unixSeconds = 0;
+    int year = 0;
+    int month = 0;   // 1..12
+    int day = 0;     // 1..31
+    int weekday = 0; // 0 = Sonntag
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    wchar_t time[9] = {};  // HH:MM:SS
+    wchar_t date[11] = {}; // TT.MM.JJJJ
+    bool valid = false;    // false, wenn die Zeitzone nicht ermittelt werden konnte
+};
+
+/**
+ * Zwischenspeicher fuer die lokale Zeit: innerhalb derselben Sekunde liefert Now() das fertige
+ * Ergebnis, beim Sekundenwechsel werden nur die Ziffern neu berechnet. Die Zeitzone (Abstand
+ * zu UTC) wird per localtime_s/localtime_r ermittelt und gilt dann bis zur naechsten
+ * Viertelstunde, damit ein Wechsel der Sommerzeit hoechstens so spaet auffaellt. Datum und
+ * Wochentag folgen rein rechnerisch aus der Tagesnummer, ohne Streams oder put_time.
+ */
+class ClockFormatter {
+public:
+    static constexpr int64_t ZONE_CHECK_SECONDS = 900;
+
+    const LocalTime& Now();
+    const LocalTime& At(int64_t unixSeconds);
+
+    // Millisekunden bis zur naechsten vollen Sekunde der Systemuhr (1..1000), fuer den Takt
+    // der Uhranzeige.
+    static uint32_t MillisToNextSecond();
+
+private:
+    bool ResolveZone(int64_t unixSeconds);
+
+    LocalTime m_time;
+    bool m_cached = false;
+    int64_t m_offset = 0;     // Sekunden, lokale Zeit = UTC + m_offset
+    int64_t m_zoneUntil = 0;  // m_offset gilt fuer Zeiten < m_zoneUntil ...
+    int64_t m_zoneFrom = 1;   // ... und >= m_zoneFrom (anfangs leer)
+    bool m_zoneValid = false;
+    int64_t m_dayNumber = INT64_MIN; // Tage seit 1970 der zuletzt formatierten lokalen Zeit
+};
+
+/**
+ * Grosse Uhranzeige fuer den oberen Bildschirmrand: HH:MM:SS in Siebensegment-Ziffern aus
+ * Vollblock-Zeichen, darunter Wochentag und Datum. Die Zeilen liegen fertig als Text vor;
+ * Update() schreibt nur die Ziffern neu, die sich seit der letzten Sekunde geaendert haben
+ * (meist nur die letzte). Welche Zellen tatsaechlich neu gezeichnet werden, bestimmt das
+ * ScreenModel durch Vergleich mit dem zuletzt gezeichneten Text.
+ */
+class ClockPanel {
+public:
+    static constexpr int DIGIT_ROWS = 5;
+    static constexpr int ROWS = DIGIT_ROWS + 2; // Ziffern, Datum, Leerzeile
+    static constexpr int INDENT = 2;
+
+    ClockPanel();
+
+    // Liefert false, wenn sich nichts geaendert hat (gleiche Sekunde).
+    bool Update(const LocalTime& time);
+
+    std::wstring_view Row(int row) const {
+        return row >= 0 && row < ROWS ? std::wstring_view(m_rows[row]) : std::wstring_view();
+    }
+
+private:
+    void DrawDigit(int position, int digit);
+
+    std::wstring m_rows[ROWS];
+    int m_digits[6];
+    int64_t m_shownSecond = INT64_MIN;
+    int m_shownDay = -1;
+};
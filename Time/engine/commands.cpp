@@ -0,0 +1,96 @@
+#include "commands.h"
+
+#include <iterator>
+
+namespace {
+
+bool IsSeparator(wchar_t c) {
+    return c == L' ' || c == L'\t' || c == L'\r' || c == L'\n' || c == L'\f' || c == L'\v';
+}
+
+wchar_t FoldCase(wchar_t c) {
+    return c >= L'a' && c <= L'z' ? static_cast<wchar_t>(c - (L'a' - L'A')) : c;
+}
+
+struct SectionInfo {
+    const wchar_t* title;
+    const wchar_t* noteLabel; // zusaetzliche Zeile ohne eigenen Befehl (Tastenkuerzel)
+    const wchar_t* noteHelp;
+};
+
+const SectionInfo SECTIONS[] = {
+    { L"Verfuegbare Befehle:", nullptr, nullptr },
+    { L"Jobs:", L"Strg+C", L"Bricht den laufenden Befehl ab." },
+    { L"Netzwerk-Tools:", nullptr, nullptr },
+    { L"System-Tools:", nullptr, nullptr },
+    { L"Mathematik & Konvertierung:", nullptr, nullptr },
+};
+
+// "  NAME           - Hilfe"; zu lange Bezeichnungen bekommen eine eigene Zeile
+void AppendHelpLine(std::wstring& text, std::wstring_view label, std::wstring_view help) {
+    const size_t LABEL_WIDTH = 15;
+    text += L"\n  ";
+    text += label;
+    if (label.size() < LABEL_WIDTH) text.append(LABEL_WIDTH - label.size(), L' ');
+    else text.append(L"\n").append(LABEL_WIDTH + 2, L' ');
+    text += L"- ";
+    text += help;
+}
+
+} // namespace
+
+CommandLine::CommandLine(std::wstring_view line)
+    : m_line(line) {
+    size_t pos = 0;
+    while (m_count < MAX_TOKENS) {
+        while (pos < line.size() && IsSeparator(line[pos])) pos++;
+        if (pos == line.size()) break;
+        size_t start = pos;
+        while (pos < line.size() && !IsSeparator(line[pos])) pos++;
+        m_tokens[m_count++] = line.substr(start, pos - start);
+    }
+}
+
+std::wstring_view CommandLine::Rest() const {
+    if (m_count == 0) return std::wstring_view();
+    size_t end = static_cast<size_t>(m_tokens[0].data() - m_line.data()) + m_tokens[0].size();
+    return end < m_line.size() ? m_line.substr(end + 1) : std::wstring_view();
+}
+
+bool EqualsIgnoreCase(std::wstring_view a, std::wstring_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (FoldCase(a[i]) != FoldCase(b[i])) return false;
+    }
+    return true;
+}
+
+bool StartsWithIgnoreCase(std::wstring_view text, std::wstring_view prefix) {
+    return text.size() >= prefix.size() && EqualsIgnoreCase(text.substr(0, prefix.size()), prefix);
+}
+
+std::wstring CommandRegistry::HelpText() const {
+    std::wstring text;
+    for (size_t s = 0; s < std::size(SECTIONS); ++s) {
+        CommandSection section = static_cast<CommandSection>(s);
+        if (s > 0) text += L"\n\n";
+        text += SECTIONS[s].title;
+
+        std::wstring shortList; // Befehle ohne eigenen Hilfetext
+        for (const CommandSpec& spec : *this) {
+            if (spec.section != section) continue;
+            if (spec.help.empty()) {
+                shortList += shortList.empty() ? L"\n  " : L", ";
+                shortList += spec.name;
+                continue;
+            }
+            std::wstring label(spec.name);
+            if (!spec.alias.empty()) label.append(L" / ").append(spec.alias);
+            if (!spec.usage.empty()) label.append(L" ").append(spec.usage);
+            AppendHelpLine(text, label, spec.help);
+        }
+        if (SECTIONS[s].noteLabel) AppendHelpLine(text, SECTIONS[s].noteLabel, SECTIONS[s].noteHelp);
+        text += shortList;
+    }
+    return text;
+}
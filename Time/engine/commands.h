@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ConsoleEngine;
+class CommandLine;
+
+using CommandHandler = void (ConsoleEngine::*)(const CommandLine& line);
+
+/**
+ * Zerlegt eine Befehlszeile in durch Leerraum getrennte Teile, ohne etwas zu kopieren: alle
+ * Teile zeigen in die Originalzeile (Originalschreibweise). Die Zeile muss so lange leben wie
+ * das CommandLine-Objekt.
+ */
+class CommandLine {
+public:
+    static constexpr size_t MAX_TOKENS = 8; // Befehlsname und bis zu 7 Argumente
+
+    explicit CommandLine(std::wstring_view line);
+
+    std::wstring_view Line() const { return m_line; }
+    std::wstring_view Name() const { return m_count ? m_tokens[0] : std::wstring_view(); }
+
+    size_t ArgCount() const { return m_count ? m_count - 1 : 0; }
+    std::wstring_view Arg(size_t i) const { return i + 1 < m_count ? m_tokens[i + 1] : std::wstring_view(); }
+
+    // Alles hinter dem Befehlsnamen und genau einem Trennzeichen (ECHO behaelt weitere Leerzeichen).
+    std::wstring_view Rest() const;
+
+private:
+    std::wstring_view m_line;
+    std::array<std::wstring_view, MAX_TOKENS> m_tokens{};
+    size_t m_count = 0;
+};
+
+// Vergleich ohne Beachtung der Gross-/Kleinschreibung (ASCII, wie alle Befehlsnamen).
+bool EqualsIgnoreCase(std::wstring_view a, std::wstring_view b);
+bool StartsWithIgnoreCase(std::wstring_view text, std::wstring_view prefix);
+
+// Abschnitte der Hilfe, in dieser Reihenfolge ausgegeben.
+enum class CommandSection { General, Jobs, Network, System, Math };
+
+/**
+ * Ein Eintrag der Befehlstabelle. Aus denselben Eintraegen entstehen Zuordnung (Find), HELP und
+ * die Vervollstaendigung mit Tab.
+ */
+struct CommandSpec {
+    std::wstring_view name;
+    std::wstring_view alias;   // zweiter Name (z.B. CLS), leer = keiner
+    std::wstring_view usage;   // Argumente fuer HELP, z.B. L"<text>"
+    uint8_t minArgs;           // weniger Argumente: Fehlermeldung missing, Handler wird nicht aufgerufen
+    std::wstring_view missing;
+    CommandSection section;
+    std::wstring_view help;    // leer = nur in der Kurzliste am Ende des Abschnitts
+    CommandHandler handler;
+};
+
+// Hash ueber die Grossbuchstaben-Form eines Namens (FNV-1a, seed veraendert den Startwert).
+constexpr uint32_t CommandHash(std::wstring_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (wchar_t c : name) {
+        if (c >= L'a' && c <= L'z') c = static_cast<wchar_t>(c - (L'a' - L'A'));
+        hash ^= static_cast<uint32_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Befehlstabelle mit perfektem Hash: Der Konstruktor sucht zur Uebersetzungszeit einen Startwert,
+ * unter dem alle Namen und Aliase auf verschiedene Plaetze fallen. Find() braucht dann genau eine
+ * Hashberechnung und einen Vergleich, ohne den Namen vorher zu kopieren oder umzuwandeln.
+ */
+class CommandRegistry {
+public:
+    static constexpr size_t SLOTS = 256;
+    static constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+    template <size_t N>
+    constexpr explicit CommandRegistry(const CommandSpec (&specs)[N])
+        : m_specs(specs), m_count(N) {
+        static_assert(N < EMPTY_SLOT, "Zu viele Befehle fuer die Hashtabelle");
+        for (uint32_t seed = 0; seed < 4096; ++seed) {
+            if (TryBuild(seed)) return;
+        }
+        throw std::logic_error("Kein perfekter Hash fuer die Befehlstabelle gefunden");
+    }
+
+    const CommandSpec* Find(std::wstring_view name) const {
+        if (name.empty() || name.size() > MAX_NAME) return nullptr;
+        uint8_t index = m_slots[CommandHash(name, m_seed) & (SLOTS - 1)];
+        if (index == EMPTY_SLOT) return nullptr;
+        const CommandSpec& spec = m_specs[index];
+        return EqualsIgnoreCase(name, spec.name) || EqualsIgnoreCase(name, spec.alias) ? &spec : nullptr;
+    }
+
+    const CommandSpec* begin() const { return m_specs; }
+    const CommandSpec* end() const { return m_specs + m_count; }
+
+    // Hilfetext, nach Abschnitten gegliedert.
+    std::wstring HelpText() const;
+
+private:
+    static constexpr size_t MAX_NAME = 16;
+
+    constexpr bool TryBuild(uint32_t seed) {
+        m_slots.fill(EMPTY_SLOT);
+        for (size_t i = 0; i < m_count; ++i) {
+            if (!Place(m_specs[i].name, i, seed)) return false;
+            if (!m_specs[i].alias.empty() && !Place(m_specs[i].alias, i, seed)) return false;
+        }
+        m_seed = seed;
+        return true;
+    }
+
+    constexpr bool Place(std::wstring_view name, size_t index, uint32_t seed) {
+        if (name.size() > MAX_NAME) throw std::logic_error("Befehlsname zu lang");
+        uint8_t& slot = m_slots[CommandHash(name, seed) & (SLOTS - 1)];
+        if (slot != EMPTY_SLOT) return false;
+        slot = static_cast<uint8_t>(index);
+        return true;
+    }
+
+    const CommandSpec* m_specs;
+    size_t m_count;
+    uint32_t m_seed = 0;
+    std::array<uint8_t, SLOTS> m_slots{};
+};
@@ -0,0 +1,157 @@
+#include "completion.h"
+#include "dirwalk.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cwctype>
+
+namespace {
+
+wchar_t UpperKey(wchar_t c) {
+    return c >= L'a' && c <= L'z' ? static_cast<wchar_t>(c - (L'a' - L'A')) : c;
+}
+
+wchar_t FoldName(wchar_t c) {
+    if (c < 0x80) return c >= L'A' && c <= L'Z' ? static_cast<wchar_t>(c + (L'a' - L'A')) : c;
+    return static_cast<wchar_t>(std::towlower(c));
+}
+
+// Reihenfolge wie DIR: ohne Ruecksicht auf Gross-/Kleinschreibung, bei Gleichstand ordinal
+bool EntryLess(const DirectoryIndex::Entry& a, const DirectoryIndex::Entry& b) {
+    size_t length = std::min(a.name.size(), b.name.size());
+    for (size_t i = 0; i < length; ++i) {
+        wchar_t x = FoldName(a.name[i]);
+        wchar_t y = FoldName(b.name[i]);
+        if (x != y) return x < y;
+    }
+    if (a.name.size() != b.name.size()) return a.name.size() < b.name.size();
+    return a.name < b.name;
+}
+
+// Vergleicht nur die ersten prefix.size() Zeichen des Namens mit prefix (gefaltet)
+int ComparePrefix(const std::wstring& name, std::wstring_view prefix) {
+    size_t length = std::min(name.size(), prefix.size());
+    for (size_t i = 0; i < length; ++i) {
+        wchar_t x = FoldName(name[i]);
+        wchar_t y = FoldName(prefix[i]);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return name.size() < prefix.size() ? -1 : 0;
+}
+
+} // namespace
+
+CompletionTrie::CompletionTrie() {
+    m_nodes.push_back({ L'\0' });
+}
+
+uint32_t CompletionTrie::Child(uint32_t node, wchar_t key) const {
+    for (uint32_t child = m_nodes[node].child; child != NONE; child = m_nodes[child].sibling) {
+        if (m_nodes[child].key == key) return child;
+        if (m_nodes[child].key > key) break;
+    }
+    return NONE;
+}
+
+void CompletionTrie::Insert(std::wstring_view word) {
+    uint32_t node = 0;
+    for (wchar_t c : word) {
+        wchar_t key = UpperKey(c);
+        uint32_t found = Child(node, key);
+        if (found == NONE) {
+            // An der sortierten Stelle in die Geschwisterliste einhaengen
+            found = static_cast<uint32_t>(m_nodes.size());
+            Node added{ key };
+            uint32_t* link = &m_nodes[node].child;
+            while (*link != NONE && m_nodes[*link].key < key) link = &m_nodes[*link].sibling;
+            added.sibling = *link;
+            *link = found; // link zeigt noch in den alten Vektor, erst danach vergroessern
+            m_nodes.push_back(added);
+        }
+        node = found;
+    }
+    if (node == 0 || m_nodes[node].word != NO_WORD) return;
+    m_nodes[node].word = static_cast<uint32_t>(m_words.size());
+    m_words.push_back(word);
+}
+
+void CompletionTrie::Complete(std::wstring_view prefix, std::vector<std::wstring_view>& matches) const {
+    uint32_t node = 0;
+    for (wchar_t c : prefix) {
+        node = Child(node, UpperKey(c));
+        if (node == NONE) return;
+    }
+    Collect(node, matches);
+}
+
+void CompletionTrie::Collect(uint32_t node, std::vector<std::wstring_view>& matches) const {
+    if (m_nodes[node].word != NO_WORD) matches.push_back(m_words[m_nodes[node].word]);
+    for (uint32_t child = m_nodes[node].child; child != NONE; child = m_nodes[child].sibling) {
+        Collect(child, matches);
+    }
+}
+
+bool DirectoryIndex::Complete(const std::wstring& directory, std::wstring_view prefix, std::span<const Entry>& matches, std::wstring& error) {
+    Listing* listing = Find(directory, error);
+    if (!listing) return false;
+    const std::vector<Entry>& entries = listing->entries;
+    auto first = std::lower_bound(entries.begin(), entries.end(), prefix,
+        [](const Entry& entry, std::wstring_view p) { return ComparePrefix(entry.name, p) < 0; });
+    auto last = std::upper_bound(first, entries.end(), prefix,
+        [](std::wstring_view p, const Entry& entry) { return ComparePrefix(entry.name, p) > 0; });
+    matches = std::span<const Entry>(entries.data() + (first - entries.begin()), static_cast<size_t>(last - first));
+    return true;
+}
+
+/**
+ * Liefert die Liste von directory; liest sie neu, wenn sie fehlt, sich das Verzeichnis seitdem
+ * geaendert hat oder sie beim Lesen noch nicht sicher war. Die am laengsten unbenutzte Liste
+ * macht Platz, sobald MAX_DIRECTORIES erreicht ist.
+ */
+DirectoryIndex::Listing* DirectoryIndex::Find(const std::wstring& directory, std::wstring& error) {
+    int64_t stamp = 0;
+    if (!DirectoryStamp(directory, stamp)) {
+        error = L"Verzeichnis nicht gefunden";
+        return nullptr;
+    }
+    auto it = std::find_if(m_listings.begin(), m_listings.end(), [&](const Listing& l) { return l.path == directory; });
+    if (it != m_listings.end() && it->settled && it->stamp == stamp) {
+        it->used = ++m_useCounter;
+        return &*it;
+    }
+    if (it == m_listings.end()) {
+        if (m_listings.size() < MAX_DIRECTORIES) {
+            it = m_listings.emplace(m_listings.end());
+        }
+        else {
+            it = std::min_element(m_listings.begin(), m_listings.end(), [](const Listing& a, const Listing& b) { return a.used < b.used; });
+        }
+        it->path = directory;
+    }
+
+    std::vector<DirectoryEntry> read;
+    if (!ReadDirectory(directory, EntryDetail::Names, read, error)) {
+        m_listings.erase(it);
+        return nullptr;
+    }
+    m_reads++;
+    it->entries.clear();
+    it->entries.reserve(read.size());
+    for (DirectoryEntry& entry : read) it->entries.push_back({ std::move(entry.name), entry.directory });
+    std::sort(it->entries.begin(), it->entries.end(), EntryLess);
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    it->stamp = stamp;
+    it->settled = now - stamp >= SETTLE_NANOS;
+    it->used = ++m_useCounter;
+    return &*it;
+}
+
+std::wstring_view DirectoryIndex::CommonPrefix(std::span<const Entry> matches) {
+    if (matches.empty()) return std::wstring_view();
+    // Sortiert: der gemeinsame Anfang von erstem und letztem gilt fuer alle dazwischen
+    const std::wstring& first = matches.front().name;
+    const std::wstring& last = matches.back().name;
+    size_t length = 0;
+    while (length < first.size() && length < last.size() && FoldName(first[length]) == FoldName(last[length])) length++;
+    return std::wstring_view(first).substr(0, length);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Praefixbaum (Trie) fuer die Tab-Vervollstaendigung der Befehlsnamen. Knoten liegen in einem
+ * Vektor (erstes Kind / naechstes Geschwister, Geschwister nach Zeichen sortiert); Schluessel
+ * sind die Grossbuchstaben-Form, geliefert wird die Originalschreibweise. Eine Abfrage laeuft
+ * nur den Praefix entlang und sammelt dann den Teilbaum darunter, unabhaengig von der Anzahl
+ * Woerter insgesamt.
+ */
+class CompletionTrie {
+public:
+    CompletionTrie();
+
+    // word muss so lange leben wie der Trie (Eintraege der Befehlstabelle). Doppelte werden
+    // ignoriert.
+    void Insert(std::wstring_view word);
+
+    // Alle Woerter, die mit prefix beginnen (ohne Gross-/Kleinschreibung), alphabetisch.
+    void Complete(std::wstring_view prefix, std::vector<std::wstring_view>& matches) const;
+
+    size_t Nodes() const { return m_nodes.size(); }
+
+private:
+    static constexpr uint32_t NONE = 0;
+    static constexpr uint32_t NO_WORD = ~0u;
+
+    struct Node {
+        wchar_t key;
+        uint32_t child = NONE;   // 0 = keins (die Wurzel ist nie Kind)
+        uint32_t sibling = NONE;
+        uint32_t word = NO_WORD; // Index in m_words
+    };
+
+    uint32_t Child(uint32_t node, wchar_t key) const;
+    void Collect(uint32_t node, std::vector<std::wstring_view>& matches) const;
+
+    std::vector<Node> m_nodes; // [0] = Wurzel
+    std::vector<std::wstring_view> m_words;
+};
+
+/**
+ * Zwischengespeicherte, nach Namen sortierte Verzeichnislisten fuer die Vervollstaendigung von
+ * Pfaden. Eine Liste wird nur neu gelesen, wenn sich die Aenderungszeit des Verzeichnisses
+ * geaendert hat (DirectoryStamp, ein Systemaufruf je Abfrage); die Suche nach einem Praefix ist
+ * dann eine binaere Suche, auch bei Verzeichnissen mit 100.000 Eintraegen.
+ *
+ * Liegt die Aenderungszeit beim Lesen weniger als SETTLE_NANOS zurueck, gilt die Liste nur fuer
+ * diese Abfrage: eine Aenderung im selben Zeitstempel-Takt (FAT: 2 s) bliebe sonst unbemerkt.
+ */
+class DirectoryIndex {
+public:
+    static constexpr size_t MAX_DIRECTORIES = 8;
+    static constexpr int64_t SETTLE_NANOS = 2000000000;
+
+    struct Entry {
+        std::wstring name;
+        bool directory;
+    };
+
+    // Eintraege von directory, deren Name mit prefix beginnt (ohne Gross-/Kleinschreibung),
+    // sortiert; gueltig bis zum naechsten Aufruf. false und eine Meldung, wenn directory nicht
+    // lesbar ist.
+    bool Complete(const std::wstring& directory, std::wstring_view prefix, std::span<const Entry>& matches, std::wstring& error);
+
+    // Gemeinsamer Anfang aller Treffer (Schreibweise des ersten).
+    static std::wstring_view CommonPrefix(std::span<const Entry> matches);
+
+    size_t Reads() const { return m_reads; }
+
+private:
+    struct Listing {
+        std::wstring path;
+        int64_t stamp = 0;
+        bool settled = false;
+        uint64_t used = 0;
+        std::vector<Entry> entries;
+    };
+
+    Listing* Find(const std::wstring& directory, std::wstring& error);
+
+    std::vector<Listing> m_listings;
+    uint64_t m_useCounter = 0;
+    size_t m_reads = 0;
+};
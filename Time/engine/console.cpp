@@ -0,0 +1,1641 @@
+#include "console.h"
+#include "bignum.h"
+#include "perf.h"
+#include "vecmath.h"
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cwctype>
+#include <cmath>
+#include <cwchar>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+const std::wstring PROMPT = L"C:\\> ";
+
+/**
+ * Konvertiert einen String vollständig zu Großbuchstaben.
+ */
+std::wstring ToUpper(const std::wstring& str) {
+    std::wstring s = str;
+    std::transform(s.begin(), s.end(), s.begin(),
+        [](wchar_t c) { return std::towupper(c); });
+    return s;
+}
+
+/**
+ * Uhrzeit und Datum fuer TIME und DATE. Jeder Thread hat seinen eigenen Zwischenspeicher, die
+ * Zeitzone wird nur einmal je Viertelstunde ermittelt.
+ */
+std::wstring GetCurrentTimeString() {
+    thread_local ClockFormatter formatter;
+    const LocalTime& now = formatter.Now();
+    return now.valid ? std::wstring(now.time, 8) : L"FEHLER";
+}
+
+std::wstring GetCurrentDateString() {
+    thread_local ClockFormatter formatter;
+    const LocalTime& now = formatter.Now();
+    return now.valid ? std::wstring(now.date, 10) : L"FEHLER";
+}
+
+ConsoleEngine::ConsoleEngine(ConsoleHost& host)
+    : m_host(host) {
+}
+
+void ConsoleEngine::PrintBanner() {
+    uint64_t first = m_history.TotalLines();
+    m_history.AppendLine(L"MS-DOS Version 6.22");
+    m_history.AppendLine(L"(C)Copyright Microsoft Corporation 1981-1994.");
+    m_history.AppendLine(L"Made with \x2764 by HUTAOSHUSBAND");
+    m_history.AppendLine(L"");
+    m_history.AppendLine(L"Tippen Sie 'HELP' fuer eine Liste der Befehle ein.");
+    m_history.AppendLine(L"");
+    LogLines(first);
+}
+
+void ConsoleEngine::RestoreSession(const RestoredSession& session) {
+    for (size_t i = 0; i < session.lines.size(); ++i) m_history.AppendLine(session.Line(i));
+    size_t skip = session.commands.size() > MAX_COMMAND_HISTORY ? session.commands.size() - MAX_COMMAND_HISTORY : 0;
+    m_commandHistory.assign(session.commands.begin() + skip, session.commands.end());
+    m_scrollOffset = 0;
+}
+
+void ConsoleEngine::AttachSessionLog(SessionLog* log) {
+    m_log = log;
+    if (m_log) m_log->Begin(m_history.TotalLines());
+}
+
+/**
+ * Uebergibt die seit first angehaengten Zeilen an das Sitzungsprotokoll (nur eine Kopie, das
+ * Schreiben uebernimmt dessen Thread).
+ */
+void ConsoleEngine::LogLines(uint64_t first) {
+    if (!m_log) return;
+    uint64_t total = m_history.TotalLines();
+    uint64_t oldest = total - m_history.Size();
+    std::wstring scratch;
+    for (uint64_t sequence = std::max(first, oldest); sequence < total; ++sequence) {
+        m_log->AppendLine(sequence, m_history.Line(static_cast<size_t>(sequence - oldest), scratch));
+    }
+}
+
+void ConsoleEngine::AppendTable(std::shared_ptr<ResultTable> table, std::wstring prefix) {
+    // Erst nach Scrollback::AppendTable (Compact) ist die Tabelle fertig fuer den Schreibthread
+    uint64_t first = m_history.TotalLines();
+    std::shared_ptr<const ResultTable> logged = m_log ? table : nullptr;
+    m_history.AppendTable(std::move(table), prefix);
+    if (logged) m_log->AppendTable(first, std::move(logged), prefix);
+    FollowOutput();
+}
+
+void ConsoleEngine::RememberCommand(const std::wstring& command) {
+    if (command.empty() || (!m_commandHistory.empty() && m_commandHistory.back() == command)) return;
+    if (m_commandHistory.size() == MAX_COMMAND_HISTORY) m_commandHistory.pop_front();
+    m_commandHistory.push_back(command);
+    if (m_log) m_log->AppendCommand(command);
+}
+
+/**
+ * Fügt eine oder mehrere Zeilen zum Konsolenverlauf hinzu und setzt den Scroll-Offset zurück.
+ */
+void ConsoleEngine::AddHistory(const std::wstring& text) {
+    if (CaptureOutput(text)) return;
+    PerfSpan span(L"AddHistory");
+    uint64_t first = m_history.TotalLines();
+    m_history.Append(text);
+    LogLines(first);
+    FollowOutput(); // Beim Hinzufügen neuer Inhalte nach unten scrollen
+}
+
+void ConsoleEngine::AddLine(const std::wstring& line) {
+    if (CaptureOutput(line)) return;
+    m_history.AppendLine(line);
+    if (m_log) m_log->AppendLine(m_history.TotalLines() - 1, line);
+    FollowOutput();
+}
+
+void ConsoleEngine::AddError(const std::wstring& text) {
+    PipeCapture* capture = std::exchange(m_capture, nullptr);
+    AddHistory(text);
+    m_capture = capture;
+}
+
+/**
+ * Nach neuen Zeilen: ans Ende springen, ausser eine Suche zeigt gerade einen Treffer; der
+ * bleibt an seiner Stelle stehen, waehrend die Ausgabe darunter weiterlaeuft.
+ */
+void ConsoleEngine::FollowOutput() {
+    if (m_search.active && m_search.found) ScrollToMatch();
+    else m_scrollOffset = 0;
+}
+
+void ConsoleEngine::AddTable(std::shared_ptr<ResultTable> table) {
+    if (m_capture) {
+        std::wstring line;
+        for (size_t i = 0; i < table->LineCount(); ++i) {
+            line.clear();
+            table->FormatLine(i, line);
+            CaptureOutput(line);
+        }
+        return;
+    }
+    AppendTable(std::move(table), std::wstring());
+}
+
+/**
+ * Waehrend StartPipeline: Ausgabe der ersten Stufe sammeln statt anzeigen. Fehlermeldungen
+ * (AddError) kommen hier nicht an und erscheinen sofort (wie stderr bei cmd.exe).
+ */
+bool ConsoleEngine::CaptureOutput(const std::wstring& text) {
+    if (!m_capture) return false;
+    if (!m_capture->text.empty()) m_capture->text += L'\n';
+    m_capture->text += text;
+    return true;
+}
+
+void ConsoleEngine::SetScrollbackLimit(size_t maxLines) {
+    m_history.SetMaxLines(maxLines);
+    m_scrollOffset = std::min(m_scrollOffset, static_cast<int>(m_history.Size()));
+}
+
+void ConsoleEngine::ClearHistory() {
+    m_history.Clear();
+    if (m_log) m_log->Clear();
+    m_search.found = false;
+    m_scrollOffset = 0;
+}
+
+void ConsoleEngine::HandleChar(wchar_t ch) {
+    if (!m_isTypingEnabled) return;
+    if (m_viewer) {
+        // Dateianzeige wie MORE: Leertaste blaettert, Esc/Q/Strg+C beendet
+        if (ch == KEY_ESCAPE || ch == KEY_CTRL_C || ch == L'q' || ch == L'Q') CloseViewer();
+        else if (ch == L' ') m_viewer->PageDown();
+        m_host.RequestRedraw();
+        return;
+    }
+    if (m_search.active) {
+        SearchKey(ch);
+        m_host.RequestRedraw();
+        return;
+    }
+    if (ch == KEY_CTRL_C) {
+        if (IsBusy()) {
+            // Das Ende meldet der Job selbst (PumpJobs), erst dann erscheint wieder der Prompt
+            m_executor->Cancel(m_foregroundJob);
+            m_pendingCommands.clear();
+            if (!m_scripts.empty()) {
+                m_scripts.clear();
+                AddHistory(L"Batchvorgang abgebrochen.");
+            }
+        }
+        else {
+            AddHistory(PROMPT + m_input.Text() + L"^C");
+            m_input.Clear();
+            m_recallBack = 0;
+        }
+    }
+    else if (ch == KEY_BACKSPACE) {
+        m_input.DeleteBackward();
+    }
+    else if (ch == KEY_ESCAPE) {
+        m_input.Clear();
+        m_recallBack = 0;
+    }
+    else if (ch == KEY_TAB) {
+        CompleteInput();
+    }
+    else if (ch == KEY_CTRL_R || ch == KEY_CTRL_F) {
+        StartSearch(ch == KEY_CTRL_R);
+    }
+    else if (ch >= 32 && ch < 255) {
+        m_input.Insert(ch);
+    }
+    m_host.RequestRedraw();
+}
+
+/**
+ * Tasten ohne Zeichen (Pfeile, Pos1/Ende, Entf). In der Dateianzeige blaettern Pfeil hoch/runter
+ * zeilenweise, eine laufende Suche wird zuerst uebernommen.
+ */
+void ConsoleEngine::HandleKey(EditKey key) {
+    if (!m_isTypingEnabled) return;
+    if (m_viewer) {
+        if (key == EditKey::Up) m_viewer->ScrollBy(-1);
+        else if (key == EditKey::Down) m_viewer->ScrollBy(1);
+        m_host.RequestRedraw();
+        return;
+    }
+    if (m_search.active) EndSearch(true);
+    switch (key) {
+    case EditKey::Left: m_input.MoveLeft(); break;
+    case EditKey::Right: m_input.MoveRight(); break;
+    case EditKey::WordLeft: m_input.WordLeft(); break;
+    case EditKey::WordRight: m_input.WordRight(); break;
+    case EditKey::Home: m_input.Home(); break;
+    case EditKey::End: m_input.End(); break;
+    case EditKey::Delete: m_input.DeleteForward(); break;
+    case EditKey::Up: RecallCommand(true); break;
+    case EditKey::Down: RecallCommand(false); break;
+    }
+    m_host.RequestRedraw();
+}
+
+/**
+ * Pfeil hoch/runter: blaettert durch die zuletzt bestaetigten Befehle (m_commandHistory, auf
+ * MAX_COMMAND_HISTORY begrenzt). Die angefangene Zeile wird beim ersten Schritt gemerkt und
+ * kommt unten wieder zum Vorschein.
+ */
+void ConsoleEngine::RecallCommand(bool older) {
+    size_t count = m_commandHistory.size();
+    m_recallBack = std::min(m_recallBack, count);
+    if (older) {
+        if (m_recallBack == count) return;
+        if (m_recallBack == 0) m_recallDraft = m_input.Text();
+        m_recallBack++;
+    }
+    else {
+        if (m_recallBack == 0) return;
+        m_recallBack--;
+    }
+    m_input.SetText(m_recallBack == 0 ? m_recallDraft : m_commandHistory[count - m_recallBack]);
+}
+
+/**
+ * Übernimmt eingefügten Text in einem Stück; neu gezeichnet wird erst am Ende, nicht pro Zeichen.
+ */
+void ConsoleEngine::PasteText(std::wstring_view text) {
+    if (m_viewer) return;
+    if (m_search.active) EndSearch(true);
+    for (wchar_t ch : text) {
+        if (!m_isTypingEnabled) break;
+        if (ch == L'\n') {
+            std::wstring line = m_input.Text();
+            m_input.Clear();
+            m_recallBack = 0;
+            SubmitLine(line);
+        }
+        else if (ch >= 32 && ch < 255) { // '\r' und Steuerzeichen ignorieren
+            m_input.Insert(ch);
+        }
+    }
+    m_host.RequestRedraw();
+}
+
+/**
+ * Befehlsnamen fuer die Vervollstaendigung, einmal aus der Befehlstabelle aufgebaut.
+ */
+static const CompletionTrie& CommandTrie() {
+    static const CompletionTrie trie = [] {
+        CompletionTrie built;
+        for (const CommandSpec& spec : ConsoleEngine::Commands()) {
+            built.Insert(spec.name);
+            if (!spec.alias.empty()) built.Insert(spec.alias);
+        }
+        return built;
+    }();
+    return trie;
+}
+
+/**
+ * Tab: ergaenzt das Wort vor dem Cursor. Das erste Wort (und das nach START) ist ein
+ * Befehlsname, alle weiteren sind Pfade relativ zum Arbeitsverzeichnis. Bei genau einem Treffer
+ * wird er uebernommen (Befehle und Dateien mit Leerzeichen, Verzeichnisse mit Trennzeichen),
+ * sonst bis zum gemeinsamen Anfang ergaenzt und, wenn das nichts mehr ergaenzt, die Treffer im
+ * Verlauf aufgelistet.
+ */
+void ConsoleEngine::CompleteInput() {
+    const std::wstring& text = m_input.Text();
+    size_t cursor = m_input.Cursor();
+
+    // Wortanfang: nach dem letzten Leerzeichen bzw. an einem offenen Anfuehrungszeichen
+    bool quoted = std::count(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(cursor), L'"') % 2 == 1;
+    size_t start = 0;
+    if (quoted) {
+        start = text.rfind(L'"', cursor - 1);
+    }
+    else if (cursor > 0) {
+        size_t space = text.find_last_of(L" \t", cursor - 1);
+        start = space == std::wstring::npos ? 0 : space + 1;
+    }
+    std::wstring_view word = std::wstring_view(text).substr(start, cursor - start);
+
+    CommandLine before(std::wstring_view(text).substr(0, start));
+    bool command = before.Name().empty() || (before.ArgCount() == 0 && EqualsIgnoreCase(before.Name(), L"START"));
+    if (command) {
+        if (word.empty()) return;
+        std::vector<std::wstring_view> matches;
+        CommandTrie().Complete(word, matches);
+        if (matches.empty()) return;
+        size_t common = matches[0].size();
+        for (std::wstring_view match : matches) {
+            size_t i = 0;
+            while (i < common && i < match.size() && match[i] == matches[0][i]) i++;
+            common = i;
+        }
+        if (matches.size() == 1) {
+            m_input.Replace(start, cursor, std::wstring(matches[0]) + L" ");
+        }
+        else if (common > word.size()) {
+            m_input.Replace(start, cursor, matches[0].substr(0, common));
+        }
+        else {
+            std::wstring list;
+            for (std::wstring_view match : matches) {
+                if (!list.empty()) list += L"  ";
+                list += match;
+            }
+            AddHistory(PROMPT + text);
+            AddHistory(list);
+        }
+        return;
+    }
+
+    // Pfad: Verzeichnisanteil bleibt stehen, nur der Name danach wird ergaenzt
+    std::wstring path(quoted ? word.substr(1) : word);
+    size_t separator = LastSeparator(path);
+    std::wstring directoryPart = separator == std::wstring::npos ? std::wstring() : path.substr(0, separator + 1);
+    std::wstring namePrefix = separator == std::wstring::npos ? path : path.substr(separator + 1);
+    std::span<const DirectoryIndex::Entry> matches;
+    std::wstring error;
+    if (!m_directories.Complete(ResolvePath(m_host.WorkingDirectory(), directoryPart), namePrefix, matches, error) || matches.empty()) {
+        return;
+    }
+
+    std::wstring completed = directoryPart;
+    bool finished = matches.size() == 1;
+    if (finished) {
+        completed += matches[0].name;
+    }
+    else {
+        std::wstring_view common = DirectoryIndex::CommonPrefix(matches);
+        if (common.size() > namePrefix.size()) {
+            completed += common;
+        }
+        else {
+            const size_t MAX_LISTED = 100;
+            std::wstring list;
+            for (size_t i = 0; i < matches.size() && i < MAX_LISTED; ++i) {
+                if (!list.empty()) list += L"  ";
+                list += matches[i].name;
+                if (matches[i].directory) list += PATH_SEPARATOR;
+            }
+            if (matches.size() > MAX_LISTED) list += L"  ... (" + std::to_wstring(matches.size()) + L" Eintraege)";
+            AddHistory(PROMPT + text);
+            AddHistory(list);
+            return;
+        }
+    }
+    bool needsQuotes = quoted || completed.find(L' ') != std::wstring::npos;
+    std::wstring replacement = needsQuotes ? L"\"" + completed : completed;
+    if (finished && matches[0].directory) {
+        replacement += PATH_SEPARATOR;
+    }
+    else if (finished) {
+        if (needsQuotes) replacement += L'"';
+        replacement += L' ';
+    }
+    m_input.Replace(start, cursor, replacement);
+}
+
+void ConsoleEngine::SubmitInput() {
+    if (!m_isTypingEnabled) return;
+    if (m_viewer) {
+        m_viewer->ScrollBy(1);
+        m_host.RequestRedraw();
+        return;
+    }
+    if (m_search.active) {
+        // Wie bei Strg+R in der Bash: Enter uebernimmt die Stelle, ausgefuehrt wird nichts
+        EndSearch(true);
+        m_host.RequestRedraw();
+        return;
+    }
+    std::wstring line = m_input.Text();
+    m_input.Clear();
+    m_recallBack = 0;
+    SubmitLine(line);
+    m_host.RequestRedraw();
+}
+
+/**
+ * Fuehrt eine bestaetigte Zeile aus oder stellt sie zurueck, solange ein Befehl im Vordergrund
+ * laeuft (wie die Tastaturpufferung von cmd.exe).
+ */
+void ConsoleEngine::SubmitLine(const std::wstring& line) {
+    if (IsBusy()) {
+        m_pendingCommands.push_back(line);
+        return;
+    }
+    ProcessCommand(line);
+}
+
+void ConsoleEngine::RunPendingCommands() {
+    RunScripts(); // getippte Zeilen erst nach dem Ende der Batchdatei
+    while (!IsBusy() && m_scripts.empty() && !m_pendingCommands.empty() && m_isTypingEnabled) {
+        std::wstring command = std::move(m_pendingCommands.front());
+        m_pendingCommands.pop_front();
+        // Bereits wieder getippten Text nicht verlieren, ProcessCommand leert die Eingabezeile
+        LineEditor typed;
+        std::swap(typed, m_input);
+        ProcessCommand(command);
+        std::swap(m_input, typed);
+    }
+}
+
+void ConsoleEngine::ScrollPageUp() {
+    if (m_viewer) {
+        m_viewer->PageUp();
+        m_host.RequestRedraw();
+        return;
+    }
+    if (m_search.active) EndSearch(true);
+    m_scrollOffset += 10;
+    if (!m_history.Empty() && m_scrollOffset > static_cast<int>(m_history.Size()) - 1) {
+        m_scrollOffset = static_cast<int>(m_history.Size()) - 1;
+    }
+    m_host.RequestRedraw();
+}
+
+void ConsoleEngine::ScrollPageDown() {
+    if (m_viewer) {
+        m_viewer->PageDown();
+        m_host.RequestRedraw();
+        return;
+    }
+    if (m_search.active) EndSearch(true);
+    m_scrollOffset -= 10;
+    if (m_scrollOffset < 0) m_scrollOffset = 0;
+    m_host.RequestRedraw();
+}
+
+/**
+ * Strg+R/Strg+F: beginnt eine Suche (rueckwaerts ab der neuesten bzw. vorwaerts ab der
+ * aeltesten Zeile) oder springt in einer laufenden zum naechsten Treffer in dieser Richtung.
+ * Mit leerem Suchtext wird der zuletzt gesuchte wieder aufgenommen.
+ */
+void ConsoleEngine::StartSearch(bool backward) {
+    if (!m_search.active) {
+        m_search = HistorySearch();
+        m_search.active = true;
+        m_search.savedScrollOffset = m_scrollOffset;
+        m_search.origin = backward ? m_history.TotalLines() : m_history.TotalLines() - m_history.Size();
+        m_search.sequence = m_search.origin;
+    }
+    bool next = m_search.found;
+    m_search.backward = backward;
+    if (m_search.text.empty()) {
+        if (m_lastSearch.empty()) return;
+        m_search.text = m_lastSearch;
+        next = false;
+    }
+    FindMatch(next);
+}
+
+void ConsoleEngine::SearchKey(wchar_t ch) {
+    if (ch == KEY_CTRL_R || ch == KEY_CTRL_F) {
+        StartSearch(ch == KEY_CTRL_R);
+    }
+    else if (ch == KEY_ESCAPE || ch == KEY_CTRL_C) {
+        EndSearch(false);
+    }
+    else if (ch == KEY_BACKSPACE) {
+        if (m_search.text.empty()) return;
+        // Der kuerzere Text kann schon vor dem aktuellen Treffer vorkommen: vom Start neu suchen
+        m_search.text.pop_back();
+        m_search.sequence = m_search.origin;
+        m_search.found = false;
+        FindMatch(false);
+    }
+    else if (ch >= 32 && ch < 255) {
+        // Der laengere Text steht fruehestens im aktuellen Treffer, dort weitersuchen
+        m_search.text += ch;
+        FindMatch(false);
+    }
+}
+
+/**
+ * Sucht ab m_search.sequence (mit next ab der Zeile danach in Suchrichtung). Ohne Treffer bleibt
+ * die Anzeige beim letzten stehen.
+ */
+void ConsoleEngine::FindMatch(bool next) {
+    if (m_search.text.empty() || m_history.Empty()) {
+        m_search.found = false;
+        return;
+    }
+    uint64_t first = m_history.TotalLines() - m_history.Size();
+    if (m_search.sequence < first) {
+        // Start oder Treffer wurde inzwischen verdraengt
+        if (m_search.backward && next) {
+            m_search.found = false;
+            return;
+        }
+        m_search.sequence = first;
+        next = false;
+    }
+    size_t from = static_cast<size_t>(m_search.sequence - first);
+    if (next) {
+        if (m_search.backward && from == 0) {
+            m_search.found = false;
+            return;
+        }
+        from = m_search.backward ? from - 1 : from + 1;
+    }
+
+    Scrollback::Match match;
+    if (!m_history.Find(HistoryIndex::Prepare(m_search.text), from, m_search.backward, match)) {
+        m_search.found = false;
+        return;
+    }
+    m_search.found = true;
+    m_search.sequence = first + match.line;
+    m_search.column = match.column;
+    ScrollToMatch();
+}
+
+void ConsoleEngine::EndSearch(bool keepPosition) {
+    if (!m_search.text.empty()) m_lastSearch = m_search.text;
+    if (!keepPosition) {
+        m_scrollOffset = std::min(m_search.savedScrollOffset, std::max(static_cast<int>(m_history.Size()) - 1, 0));
+    }
+    m_search.active = false;
+    m_search.found = false;
+}
+
+/**
+ * Scrollt so, dass der Treffer einige Zeilen ueber der Eingabezeile steht (auch bei wenigen
+ * Bildschirmzeilen sichtbar, mit etwas Zusammenhang darunter).
+ */
+void ConsoleEngine::ScrollToMatch() {
+    const int CONTEXT_LINES = 3;
+    int below = static_cast<int>(std::min<uint64_t>(m_history.TotalLines() - 1 - m_search.sequence, m_history.Size() - 1));
+    m_scrollOffset = std::max(below - CONTEXT_LINES, 0);
+}
+
+bool ConsoleEngine::SearchHighlight(uint64_t& sequence, int& column, int& length) const {
+    if (!m_search.active || !m_search.found) return false;
+    sequence = m_search.sequence;
+    column = static_cast<int>(m_search.column);
+    length = static_cast<int>(m_search.text.size());
+    return true;
+}
+
+bool ConsoleEngine::TickCountdown() {
+    if (!m_countdownActive) return false;
+    if (m_countdownSeconds > 0) {
+        m_countdownSeconds--;
+        m_host.RequestRedraw();
+    }
+    return m_countdownSeconds <= 0;
+}
+
+void ConsoleEngine::ShowClock(bool visible) {
+    if (visible == m_clockVisible) return;
+    m_clockVisible = visible;
+    if (visible) {
+        TickClock();
+        m_host.StartClock();
+    }
+    m_host.RequestRedraw();
+}
+
+bool ConsoleEngine::TickClock() {
+    if (!m_clockVisible) return false;
+    if (m_clockPanel.Update(m_clockTime.Now())) m_host.RequestRedraw();
+    return true;
+}
+
+bool ConsoleEngine::TickClock(int64_t unixSeconds) {
+    if (!m_clockVisible) return false;
+    if (m_clockPanel.Update(m_clockTime.At(unixSeconds))) m_host.RequestRedraw();
+    return true;
+}
+
+std::wstring ConsoleEngine::BottomLine(bool cursorVisible) const {
+    if (m_countdownActive) {
+        std::wstringstream shutdownSS;
+        if (m_countdownSeconds > 0) {
+            shutdownSS << L"EXIT.BAT: Terminierung in " << m_countdownSeconds << L" Sekunde(n)...";
+        }
+        else {
+            shutdownSS << L"EXIT.BAT: SYSTEM SHUTDOWN. Goodbye.";
+        }
+        return shutdownSS.str();
+    }
+    if (m_viewer) return m_viewer->StatusText();
+    if (m_search.active) {
+        std::wstring line(SearchPrefix());
+        line += m_search.text;
+        line += cursorVisible ? L'_' : L' ';
+        if (m_search.found) {
+            uint64_t first = m_history.TotalLines() - m_history.Size();
+            line += L"   [Zeile " + std::to_wstring(m_search.sequence - first + 1) + L" von " + std::to_wstring(m_history.Size()) + L"]";
+        }
+        else if (m_search.text.empty()) {
+            line += L"   [Strg+R aelter, Strg+F neuer, Enter uebernimmt, Esc bricht ab]";
+        }
+        else {
+            line += L"   [nicht gefunden]";
+        }
+        return line;
+    }
+    std::wstring promptAndInput = IsBusy() ? m_input.Text() : PROMPT + m_input.Text();
+    // Steht der Cursor mitten in der Zeile, zeichnet ihn das Frontend ueber das Zeichen
+    if (m_input.Cursor() == m_input.Size()) promptAndInput += cursorVisible ? L'_' : L' ';
+    return promptAndInput;
+}
+
+/**
+ * Führt den eingegebenen Befehl aus und aktualisiert den Verlauf.
+ */
+void ConsoleEngine::ProcessCommand(const std::wstring& command) {
+    PerfSpan span(L"ProcessCommand", &Perf::Commands());
+    std::wstring trimmedCommand = command;
+    size_t end = trimmedCommand.find_last_not_of(L" \t\n\r\f\v");
+    if (end != std::wstring::npos) trimmedCommand.resize(end + 1);
+
+    if (m_awaitingUpdateConfirmation) {
+        AddHistory(PROMPT + trimmedCommand);
+        if (EqualsIgnoreCase(trimmedCommand, L"Y")) {
+            m_host.PerformUpdate(*this);
+        }
+        else if (EqualsIgnoreCase(trimmedCommand, L"N")) {
+            AddHistory(L"Update abgebrochen.");
+        }
+        else {
+            AddHistory(L"Bitte 'Y' oder 'N' eingeben.");
+        }
+        m_awaitingUpdateConfirmation = false;
+        m_input.Clear(); m_host.RequestRedraw();
+        return;
+    }
+
+    AddHistory(PROMPT + trimmedCommand);
+    RememberCommand(trimmedCommand.substr(std::min(trimmedCommand.size(), trimmedCommand.find_first_not_of(L" \t"))));
+    RunCommandLine(trimmedCommand);
+
+    m_input.Clear();
+    m_host.RequestRedraw();
+}
+
+/**
+ * Alle Befehle der Konsole. Reihenfolge = Reihenfolge in HELP; der perfekte Hash fuer die
+ * Zuordnung entsteht beim Uebersetzen.
+ */
+const CommandRegistry& ConsoleEngine::Commands() {
+    using S = CommandSection;
+    static constexpr CommandSpec COMMANDS[] = {
+        { L"DATE", L"", L"", 0, L"", S::General, L"Zeigt das aktuelle Datum an.", &ConsoleEngine::CmdDate },
+        { L"TIME", L"", L"", 0, L"", S::General, L"Zeigt die aktuelle Uhrzeit an.", &ConsoleEngine::CmdTime },
+        { L"CLOCK", L"", L"[ON|OFF]", 0, L"", S::General, L"Zeigt die Uhrzeit gross am oberen Rand an.", &ConsoleEngine::CmdClock },
+        { L"CLEAR", L"CLS", L"", 0, L"", S::General, L"Leert den Konsolenbildschirm.", &ConsoleEngine::CmdClear },
+        { L"UPDATE", L"", L"", 0, L"", S::General, L"Sucht und installiert automatisch Updates.", &ConsoleEngine::CmdUpdate },
+        { L"EXIT", L"", L"", 0, L"", S::General, L"Startet die Systemterminierung.", &ConsoleEngine::CmdExit },
+        { L"HELP", L"", L"", 0, L"", S::General, L"Zeigt diese Hilfe an.", &ConsoleEngine::CmdHelp },
+        { L"ECHO", L"", L"<text>", 0, L"", S::General, L"Gibt den angegebenen Text aus.", &ConsoleEngine::CmdEcho },
+        { L"VER", L"", L"", 0, L"", S::General, L"Zeigt die Version an.", &ConsoleEngine::CmdVer },
+        { L"HISTORY", L"", L"[/FIND text]", 0, L"", S::General,
+            L"Listet die zuletzt eingegebenen Befehle auf; /FIND durchsucht den Verlauf (auch Strg+R/Strg+F).", &ConsoleEngine::CmdHistory },
+        { L"VOL", L"", L"", 0, L"", S::General, L"Zeigt die Datentraegerbezeichnung an.", &ConsoleEngine::CmdVol },
+        { L"DIR", L"", L"[/S] [pfad]", 0, L"", S::General,
+            L"Listet ein Verzeichnis auf (/S: mit Unterverzeichnissen).", &ConsoleEngine::CmdDir },
+        { L"TREE", L"", L"[/F] [pfad]", 0, L"", S::General,
+            L"Zeigt die Ordnerstruktur grafisch an (/F: mit Dateien).", &ConsoleEngine::CmdTree },
+        { L"DU", L"", L"[-l tiefe] [pfad]", 0, L"", S::General,
+            L"Summiert Dateien und Groesse eines Verzeichnisbaums.", &ConsoleEngine::CmdDiskUsage },
+        { L"TYPE", L"", L"<file>", 1, L"Dateiname erforderlich.", S::General,
+            L"Zeigt eine Textdatei seitenweise an (Bild auf/ab, Esc).", &ConsoleEngine::CmdType },
+        { L"FIND", L"", L"[/V] [/C] [/N] [/I] \"text\" <datei...>", 2, L"Suchtext und Datei erforderlich.", S::General,
+            L"Sucht einen Text in Dateien oder in der Ausgabe davor (befehl | FIND text).", &ConsoleEngine::CmdFind },
+        { L"FINDSTR", L"", L"[/R|/L] [/I] [/N] [/C] [/V] [/C:text] <muster> <datei...>", 2, L"Suchmuster und Datei erforderlich.", S::General,
+            L"Sucht Muster (regulaere Ausdruecke) in Dateien, * und ? im Dateinamen.", &ConsoleEngine::CmdFindstr },
+        { L"SORT", L"", L"[/R] [/+n] [datei]", 0, L"", S::General,
+            L"Sortiert die Zeilen einer Datei oder der Ausgabe davor (TASKLIST | SORT).", &ConsoleEngine::CmdSort },
+        { L"CALL", L"", L"<datei.bat> [argumente]", 1, L"Batchdatei erforderlich, z.B. CALL pruefung.bat.", S::General,
+            L"Fuehrt eine Batchdatei aus (%1..%9, GOTO, ECHO OFF, EXIT /B).", &ConsoleEngine::CmdCall },
+        { L"HOSTNAME", L"", L"", 0, L"", S::General, L"Zeigt den Computernamen an.", &ConsoleEngine::CmdHostname },
+        { L"WHOAMI", L"", L"", 0, L"", S::General, L"Zeigt den aktuellen Benutzernamen an.", &ConsoleEngine::CmdWhoami },
+        { L"UPTIME", L"", L"", 0, L"", S::General, L"Zeigt die Systemlaufzeit an.", &ConsoleEngine::CmdUptime },
+
+        { L"START", L"", L"<befehl>", 1, L"Befehl erforderlich, z.B. START PING localhost.", S::Jobs,
+            L"Fuehrt einen Befehl im Hintergrund aus.", &ConsoleEngine::CmdStart },
+        { L"JOBS", L"", L"", 0, L"", S::Jobs, L"Listet laufende Befehle auf.", &ConsoleEngine::CmdJobs },
+        { L"STOP", L"", L"<nr>", 0, L"", S::Jobs, L"Bricht einen Hintergrundbefehl ab.", &ConsoleEngine::CmdStop },
+
+        { L"PING", L"", L"[-t] [-n anzahl] [-l groesse] [-i ms] [-w ms] [-4|-6] <host>", 0, L"", S::Network,
+            L"Sendet ICMP-Anfragen an einen Host (-t bis Strg+C).", &ConsoleEngine::CmdPing },
+        { L"IPCONFIG", L"", L"[/ALL]", 0, L"", S::Network,
+            L"Zeigt die Netzwerkkonfiguration an (/ALL: mit MAC, MTU und DNS-Servern).", &ConsoleEngine::CmdIpConfig },
+        { L"NETSTAT", L"", L"[-r sek]", 0, L"", S::Network,
+            L"Zeigt TCP/UDP-Verbindungen mit PID an (-r: nur Aenderungen).", &ConsoleEngine::CmdNetstat },
+
+        { L"SYSTEMINFO", L"", L"[/WATCH [/I ms]]", 0, L"", S::System,
+            L"Zeigt Systeminformationen an (/WATCH: CPU, Speicher, Datentraeger, Netzwerk laufend).", &ConsoleEngine::CmdSystemInfo },
+        { L"TASKLIST", L"", L"", 0, L"", S::System, L"Listet laufende Prozesse auf.", &ConsoleEngine::CmdTaskList },
+        { L"TOP", L"", L"[-n anz] [-i sek]", 0, L"", S::System,
+            L"Zeigt Prozesse nach CPU-Last an, laufend aktualisiert.", &ConsoleEngine::CmdTop },
+        { L"STARTUP", L"", L"", 0, L"", S::System,
+            L"Zeigt die Dauer des Programmstarts bis zum ersten Bild an.", &ConsoleEngine::CmdStartup },
+        { L"PERF", L"", L"[ON|OFF|RESET|DUMP datei]", 0, L"", S::System,
+            L"Zeigt Bildzeiten, Befehlslatenz und Speicher an (DUMP: Chrome-Trace).", &ConsoleEngine::CmdPerf },
+
+        { L"CALC", L"", L"<formel>", 1, L"Ausdruck erforderlich, z.B. CALC 2*(3+4).", S::Math,
+            L"Berechnet einen Ausdruck (Variablen mit x = ..., ans).", &ConsoleEngine::CmdCalc },
+        { L"TABLE", L"", L"<formel> x=a..b [step s]", 1, L"Ausdruck und Bereich erforderlich, z.B. TABLE sin(x) x=0..360 step 15.",
+            S::Math, L"Wertet einen Ausdruck ueber einen Bereich aus.", &ConsoleEngine::CmdTable },
+        { L"BASE", L"", L"<zahl> [DEC|HEX|OCT|BIN]", 1, L"Zahl erforderlich, z.B. BASE 0xFF.", S::Math,
+            L"Wandelt beliebig grosse Zahlen um (Praefix 0x, 0o, 0b).", &ConsoleEngine::CmdBase },
+        { L"SQRT", L"", L"<x>", 1, L"Fehlender Parameter.", S::Math, L"", &ConsoleEngine::CmdSqrt },
+        { L"POW", L"", L"<x> <y>", 2, L"Zwei Parameter benoetigt.", S::Math, L"", &ConsoleEngine::CmdPow },
+        { L"LOG", L"", L"<x>", 1, L"Fehlender Parameter.", S::Math, L"", &ConsoleEngine::CmdLog },
+        { L"LOG10", L"", L"<x>", 1, L"Fehlender Parameter.", S::Math, L"", &ConsoleEngine::CmdLog },
+        { L"SIN", L"", L"<grad>", 1, L"Fehlender Winkel-Parameter (in Grad).", S::Math, L"", &ConsoleEngine::CmdTrig },
+        { L"COS", L"", L"<grad>", 1, L"Fehlender Winkel-Parameter (in Grad).", S::Math, L"", &ConsoleEngine::CmdTrig },
+        { L"TAN", L"", L"<grad>", 1, L"Fehlender Winkel-Parameter (in Grad).", S::Math, L"", &ConsoleEngine::CmdTrig },
+        { L"HEX", L"", L"<dez>", 1, L"Fehlender Dezimal-Parameter.", S::Math, L"", &ConsoleEngine::CmdHex },
+        { L"DEC", L"", L"<hex>", 1, L"Fehlender HEX-Parameter.", S::Math, L"", &ConsoleEngine::CmdDec },
+    };
+    static constexpr CommandRegistry REGISTRY(COMMANDS);
+    return REGISTRY;
+}
+
+/**
+ * Eine Befehlszeile, auch aus einer Batchdatei: ein Befehl oder eine Pipeline (a | b | c).
+ */
+void ConsoleEngine::RunCommandLine(const std::wstring& command) {
+    std::vector<std::wstring> stages;
+    // START a | b: die ganze Pipeline im Hintergrund (CmdStart kommt wieder hierher)
+    if (!SplitPipeline(command, stages) || EqualsIgnoreCase(CommandLine(stages.front()).Name(), L"START")) {
+        ExecuteCommand(command);
+        return;
+    }
+    StartPipeline(command, stages);
+}
+
+/**
+ * Pipeline: die erste Stufe ist ein beliebiger Befehl, dessen Ausgabe (bzw. Job) abgefangen
+ * wird; alle weiteren Stufen muessen Filter sein. Zusammen laufen sie als ein Job, Strg+C,
+ * START und JOBS wirken auf die ganze Pipeline.
+ */
+void ConsoleEngine::StartPipeline(const std::wstring& command, const std::vector<std::wstring>& stages) {
+    std::vector<PipeFilter> filters;
+    for (size_t i = 1; i < stages.size(); ++i) {
+        CommandLine line(stages[i]);
+        std::wstring arguments(line.Rest());
+        std::wstring error;
+        if (EqualsIgnoreCase(line.Name(), L"FIND") || EqualsIgnoreCase(line.Name(), L"FINDSTR")) {
+            SearchOptions options;
+            bool valid = EqualsIgnoreCase(line.Name(), L"FIND")
+                ? ParseFindArguments(arguments, options, error, true)
+                : ParseFindstrArguments(arguments, options, error, true);
+            if (!valid) {
+                AddError(L"FEHLER: " + error);
+                return;
+            }
+            filters.push_back([options](JobContext& job, RecordQueue& in, RecordSink& out) { FilterLines(job, in, out, options); });
+        }
+        else if (EqualsIgnoreCase(line.Name(), L"SORT")) {
+            SortOptions options;
+            if (!ParseSortArguments(arguments, options, error)) {
+                AddError(L"FEHLER: " + error);
+                return;
+            }
+            if (!options.file.empty()) {
+                AddError(L"FEHLER: In einer Pipeline keine Datei angeben ('" + options.file + L"'), gelesen wird die Ausgabe davor.");
+                return;
+            }
+            filters.push_back([options](JobContext& job, RecordQueue& in, RecordSink& out) { SortLines(job, in, out, options); });
+        }
+        else if (line.Name().empty()) {
+            AddError(L"FEHLER: Leere Stufe in der Pipeline.");
+            return;
+        }
+        else {
+            AddError(L"FEHLER: '" + std::wstring(line.Name()) + L"' kann nicht aus einer Pipeline lesen (moeglich: FIND, FINDSTR, SORT).");
+            return;
+        }
+    }
+    if (stages.front().empty()) {
+        AddError(L"FEHLER: Leere Stufe in der Pipeline.");
+        return;
+    }
+    if (!Commands().Find(CommandLine(stages.front()).Name())) {
+        ExecuteCommand(stages.front()); // Fehlermeldung
+        return;
+    }
+
+    PipeCapture capture;
+    m_capture = &capture;
+    ExecuteCommand(stages.front());
+    m_capture = nullptr;
+    PipeSource source = std::move(capture.job);
+    if (!source) {
+        source = [text = std::move(capture.text)](JobContext& job) {
+            if (!text.empty()) job.AddHistory(text);
+        };
+    }
+    RunJob(command, [source = std::move(source), filters = std::move(filters)](JobContext& job) {
+        RunPipeline(job, source, filters);
+    });
+}
+
+/**
+ * Wertet einen Befehl aus (ohne Echo und ohne die Eingabezeile anzufassen).
+ */
+void ConsoleEngine::ExecuteCommand(const std::wstring& trimmedCommand) {
+    CommandLine line(trimmedCommand);
+    if (line.Name().empty()) return;
+
+    const CommandSpec* spec = Commands().Find(line.Name());
+    if (!spec) {
+        AddHistory(L"Ungueltiger Befehl oder Dateiname. Tippen Sie 'HELP'.");
+        return;
+    }
+    if (line.ArgCount() < spec->minArgs) {
+        AddError(L"FEHLER: " + std::wstring(spec->missing));
+        return;
+    }
+    PerfSpan span(spec->name.data()); // Literal aus der Befehlstabelle, nullterminiert
+    (this->*spec->handler)(line);
+}
+
+void ConsoleEngine::CmdHelp(const CommandLine&) {
+    static const std::wstring help = Commands().HelpText();
+    AddHistory(help);
+}
+
+void ConsoleEngine::CmdDate(const CommandLine&) {
+    AddHistory(L"Aktuelles Datum ist " + GetCurrentDateString());
+}
+
+void ConsoleEngine::CmdTime(const CommandLine&) {
+    AddHistory(L"Aktuelle Zeit ist " + GetCurrentTimeString());
+}
+
+void ConsoleEngine::CmdClock(const CommandLine& line) {
+    std::wstring_view mode = line.Arg(0);
+    bool visible = !m_clockVisible;
+    if (EqualsIgnoreCase(mode, L"ON")) visible = true;
+    else if (EqualsIgnoreCase(mode, L"OFF")) visible = false;
+    else if (!mode.empty()) {
+        AddError(L"FEHLER: Unbekannte Option '" + std::wstring(mode) + L"' (ON oder OFF).");
+        return;
+    }
+    ShowClock(visible);
+    AddHistory(visible ? L"Uhr eingeschaltet." : L"Uhr ausgeschaltet.");
+}
+
+void ConsoleEngine::CmdHistory(const CommandLine& line) {
+    if (line.ArgCount() > 0) {
+        if (!EqualsIgnoreCase(line.Arg(0), L"/FIND")) {
+            AddError(L"FEHLER: Unbekannte Option " + std::wstring(line.Arg(0)) + L" (erwartet /FIND text).");
+            return;
+        }
+        std::wstring_view text = line.Rest();
+        text.remove_prefix(std::min(text.size(), text.find_first_not_of(L" \t") + line.Arg(0).size()));
+        size_t start = text.find_first_not_of(L" \t");
+        text = start == std::wstring_view::npos ? std::wstring_view() : text.substr(start);
+        if (text.size() >= 2 && text.front() == L'"' && text.back() == L'"') text = text.substr(1, text.size() - 2);
+        if (text.empty()) {
+            AddError(L"FEHLER: Suchtext fehlt.");
+            return;
+        }
+        FindInHistory(text);
+        return;
+    }
+    std::wstring text;
+    size_t number = 0;
+    for (const std::wstring& command : m_commandHistory) {
+        std::wstring index = std::to_wstring(++number);
+        text += std::wstring(index.size() < 4 ? 4 - index.size() : 0, L' ') + index + L"  " + command + L"\n";
+    }
+    AddHistory(text);
+}
+
+/**
+ * HISTORY /FIND: zaehlt alle Verlaufszeilen mit dem Suchtext und listet die neuesten
+ * MAX_LISTED davon (aelteste zuerst). Die eigene Befehlszeile (letzte Zeile) zaehlt nicht mit.
+ */
+void ConsoleEngine::FindInHistory(std::wstring_view text) {
+    const size_t MAX_LISTED = 50;
+    auto start = std::chrono::steady_clock::now();
+    HistoryIndex::Query query = HistoryIndex::Prepare(text);
+    std::vector<size_t> listed;
+    size_t count = 0;
+    Scrollback::Match match;
+    size_t from = m_history.Size() >= 2 ? m_history.Size() - 2 : 0;
+    while (m_history.Size() >= 2 && m_history.Find(query, from, true, match)) {
+        if (listed.size() < MAX_LISTED) listed.push_back(match.line);
+        count++;
+        if (match.line == 0) break;
+        from = match.line - 1;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::wstring out;
+    std::wstring scratch;
+    for (auto it = listed.rbegin(); it != listed.rend(); ++it) {
+        out += L"[" + std::to_wstring(*it + 1) + L"] ";
+        out += m_history.Line(*it, scratch);
+        out += L'\n';
+    }
+    wchar_t summary[128];
+    swprintf(summary, 128, L"%zu Treffer in %zu Zeilen (%.2f ms)%ls", count, m_history.Size() - 1, ms,
+        count > listed.size() ? L", die neuesten werden angezeigt" : L"");
+    out += summary;
+    AddHistory(out);
+}
+
+void ConsoleEngine::CmdClear(const CommandLine&) {
+    ClearHistory();
+}
+
+void ConsoleEngine::CmdUpdate(const CommandLine&) {
+    if (m_host.CheckForUpdate(*this)) {
+        AddHistory(L"Update gefunden!");
+        AddHistory(L"Moechten Sie jetzt aktualisieren? (Y/N)");
+        m_awaitingUpdateConfirmation = true;
+    }
+}
+
+void ConsoleEngine::CmdExit(const CommandLine&) {
+    m_isTypingEnabled = false;
+    m_countdownActive = true;
+    AddHistory(L"EXIT.BAT: Terminierung gestartet. Bitte warten...");
+    m_host.StartCountdown();
+}
+
+void ConsoleEngine::CmdPing(const CommandLine& line) {
+    // Optionen und Hostname in Originalschreibweise
+    std::wstring host;
+    std::wstring error;
+    PingOptions options;
+    if (!ParsePingArguments(std::wstring(line.Rest()), host, options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    RunJob(std::wstring(line.Line()), [this, host, options](JobContext& job) {
+        std::unique_ptr<PingProber> prober = m_host.CreatePingProber();
+        if (prober) RunPing(job, *prober, host, options);
+        else job.AddError(L"FEHLER: PING ist auf diesem System nicht verfuegbar.");
+    });
+}
+
+void ConsoleEngine::CmdIpConfig(const CommandLine& line) {
+    bool all = false;
+    for (size_t i = 0; i < line.ArgCount(); ++i) {
+        if (!EqualsIgnoreCase(line.Arg(i), L"/ALL")) {
+            AddError(L"FEHLER: Unbekannte Option " + std::wstring(line.Arg(i)) + L" (erwartet /ALL).");
+            return;
+        }
+        all = true;
+    }
+    if (!m_netConfig) {
+        std::unique_ptr<NetConfigSource> source = m_host.CreateNetConfigSource();
+        if (!source) {
+            AddError(L"FEHLER: IPCONFIG ist auf diesem System nicht verfuegbar.");
+            return;
+        }
+        m_netConfig = std::make_shared<NetConfigCache>(std::move(source));
+    }
+
+    // Normalfall: der Stand liegt schon im Speicher, die Antwort kommt ohne Job
+    if (std::shared_ptr<const NetSnapshot> snapshot = m_netConfig->Current()) {
+        AddTable(FormatIpConfig(*snapshot, all));
+        return;
+    }
+    RunJob(std::wstring(line.Line()), [cache = m_netConfig, all](JobContext& job) {
+        std::wstring error;
+        std::shared_ptr<const NetSnapshot> snapshot = cache->Wait(job, error);
+        if (snapshot) job.AddTable(FormatIpConfig(*snapshot, all));
+        else if (!error.empty()) job.AddError(L"FEHLER: " + error);
+    });
+}
+
+void ConsoleEngine::CmdSystemInfo(const CommandLine& line) {
+    SystemInfoOptions options;
+    std::wstring error;
+    if (!ParseSystemInfoArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    if (!options.watch) {
+        m_host.SystemInfo(*this);
+        return;
+    }
+    if (!m_systemMonitor) {
+        std::unique_ptr<SystemSampler> sampler = m_host.CreateSystemSampler();
+        if (!sampler) {
+            AddError(L"FEHLER: SYSTEMINFO /WATCH ist auf diesem System nicht verfuegbar.");
+            return;
+        }
+        m_systemMonitor = std::make_shared<SystemMonitor>(std::move(sampler), options.intervalMillis);
+    }
+    else if (options.intervalSet) {
+        m_systemMonitor->SetInterval(options.intervalMillis);
+    }
+    RunJob(std::wstring(line.Line()), [monitor = m_systemMonitor](JobContext& job) { RunSystemWatch(job, *monitor); });
+}
+
+void ConsoleEngine::CmdStartup(const CommandLine&) {
+    AddHistory(m_startup ? m_startup->Format() : L"Keine Startzeiten erfasst.");
+}
+
+void ConsoleEngine::CmdPerf(const CommandLine& line) {
+    std::wstring_view mode = line.Arg(0);
+    if (EqualsIgnoreCase(mode, L"ON") || EqualsIgnoreCase(mode, L"OFF")) {
+        Perf::Enable(EqualsIgnoreCase(mode, L"ON"));
+        AddHistory(Perf::Enabled() ? L"Aufzeichnung eingeschaltet." : L"Aufzeichnung ausgeschaltet.");
+        return;
+    }
+    if (EqualsIgnoreCase(mode, L"RESET")) {
+        Perf::Reset();
+        AddHistory(L"Messwerte verworfen.");
+        return;
+    }
+    if (EqualsIgnoreCase(mode, L"DUMP")) {
+        if (line.ArgCount() < 2) {
+            AddError(L"FEHLER: Dateiname erforderlich, z.B. PERF DUMP trace.json.");
+            return;
+        }
+        std::wstring path = ResolvePath(m_host.WorkingDirectory(), std::wstring(line.Arg(1)));
+        RunJob(std::wstring(line.Line()), [path](JobContext& job) {
+            size_t events = 0;
+            std::wstring error;
+            if (!Perf::WriteChromeTrace(path, events, error)) {
+                job.AddError(L"FEHLER: " + error);
+                return;
+            }
+            job.AddHistory(std::to_wstring(events) + L" Spannen nach " + path + L" geschrieben.");
+        });
+        return;
+    }
+    if (!mode.empty()) {
+        AddError(L"FEHLER: Unbekannte Option '" + std::wstring(mode) + L"' (ON, OFF, RESET oder DUMP).");
+        return;
+    }
+
+    Perf::Stats stats = Perf::Statistics();
+    std::wstring text = Perf::Enabled() ? L"Aufzeichnung an" : L"Aufzeichnung aus (PERF ON schaltet sie ein)";
+    text += L", " + std::to_wstring(stats.events) + L" Spannen aus " + std::to_wstring(stats.threads) + L" Threads";
+    if (stats.overwritten + stats.dropped > 0) {
+        text += L", " + std::to_wstring(stats.overwritten + stats.dropped) + L" verworfen";
+    }
+    text += L"\n";
+    text += Perf::Frames().Format(L"Bildzeit");
+    text += Perf::Commands().Format(L"Befehlslatenz");
+    text += Perf::Jobs().Format(L"Jobs");
+
+    wchar_t memory[160];
+    uint64_t resident = 0;
+    uint64_t privateBytes = 0;
+    text += L"Speicher:";
+    if (m_host.ProcessMemory(resident, privateBytes)) {
+        swprintf(memory, 160, L" Prozess %.1f MB (privat %.1f MB),", resident / 1048576.0, privateBytes / 1048576.0);
+        text += memory;
+    }
+    swprintf(memory, 160, L" Verlauf %.1f MB, Spurpuffer %.1f MB", m_history.ResidentBytes() / 1048576.0, stats.ringBytes / 1048576.0);
+    text += memory;
+    AddHistory(text);
+}
+
+void ConsoleEngine::CmdTaskList(const CommandLine& line) {
+    RunJob(std::wstring(line.Line()), [this](JobContext& job) { m_host.TaskList(job); });
+}
+
+void ConsoleEngine::CmdTop(const CommandLine& line) {
+    TopOptions options;
+    std::wstring error;
+    if (!ParseTopArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    RunJob(std::wstring(line.Line()), [this, options](JobContext& job) {
+        std::unique_ptr<ProcessSampler> sampler = m_host.CreateProcessSampler();
+        if (sampler) RunTop(job, *sampler, options);
+        else job.AddError(L"FEHLER: TOP ist auf diesem System nicht verfuegbar.");
+    });
+}
+
+void ConsoleEngine::CmdNetstat(const CommandLine& line) {
+    NetstatOptions options;
+    std::wstring error;
+    if (!ParseNetstatArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    RunJob(std::wstring(line.Line()), [this, options](JobContext& job) {
+        std::unique_ptr<ConnectionSource> source = m_host.CreateConnectionSource();
+        if (source) RunNetstat(job, *source, options);
+        else job.AddError(L"FEHLER: NETSTAT ist auf diesem System nicht verfuegbar.");
+    });
+}
+
+void ConsoleEngine::CmdVol(const CommandLine&) {
+    m_host.Vol(*this);
+}
+
+void ConsoleEngine::CmdDir(const CommandLine& line) {
+    WalkOptions options;
+    std::wstring error;
+    if (!ParseDirArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    std::wstring base = m_host.WorkingDirectory();
+    RunJob(std::wstring(line.Line()), [base, options](JobContext& job) { RunDir(job, base, options); });
+}
+
+void ConsoleEngine::CmdTree(const CommandLine& line) {
+    WalkOptions options;
+    std::wstring error;
+    if (!ParseTreeArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    std::wstring base = m_host.WorkingDirectory();
+    RunJob(std::wstring(line.Line()), [base, options](JobContext& job) { RunTree(job, base, options); });
+}
+
+void ConsoleEngine::CmdDiskUsage(const CommandLine& line) {
+    WalkOptions options;
+    std::wstring error;
+    if (!ParseDiskUsageArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    std::wstring base = m_host.WorkingDirectory();
+    RunJob(std::wstring(line.Line()), [base, options](JobContext& job) { RunDiskUsage(job, base, options); });
+}
+
+void ConsoleEngine::CmdFind(const CommandLine& line) {
+    SearchOptions options;
+    std::wstring error;
+    if (!ParseFindArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    std::wstring base = m_host.WorkingDirectory();
+    RunJob(std::wstring(line.Line()), [base, options](JobContext& job) { RunSearch(job, base, options); });
+}
+
+void ConsoleEngine::CmdFindstr(const CommandLine& line) {
+    SearchOptions options;
+    std::wstring error;
+    if (!ParseFindstrArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    std::wstring base = m_host.WorkingDirectory();
+    RunJob(std::wstring(line.Line()), [base, options](JobContext& job) { RunSearch(job, base, options); });
+}
+
+void ConsoleEngine::CmdSort(const CommandLine& line) {
+    SortOptions options;
+    std::wstring error;
+    if (!ParseSortArguments(std::wstring(line.Rest()), options, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    if (options.file.empty()) {
+        AddError(L"FEHLER: Datei erforderlich, z.B. SORT namen.txt oder TASKLIST | SORT.");
+        return;
+    }
+    std::wstring path = ResolvePath(m_host.WorkingDirectory(), options.file);
+    RunJob(std::wstring(line.Line()), [path, options](JobContext& job) {
+        RunPipeline(job, [&path](JobContext& source) { StreamFileLines(source, path); },
+            { [&options](JobContext& sort, RecordQueue& in, RecordSink& out) { SortLines(sort, in, out, options); } });
+    });
+}
+
+void ConsoleEngine::CmdCall(const CommandLine& line) {
+    if (m_capture || m_runInBackground) {
+        AddError(L"FEHLER: CALL kann nicht in einer Pipeline oder mit START laufen.");
+        return;
+    }
+    if (m_scripts.size() >= MAX_CALL_DEPTH) {
+        m_scripts.clear();
+        AddError(L"FEHLER: Zu viele verschachtelte CALL-Aufrufe (hoechstens " + std::to_wstring(MAX_CALL_DEPTH) + L").");
+        return;
+    }
+    std::vector<std::wstring> arguments = SplitBatchArguments(line.Rest());
+    std::wstring name = arguments.front();
+    name.erase(std::remove(name.begin(), name.end(), L'"'), name.end());
+    std::wstring path = ResolvePath(m_host.WorkingDirectory(), name);
+
+    std::wstring error;
+    std::shared_ptr<const BatchScript> script = m_scriptCache.Load(path, error);
+    if (!script && name.find(L'.') == std::wstring::npos) {
+        std::wstring ignored;
+        script = m_scriptCache.Load(path + L".bat", ignored);
+    }
+    if (!script) {
+        AddError(L"FEHLER: " + name + L": " + error);
+        return;
+    }
+    bool echo = m_scripts.empty() || m_scripts.back().echo; // ECHO OFF gilt auch fuer aufgerufene Dateien
+    m_scripts.push_back({ std::move(script), std::move(arguments), 0, echo });
+    RunScripts();
+}
+
+/**
+ * Fuehrt Anweisungen der laufenden Batchdateien aus, bis eine einen Vordergrund-Job startet
+ * oder alle beendet sind. Ein CALL innerhalb einer Batchdatei legt nur einen Rahmen an, die
+ * aeussere Schleife fuehrt ihn aus.
+ */
+void ConsoleEngine::RunScripts() {
+    if (m_runningScripts) return;
+    m_runningScripts = true;
+    size_t steps = 0;
+    while (!m_scripts.empty() && !IsBusy() && m_isTypingEnabled) {
+        ScriptFrame& frame = m_scripts.back();
+        if (frame.next >= frame.script->Size()) {
+            m_scripts.pop_back();
+            continue;
+        }
+        if (++steps > MAX_SCRIPT_STEPS) {
+            m_scripts.clear();
+            AddError(L"FEHLER: Batchdatei nach " + std::to_wstring(MAX_SCRIPT_STEPS) + L" Anweisungen ohne Wartezeit abgebrochen (Endlosschleife?).");
+            break;
+        }
+        const BatchStatement& statement = (*frame.script)[frame.next++];
+        switch (statement.kind) {
+        case BatchStatement::Kind::Goto:
+            frame.next = statement.target;
+            break;
+        case BatchStatement::Kind::Return:
+            m_scripts.pop_back();
+            break;
+        case BatchStatement::Kind::EchoOn:
+        case BatchStatement::Kind::EchoOff:
+            if (frame.echo && !statement.quiet) AddHistory(PROMPT + (statement.kind == BatchStatement::Kind::EchoOn ? L"ECHO ON" : L"ECHO OFF"));
+            frame.echo = statement.kind == BatchStatement::Kind::EchoOn;
+            break;
+        case BatchStatement::Kind::Command: {
+            std::wstring text = BatchScript::Expand(statement, frame.arguments);
+            if (frame.echo && !statement.quiet) AddHistory(PROMPT + text);
+            RunCommandLine(text); // frame ist danach ungueltig (CALL legt einen Rahmen an)
+            break;
+        }
+        }
+    }
+    m_runningScripts = false;
+}
+
+void ConsoleEngine::CmdStart(const CommandLine& line) {
+    std::wstring_view rest = line.Rest();
+    m_runInBackground = true;
+    RunCommandLine(std::wstring(rest.substr(rest.find_first_not_of(L" \t"))));
+    m_runInBackground = false;
+}
+
+void ConsoleEngine::CmdJobs(const CommandLine&) {
+    ListJobs();
+}
+
+void ConsoleEngine::CmdStop(const CommandLine& line) {
+    std::wstring arg(line.Arg(0));
+    unsigned long id = 0;
+    try {
+        id = std::stoul(arg);
+    }
+    catch (...) {
+    }
+    if (id == 0 || !m_executor || !m_executor->Cancel(static_cast<JobId>(id))) {
+        AddError(L"FEHLER: Kein laufender Job mit der Nummer '" + arg + L"'.");
+    }
+}
+
+void ConsoleEngine::CmdType(const CommandLine& line) {
+    // Dateiname in Originalschreibweise (Linux-Dateisysteme unterscheiden Gross-/Kleinschreibung)
+    m_host.Type(*this, std::wstring(line.Arg(0)));
+}
+
+void ConsoleEngine::CmdHostname(const CommandLine&) {
+    m_host.Hostname(*this);
+}
+
+void ConsoleEngine::CmdWhoami(const CommandLine&) {
+    m_host.Whoami(*this);
+}
+
+void ConsoleEngine::CmdUptime(const CommandLine&) {
+    m_host.Uptime(*this);
+}
+
+void ConsoleEngine::CmdVer(const CommandLine&) {
+    AddHistory(L"Terminal Clock Version 1.1");
+}
+
+void ConsoleEngine::CmdEcho(const CommandLine& line) {
+    std::wstring_view text = line.Rest();
+    if (!text.empty()) AddHistory(std::wstring(text));
+}
+
+void ConsoleEngine::CmdHex(const CommandLine& line) {
+    std::wstring dec_str(line.Arg(0));
+    BigInteger value;
+    if (!BigInteger::Parse(dec_str, 10, value)) {
+        AddError(L"FEHLER: Ungueltige Dezimalzahl '" + dec_str + L"'.");
+        return;
+    }
+    AddHistory(dec_str + L" (DEC) = " + value.ToString(16) + L" (HEX)");
+}
+
+void ConsoleEngine::CmdDec(const CommandLine& line) {
+    std::wstring hex_str(line.Arg(0));
+    std::wstring_view digits = hex_str;
+    if (digits.size() > 2 && digits[0] == L'0' && (digits[1] == L'x' || digits[1] == L'X')) digits.remove_prefix(2);
+    BigInteger value;
+    if (!BigInteger::Parse(digits, 16, value)) {
+        AddError(L"FEHLER: Ungueltiger HEX-String '" + hex_str + L"'.");
+        return;
+    }
+    AddHistory(hex_str + L" (HEX) = " + value.ToString(10) + L" (DEC)");
+}
+
+void ConsoleEngine::CmdBase(const CommandLine& line) {
+    static const struct {
+        const wchar_t* name;
+        unsigned radix;
+    } TARGETS[] = { { L"DEC", 10 }, { L"HEX", 16 }, { L"OCT", 8 }, { L"BIN", 2 } };
+    // Laengere Zahlen werden umbrochen, statt am Bildschirmrand abgeschnitten zu werden
+    const size_t LINE_DIGITS = 64;
+
+    std::wstring_view target = line.Arg(1);
+    if (!target.empty() && std::none_of(std::begin(TARGETS), std::end(TARGETS),
+        [target](const auto& t) { return EqualsIgnoreCase(target, t.name); })) {
+        AddError(L"FEHLER: Unbekannte Zielbasis '" + std::wstring(target) + L"' (DEC, HEX, OCT oder BIN).");
+        return;
+    }
+    BigInteger value;
+    unsigned radix;
+    if (!BigInteger::ParseLiteral(line.Arg(0), value, radix)) {
+        AddError(L"FEHLER: Ungueltige Zahl '" + std::wstring(line.Arg(0)) + L"'.");
+        return;
+    }
+
+    for (const auto& t : TARGETS) {
+        if (!target.empty() ? !EqualsIgnoreCase(target, t.name) : t.radix == radix) continue;
+        std::wstring digits = value.ToString(t.radix);
+        for (size_t pos = 0; pos < digits.size(); pos += LINE_DIGITS) {
+            AddLine((pos == 0 ? std::wstring(t.name) + L"  " : std::wstring(5, L' ')) + digits.substr(pos, LINE_DIGITS));
+        }
+    }
+    AddLine(L"(" + std::to_wstring(value.BitLength()) + L" Bit)");
+}
+
+/**
+ * JobContext fuer synchron ausgefuehrte Befehle (ohne Executor): schreibt direkt in den Verlauf.
+ */
+class InlineJobContext : public JobContext {
+public:
+    explicit InlineJobContext(ConsoleEngine& console)
+        : m_console(console) {
+    }
+
+    void AddHistory(const std::wstring& text) override { m_console.AddHistory(text); }
+    void AddError(const std::wstring& text) override { m_console.AddError(text); }
+    void SetLiveLine(uint32_t slot, const std::wstring& text) override { m_console.SetLiveLine(0, slot, text); }
+    void AddTable(std::shared_ptr<ResultTable> table) override { m_console.AddTable(std::move(table)); }
+    bool Cancelled() const override { return false; }
+
+    bool Sleep(uint32_t milliseconds) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+        return true;
+    }
+
+private:
+    ConsoleEngine& m_console;
+};
+
+/**
+ * Startet einen langsamen Befehl im Executor, im Vordergrund oder (unter START) im Hintergrund.
+ */
+void ConsoleEngine::RunJob(const std::wstring& name, JobFunction function) {
+    if (m_capture) {
+        m_capture->job = std::move(function);
+        return;
+    }
+    if (!m_executor) {
+        InlineJobContext job(*this);
+        function(job);
+        m_liveLines.clear();
+        return;
+    }
+    JobId id = m_executor->Submit(name, std::move(function), m_runInBackground);
+    if (m_runInBackground) {
+        m_backgroundJobs.push_back({ id, name });
+        AddHistory(L"[" + std::to_wstring(id) + L"] " + name + L" gestartet.");
+    }
+    else {
+        m_foregroundJob = id;
+    }
+}
+
+void ConsoleEngine::PumpJobs() {
+    // Fortschritt des Dateiindex (TYPE) aendert nur die Statuszeile
+    if (m_viewer && m_viewer->TakeProgress()) m_host.RequestRedraw();
+    if (!m_executor) return;
+    m_executor->TakeEvents(m_jobEvents);
+    if (m_jobEvents.empty()) return;
+
+    for (JobEvent& event : m_jobEvents) {
+        auto background = std::find_if(m_backgroundJobs.begin(), m_backgroundJobs.end(),
+            [&event](const BackgroundJob& job) { return job.id == event.job; });
+        bool isBackground = background != m_backgroundJobs.end();
+        std::wstring tag = L"[" + std::to_wstring(event.job) + L"] ";
+
+        if (event.type == JobEvent::Type::Output) {
+            if (!isBackground) {
+                AddHistory(event.text);
+                continue;
+            }
+            // Hintergrundausgabe zeilenweise mit der Jobnummer kennzeichnen (Zerlegung wie
+            // Scrollback::Append, ein Puffer fuer alle Zeilen)
+            std::wstring_view text(event.text);
+            size_t pos = 0;
+            while (pos < text.size()) {
+                size_t nl = std::min(text.find(L'\n', pos), text.size());
+                m_jobLine.assign(tag);
+                m_jobLine.append(text.substr(pos, nl - pos));
+                AddLine(m_jobLine);
+                pos = nl + 1;
+            }
+            continue;
+        }
+        if (event.type == JobEvent::Type::Table) {
+            AppendTable(std::move(event.table), isBackground ? tag : std::wstring());
+            continue;
+        }
+        if (event.type == JobEvent::Type::Live) {
+            SetLiveLine(event.job, event.slot, isBackground ? tag + event.text : event.text);
+            continue;
+        }
+
+        // Finished
+        m_liveLines.erase(std::remove_if(m_liveLines.begin(), m_liveLines.end(),
+            [&event](const LiveLine& live) { return live.job == event.job; }), m_liveLines.end());
+        if (isBackground) {
+            AddHistory(tag + background->name + (event.cancelled ? L" abgebrochen." : L" beendet."));
+            m_backgroundJobs.erase(background);
+        }
+        else if (event.job == m_foregroundJob) {
+            if (event.cancelled) AddHistory(L"^C");
+            m_foregroundJob = 0;
+        }
+    }
+    m_jobEvents.clear();
+
+    RunPendingCommands();
+    m_host.RequestRedraw();
+}
+
+/**
+ * Ersetzt die Statuszeile eines Jobs oder haengt sie an, falls es noch keine gibt oder sie
+ * inzwischen verdraengt bzw. geloescht (CLS) wurde. Der Scroll-Offset bleibt beim Ersetzen
+ * unveraendert, wer im Verlauf zurueckgeblaettert hat, wird nicht nach unten gerissen.
+ */
+void ConsoleEngine::SetLiveLine(JobId job, uint32_t slot, const std::wstring& text) {
+    std::wstring_view line = text;
+    line = line.substr(0, line.find(L'\n'));
+
+    auto live = std::find_if(m_liveLines.begin(), m_liveLines.end(),
+        [job, slot](const LiveLine& entry) { return entry.job == job && entry.slot == slot; });
+    if (live != m_liveLines.end() && m_history.ReplaceLine(live->sequence, line)) {
+        if (m_log) m_log->ReplaceLine(live->sequence, line);
+        return;
+    }
+
+    AddLine(std::wstring(line));
+    uint64_t sequence = m_history.TotalLines() - 1;
+    if (live != m_liveLines.end()) live->sequence = sequence;
+    else m_liveLines.push_back({ job, slot, sequence });
+}
+
+bool ConsoleEngine::ViewFile(const std::wstring& path, const std::wstring& name) {
+    if (m_capture) {
+        // TYPE in einer Pipeline: Zeilen statt Anzeige
+        m_capture->job = [path](JobContext& job) { StreamFileLines(job, path); };
+        return true;
+    }
+    auto viewer = std::make_unique<FileViewer>();
+    std::function<void()> progress;
+    if (m_executor) {
+        CommandExecutor* executor = m_executor;
+        progress = [executor] { executor->Wake(); };
+    }
+    std::wstring error;
+    if (!viewer->Open(path, name, std::move(progress), error)) {
+        AddError(L"FEHLER: " + error);
+        return false;
+    }
+    m_viewer = std::move(viewer);
+    m_host.RequestRedraw();
+    return true;
+}
+
+void ConsoleEngine::ListJobs() {
+    std::vector<JobInfo> jobs;
+    if (m_executor) jobs = m_executor->Jobs();
+    if (jobs.empty()) {
+        AddHistory(L"Keine laufenden Jobs.");
+        return;
+    }
+    for (const JobInfo& job : jobs) {
+        std::wstringstream ss;
+        ss << L"[" << job.id << L"] " << std::left << std::setw(10) << (job.running ? L"Laeuft" : L"Wartet")
+            << std::setw(12) << (job.background ? L"Hintergrund" : L"Vordergrund") << job.name;
+        AddHistory(ss.str());
+    }
+}
+
+/**
+ * Liest Argument index als Zahl. Die Argumente zeigen in die nullterminierte Befehlszeile und
+ * enden vor einem Trennzeichen, wcstod liest daher nie ueber das Argument hinaus.
+ */
+bool ConsoleEngine::NumberArgument(const CommandLine& line, size_t index, double& value) {
+    std::wstring_view arg = line.Arg(index);
+    wchar_t* end = nullptr;
+    value = std::wcstod(arg.data(), &end);
+    if (arg.empty() || end != arg.data() + arg.size() || !std::isfinite(value)) {
+        AddError(L"FEHLER: Ungueltige numerische Eingabe.");
+        return false;
+    }
+    return true;
+}
+
+void ConsoleEngine::CmdSqrt(const CommandLine& line) {
+    double n;
+    if (!NumberArgument(line, 0, n)) return;
+    if (n < 0) {
+        AddError(L"FEHLER: Wurzel aus negativer Zahl nicht definiert.");
+        return;
+    }
+    AddHistory(L"sqrt(" + std::wstring(line.Arg(0)) + L") = " + std::to_wstring(std::sqrt(n)));
+}
+
+void ConsoleEngine::CmdPow(const CommandLine& line) {
+    double base, exp;
+    if (!NumberArgument(line, 0, base) || !NumberArgument(line, 1, exp)) return;
+    AddHistory(std::wstring(line.Arg(0)) + L"^" + std::wstring(line.Arg(1)) + L" = " + std::to_wstring(std::pow(base, exp)));
+}
+
+void ConsoleEngine::CmdLog(const CommandLine& line) {
+    double n;
+    if (!NumberArgument(line, 0, n)) return;
+    if (n <= 0) {
+        AddError(L"FEHLER: Logarithmus nur fuer positive Zahlen definiert.");
+        return;
+    }
+    bool log10 = EqualsIgnoreCase(line.Name(), L"LOG10");
+    AddHistory((log10 ? L"log10(" : L"ln(") + std::wstring(line.Arg(0)) + L") = "
+        + std::to_wstring(log10 ? std::log10(n) : std::log(n)));
+}
+
+void ConsoleEngine::CmdTrig(const CommandLine& line) {
+    double deg;
+    if (!NumberArgument(line, 0, deg)) return;
+    // Exakte Reduktion in Grad: SIN 180 und COS 90 ergeben 0 statt 1e-16
+    const wchar_t* name = L"TAN";
+    double result;
+    if (EqualsIgnoreCase(line.Name(), L"SIN")) {
+        name = L"SIN";
+        result = SinDegrees(deg);
+    }
+    else if (EqualsIgnoreCase(line.Name(), L"COS")) {
+        name = L"COS";
+        result = CosDegrees(deg);
+    }
+    else {
+        result = TanDegrees(deg);
+    }
+    AddHistory(name + (L"(" + std::wstring(line.Arg(0)) + L" deg) = ") + std::to_wstring(result));
+}
+
+void ConsoleEngine::CmdCalc(const CommandLine& line) {
+    std::wstring name;
+    std::wstring error;
+    double value;
+    if (!m_calc.Execute(line.Rest(), name, value, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    AddHistory((name.empty() ? std::wstring(line.Rest()) : name) + L" = " + FormatCalcNumber(value));
+}
+
+void ConsoleEngine::CmdTable(const CommandLine& line) {
+    CalcTable table;
+    std::wstring error;
+    if (!m_calc.PrepareTable(line.Rest(), table, error)) {
+        AddError(L"FEHLER: " + error);
+        return;
+    }
+    RunJob(std::wstring(line.Line()), [table](JobContext& job) { RunCalcTable(job, table); });
+}
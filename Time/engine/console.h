@@ -0,0 +1,413 @@
+#pragma once
+
+#include "batch.h"
+#include "calc.h"
+#include "clock.h"
+#include "commands.h"
+#include "completion.h"
+#include "dirwalk.h"
+#include "executor.h"
+#include "line_editor.h"
+#include "netconfig.h"
+#include "netstat.h"
+#include "ping.h"
+#include "pipeline.h"
+#include "scrollback.h"
+#include "search.h"
+#include "session_log.h"
+#include "startup.h"
+#include "sysmon.h"
+#include "top.h"
+#include "viewer.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ConsoleEngine;
+
+/**
+ * Schnittstelle zwischen der plattformneutralen Konsole und dem jeweiligen Frontend
+ * (Win32-Fenster, Headless-Konsole, ...). Das Frontend liefert die Systembefehle
+ * und wird benachrichtigt, wenn sich der Bildschirminhalt geaendert hat.
+ */
+class ConsoleHost {
+public:
+    virtual ~ConsoleHost() = default;
+
+    // Langsame Systembefehle laufen als Job, ggf. auf einem Arbeitsthread: Ausgabe nur ueber
+    // job, kein Zugriff auf die Konsole.
+    virtual void TaskList(JobContext& job) = 0;
+
+    // Echo-Anfragen fuer PING; die Auswertung (Optionen, Statistik, Ausgabe) uebernimmt RunPing.
+    // Wird auf dem Arbeitsthread des Jobs aufgerufen. nullptr = PING nicht verfuegbar.
+    virtual std::unique_ptr<PingProber> CreatePingProber() = 0;
+
+    // Socket-Tabellen fuer NETSTAT; Ausgabe und Vergleich (-r) uebernimmt RunNetstat. Wird auf
+    // dem Arbeitsthread des Jobs aufgerufen. nullptr = NETSTAT nicht verfuegbar.
+    virtual std::unique_ptr<ConnectionSource> CreateConnectionSource() = 0;
+
+    // Adapterkonfiguration mit Aenderungsmeldungen fuer IPCONFIG; die Konsole haelt die Quelle in
+    // einem NetConfigCache. Einmal aufgerufen. nullptr = IPCONFIG nicht verfuegbar.
+    virtual std::unique_ptr<NetConfigSource> CreateNetConfigSource() = 0;
+
+    // Prozessstichproben fuer TOP; Vergleich, Sortierung und Anzeige uebernimmt RunTop. Wird auf
+    // dem Arbeitsthread des Jobs aufgerufen. nullptr = TOP nicht verfuegbar.
+    virtual std::unique_ptr<ProcessSampler> CreateProcessSampler() = 0;
+
+    // Systemzaehler fuer SYSTEMINFO /WATCH; die Konsole haelt den Sampler in einem
+    // SystemMonitor. Einmal aufgerufen. nullptr = /WATCH nicht verfuegbar.
+    virtual std::unique_ptr<SystemSampler> CreateSystemSampler() = 0;
+
+    // Bezugsverzeichnis fuer relative Pfade von DIR, TREE, DU und FIND; den Durchlauf selbst
+    // uebernimmt DirectoryWalker.
+    virtual std::wstring WorkingDirectory() = 0;
+
+    // Schnelle Systembefehle, die vom Betriebssystem abhaengen
+    virtual void SystemInfo(ConsoleEngine& console) = 0;
+    virtual void Vol(ConsoleEngine& console) = 0;
+    // Loest den Dateinamen auf und oeffnet die Datei mit ConsoleEngine::ViewFile.
+    virtual void Type(ConsoleEngine& console, const std::wstring& filename) = 0;
+    virtual void Hostname(ConsoleEngine& console) = 0;
+    virtual void Whoami(ConsoleEngine& console) = 0;
+    virtual void Uptime(ConsoleEngine& console) = 0;
+    // Liefert true, wenn ein Update verfuegbar ist; die Konsole stellt dann die Rueckfrage (Y/N).
+    virtual bool CheckForUpdate(ConsoleEngine& console) = 0;
+    virtual void PerformUpdate(ConsoleEngine& console) = 0;
+
+    // Der Bildschirminhalt hat sich geaendert und sollte neu gezeichnet werden.
+    virtual void RequestRedraw() {}
+
+    // Speicherbelegung des Prozesses fuer PERF (resident bzw. Working Set, privat). false =
+    // nicht verfuegbar.
+    virtual bool ProcessMemory(uint64_t& /*residentBytes*/, uint64_t& /*privateBytes*/) { return false; }
+
+    // Der EXIT-Befehl wurde eingegeben; das Frontend startet den Sekunden-Countdown.
+    virtual void StartCountdown() {}
+
+    // Die Uhr (CLOCK) wurde eingeschaltet; das Frontend ruft ab jetzt zu jeder vollen Sekunde
+    // ConsoleEngine::TickClock() auf, bis die Uhr wieder aus ist.
+    virtual void StartClock() {}
+};
+
+// Tastencodes, die HandleChar gesondert behandelt (identisch mit VK_BACK / VK_ESCAPE bzw. WM_CHAR bei Strg+C)
+const wchar_t KEY_BACKSPACE = 0x08;
+const wchar_t KEY_ESCAPE = 0x1B;
+const wchar_t KEY_CTRL_C = 0x03;
+const wchar_t KEY_TAB = 0x09;
+const wchar_t KEY_CTRL_F = 0x06;
+const wchar_t KEY_CTRL_R = 0x12;
+
+// Tasten ohne Zeichen fuer die Eingabezeile (das Frontend uebersetzt seine Tastencodes)
+enum class EditKey {
+    Left,
+    Right,
+    WordLeft,  // Strg+Links
+    WordRight, // Strg+Rechts
+    Home,
+    End,
+    Delete,
+    Up,        // vorheriger Befehl
+    Down,      // naechster Befehl
+};
+
+extern const std::wstring PROMPT;
+
+/**
+ * Befehlsinterpreter, Konsolenverlauf und Eingabezeile ohne Abhaengigkeit zu einem Fenstersystem.
+ */
+class ConsoleEngine {
+public:
+    explicit ConsoleEngine(ConsoleHost& host);
+
+    // Schreibt den Startbildschirm (MS-DOS-Banner) in den Verlauf.
+    void PrintBanner();
+
+    // Uebernimmt Verlauf und Befehle frueherer Sitzungen (SessionLog::Replay), vor AttachSessionLog.
+    void RestoreSession(const RestoredSession& session);
+
+    // Ab jetzt gehen alle Verlaufszeilen und Befehle in das Protokoll; nullptr beendet das.
+    void AttachSessionLog(SessionLog* log);
+
+    // Zeitpunkte des Programmstarts fuer STARTUP; gehoert dem Frontend.
+    void SetStartupTrace(const StartupTrace* trace) { m_startup = trace; }
+
+    // Zuletzt bestaetigte Befehle, aeltester zuerst (HISTORY).
+    static constexpr size_t MAX_COMMAND_HISTORY = 100;
+    const std::deque<std::wstring>& CommandHistory() const { return m_commandHistory; }
+
+    // Fuegt eine oder mehrere, durch '\n' getrennte Zeilen zum Verlauf hinzu.
+    void AddHistory(const std::wstring& text);
+
+    // Fuegt genau eine Zeile hinzu (auch eine leere).
+    void AddLine(const std::wstring& line);
+
+    // Fehlermeldung: wie AddHistory, geht aber an einer laufenden Pipeline vorbei (wie stderr).
+    void AddError(const std::wstring& text);
+
+    // Fuegt eine Tabelle hinzu; ihre Zeilen werden erst formatiert, wenn sie sichtbar werden.
+    void AddTable(std::shared_ptr<ResultTable> table);
+
+    void ClearHistory();
+
+    // Fuehrt einen Befehl aus, als waere er an der Eingabeaufforderung bestaetigt worden.
+    void ProcessCommand(const std::wstring& command);
+
+    // Befehlstabelle: Zuordnung der Befehlsnamen, HELP und Vervollstaendigung.
+    static const CommandRegistry& Commands();
+
+    // Tastatureingabe: druckbares Zeichen, Backspace, Escape, Tab (vervollstaendigt Befehlsnamen
+    // und Pfade), Strg+C (bricht den laufenden Befehl ab) oder Strg+R/Strg+F (Suche im Verlauf).
+    void HandleChar(wchar_t ch);
+
+    // Cursor bewegen, Entf, Befehle zurueckholen (Pfeil hoch/runter).
+    void HandleKey(EditKey key);
+
+    // Eingefuegter Text (Zwischenablage); jeder Zeilenumbruch fuehrt die Zeile aus.
+    void PasteText(std::wstring_view text);
+
+    // Enter: fuehrt den Inhalt der Eingabezeile aus.
+    void SubmitInput();
+
+    void ClearInput() {
+        m_input.Clear();
+        m_recallBack = 0;
+    }
+
+    void ScrollPageUp();
+    void ScrollPageDown();
+
+    // Zaehlt den EXIT-Countdown herunter. Liefert true, sobald die Anwendung beendet werden soll.
+    bool TickCountdown();
+
+    // Grosse Uhr am oberen Bildschirmrand ein- bzw. ausschalten (CLOCK ON/OFF).
+    void ShowClock(bool visible);
+    bool IsClockVisible() const { return m_clockVisible; }
+
+    // Uebernimmt die aktuelle Sekunde in die Uhr; fordert nur bei einer Aenderung einen Frame an.
+    // Liefert false, wenn die Uhr aus ist. Mit unixSeconds (Headless, Benchmarks) statt Systemzeit.
+    bool TickClock();
+    bool TickClock(int64_t unixSeconds);
+
+    // Die anzuzeigende Uhr oder nullptr (aus bzw. waehrend der Dateianzeige).
+    const ClockPanel* Clock() const { return m_clockVisible && !m_viewer ? &m_clockPanel : nullptr; }
+
+    // Unterste Bildschirmzeile: Eingabeaufforderung mit Cursor, Suchtext oder der Countdown-Text.
+    std::wstring BottomLine(bool cursorVisible) const;
+
+    // Cursor in der untersten Zeile (nicht waehrend des Countdowns) und seine Spalte. Waehrend
+    // eines Vordergrund-Jobs steht wie bei cmd.exe keine Eingabeaufforderung vor der Eingabe.
+    bool ShowsCursor() const { return !m_countdownActive && !m_viewer; }
+    int CursorColumn() const {
+        if (m_search.active) return static_cast<int>(SearchPrefix().size() + m_search.text.size());
+        return static_cast<int>((IsBusy() ? 0 : PROMPT.size()) + m_input.Cursor());
+    }
+
+    // Inkrementelle Suche im Verlauf (Strg+R aeltere, Strg+F neuere Treffer). Solange sie laeuft,
+    // gehen alle Tasten an die Suche; Enter uebernimmt die Position, Esc kehrt zurueck.
+    bool IsSearching() const { return m_search.active; }
+
+    // Hervorzuhebender Treffer: fortlaufende Nummer der Zeile, Spalte und Laenge. false = keiner.
+    bool SearchHighlight(uint64_t& sequence, int& column, int& length) const;
+
+    // Maximale Anzahl Zeilen im Verlauf; aeltere Zeilen werden verdraengt.
+    void SetScrollbackLimit(size_t maxLines);
+
+    // Executor fuer langsame Befehle; ohne Executor (nullptr) laufen sie synchron.
+    // Ein Wechsel schliesst die Dateianzeige, deren Indexthread den alten Executor weckt.
+    void AttachExecutor(CommandExecutor* executor) {
+        if (executor != m_executor) CloseViewer();
+        m_executor = executor;
+    }
+
+    // Uebernimmt Ausgaben und Ende der Jobs in den Verlauf (UI-Thread, nach notify des Executors).
+    void PumpJobs();
+
+    // Ein Befehl im Vordergrund laeuft noch; Eingaben werden bis zu seinem Ende gepuffert.
+    bool IsBusy() const { return m_foregroundJob != 0; }
+
+    // Zeigt eine Datei seitenweise an (TYPE); bis Esc ersetzt sie den Verlauf auf dem Bildschirm.
+    // name erscheint in der Statuszeile. Fehler landen im Verlauf.
+    bool ViewFile(const std::wstring& path, const std::wstring& name);
+    void CloseViewer() { m_viewer.reset(); }
+    bool IsViewing() const { return m_viewer != nullptr; }
+    FileViewer* Viewer() const { return m_viewer.get(); }
+
+    ConsoleHost& Host() { return m_host; }
+    const Scrollback& History() const { return m_history; }
+    const std::wstring& InputBuffer() const { return m_input.Text(); }
+    int ScrollOffset() const { return m_scrollOffset; }
+    bool IsTypingEnabled() const { return m_isTypingEnabled; }
+    bool IsCountdownActive() const { return m_countdownActive; }
+    int CountdownSeconds() const { return m_countdownSeconds; }
+
+private:
+    void ExecuteCommand(const std::wstring& trimmedCommand);
+    void RunCommandLine(const std::wstring& command);
+    void StartPipeline(const std::wstring& command, const std::vector<std::wstring>& stages);
+    bool CaptureOutput(const std::wstring& text);
+    void RunScripts();
+    void SubmitLine(const std::wstring& line);
+    void RunPendingCommands();
+    void RunJob(const std::wstring& name, JobFunction function);
+    void ListJobs();
+    void SetLiveLine(JobId job, uint32_t slot, const std::wstring& text);
+    void CompleteInput();
+    void RecallCommand(bool older);
+    void LogLines(uint64_t first);
+    void AppendTable(std::shared_ptr<ResultTable> table, std::wstring prefix);
+    void RememberCommand(const std::wstring& command);
+    void FollowOutput();
+
+    // Verlaufssuche (Strg+R/Strg+F)
+    void StartSearch(bool backward);
+    void SearchKey(wchar_t ch);
+    void FindMatch(bool next);
+    void EndSearch(bool keepPosition);
+    void ScrollToMatch();
+    std::wstring_view SearchPrefix() const { return m_search.backward ? L"(Suche rueckwaerts) " : L"(Suche vorwaerts) "; }
+
+    // Die Befehle (Eintraege der Befehlstabelle)
+    void CmdHelp(const CommandLine& line);
+    void CmdDate(const CommandLine& line);
+    void CmdTime(const CommandLine& line);
+    void CmdClock(const CommandLine& line);
+    void CmdClear(const CommandLine& line);
+    void CmdHistory(const CommandLine& line);
+    void FindInHistory(std::wstring_view text);
+    void CmdUpdate(const CommandLine& line);
+    void CmdExit(const CommandLine& line);
+    void CmdPing(const CommandLine& line);
+    void CmdIpConfig(const CommandLine& line);
+    void CmdSystemInfo(const CommandLine& line);
+    void CmdStartup(const CommandLine& line);
+    void CmdPerf(const CommandLine& line);
+    void CmdTaskList(const CommandLine& line);
+    void CmdTop(const CommandLine& line);
+    void CmdNetstat(const CommandLine& line);
+    void CmdVol(const CommandLine& line);
+    void CmdDir(const CommandLine& line);
+    void CmdTree(const CommandLine& line);
+    void CmdDiskUsage(const CommandLine& line);
+    void CmdFind(const CommandLine& line);
+    void CmdFindstr(const CommandLine& line);
+    void CmdSort(const CommandLine& line);
+    void CmdCall(const CommandLine& line);
+    void CmdStart(const CommandLine& line);
+    void CmdJobs(const CommandLine& line);
+    void CmdStop(const CommandLine& line);
+    void CmdType(const CommandLine& line);
+    void CmdHostname(const CommandLine& line);
+    void CmdWhoami(const CommandLine& line);
+    void CmdUptime(const CommandLine& line);
+    void CmdVer(const CommandLine& line);
+    void CmdEcho(const CommandLine& line);
+    void CmdCalc(const CommandLine& line);
+    void CmdTable(const CommandLine& line);
+    void CmdBase(const CommandLine& line);
+    void CmdHex(const CommandLine& line);
+    void CmdDec(const CommandLine& line);
+    void CmdSqrt(const CommandLine& line);
+    void CmdPow(const CommandLine& line);
+    void CmdLog(const CommandLine& line);
+    void CmdTrig(const CommandLine& line);
+    bool NumberArgument(const CommandLine& line, size_t index, double& value);
+
+    friend class InlineJobContext;
+
+    ConsoleHost& m_host;
+
+    Scrollback m_history;
+    LineEditor m_input;
+    size_t m_recallBack = 0;     // Pfeil hoch: so viele Befehle zurueck, 0 = eigene Eingabe
+    std::wstring m_recallDraft;  // eigene Eingabe waehrend des Zurueckholens
+    DirectoryIndex m_directories; // Tab-Vervollstaendigung von Pfaden
+    int m_scrollOffset = 0;
+
+    int m_countdownSeconds = 10;
+    bool m_countdownActive = false;
+    bool m_isTypingEnabled = true;
+    bool m_awaitingUpdateConfirmation = false;
+
+    // Jobs
+    struct BackgroundJob {
+        JobId id;
+        std::wstring name;
+    };
+
+    // Statuszeile eines Jobs: fortlaufende Nummer der Verlaufszeile, die ersetzt wird
+    struct LiveLine {
+        JobId job;
+        uint32_t slot;
+        uint64_t sequence;
+    };
+
+    CommandExecutor* m_executor = nullptr;
+    JobId m_foregroundJob = 0;
+    bool m_runInBackground = false;        // waehrend START <befehl>
+    std::vector<BackgroundJob> m_backgroundJobs;
+    std::vector<JobEvent> m_jobEvents;
+    std::wstring m_jobLine; // PumpJobs: Zeile eines Hintergrundjobs mit Jobnummer
+    std::vector<LiveLine> m_liveLines;
+    std::deque<std::wstring> m_pendingCommands; // waehrend eines Vordergrund-Jobs bestaetigte Zeilen
+
+    // Erste Stufe einer Pipeline: ihre Ausgabe bzw. der Job, den sie gestartet haette
+    struct PipeCapture {
+        std::wstring text;
+        JobFunction job;
+    };
+    PipeCapture* m_capture = nullptr; // nur waehrend StartPipeline
+
+    // Laufende Batchdateien (CALL), innerste zuletzt. Eine Anweisung, die einen Job startet,
+    // haelt die Ausfuehrung an; nach dem Job geht es weiter (RunPendingCommands).
+    struct ScriptFrame {
+        std::shared_ptr<const BatchScript> script;
+        std::vector<std::wstring> arguments; // %0 = Name der Datei
+        size_t next = 0;
+        bool echo = true;
+    };
+    static constexpr size_t MAX_CALL_DEPTH = 16;
+    static constexpr size_t MAX_SCRIPT_STEPS = 100000; // ohne Job dazwischen: Endlosschleife
+    std::vector<ScriptFrame> m_scripts;
+    ScriptCache m_scriptCache;
+    bool m_runningScripts = false;
+
+    std::unique_ptr<FileViewer> m_viewer;
+
+    // Beim ersten IPCONFIG angelegt; laufende Jobs halten eine eigene Referenz.
+    std::shared_ptr<NetConfigCache> m_netConfig;
+    // Beim ersten SYSTEMINFO /WATCH gestartet, laeuft danach im Hintergrund weiter.
+    std::shared_ptr<SystemMonitor> m_systemMonitor;
+
+    // Laufende Verlaufssuche. sequence ist der Treffer bzw. die Stelle, ab der weitergesucht wird
+    // (fortlaufende Zeilennummer, ueberlebt neue Ausgaben); origin die Stelle beim Start.
+    struct HistorySearch {
+        bool active = false;
+        bool backward = true;
+        bool found = false;
+        std::wstring text;
+        uint64_t sequence = 0;
+        size_t column = 0;
+        uint64_t origin = 0;
+        int savedScrollOffset = 0;
+    };
+    HistorySearch m_search;
+    std::wstring m_lastSearch; // Strg+R mit leerem Suchtext sucht wieder danach
+
+    SessionLog* m_log = nullptr;
+    const StartupTrace* m_startup = nullptr;
+    std::deque<std::wstring> m_commandHistory;
+
+    Calculator m_calc; // Variablen und uebersetzte Ausdruecke von CALC/TABLE
+
+    bool m_clockVisible = false;
+    ClockFormatter m_clockTime;
+    ClockPanel m_clockPanel;
+};
+
+// Hilfsfunktionen, die auch von den Frontends verwendet werden
+std::wstring ToUpper(const std::wstring& str);
+std::wstring GetCurrentTimeString();
+std::wstring GetCurrentDateString();
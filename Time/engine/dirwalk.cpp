@@ -0,0 +1,617 @@
+#include "dirwalk.h"
+#include "clock.h"
+#include "top.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cwchar>
+#include <cwctype>
+#include <string_view>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "utf8.h"
+
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool IsSeparator(wchar_t c) {
+#ifdef _WIN32
+    return c == L'\\' || c == L'/';
+#else
+    return c == L'/';
+#endif
+}
+
+// Ohne Ruecksicht auf Gross-/Kleinschreibung, bei Gleichstand ordinal (POSIX erlaubt "a" und "A")
+bool NameLess(const DirectoryEntry& a, const DirectoryEntry& b) {
+    size_t length = std::min(a.name.size(), b.name.size());
+    for (size_t i = 0; i < length; ++i) {
+        wchar_t x = static_cast<wchar_t>(std::towlower(a.name[i]));
+        wchar_t y = static_cast<wchar_t>(std::towlower(b.name[i]));
+        if (x != y) return x < y;
+    }
+    if (a.name.size() != b.name.size()) return a.name.size() < b.name.size();
+    return a.name < b.name;
+}
+
+#ifndef _WIN32
+std::wstring ErrnoText(int code) {
+    switch (code) {
+    case EACCES:
+    case EPERM: return L"Zugriff verweigert";
+    case ENOENT: return L"Verzeichnis nicht gefunden";
+    case ENOTDIR: return L"Kein Verzeichnis";
+    default: return L"Verzeichnis konnte nicht gelesen werden";
+    }
+}
+#endif
+
+// Zerlegt die Argumente von DIR, TREE und DU. Optionen (-x oder /x) duerfen vor und nach dem
+// Pfad stehen; alles andere ist der Pfad, in Anfuehrungszeichen auch mit mehreren Leerzeichen.
+bool ParseWalkArguments(const std::wstring& arguments, const wchar_t* allowed, const wchar_t* usage, WalkOptions& options,
+    std::wstring& error) {
+    std::vector<std::wstring> parts;
+    size_t pos = 0;
+    while (pos < arguments.size()) {
+        if (std::iswspace(arguments[pos])) {
+            ++pos;
+            continue;
+        }
+        if (arguments[pos] == L'"') {
+            size_t end = arguments.find(L'"', pos + 1);
+            if (end == std::wstring::npos) end = arguments.size();
+            parts.push_back(arguments.substr(pos + 1, end - pos - 1));
+            pos = end + 1;
+            continue;
+        }
+        size_t end = pos;
+        while (end < arguments.size() && !std::iswspace(arguments[end])) ++end;
+        std::wstring token = arguments.substr(pos, end - pos);
+        pos = end;
+
+        bool isOption = token.size() == 2 && (token[0] == L'-' || token[0] == L'/') && std::iswalpha(token[1]);
+        if (!isOption) {
+            parts.push_back(token);
+            continue;
+        }
+        wchar_t option = static_cast<wchar_t>(std::towlower(token[1]));
+        if (!wcschr(allowed, option)) {
+            error = L"Ungueltige Option '" + token + L"' (erlaubt: " + usage + L").";
+            return false;
+        }
+        if (option == L's') options.recursive = true;
+        if (option == L'f') options.files = true;
+        if (option == L'l') {
+            while (pos < arguments.size() && std::iswspace(arguments[pos])) ++pos;
+            size_t valueEnd = pos;
+            while (valueEnd < arguments.size() && !std::iswspace(arguments[valueEnd])) ++valueEnd;
+            std::wstring value = arguments.substr(pos, valueEnd - pos);
+            pos = valueEnd;
+            if (value.empty()) {
+                error = L"Wert fuer Option '" + token + L"' fehlt.";
+                return false;
+            }
+            bool digits = value.size() <= 2 && std::all_of(value.begin(), value.end(), [](wchar_t c) { return c >= L'0' && c <= L'9'; });
+            unsigned long levels = digits ? wcstoul(value.c_str(), nullptr, 10) : 0;
+            if (levels < 1 || levels > 64) {
+                error = L"Ungueltiger Wert '" + value + L"' fuer Option '" + token + L"' (erlaubt: 1 bis 64).";
+                return false;
+            }
+            options.levels = static_cast<uint32_t>(levels);
+        }
+    }
+    options.path.clear();
+    for (const std::wstring& part : parts) {
+        if (!options.path.empty()) options.path += L' ';
+        options.path += part;
+    }
+    return true;
+}
+
+std::wstring SummaryLine(uint64_t count, const wchar_t* label) {
+    wchar_t text[96];
+    swprintf(text, 96, L"%16ls %ls", GroupDigits(count).c_str(), label);
+    return text;
+}
+
+std::wstring FilesLine(uint64_t files, uint64_t bytes) {
+    wchar_t text[96];
+    swprintf(text, 96, L"%16ls Datei(en),%15ls Bytes", GroupDigits(files).c_str(), GroupDigits(bytes).c_str());
+    return text;
+}
+
+// "17.10.2026  08:12    <DIR>          name" bzw. mit Groesse rechtsbuendig
+void FormatEntry(std::wstring& line, ClockFormatter& clock, const DirectoryEntry& entry) {
+    const LocalTime& time = clock.At(entry.modified);
+    line.assign(time.date, 10);
+    line += L"  ";
+    line.append(time.time, 5);
+    if (entry.directory) {
+        line += entry.link ? L"    <JUNCTION>     " : L"    <DIR>          ";
+    }
+    else if (entry.link) {
+        line += L"    <SYMLINK>      ";
+    }
+    else {
+        wchar_t size[32];
+        swprintf(size, 32, L"%18ls ", GroupDigits(entry.size).c_str());
+        line += size;
+    }
+    line += entry.name;
+}
+
+void ReportUnreadable(OutputBlock& out, uint64_t unreadable) {
+    if (unreadable > 0) {
+        out.AddError(L"FEHLER: " + GroupDigits(unreadable) + L" Verzeichnis(se) konnten nicht gelesen werden.");
+    }
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+bool ReadDirectory(const std::wstring& path, EntryDetail, std::vector<DirectoryEntry>& entries, std::wstring& error) {
+    std::wstring pattern = JoinPath(path, L"*");
+    WIN32_FIND_DATAW data;
+    // Nur Basisinformationen (kein 8.3-Name) und groessere Abrufe je Systemaufruf
+    HANDLE find = FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (find == INVALID_HANDLE_VALUE) {
+        DWORD code = GetLastError();
+        if (code == ERROR_FILE_NOT_FOUND) return true; // leer
+        error = code == ERROR_ACCESS_DENIED ? L"Zugriff verweigert"
+            : code == ERROR_PATH_NOT_FOUND ? L"Verzeichnis nicht gefunden"
+            : code == ERROR_DIRECTORY ? L"Kein Verzeichnis"
+            : L"Verzeichnis konnte nicht gelesen werden";
+        return false;
+    }
+    do {
+        const wchar_t* name = data.cFileName;
+        if (name[0] == L'.' && (name[1] == L'\0' || (name[1] == L'.' && name[2] == L'\0'))) continue;
+        DirectoryEntry& entry = entries.emplace_back();
+        entry.name = name;
+        entry.directory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.link = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+        entry.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        // 100-ns-Schritte seit 1601 -> Sekunden seit 1970
+        uint64_t ticks = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        entry.modified = static_cast<int64_t>(ticks / 10000000) - 11644473600LL;
+    } while (FindNextFileW(find, &data));
+    FindClose(find);
+    return true;
+}
+
+bool DirectoryStamp(const std::wstring& path, int64_t& stamp) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data)) return false;
+    uint64_t ticks = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    stamp = (static_cast<int64_t>(ticks) - 116444736000000000LL) * 100;
+    return true;
+}
+
+#else
+
+bool ReadDirectory(const std::wstring& path, EntryDetail detail, std::vector<DirectoryEntry>& entries, std::wstring& error) {
+    std::string native = WideToUtf8(path);
+    int fd = open(native.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR* dir = fd >= 0 ? fdopendir(fd) : nullptr;
+    if (!dir) {
+        error = ErrnoText(errno);
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    // readdir liest ueber getdents64 in grossen Bloecken; stat nur relativ zum offenen
+    // Verzeichnis und nur, wo d_type nicht reicht
+    while (dirent* item = readdir(dir)) {
+        const char* name = item->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+        DirectoryEntry& entry = entries.emplace_back();
+        entry.name = Utf8ToWide(name);
+        entry.directory = item->d_type == DT_DIR;
+        entry.link = item->d_type == DT_LNK;
+        if (detail == EntryDetail::Names && item->d_type != DT_UNKNOWN) continue;
+        if (entry.directory && detail == EntryDetail::Files) continue;
+        struct stat info;
+        if (fstatat(dirfd(dir), name, &info, AT_SYMLINK_NOFOLLOW) != 0) continue; // inzwischen geloescht
+        entry.directory = S_ISDIR(info.st_mode);
+        entry.link = S_ISLNK(info.st_mode);
+        entry.size = entry.directory ? 0 : static_cast<uint64_t>(info.st_size);
+        entry.modified = static_cast<int64_t>(info.st_mtime);
+    }
+    closedir(dir);
+    return true;
+}
+
+bool DirectoryStamp(const std::wstring& path, int64_t& stamp) {
+    struct stat info;
+    if (stat(WideToUtf8(path).c_str(), &info) != 0) return false;
+    stamp = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+    return true;
+}
+
+#endif
+
+std::wstring JoinPath(const std::wstring& directory, const std::wstring& name) {
+    std::wstring path;
+    path.reserve(directory.size() + name.size() + 1);
+    path = directory;
+    if (!path.empty() && !IsSeparator(path.back())) path += PATH_SEPARATOR;
+    path += name;
+    return path;
+}
+
+size_t LastSeparator(const std::wstring& path) {
+#ifdef _WIN32
+    return path.find_last_of(L"\\/");
+#else
+    return path.rfind(L'/');
+#endif
+}
+
+std::wstring ResolvePath(const std::wstring& base, const std::wstring& path) {
+    if (path.empty() || path == L".") return base;
+#ifdef _WIN32
+    bool absolute = (path.size() >= 2 && path[1] == L':') || IsSeparator(path[0]);
+#else
+    bool absolute = IsSeparator(path[0]);
+#endif
+    return absolute ? path : JoinPath(base, path);
+}
+
+DirectoryWalker::DirectoryWalker(const Options& options)
+    : m_options(options) {
+}
+
+DirectoryWalker::~DirectoryWalker() {
+    Stop();
+}
+
+void DirectoryWalker::Start(const std::wstring& root) {
+    m_root = std::make_unique<DirectoryNode>();
+    m_root->path = root;
+    m_root->name = root;
+
+    unsigned threads = m_options.threads;
+    if (threads == 0) threads = std::clamp(std::thread::hardware_concurrency(), 1u, MAX_THREADS);
+    if (m_options.maxDepth == 0) threads = 1;
+
+    m_queues.clear();
+    for (unsigned i = 0; i < threads; ++i) m_queues.push_back(std::make_unique<Queue>());
+    m_scratch.assign(threads, {});
+    m_remaining = 1;
+    m_queues[0]->nodes.push_back(m_root.get());
+    for (unsigned i = 0; i < threads; ++i) {
+        m_workers.emplace_back(&DirectoryWalker::WorkerLoop, this, i);
+    }
+}
+
+void DirectoryWalker::Stop() {
+    m_stop = true;
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+    }
+    m_workAvailable.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+    m_workers.clear();
+}
+
+void DirectoryWalker::WorkerLoop(unsigned self) {
+    while (!m_stop) {
+        DirectoryNode* node = Take(self);
+        if (!node) {
+            if (m_remaining == 0) return;
+            // Andere Threads lesen noch und reihen vielleicht neue Verzeichnisse ein
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            ++m_idle;
+            m_workAvailable.wait_for(lock, std::chrono::milliseconds(1));
+            --m_idle;
+            continue;
+        }
+        List(*node, self);
+        if (m_remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            m_workAvailable.notify_all();
+        }
+    }
+}
+
+DirectoryNode* DirectoryWalker::Take(unsigned self) {
+    {
+        Queue& own = *m_queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.nodes.empty()) {
+            DirectoryNode* node = own.nodes.back();
+            own.nodes.pop_back();
+            return node;
+        }
+    }
+    const size_t count = m_queues.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Queue& other = *m_queues[(self + offset) % count];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.nodes.empty()) {
+            DirectoryNode* node = other.nodes.front();
+            other.nodes.pop_front();
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+void DirectoryWalker::List(DirectoryNode& node, unsigned self) {
+    std::vector<DirectoryEntry>& entries = m_scratch[self];
+    entries.clear();
+    if (ReadDirectory(node.path, m_options.details ? EntryDetail::All : EntryDetail::Files, entries, node.error)) {
+        std::sort(entries.begin(), entries.end(), NameLess);
+        m_scanned.fetch_add(entries.size(), std::memory_order_relaxed);
+        for (const DirectoryEntry& entry : entries) {
+            if (!entry.directory) {
+                ++node.files;
+                node.bytes += entry.size;
+                continue;
+            }
+            ++node.directories;
+            if (entry.link || node.depth >= m_options.maxDepth) continue;
+            auto child = std::make_unique<DirectoryNode>();
+            child->path = JoinPath(node.path, entry.name);
+            child->name = entry.name;
+            child->parent = &node;
+            child->depth = node.depth + 1;
+            child->index = static_cast<uint32_t>(node.children.size());
+            node.children.push_back(std::move(child));
+        }
+        if (m_options.keepEntries) node.entries.swap(entries);
+    }
+
+    if (!node.children.empty()) {
+        m_remaining.fetch_add(node.children.size());
+        Queue& own = *m_queues[self];
+        {
+            // Rueckwaerts, damit das erste Unterverzeichnis als naechstes gelesen wird
+            std::lock_guard<std::mutex> lock(own.mutex);
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) own.nodes.push_back(it->get());
+        }
+        if (m_idle > 0) m_workAvailable.notify_all();
+    }
+
+    node.listed.store(true);
+    if (m_waiting.load() == &node) {
+        std::lock_guard<std::mutex> lock(m_listedMutex);
+        m_listedChanged.notify_one();
+    }
+}
+
+bool DirectoryWalker::Wait(JobContext& job, DirectoryNode& node) {
+    if (node.listed.load(std::memory_order_acquire)) return true;
+    std::unique_lock<std::mutex> lock(m_listedMutex);
+    m_waiting.store(&node);
+    while (!node.listed.load()) {
+        if (job.Cancelled()) {
+            m_waiting.store(nullptr);
+            return false;
+        }
+        m_listedChanged.wait_for(lock, std::chrono::milliseconds(50));
+    }
+    m_waiting.store(nullptr);
+    return true;
+}
+
+bool DirectoryWalker::Next(JobContext& job, WalkStep& step) {
+    if (job.Cancelled() || !m_root) return false;
+    if (!m_begun) {
+        m_begun = true;
+        if (!Wait(job, *m_root)) return false;
+        m_stack.push_back({ m_root.get(), 0 });
+        step = { m_root.get(), false };
+        return true;
+    }
+    if (m_stack.empty()) return false;
+
+    Frame& top = m_stack.back();
+    if (top.next < top.node->children.size()) {
+        DirectoryNode* child = top.node->children[top.next++].get();
+        if (!Wait(job, *child)) return false;
+        m_stack.push_back({ child, 0 });
+        step = { child, false };
+        return true;
+    }
+
+    // Alle Unterverzeichnisse verlassen: Summen bilden, Teilbaum und Eintraege freigeben
+    DirectoryNode& node = *top.node;
+    m_stack.pop_back();
+    node.totalFiles += node.files;
+    node.totalBytes += node.bytes;
+    node.totalDirectories += node.directories;
+    if (!node.error.empty()) ++node.unreadable;
+    if (!m_stack.empty()) {
+        DirectoryNode& parent = *m_stack.back().node;
+        parent.totalFiles += node.totalFiles;
+        parent.totalBytes += node.totalBytes;
+        parent.totalDirectories += node.totalDirectories;
+        parent.unreadable += node.unreadable;
+    }
+    std::vector<std::unique_ptr<DirectoryNode>>().swap(node.children);
+    std::vector<DirectoryEntry>().swap(node.entries);
+    step = { &node, true };
+    return true;
+}
+
+bool ParseDirArguments(const std::wstring& arguments, WalkOptions& options, std::wstring& error) {
+    return ParseWalkArguments(arguments, L"s", L"/S", options, error);
+}
+
+bool ParseTreeArguments(const std::wstring& arguments, WalkOptions& options, std::wstring& error) {
+    return ParseWalkArguments(arguments, L"f", L"/F", options, error);
+}
+
+bool ParseDiskUsageArguments(const std::wstring& arguments, WalkOptions& options, std::wstring& error) {
+    return ParseWalkArguments(arguments, L"l", L"-l <tiefe>", options, error);
+}
+
+std::wstring GroupDigits(uint64_t value) {
+    wchar_t digits[32];
+    int length = swprintf(digits, 32, L"%llu", static_cast<unsigned long long>(value));
+    std::wstring text;
+    text.reserve(length + length / 3);
+    for (int i = 0; i < length; ++i) {
+        if (i > 0 && (length - i) % 3 == 0) text += L'.';
+        text += digits[i];
+    }
+    return text;
+}
+
+void RunDir(JobContext& job, const std::wstring& base, const WalkOptions& options) {
+    DirectoryWalker::Options walk;
+    walk.keepEntries = true;
+    walk.details = true;
+    walk.maxDepth = options.recursive ? ~0u : 0;
+    DirectoryWalker walker(walk);
+    walker.Start(ResolvePath(base, options.path));
+
+    OutputBlock out(job);
+    ClockFormatter clock;
+    std::wstring line;
+    WalkStep step;
+    const DirectoryNode* root = nullptr;
+    while (walker.Next(job, step)) {
+        const DirectoryNode& node = *step.node;
+        if (step.leave) {
+            if (node.depth == 0) root = &node;
+            continue;
+        }
+        if (!node.error.empty()) {
+            if (node.depth == 0) {
+                job.AddError(L"FEHLER: " + node.error + L": " + node.path);
+                return;
+            }
+            out.AddError(L"FEHLER: " + node.error + L": " + node.path);
+            out.Add(L"");
+            continue;
+        }
+
+        out.Add(L" Verzeichnis von " + node.path);
+        out.Add(L"");
+        for (const DirectoryEntry& entry : node.entries) {
+            FormatEntry(line, clock, entry);
+            out.Add(line);
+        }
+        out.Add(FilesLine(node.files, node.bytes));
+        if (!options.recursive) out.Add(SummaryLine(node.directories, L"Verzeichnis(se)"));
+        else out.Add(L"");
+    }
+    if (!root || !options.recursive) return;
+
+    out.Add(L"     Anzahl der angezeigten Dateien:");
+    out.Add(FilesLine(root->totalFiles, root->totalBytes));
+    out.Add(SummaryLine(root->totalDirectories, L"Verzeichnis(se)"));
+    ReportUnreadable(out, root->unreadable);
+}
+
+void RunTree(JobContext& job, const std::wstring& base, const WalkOptions& options) {
+    static const wchar_t BRANCH[] = L"\x251C\x2500\x2500\x2500"; // |---
+    static const wchar_t LAST[] = L"\x2514\x2500\x2500\x2500";   // `---
+    static const wchar_t PIPE[] = L"\x2502   ";
+    static const wchar_t SPACE[] = L"    ";
+
+    DirectoryWalker::Options walk;
+    walk.keepEntries = options.files;
+    DirectoryWalker walker(walk);
+    walker.Start(ResolvePath(base, options.path));
+
+    OutputBlock out(job);
+    std::wstring prefix;
+    WalkStep step;
+    const DirectoryNode* root = nullptr;
+    while (walker.Next(job, step)) {
+        const DirectoryNode& node = *step.node;
+        if (step.leave) {
+            if (node.depth == 0) root = &node;
+            else prefix.resize(prefix.size() - 4);
+            continue;
+        }
+        if (node.depth == 0) {
+            if (!node.error.empty()) {
+                job.AddError(L"FEHLER: " + node.error + L": " + node.path);
+                return;
+            }
+            out.Add(L"Auflistung der Ordnerpfade");
+            out.Add(node.path);
+        }
+        else {
+            bool last = node.index + 1 == node.parent->children.size();
+            out.Add(prefix + (last ? LAST : BRANCH) + node.name);
+            prefix += last ? SPACE : PIPE;
+        }
+        if (!node.error.empty()) out.Add(prefix + L"(" + node.error + L")");
+        if (options.files) {
+            std::wstring filePrefix = prefix + (node.children.empty() ? SPACE : PIPE);
+            bool any = false;
+            for (const DirectoryEntry& entry : node.entries) {
+                if (entry.directory) continue;
+                out.Add(filePrefix + entry.name);
+                any = true;
+            }
+            if (any) out.Add(filePrefix);
+        }
+    }
+    if (root && root->totalDirectories == 0) out.Add(L"Es sind keine Unterordner vorhanden.");
+}
+
+void RunDiskUsage(JobContext& job, const std::wstring& base, const WalkOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const std::wstring path = ResolvePath(base, options.path);
+
+    DirectoryWalker walker(DirectoryWalker::Options{});
+    walker.Start(path);
+    job.SetLiveLine(L"Durchsuche " + path + L" ...");
+
+    OutputBlock out(job);
+    WalkStep step;
+    const DirectoryNode* root = nullptr;
+    Clock::time_point nextProgress = start + std::chrono::milliseconds(250);
+    while (walker.Next(job, step)) {
+        const DirectoryNode& node = *step.node;
+        if (!step.leave) {
+            if (node.depth == 0 && !node.error.empty()) {
+                job.AddError(L"FEHLER: " + node.error + L": " + node.path);
+                return;
+            }
+        }
+        else if (node.depth == 0) {
+            root = &node;
+        }
+        else if (node.depth <= options.levels) {
+            wchar_t size[32];
+            swprintf(size, 32, L"%15ls  ", GroupDigits(node.totalBytes).c_str());
+            out.Add(size + node.path);
+        }
+        Clock::time_point now = Clock::now();
+        if (now >= nextProgress) {
+            nextProgress = now + std::chrono::milliseconds(250);
+            job.SetLiveLine(L"Durchsucht: " + GroupDigits(walker.ScannedEntries()) + L" Eintraege ...");
+        }
+    }
+    if (!root) return;
+    out.Flush();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    wchar_t text[128];
+    swprintf(text, 128, L"Durchsucht: %ls Eintraege in %.2f s (%u Threads, %llu Verzeichnisse uebernommen)",
+        GroupDigits(walker.ScannedEntries()).c_str(), seconds, walker.Threads(),
+        static_cast<unsigned long long>(walker.Steals()));
+    job.SetLiveLine(text);
+
+    out.Add(L"Dateien:        " + GroupDigits(root->totalFiles));
+    out.Add(L"Verzeichnisse:  " + GroupDigits(root->totalDirectories));
+    out.Add(L"Groesse:        " + GroupDigits(root->totalBytes) + L" Bytes (" + FormatBytes(root->totalBytes) + L")");
+    ReportUnreadable(out, root->unreadable);
+}
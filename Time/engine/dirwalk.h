@@ -0,0 +1,185 @@
+#pragma once
+
+#include "executor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Ein Eintrag eines Verzeichnisses.
+ */
+struct DirectoryEntry {
+    std::wstring name;
+    uint64_t size = 0;
+    int64_t modified = 0;   // Unix-Sekunden; nur mit details
+    bool directory = false;
+    bool link = false;      // symbolischer Link bzw. Junction: wird nicht betreten
+};
+
+// Was ReadDirectory ausser Name und Art (Verzeichnis, Link) bestimmt.
+enum class EntryDetail {
+    Names, // nichts weiter (Vervollstaendigung); POSIX: stat nur, wo readdir keinen Typ liefert
+    Files, // Groesse und Zeit fuer Dateien
+    All,   // Groesse und Zeit auch fuer Verzeichnisse (DIR)
+};
+
+// Liest die Eintraege von path ohne "." und ".." (Win32: FindFirstFileExW mit grossen Abrufen,
+// sonst readdir/fstatat relativ zum geoeffneten Verzeichnis). Liefert false und eine Meldung,
+// wenn path nicht lesbar ist.
+bool ReadDirectory(const std::wstring& path, EntryDetail detail, std::vector<DirectoryEntry>& entries, std::wstring& error);
+
+// Letzte Aenderung des Verzeichnisses selbst (Eintrag angelegt, geloescht, umbenannt) in
+// Nanosekunden seit 1970. false, wenn path nicht lesbar ist.
+bool DirectoryStamp(const std::wstring& path, int64_t& stamp);
+
+#ifdef _WIN32
+constexpr wchar_t PATH_SEPARATOR = L'\\';
+#else
+constexpr wchar_t PATH_SEPARATOR = L'/';
+#endif
+
+// Macht path relativ zu base absolut; absolute Pfade bleiben unveraendert.
+std::wstring ResolvePath(const std::wstring& base, const std::wstring& path);
+
+// Haengt name mit dem Trennzeichen des Systems an directory an.
+std::wstring JoinPath(const std::wstring& directory, const std::wstring& name);
+
+// Position des letzten Trennzeichens in path oder npos.
+size_t LastSeparator(const std::wstring& path);
+
+/**
+ * Ein Verzeichnis im Baum des DirectoryWalker. Die Summen des Teilbaums sind erst gueltig, wenn
+ * der Knoten verlassen wird (WalkStep::leave).
+ */
+struct DirectoryNode {
+    std::wstring path;
+    std::wstring name;
+    const DirectoryNode* parent = nullptr;
+    uint32_t depth = 0;
+    uint32_t index = 0;  // Position unter den betretenen Geschwistern
+    std::wstring error;  // nicht lesbar
+
+    std::vector<DirectoryEntry> entries; // nur mit keepEntries, nach Namen sortiert
+    std::vector<std::unique_ptr<DirectoryNode>> children; // betretene Unterverzeichnisse, sortiert
+
+    uint64_t files = 0;        // eigene Dateien
+    uint64_t bytes = 0;
+    uint64_t directories = 0;  // eigene Unterverzeichnisse (auch nicht betretene)
+    uint64_t totalFiles = 0;   // ganzer Teilbaum, beim Verlassen
+    uint64_t totalBytes = 0;
+    uint64_t totalDirectories = 0;
+    uint64_t unreadable = 0;   // nicht lesbare Verzeichnisse im Teilbaum, beim Verlassen
+
+    std::atomic<bool> listed{ false };
+};
+
+struct WalkStep {
+    const DirectoryNode* node = nullptr;
+    bool leave = false; // false = betreten (Eintraege gelesen), true = Teilbaum fertig
+};
+
+/**
+ * Paralleler Verzeichnisdurchlauf. Jeder Arbeitsthread hat eine eigene Warteschlange: neue
+ * Unterverzeichnisse kommen hinten hinein und werden dort auch wieder entnommen (Tiefensuche,
+ * gute Lokalitaet); ein Thread ohne Arbeit stiehlt vorne aus fremden Warteschlangen, also die
+ * aeltesten und meist groessten Teilbaeume.
+ *
+ * Der Aufrufer erhaelt die Verzeichnisse mit Next() trotzdem in fester Tiefensuche-Reihenfolge
+ * (nach Namen sortiert): er wartet nur, solange das naechste Verzeichnis noch nicht gelesen
+ * ist. Die Ausgabe ist damit gestreamt und unabhaengig von der Anzahl Threads. Eintraege und
+ * Unterbaeume werden beim Verlassen freigegeben.
+ */
+class DirectoryWalker {
+public:
+    struct Options {
+        bool keepEntries = false;   // DirectoryNode::entries fuellen
+        bool details = false;       // Zeit und Groesse auch fuer Verzeichnisse (DIR)
+        uint32_t maxDepth = ~0u;    // 0 = nur die Wurzel lesen
+        unsigned threads = 0;       // 0 = je logischem Prozessor, hoechstens MAX_THREADS
+    };
+
+    static constexpr unsigned MAX_THREADS = 16;
+
+    explicit DirectoryWalker(const Options& options);
+    ~DirectoryWalker();
+
+    DirectoryWalker(const DirectoryWalker&) = delete;
+    DirectoryWalker& operator=(const DirectoryWalker&) = delete;
+
+    void Start(const std::wstring& root);
+
+    // Naechster Schritt; false am Ende oder sobald job abgebrochen wurde.
+    bool Next(JobContext& job, WalkStep& step);
+
+    unsigned Threads() const { return static_cast<unsigned>(m_workers.size()); }
+    uint64_t ScannedEntries() const { return m_scanned.load(std::memory_order_relaxed); }
+    uint64_t Steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<DirectoryNode*> nodes;
+    };
+
+    struct Frame {
+        DirectoryNode* node;
+        size_t next;
+    };
+
+    void WorkerLoop(unsigned self);
+    DirectoryNode* Take(unsigned self);
+    void List(DirectoryNode& node, unsigned self);
+    bool Wait(JobContext& job, DirectoryNode& node);
+    void Stop();
+
+    Options m_options;
+    std::unique_ptr<DirectoryNode> m_root;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::vector<DirectoryEntry>> m_scratch; // je Thread
+    std::vector<std::thread> m_workers;
+
+    std::atomic<size_t> m_remaining{ 0 }; // eingereihte, noch nicht gelesene Verzeichnisse
+    std::atomic<bool> m_stop{ false };
+    std::atomic<uint64_t> m_scanned{ 0 };
+    std::atomic<uint64_t> m_steals{ 0 };
+
+    std::mutex m_idleMutex;
+    std::condition_variable m_workAvailable;
+    std::atomic<unsigned> m_idle{ 0 };
+
+    std::mutex m_listedMutex;
+    std::condition_variable m_listedChanged;
+    std::atomic<DirectoryNode*> m_waiting{ nullptr };
+
+    std::vector<Frame> m_stack; // nur Aufrufer von Next()
+    bool m_begun = false;
+};
+
+/**
+ * Optionen von DIR, TREE und DU.
+ */
+struct WalkOptions {
+    bool recursive = false; // DIR /S
+    bool files = false;     // TREE /F
+    uint32_t levels = 0;    // DU -l <tiefe>: Summen bis zu dieser Tiefe einzeln ausgeben
+    std::wstring path;      // leer = Arbeitsverzeichnis
+};
+
+bool ParseDirArguments(const std::wstring& arguments, WalkOptions& options, std::wstring& error);
+bool ParseTreeArguments(const std::wstring& arguments, WalkOptions& options, std::wstring& error);
+bool ParseDiskUsageArguments(const std::wstring& arguments, WalkOptions& options, std::wstring& error);
+
+// "1.234.567"
+std::wstring GroupDigits(uint64_t value);
+
+// Befehle; base ist das Arbeitsverzeichnis des Frontends, relative Pfade beziehen sich darauf.
+void RunDir(JobContext& job, const std::wstring& base, const WalkOptions& options);
+void RunTree(JobContext& job, const std::wstring& base, const WalkOptions& options);
+void RunDiskUsage(JobContext& job, const std::wstring& base, const WalkOptions& options);
@@ -0,0 +1,275 @@
+#include "executor.h"
+#include "perf.h"
+
+#include <algorithm>
+
+/**
+ * JobContext eines Arbeitsthreads: Ausgaben gehen in den Postausgang des Executors.
+ */
+class CommandExecutor::WorkerContext : public JobContext {
+public:
+    WorkerContext(CommandExecutor& executor, const Job& job)
+        : m_executor(executor), m_job(job) {
+    }
+
+    void AddHistory(const std::wstring& text) override {
+        m_executor.Post({ .type = JobEvent::Type::Output, .job = m_job.id, .text = text });
+    }
+
+    void SetLiveLine(uint32_t slot, const std::wstring& text) override {
+        m_executor.Post({ .type = JobEvent::Type::Live, .job = m_job.id, .text = text, .slot = slot });
+    }
+
+    void AddTable(std::shared_ptr<ResultTable> table) override {
+        m_executor.Post({ .type = JobEvent::Type::Table, .job = m_job.id, .table = std::move(table) });
+    }
+
+    bool Cancelled() const override {
+        return m_job.cancelled.load(std::memory_order_relaxed);
+    }
+
+    bool Sleep(uint32_t milliseconds) override {
+        return m_executor.SleepFor(m_job, milliseconds);
+    }
+
+private:
+    CommandExecutor& m_executor;
+    const Job& m_job;
+};
+
+OutputBlock::OutputBlock(JobContext& job)
+    : m_job(job), m_lastFlush(std::chrono::steady_clock::now()) {
+}
+
+void OutputBlock::Add(std::wstring_view line) {
+    if (m_lines > 0) m_text += L'\n';
+    // Leere Zeilen als Leerzeichen: Append() verwirft eine leere letzte Zeile
+    if (line.empty()) m_text += L' ';
+    else m_text += line;
+    if (++m_lines >= MAX_LINES || std::chrono::steady_clock::now() - m_lastFlush >= FLUSH_INTERVAL) Flush();
+}
+
+void OutputBlock::AddError(const std::wstring& text) {
+    Flush();
+    m_job.AddError(text);
+}
+
+void OutputBlock::Flush() {
+    m_lastFlush = std::chrono::steady_clock::now();
+    if (m_lines == 0) return;
+    m_job.AddHistory(m_text);
+    m_text.clear();
+    m_lines = 0;
+}
+
+CommandExecutor::CommandExecutor(size_t workerCount, NotifyFunction notify)
+    : m_notify(std::move(notify)),
+      m_baseWorkers(std::max<size_t>(workerCount, 1)) {
+    workerCount = m_baseWorkers;
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&CommandExecutor::WorkerLoop, this);
+    }
+}
+
+CommandExecutor::~CommandExecutor() {
+    Shutdown();
+}
+
+JobId CommandExecutor::Submit(const std::wstring& name, JobFunction function, bool background) {
+    auto job = std::make_shared<Job>();
+    job->name = name;
+    job->background = background;
+    job->function = std::move(function);
+    JoinRetired();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        job->id = m_nextId++;
+        m_queue.push_back(job);
+        m_jobs.push_back(job);
+        // Alle Threads belegt (z.B. durch Hintergrundjobs ohne Ende): nicht warten, sondern
+        // einen weiteren starten
+        if (!m_stopping && m_queue.size() > m_idleWorkers) {
+            m_workers.emplace_back(&CommandExecutor::WorkerLoop, this);
+        }
+    }
+    m_workAvailable.notify_one();
+    return job->id;
+}
+
+bool CommandExecutor::Cancel(JobId id) {
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [id](const std::shared_ptr<Job>& job) { return job->id == id; });
+        if (it == m_jobs.end()) return false;
+        (*it)->cancelled = true;
+        if (!(*it)->running) {
+            // Noch nicht gestartet: gar nicht erst ausfuehren
+            m_queue.erase(std::find(m_queue.begin(), m_queue.end(), *it));
+            m_jobs.erase(it);
+            notify = PushEvent({ .type = JobEvent::Type::Finished, .job = id, .cancelled = true });
+        }
+    }
+    m_wakeSleepers.notify_all();
+    if (notify) NotifyEvents();
+    return true;
+}
+
+void CommandExecutor::TakeEvents(std::vector<JobEvent>& events) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (events.empty()) {
+        events.swap(m_outbox);
+    }
+    else {
+        std::move(m_outbox.begin(), m_outbox.end(), std::back_inserter(events));
+        m_outbox.clear();
+    }
+}
+
+bool CommandExecutor::WaitForEvents(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_eventsAvailable.wait_for(lock, timeout, [this] { return !m_outbox.empty(); });
+}
+
+std::vector<JobInfo> CommandExecutor::Jobs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<JobInfo> jobs;
+    jobs.reserve(m_jobs.size());
+    for (const std::shared_ptr<Job>& job : m_jobs) {
+        jobs.push_back({ job->id, job->name, job->background, job->running });
+    }
+    return jobs;
+}
+
+size_t CommandExecutor::ActiveJobs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size();
+}
+
+void CommandExecutor::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping && m_workers.empty()) return;
+        m_stopping = true;
+        for (const std::shared_ptr<Job>& job : m_jobs) {
+            job->cancelled = true;
+        }
+        m_queue.clear();
+    }
+    m_workAvailable.notify_all();
+    m_wakeSleepers.notify_all();
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_workers.clear();
+    JoinRetired();
+}
+
+// Erwartet m_mutex: der aufrufende Thread traegt sich aus m_workers aus. Einsammeln (join) kann
+// er sich nicht selbst; das erledigt JoinRetired beim naechsten Submit bzw. Shutdown.
+void CommandExecutor::RetireWorker() {
+    auto self = std::find_if(m_workers.begin(), m_workers.end(),
+        [](const std::thread& worker) { return worker.get_id() == std::this_thread::get_id(); });
+    m_retired.push_back(std::move(*self));
+    m_workers.erase(self);
+}
+
+void CommandExecutor::JoinRetired() {
+    std::vector<std::thread> retired;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        retired.swap(m_retired);
+    }
+    for (std::thread& worker : retired) worker.join();
+}
+
+void CommandExecutor::Post(JobEvent event) {
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        notify = PushEvent(std::move(event));
+    }
+    if (notify) NotifyEvents();
+}
+
+// Erwartet m_mutex; liefert true, wenn der Postausgang vorher leer war (dann NotifyEvents()).
+bool CommandExecutor::PushEvent(JobEvent event) {
+    bool wasEmpty = m_outbox.empty();
+    if (event.type == JobEvent::Type::Live) {
+        // Noch nicht abgeholte Statuszeile desselben Jobs ersetzen: der Postausgang waechst nicht,
+        // wenn der UI-Thread langsamer abholt, als der Job aktualisiert. Gesucht wird nur bis zur
+        // letzten anderen Ausgabe des Jobs, damit die Reihenfolge erhalten bleibt.
+        for (auto queued = m_outbox.rbegin(); queued != m_outbox.rend(); ++queued) {
+            if (queued->job != event.job) continue;
+            if (queued->type != JobEvent::Type::Live) break;
+            if (queued->slot == event.slot) {
+                queued->text = std::move(event.text);
+                return false;
+            }
+        }
+    }
+    m_outbox.push_back(std::move(event));
+    return wasEmpty;
+}
+
+void CommandExecutor::NotifyEvents() {
+    m_eventsAvailable.notify_all();
+    if (m_notify) m_notify();
+}
+
+bool CommandExecutor::SleepFor(const Job& job, uint32_t milliseconds) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool cancelled = m_wakeSleepers.wait_for(lock, std::chrono::milliseconds(milliseconds),
+        [&job] { return job.cancelled.load(); });
+    return !cancelled;
+}
+
+void CommandExecutor::WorkerLoop() {
+    Perf::SetThreadName(L"Arbeitsthread");
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_idleWorkers;
+            while (!m_stopping && m_queue.empty()) {
+                // Zusaetzliche Threads enden nach IDLE_TIMEOUT ohne Arbeit; die ersten
+                // workerCount bleiben
+                if (m_workAvailable.wait_for(lock, IDLE_TIMEOUT) == std::cv_status::timeout &&
+                    !m_stopping && m_queue.empty() && m_workers.size() > m_baseWorkers) {
+                    --m_idleWorkers;
+                    RetireWorker();
+                    return;
+                }
+            }
+            --m_idleWorkers;
+            if (m_stopping) return;
+            job = m_queue.front();
+            m_queue.pop_front();
+            job->running = true;
+        }
+
+        WorkerContext context(*this, *job);
+        try {
+            PerfSpan span(L"Job", &Perf::Jobs());
+            job->function(context);
+        }
+        catch (const std::exception& e) {
+            std::string what = e.what();
+            context.AddError(L"FEHLER: " + std::wstring(what.begin(), what.end()));
+        }
+        catch (...) {
+            context.AddError(L"FEHLER: Befehl mit unbekanntem Fehler abgebrochen.");
+        }
+
+        // Austragen und Ende melden in einem Schritt: wer ActiveJobs() == 0 sieht, findet das
+        // Finished-Ereignis bereits im Postausgang
+        bool notify;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), job));
+            notify = PushEvent({ .type = JobEvent::Type::Finished, .job = job->id, .cancelled = job->cancelled.load() });
+        }
+        if (notify) NotifyEvents();
+    }
+}
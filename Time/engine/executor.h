@@ -0,0 +1,187 @@
+#pragma once
+
+#include "table.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Schnittstelle eines laufenden Befehls zur Konsole. Langsame Systembefehle (PING, NETSTAT, ...)
+ * schreiben ihre Ausgabe hierueber statt direkt in den Verlauf, damit sie auf einem
+ * Arbeitsthread laufen koennen.
+ */
+class JobContext {
+public:
+    virtual ~JobContext() = default;
+
+    // Gleiche Semantik wie ConsoleEngine::AddHistory; die Zeilen erscheinen sofort (gestreamt).
+    virtual void AddHistory(const std::wstring& text) = 0;
+
+    // Fehlermeldung ("FEHLER: ..."): erscheint im Verlauf wie AddHistory, geht in einer Pipeline
+    // aber wie stderr an den Filtern vorbei.
+    virtual void AddError(const std::wstring& text) { AddHistory(text); }
+
+    // Statuszeile des Befehls (genau eine Zeile): der erste Aufruf haengt sie an, jeder weitere
+    // ersetzt sie, statt den Verlauf zu verlaengern (z.B. laufende PING-Statistik).
+    void SetLiveLine(const std::wstring& text) { SetLiveLine(0, text); }
+
+    // Mehrere Statuszeilen (TOP): jede Nummer ist eine eigene Zeile, eine neue Nummer wird
+    // angehaengt. Nur ersetzte Zeilen werden neu gezeichnet.
+    virtual void SetLiveLine(uint32_t slot, const std::wstring& text) = 0;
+
+    // Tabellarisches Ergebnis in einem Stueck; formatiert wird erst bei der Anzeige.
+    virtual void AddTable(std::shared_ptr<ResultTable> table) = 0;
+
+    // true, sobald der Befehl abgebrochen wurde (Strg+C, STOP, Programmende).
+    virtual bool Cancelled() const = 0;
+
+    // Wartet die angegebene Zeit; kehrt bei Abbruch sofort mit false zurueck.
+    virtual bool Sleep(uint32_t milliseconds) = 0;
+};
+
+/**
+ * Sammelt Ausgabezeilen eines Jobs und gibt sie schubweise mit einem AddHistory aus: hoechstens
+ * MAX_LINES Zeilen oder FLUSH_INTERVAL alt. Lange Ausgaben (DIR /S, FIND) bleiben so gestreamt,
+ * ohne fuer jede Zeile ein eigenes Ereignis an den UI-Thread zu schicken.
+ */
+class OutputBlock {
+public:
+    static constexpr size_t MAX_LINES = 512;
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 100 };
+
+    explicit OutputBlock(JobContext& job);
+    ~OutputBlock() { Flush(); }
+
+    OutputBlock(const OutputBlock&) = delete;
+    OutputBlock& operator=(const OutputBlock&) = delete;
+
+    void Add(std::wstring_view line);
+    // Gibt die bisherigen Zeilen aus und meldet dann den Fehler (JobContext::AddError).
+    void AddError(const std::wstring& text);
+    void Flush();
+
+private:
+    JobContext& m_job;
+    std::wstring m_text;
+    size_t m_lines = 0;
+    std::chrono::steady_clock::time_point m_lastFlush;
+};
+
+using JobFunction = std::function<void(JobContext& job)>;
+using JobId = uint32_t;
+
+/**
+ * Nachricht eines Jobs an den UI-Thread.
+ */
+struct JobEvent {
+    enum class Type { Output, Live, Table, Finished };
+
+    // Alle Felder mit Vorgabe: Ereignisse werden mit benannten Feldern angelegt
+    // ({ .type = ..., .job = ..., .text = ... }), die uebrigen bleiben leer.
+    Type type = Type::Output;
+    JobId job = 0;
+    std::wstring text = {};      // Output: Text fuer AddHistory, Live: neue Statuszeile
+    bool cancelled = false;      // Finished: Job wurde abgebrochen
+    std::shared_ptr<ResultTable> table = {}; // Table
+    uint32_t slot = 0;           // Live: Nummer der Statuszeile
+};
+
+struct JobInfo {
+    JobId id;
+    std::wstring name;
+    bool background;
+    bool running; // false = wartet noch in der Warteschlange
+};
+
+/**
+ * Thread-Pool fuer Konsolenbefehle mit Warteschlange.
+ *
+ * workerCount Threads laufen von Anfang an. Findet Submit keinen freien Thread, kommt ein weiterer
+ * hinzu: Hintergrundjobs, die bis zum STOP laufen (PING -t, TOP, NETSTAT -r), belegen ihren
+ * Thread dauerhaft, und ein neuer Befehl darf nicht hinter ihnen warten. Ein Thread ueber die
+ * Grundausstattung hinaus endet nach IDLE_TIMEOUT ohne Arbeit wieder, damit der Pool bei
+ * wochenlanger Laufzeit nicht auf seiner Hoechstzahl stehen bleibt (und Perf-Ringe frei werden).
+ *
+ * Ausgaben und Ende eines Jobs landen in einem Postausgang. Wird dieser von leer auf nicht leer
+ * gefuellt, ruft der Executor einmal notify() auf (Win32: PostMessage an das Fenster); der
+ * UI-Thread holt dann alle angesammelten Ereignisse mit TakeEvents() auf einmal ab. Der
+ * Verlauf wird so nur vom UI-Thread veraendert und pro Schub nur einmal neu gezeichnet.
+ */
+class CommandExecutor {
+public:
+    using NotifyFunction = std::function<void()>;
+
+    static constexpr std::chrono::seconds IDLE_TIMEOUT{ 30 }; // danach enden zusaetzliche Threads
+
+    explicit CommandExecutor(size_t workerCount = 4, NotifyFunction notify = nullptr);
+    ~CommandExecutor();
+
+    CommandExecutor(const CommandExecutor&) = delete;
+    CommandExecutor& operator=(const CommandExecutor&) = delete;
+
+    JobId Submit(const std::wstring& name, JobFunction function, bool background);
+
+    // Bricht einen wartenden oder laufenden Job ab; false, wenn er nicht (mehr) existiert.
+    bool Cancel(JobId id);
+
+    // Haengt alle bisher angefallenen Ereignisse an events an (nur vom UI-Thread aufrufen).
+    void TakeEvents(std::vector<JobEvent>& events);
+
+    // Wartet, bis Ereignisse vorliegen (fuer Frontends ohne Nachrichtenschleife).
+    bool WaitForEvents(std::chrono::milliseconds timeout);
+
+    // Weckt den UI-Thread ohne Ereignis (notify), z.B. fuer den Fortschritt eines Hintergrundindex.
+    void Wake() { NotifyEvents(); }
+
+    std::vector<JobInfo> Jobs() const;
+    size_t ActiveJobs() const;
+
+    // Bricht alle Jobs ab und wartet auf die Arbeitsthreads.
+    void Shutdown();
+
+private:
+    struct Job {
+        JobId id;
+        std::wstring name;
+        bool background;
+        bool running = false;
+        JobFunction function;
+        std::atomic<bool> cancelled{ false };
+    };
+
+    class WorkerContext;
+
+    void WorkerLoop();
+    void RetireWorker();
+    void JoinRetired();
+    void Post(JobEvent event);
+    bool PushEvent(JobEvent event);
+    void NotifyEvents();
+    bool SleepFor(const Job& job, uint32_t milliseconds);
+
+    NotifyFunction m_notify;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_wakeSleepers; // Abbruch weckt Jobs in Sleep()
+    std::condition_variable m_eventsAvailable;
+
+    std::deque<std::shared_ptr<Job>> m_queue;
+    std::vector<std::shared_ptr<Job>> m_jobs; // wartend und laufend, fuer JOBS
+    std::vector<JobEvent> m_outbox;
+    std::vector<std::thread> m_workers;
+    std::vector<std::thread> m_retired; // beendete zusaetzliche Threads, noch nicht eingesammelt
+    size_t m_baseWorkers;     // workerCount: so viele bleiben immer
+    size_t m_idleWorkers = 0; // warten in WorkerLoop auf Arbeit
+    JobId m_nextId = 1;
+    bool m_stopping = false;
+};
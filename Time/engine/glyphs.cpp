@@ -0,0 +1,213 @@
+#include "glyphs.h"
+
+#include <algorithm>
+#include <cstring>
+
+// 5x8-Pixelschrift fuer ASCII 0x20..0x7E, spaltenweise: Bit 0 ist die oberste Zeile,
+// Bit 7 die Unterlaenge (g, j, p, q, y).
+static const uint8_t FONT_5X8[95][5] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+    { 0x00, 0x00, 0x5F, 0x00, 0x00 }, // !
+    { 0x00, 0x07, 0x00, 0x07, 0x00 }, // "
+    { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, // #
+    { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, // $
+    { 0x23, 0x13, 0x08, 0x64, 0x62 }, // %
+    { 0x36, 0x49, 0x56, 0x20, 0x50 }, // &
+    { 0x00, 0x00, 0x07, 0x00, 0x00 }, // '
+    { 0x00, 0x1C, 0x22, 0x41, 0x00 }, // (
+    { 0x00, 0x41, 0x22, 0x1C, 0x00 }, // )
+    { 0x2A, 0x1C, 0x7F, 0x1C, 0x2A }, // *
+    { 0x08, 0x08, 0x3E, 0x08, 0x08 }, // +
+    { 0x00, 0x80, 0x70, 0x30, 0x00 }, // ,
+    { 0x08, 0x08, 0x08, 0x08, 0x08 }, // -
+    { 0x00, 0x00, 0x60, 0x60, 0x00 }, // .
+    { 0x20, 0x10, 0x08, 0x04, 0x02 }, // /
+    { 0x3E, 0x51, 0x49, 0x45, 0x3E }, // 0
+    { 0x00, 0x42, 0x7F, 0x40, 0x00 }, // 1
+    { 0x72, 0x49, 0x49, 0x49, 0x46 }, // 2
+    { 0x21, 0x41, 0x49, 0x4D, 0x33 }, // 3
+    { 0x18, 0x14, 0x12, 0x7F, 0x10 }, // 4
+    { 0x27, 0x45, 0x45, 0x45, 0x39 }, // 5
+    { 0x3C, 0x4A, 0x49, 0x49, 0x31 }, // 6
+    { 0x41, 0x21, 0x11, 0x09, 0x07 }, // 7
+    { 0x36, 0x49, 0x49, 0x49, 0x36 }, // 8
+    { 0x46, 0x49, 0x49, 0x29, 0x1E }, // 9
+    { 0x00, 0x00, 0x14, 0x00, 0x00 }, // :
+    { 0x00, 0x40, 0x34, 0x00, 0x00 }, // ;
+    { 0x00, 0x08, 0x14, 0x22, 0x41 }, // <
+    { 0x14, 0x14, 0x14, 0x14, 0x14 }, // =
+    { 0x00, 0x41, 0x22, 0x14, 0x08 }, // >
+    { 0x02, 0x01, 0x59, 0x09, 0x06 }, // ?
+    { 0x3E, 0x41, 0x5D, 0x59, 0x4E }, // @
+    { 0x7C, 0x12, 0x11, 0x12, 0x7C }, // A
+    { 0x7F, 0x49, 0x49, 0x49, 0x36 }, // B
+    { 0x3E, 0x41, 0x41, 0x41, 0x22 }, // C
+    { 0x7F, 0x41, 0x41, 0x41, 0x3E }, // D
+    { 0x7F, 0x49, 0x49, 0x49, 0x41 }, // E
+    { 0x7F, 0x09, 0x09, 0x09, 0x01 }, // F
+    { 0x3E, 0x41, 0x41, 0x51, 0x73 }, // G
+    { 0x7F, 0x08, 0x08, 0x08, 0x7F }, // H
+    { 0x00, 0x41, 0x7F, 0x41, 0x00 }, // I
+    { 0x20, 0x40, 0x41, 0x3F, 0x01 }, // J
+    { 0x7F, 0x08, 0x14, 0x22, 0x41 }, // K
+    { 0x7F, 0x40, 0x40, 0x40, 0x40 }, // L
+    { 0x7F, 0x02, 0x1C, 0x02, 0x7F }, // M
+    { 0x7F, 0x04, 0x08, 0x10, 0x7F }, // N
+    { 0x3E, 0x41, 0x41, 0x41, 0x3E }, // O
+    { 0x7F, 0x09, 0x09, 0x09, 0x06 }, // P
+    { 0x3E, 0x41, 0x51, 0x21, 0x5E }, // Q
+    { 0x7F, 0x09, 0x19, 0x29, 0x46 }, // R
+    { 0x26, 0x49, 0x49, 0x49, 0x32 }, // S
+    { 0x03, 0x01, 0x7F, 0x01, 0x03 }, // T
+    { 0x3F, 0x40, 0x40, 0x40, 0x3F }, // U
+    { 0x1F, 0x20, 0x40, 0x20, 0x1F }, // V
+    { 0x3F, 0x40, 0x38, 0x40, 0x3F }, // W
+    { 0x63, 0x14, 0x08, 0x14, 0x63 }, // X
+    { 0x03, 0x04, 0x78, 0x04, 0x03 }, // Y
+    { 0x61, 0x59, 0x49, 0x4D, 0x43 }, // Z
+    { 0x00, 0x7F, 0x41, 0x41, 0x41 }, // [
+    { 0x02, 0x04, 0x08, 0x10, 0x20 }, // Backslash
+    { 0x00, 0x41, 0x41, 0x41, 0x7F }, // ]
+    { 0x04, 0x02, 0x01, 0x02, 0x04 }, // ^
+    { 0x40, 0x40, 0x40, 0x40, 0x40 }, // _
+    { 0x00, 0x03, 0x07, 0x08, 0x00 }, // `
+    { 0x20, 0x54, 0x54, 0x78, 0x40 }, // a
+    { 0x7F, 0x28, 0x44, 0x44, 0x38 }, // b
+    { 0x38, 0x44, 0x44, 0x44, 0x28 }, // c
+    { 0x38, 0x44, 0x44, 0x28, 0x7F }, // d
+    { 0x38, 0x54, 0x54, 0x54, 0x18 }, // e
+    { 0x00, 0x08, 0x7E, 0x09, 0x02 }, // f
+    { 0x18, 0xA4, 0xA4, 0x9C, 0x78 }, // g
+    { 0x7F, 0x08, 0x04, 0x04, 0x78 }, // h
+    { 0x00, 0x44, 0x7D, 0x40, 0x00 }, // i
+    { 0x20, 0x40, 0x40, 0x3D, 0x00 }, // j
+    { 0x7F, 0x10, 0x28, 0x44, 0x00 }, // k
+    { 0x00, 0x41, 0x7F, 0x40, 0x00 }, // l
+    { 0x7C, 0x04, 0x78, 0x04, 0x78 }, // m
+    { 0x7C, 0x08, 0x04, 0x04, 0x78 }, // n
+    { 0x38, 0x44, 0x44, 0x44, 0x38 }, // o
+    { 0xFC, 0x18, 0x24, 0x24, 0x18 }, // p
+    { 0x18, 0x24, 0x24, 0x18, 0xFC }, // q
+    { 0x7C, 0x08, 0x04, 0x04, 0x08 }, // r
+    { 0x48, 0x54, 0x54, 0x54, 0x24 }, // s
+    { 0x04, 0x04, 0x3F, 0x44, 0x24 }, // t
+    { 0x3C, 0x40, 0x40, 0x20, 0x7C }, // u
+    { 0x1C, 0x20, 0x40, 0x20, 0x1C }, // v
+    { 0x3C, 0x40, 0x30, 0x40, 0x3C }, // w
+    { 0x44, 0x28, 0x10, 0x28, 0x44 }, // x
+    { 0x4C, 0x90, 0x90, 0x90, 0x7C }, // y
+    { 0x44, 0x64, 0x54, 0x4C, 0x44 }, // z
+    { 0x00, 0x08, 0x36, 0x41, 0x00 }, // {
+    { 0x00, 0x00, 0x77, 0x00, 0x00 }, // |
+    { 0x00, 0x41, 0x36, 0x08, 0x00 }, // }
+    { 0x02, 0x01, 0x02, 0x04, 0x02 }, // ~
+};
+
+// Zusaetzliche Zeichen ausserhalb von ASCII
+struct ExtraGlyph {
+    wchar_t ch;
+    uint8_t columns[5];
+};
+
+static const ExtraGlyph FONT_EXTRA[] = {
+    { L'\x00B0', { 0x00, 0x06, 0x09, 0x06, 0x00 } }, // Grad
+    { L'\x00C4', { 0x7D, 0x12, 0x11, 0x12, 0x7D } }, // Ae
+    { L'\x00D6', { 0x38, 0x45, 0x44, 0x45, 0x38 } }, // Oe
+    { L'\x00DC', { 0x3F, 0x41, 0x40, 0x41, 0x3F } }, // Ue
+    { L'\x00DF', { 0x7E, 0x01, 0x49, 0x4E, 0x30 } }, // sz
+    { L'\x00E4', { 0x20, 0x55, 0x54, 0x79, 0x40 } }, // ae
+    { L'\x00F6', { 0x38, 0x45, 0x44, 0x45, 0x38 } }, // oe
+    { L'\x00FC', { 0x3C, 0x41, 0x40, 0x21, 0x7C } }, // ue
+    { L'\x2665', { 0x0C, 0x1E, 0x3C, 0x1E, 0x0C } }, // Herz
+    { L'\x2764', { 0x0C, 0x1E, 0x3C, 0x1E, 0x0C } }, // Herz (Banner)
+};
+
+BuiltinFont::BuiltinFont(int scale)
+    : m_scale(std::max(scale, 1)) {
+}
+
+bool BuiltinFont::Rasterize(wchar_t ch, uint8_t* coverage) {
+    const int width = CellWidth();
+    const int height = CellHeight();
+    memset(coverage, 0, static_cast<size_t>(width) * height);
+
+    if (ch >= L'\x2581' && ch <= L'\x2588') { // Blockelemente 1/8 bis 8/8 von unten (Uhr, Sparklines)
+        int rows = height * (ch - L'\x2580') / 8;
+        memset(coverage + static_cast<size_t>(height - rows) * width, 255, static_cast<size_t>(width) * rows);
+        return true;
+    }
+
+    const uint8_t* columns = nullptr;
+    if (ch >= 0x20 && ch <= 0x7E) {
+        columns = FONT_5X8[ch - 0x20];
+    }
+    else {
+        for (const ExtraGlyph& extra : FONT_EXTRA) {
+            if (extra.ch == ch) {
+                columns = extra.columns;
+                break;
+            }
+        }
+    }
+    if (!columns) return false;
+
+    // Glyphe eine Pixelzeile unter dem oberen Zellrand
+    for (int col = 0; col < 5; ++col) {
+        for (int bit = 0; bit < 8; ++bit) {
+            if (!(columns[col] & (1 << bit))) continue;
+            for (int dy = 0; dy < m_scale; ++dy) {
+                uint8_t* row = coverage + static_cast<size_t>((bit + 1) * m_scale + dy) * width;
+                memset(row + col * m_scale, 255, m_scale);
+            }
+        }
+    }
+    return true;
+}
+
+GlyphAtlas::GlyphAtlas(GlyphRasterizer& rasterizer)
+    : m_rasterizer(rasterizer),
+      m_cellWidth(rasterizer.CellWidth()),
+      m_cellHeight(rasterizer.CellHeight()),
+      m_cellPixels(static_cast<size_t>(rasterizer.CellWidth()) * rasterizer.CellHeight()),
+      m_coverage(m_cellPixels) {
+    m_masks.reserve(m_cellPixels * 256);
+
+    m_fallback = Add(L'?');
+    if (m_fallback < 0) {
+        // Schrift ohne '?': leere Zelle als Ersatz
+        m_masks.resize(m_masks.size() + m_cellPixels, 0);
+        m_fallback = static_cast<int32_t>(m_masks.size() / m_cellPixels) - 1;
+    }
+    for (int ch = 0; ch < 256; ++ch) {
+        int32_t index = ch == L'?' ? m_fallback : Add(static_cast<wchar_t>(ch));
+        m_latin1[ch] = index >= 0 ? index : m_fallback;
+    }
+    // Steuerzeichen (z.B. Tabulatoren aus TYPE) als Leerzeichen statt als '?'
+    for (int ch = 0; ch < 0x20; ++ch) {
+        m_latin1[ch] = m_latin1[' '];
+    }
+}
+
+/**
+ * Rastert ein Zeichen und haengt seine Maske an; -1, wenn die Schrift es nicht enthaelt.
+ */
+int32_t GlyphAtlas::Add(wchar_t ch) {
+    if (ch < 0x20 || !m_rasterizer.Rasterize(ch, m_coverage.data())) {
+        return -1;
+    }
+    size_t offset = m_masks.size();
+    m_masks.resize(offset + m_cellPixels);
+    for (size_t i = 0; i < m_cellPixels; ++i) {
+        m_masks[offset + i] = m_coverage[i] >= 128 ? 0xFFFFFFFFu : 0u;
+    }
+    return static_cast<int32_t>(offset / m_cellPixels);
+}
+
+int32_t GlyphAtlas::LookupExtra(wchar_t ch) {
+    auto it = m_extra.find(ch);
+    if (it != m_extra.end()) return it->second;
+    int32_t index = Add(ch);
+    if (index < 0) index = m_fallback;
+    m_extra.emplace(ch, index);
+    return index;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Liefert die Pixel einzelner Zeichen fuer den Glyphen-Atlas. Alle Zeichen haben dieselbe
+ * Zellgroesse (Festbreitenschrift).
+ */
+class GlyphRasterizer {
+public:
+    virtual ~GlyphRasterizer() = default;
+
+    virtual int CellWidth() const = 0;
+    virtual int CellHeight() const = 0;
+
+    // Schreibt CellWidth() * CellHeight() Deckungswerte (0 = Hintergrund, 255 = Vordergrund).
+    // Liefert false, wenn die Schrift das Zeichen nicht enthaelt.
+    virtual bool Rasterize(wchar_t ch, uint8_t* coverage) = 0;
+};
+
+/**
+ * Eingebaute 5x8-Pixelschrift (ASCII, Umlaute, einige Sonderzeichen) fuer das Headless-Frontend
+ * und Tests ohne Systemschriften. Jede Glyphe sitzt in einer 6x10-Zelle und kann ganzzahlig
+ * skaliert werden.
+ */
+class BuiltinFont : public GlyphRasterizer {
+public:
+    explicit BuiltinFont(int scale = 1);
+
+    int CellWidth() const override { return 6 * m_scale; }
+    int CellHeight() const override { return 10 * m_scale; }
+    bool Rasterize(wchar_t ch, uint8_t* coverage) override;
+
+private:
+    int m_scale;
+};
+
+/**
+ * Vorgerasterte Zeichen in Zellgroesse. Jedes Pixel ist als 32-Bit-Maske gespeichert
+ * (0x00000000 oder 0xFFFFFFFF), damit der Renderer Vorder- und Hintergrundfarbe ohne
+ * Verzweigung per SIMD mischen kann. Latin-1 wird beim Anlegen gerastert, alle anderen
+ * Zeichen beim ersten Gebrauch.
+ */
+class GlyphAtlas {
+public:
+    explicit GlyphAtlas(GlyphRasterizer& rasterizer);
+
+    int CellWidth() const { return m_cellWidth; }
+    int CellHeight() const { return m_cellHeight; }
+
+    // Maske fuer ein Zeichen; unbekannte Zeichen werden als '?' dargestellt.
+    const uint32_t* Glyph(wchar_t ch) {
+        if (static_cast<uint32_t>(ch) < 256) {
+            return &m_masks[static_cast<size_t>(m_latin1[ch]) * m_cellPixels];
+        }
+        return &m_masks[static_cast<size_t>(LookupExtra(ch)) * m_cellPixels];
+    }
+
+    size_t GlyphCount() const { return m_masks.size() / m_cellPixels; }
+    size_t ResidentBytes() const { return m_masks.capacity() * sizeof(uint32_t); }
+
+private:
+    int32_t Add(wchar_t ch);
+    int32_t LookupExtra(wchar_t ch);
+
+    GlyphRasterizer& m_rasterizer;
+    int m_cellWidth;
+    int m_cellHeight;
+    size_t m_cellPixels;
+
+    std::vector<uint32_t> m_masks;
+    std::vector<uint8_t> m_coverage; // Arbeitspuffer fuer den Rasterizer
+    int32_t m_latin1[256];
+    std::unordered_map<wchar_t, int32_t> m_extra;
+    int32_t m_fallback = 0;
+};
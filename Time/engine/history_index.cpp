@@ -0,0 +1,78 @@
+#include "history_index.h"
+
+#include <algorithm>
+
+static_assert(HistoryIndex::SIGNATURE_BITS == 4096, "FirstBit/SecondBit liefern 12 Bit");
+static_assert(HistoryIndex::GROUP_BLOCKS == 64, "ein Bit je Block in einem 64-Bit-Wort");
+
+void HistoryIndex::Add(uint64_t sequence, std::wstring_view line) {
+    uint64_t group = sequence / GROUP_LINES;
+    if (group < m_firstGroup) return; // bereits verdraengt
+    if (m_groups.empty() && m_firstGroup < group) m_firstGroup = group;
+    while (m_firstGroup + m_groups.size() <= group) m_groups.emplace_back();
+    if (line.size() < 3) return;
+
+    uint64_t* slices = m_groups[static_cast<size_t>(group - m_firstGroup)].slices;
+    const uint64_t blockBit = uint64_t{ 1 } << (sequence / BLOCK_LINES % GROUP_BLOCKS);
+    wchar_t a = Fold(line[0]);
+    wchar_t b = Fold(line[1]);
+    for (size_t i = 2; i < line.size(); ++i) {
+        wchar_t c = Fold(line[i]);
+        uint32_t hash = TrigramHash(a, b, c);
+        slices[FirstBit(hash)] |= blockBit;
+        slices[SecondBit(hash)] |= blockBit;
+        a = b;
+        b = c;
+    }
+}
+
+void HistoryIndex::Trim(uint64_t firstSequence) {
+    while (!m_groups.empty() && (m_firstGroup + 1) * GROUP_LINES <= firstSequence) {
+        m_groups.pop_front();
+        m_firstGroup++;
+    }
+}
+
+void HistoryIndex::Clear(uint64_t nextSequence) {
+    m_groups.clear();
+    m_firstGroup = nextSequence / GROUP_LINES;
+}
+
+HistoryIndex::Query HistoryIndex::Prepare(std::wstring_view text) {
+    Query query;
+    query.folded.reserve(text.size());
+    for (wchar_t ch : text) query.folded += Fold(ch);
+    for (size_t i = 2; i < query.folded.size(); ++i) {
+        uint32_t hash = TrigramHash(query.folded[i - 2], query.folded[i - 1], query.folded[i]);
+        query.bits.push_back(FirstBit(hash));
+        query.bits.push_back(SecondBit(hash));
+    }
+    std::sort(query.bits.begin(), query.bits.end());
+    query.bits.erase(std::unique(query.bits.begin(), query.bits.end()), query.bits.end());
+    return query;
+}
+
+uint64_t HistoryIndex::Candidates(uint64_t sequence, const Query& query) const {
+    uint64_t group = sequence / GROUP_LINES;
+    if (group < m_firstGroup || group - m_firstGroup >= m_groups.size()) return ~uint64_t{ 0 }; // nicht erfasst
+    const uint64_t* slices = m_groups[static_cast<size_t>(group - m_firstGroup)].slices;
+    uint64_t blocks = ~uint64_t{ 0 };
+    for (uint32_t bit : query.bits) {
+        blocks &= slices[bit];
+        if (!blocks) break;
+    }
+    return blocks;
+}
+
+size_t HistoryIndex::FindFolded(std::wstring_view line, const Query& query) {
+    const std::wstring& needle = query.folded;
+    if (needle.empty() || needle.size() > line.size()) return std::wstring_view::npos;
+    const wchar_t first = needle[0];
+    for (size_t i = 0; i + needle.size() <= line.size(); ++i) {
+        if (Fold(line[i]) != first) continue;
+        size_t j = 1;
+        while (j < needle.size() && Fold(line[i + j]) == needle[j]) ++j;
+        if (j == needle.size()) return i;
+    }
+    return std::wstring_view::npos;
+}
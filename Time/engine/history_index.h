@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Trigramm-Index ueber den Verlauf fuer die Suche (Strg+R/Strg+F, HISTORY /FIND).
+ *
+ * Je BLOCK_LINES aufeinanderfolgende Zeilen (nach fortlaufender Nummer) teilen sich eine
+ * Signatur: ein Bitfeld, in dem jedes vorkommende Trigramm (ohne Gross-/Kleinschreibung) zwei
+ * Bits setzt. Die Signaturen von GROUP_BLOCKS Bloecken liegen spaltenweise (bit-sliced): je
+ * Signaturbit ein 64-Bit-Wort mit einem Bit pro Block. Eine Suche verknuepft so je Gruppe nur die
+ * Woerter der Trigramme des Suchtexts und erhaelt alle Bloecke, die in Frage kommen, auf einmal;
+ * nur deren Zeilen werden gelesen. Der Speicher je Zeile ist konstant
+ * (SIGNATURE_BITS / 8 / BLOCK_LINES Byte); verdraengte Gruppen fallen vorne weg. Ersetzte
+ * Zeilen setzen nur weitere Bits, alte bleiben stehen (hoechstens ein Block mehr zu lesen).
+ */
+class HistoryIndex {
+public:
+    static constexpr size_t BLOCK_LINES = 64;
+    static constexpr size_t GROUP_BLOCKS = 64;
+    static constexpr size_t SIGNATURE_BITS = 4096;
+
+    /**
+     * Suchtext in der Form, die Candidates und FindFolded erwarten.
+     */
+    struct Query {
+        std::wstring folded;
+        std::vector<uint32_t> bits; // leer bei weniger als drei Zeichen: jeder Block kommt in Frage
+    };
+
+    void Add(uint64_t sequence, std::wstring_view line);
+
+    // Verwirft alle Gruppen, deren Zeilen vollstaendig vor firstSequence liegen.
+    void Trim(uint64_t firstSequence);
+
+    // Leert den Index; die naechste Zeile hat die Nummer nextSequence.
+    void Clear(uint64_t nextSequence);
+
+    static Query Prepare(std::wstring_view text);
+
+    // Bloecke der Gruppe (sequence / BLOCK_LINES / GROUP_BLOCKS), deren Zeilen den Suchtext
+    // enthalten koennen: Bit i steht fuer den i-ten Block der Gruppe. Nicht erfasste Gruppen
+    // kommen vollstaendig in Frage.
+    uint64_t Candidates(uint64_t sequence, const Query& query) const;
+
+    // Erstes Vorkommen von query.folded in line ohne Gross-/Kleinschreibung, sonst npos.
+    static size_t FindFolded(std::wstring_view line, const Query& query);
+
+    // Kleinbuchstaben fuer ASCII und Latin-1 (Umlaute), alles andere unveraendert.
+    static wchar_t Fold(wchar_t ch) {
+        return (ch >= L'A' && ch <= L'Z') || (ch >= 0xC0 && ch <= 0xDE && ch != 0xD7) ? static_cast<wchar_t>(ch + 32) : ch;
+    }
+
+    size_t Groups() const { return m_groups.size(); }
+    size_t ResidentBytes() const { return sizeof(*this) + m_groups.size() * sizeof(Group); }
+
+private:
+    struct Group {
+        uint64_t slices[SIGNATURE_BITS]; // je Signaturbit: Bit i = Block i der Gruppe
+    };
+
+    static constexpr uint64_t GROUP_LINES = BLOCK_LINES * GROUP_BLOCKS;
+
+    // Jedes Trigramm setzt zwei Bits (obere und mittlere 12 Bit des Hashs): ein Suchtext aus
+    // nur einem Trigramm wird so nicht von jedem zufaellig gleichen Trigramm im Block verraten.
+    static uint32_t TrigramHash(wchar_t a, wchar_t b, wchar_t c) {
+        return ((static_cast<uint32_t>(a) * 0x9E3779B1u + static_cast<uint32_t>(b)) * 0x85EBCA77u + static_cast<uint32_t>(c)) * 0xC2B2AE3Du;
+    }
+    static uint32_t FirstBit(uint32_t hash) { return hash >> 20; }            // SIGNATURE_BITS = 2^12
+    static uint32_t SecondBit(uint32_t hash) { return (hash >> 8) & 0xFFF; }
+
+    std::deque<Group> m_groups;
+    uint64_t m_firstGroup = 0;
+};
@@ -0,0 +1,113 @@
+#include "line_editor.h"
+
+#include <algorithm>
+#include <cstring>
+
+void LineEditor::Insert(wchar_t ch) {
+    Reserve(1);
+    m_buffer[m_gapStart++] = ch;
+    m_textValid = false;
+}
+
+void LineEditor::Insert(std::wstring_view text) {
+    if (text.empty()) return;
+    Reserve(text.size());
+    std::copy(text.begin(), text.end(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_gapStart));
+    m_gapStart += text.size();
+    m_textValid = false;
+}
+
+bool LineEditor::DeleteBackward() {
+    if (m_gapStart == 0) return false;
+    m_gapStart--;
+    m_textValid = false;
+    return true;
+}
+
+bool LineEditor::DeleteForward() {
+    if (m_gapEnd == m_buffer.size()) return false;
+    m_gapEnd++;
+    m_textValid = false;
+    return true;
+}
+
+void LineEditor::WordLeft() {
+    size_t position = m_gapStart;
+    while (position > 0 && At(position - 1) == L' ') position--;
+    while (position > 0 && At(position - 1) != L' ') position--;
+    MoveGap(position);
+}
+
+void LineEditor::WordRight() {
+    size_t position = m_gapStart;
+    size_t size = Size();
+    while (position < size && At(position) != L' ') position++;
+    while (position < size && At(position) == L' ') position++;
+    MoveGap(position);
+}
+
+void LineEditor::SetText(std::wstring_view text) {
+    Clear();
+    Insert(text);
+}
+
+void LineEditor::Replace(size_t first, size_t last, std::wstring_view text) {
+    last = std::min(last, Size());
+    first = std::min(first, last);
+    MoveGap(last);
+    m_gapStart = first;
+    m_textValid = false;
+    Insert(text);
+}
+
+void LineEditor::Clear() {
+    // Puffer behalten, die naechste Zeile braucht meist gleich viel
+    m_gapStart = 0;
+    m_gapEnd = m_buffer.size();
+    m_text.clear();
+    m_textValid = true;
+}
+
+const std::wstring& LineEditor::Text() const {
+    if (!m_textValid) {
+        m_text.assign(m_buffer.data(), m_gapStart);
+        m_text.append(m_buffer.data() + m_gapEnd, m_buffer.size() - m_gapEnd);
+        m_textValid = true;
+    }
+    return m_text;
+}
+
+/**
+ * Verschiebt die Luecke an position: die Zeichen dazwischen wandern auf die andere Seite.
+ */
+void LineEditor::MoveGap(size_t position) {
+    if (position == m_gapStart) return;
+    wchar_t* data = m_buffer.data();
+    if (position < m_gapStart) {
+        size_t count = m_gapStart - position;
+        std::memmove(data + m_gapEnd - count, data + position, count * sizeof(wchar_t));
+        m_gapStart -= count;
+        m_gapEnd -= count;
+    }
+    else {
+        size_t count = position - m_gapStart;
+        std::memmove(data + m_gapStart, data + m_gapEnd, count * sizeof(wchar_t));
+        m_gapStart += count;
+        m_gapEnd += count;
+    }
+}
+
+/**
+ * Sorgt fuer mindestens count freie Zeichen in der Luecke; der Puffer waechst auf das Doppelte,
+ * der Text hinter der Luecke rueckt ans neue Ende.
+ */
+void LineEditor::Reserve(size_t count) {
+    if (m_gapEnd - m_gapStart >= count) return;
+    size_t tail = m_buffer.size() - m_gapEnd;
+    size_t capacity = std::max<size_t>({ 64, m_buffer.size() * 2, Size() + count });
+    std::vector<wchar_t> buffer(capacity);
+    std::copy(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_gapStart), buffer.begin());
+    std::copy(m_buffer.end() - static_cast<std::ptrdiff_t>(tail), m_buffer.end(), buffer.end() - static_cast<std::ptrdiff_t>(tail));
+    m_buffer.swap(buffer);
+    m_gapEnd = m_buffer.size() - tail;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Eingabezeile als Gap-Buffer: Der Text steht vor und hinter einer Luecke im selben Puffer, die
+ * Luecke sitzt immer am Cursor. Einfuegen und Loeschen am Cursor sind damit O(1) (ausser beim
+ * Vergroessern), ein Cursorsprung verschiebt nur die Zeichen zwischen alter und neuer Position.
+ *
+ * Text() setzt die Zeile fuer Anzeige und Ausfuehrung zusammen und bleibt bis zur naechsten
+ * Aenderung zwischengespeichert.
+ */
+class LineEditor {
+public:
+    void Insert(wchar_t ch);
+    void Insert(std::wstring_view text);
+
+    // Backspace bzw. Entf; false, wenn am Anfang bzw. Ende nichts zu loeschen war.
+    bool DeleteBackward();
+    bool DeleteForward();
+
+    void MoveLeft() { MoveGap(m_gapStart > 0 ? m_gapStart - 1 : 0); }
+    void MoveRight() { MoveGap(m_gapStart < Size() ? m_gapStart + 1 : m_gapStart); }
+    void Home() { MoveGap(0); }
+    void End() { MoveGap(Size()); }
+
+    // Strg+Links/Strg+Rechts: Anfang des vorigen bzw. naechsten Worts (wie cmd.exe).
+    void WordLeft();
+    void WordRight();
+
+    // Ersetzt die ganze Zeile; der Cursor steht danach am Ende.
+    void SetText(std::wstring_view text);
+
+    // Ersetzt die Zeichen [first, last) durch text; der Cursor steht danach hinter text.
+    void Replace(size_t first, size_t last, std::wstring_view text);
+
+    void Clear();
+
+    const std::wstring& Text() const;
+    size_t Cursor() const { return m_gapStart; }
+    size_t Size() const { return m_buffer.size() - (m_gapEnd - m_gapStart); }
+    bool Empty() const { return Size() == 0; }
+
+    // Zeichen an Position i (0 <= i < Size()).
+    wchar_t At(size_t i) const { return i < m_gapStart ? m_buffer[i] : m_buffer[i + (m_gapEnd - m_gapStart)]; }
+
+private:
+    void MoveGap(size_t position);
+    void Reserve(size_t count);
+
+    std::vector<wchar_t> m_buffer;
+    size_t m_gapStart = 0;
+    size_t m_gapEnd = 0;
+
+    mutable std::wstring m_text;
+    mutable bool m_textValid = true;
+};
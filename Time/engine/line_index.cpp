@@ -0,0 +1,144 @@
+#include "line_index.h"
+#include "mapped_file.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+const char* FindNewline(const char* data, const char* end) {
+    const void* found = memchr(data, '\n', static_cast<size_t>(end - data));
+    return found ? static_cast<const char*>(found) : end;
+}
+
+uint64_t CountNewlines(const char* data, const char* end) {
+    uint64_t count = 0;
+#if TIME_HAVE_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - data >= 64; data += 64) {
+        uint64_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), newline)))
+            | static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), newline)))) << 16
+            | static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)), newline)))) << 32
+            | static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)), newline)))) << 48;
+        count += static_cast<uint64_t>(std::popcount(mask));
+    }
+#endif
+    return count + static_cast<uint64_t>(std::count(data, end, '\n'));
+}
+
+LineIndex::LineIndex(const MappedFile& file, std::function<void()> progress)
+    : m_file(file), m_data(file.Data()), m_size(file.Size()), m_progress(std::move(progress)) {
+    m_checkpoints.push_back(0);
+    m_thread = std::thread(&LineIndex::Scan, this);
+}
+
+LineIndex::~LineIndex() {
+    m_stop = true;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void LineIndex::Wait() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_complete.load(); });
+}
+
+/**
+ * Durchsucht die Datei blockweise. Je 64 Bytes entsteht per SSE2 eine 64-Bit-Maske der
+ * Umbrueche; solange kein Stuetzpunkt faellig ist, genuegt ein popcount.
+ */
+void LineIndex::Scan() {
+    uint64_t lines = 0;
+    std::vector<uint64_t> found; // Stuetzpunkte eines Blocks, werden gesammelt uebernommen
+    auto lastProgress = std::chrono::steady_clock::now();
+    bool firstBlock = true;
+
+    auto record = [&](uint64_t newlineOffset) {
+        lines++;
+        if (lines % CHECKPOINT_LINES == 0) found.push_back(newlineOffset + 1);
+    };
+
+    uint64_t pos = 0;
+    while (pos < m_size && !m_stop.load(std::memory_order_relaxed)) {
+        uint64_t blockEnd = std::min(pos + BLOCK_BYTES, m_size);
+        const char* p = m_data + pos;
+        const char* end = m_data + blockEnd;
+#if TIME_HAVE_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; end - p >= 64; p += 64) {
+            uint64_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), newline)))
+                | static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), newline)))) << 16
+                | static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)), newline)))) << 32
+                | static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)), newline)))) << 48;
+            if (mask == 0) continue;
+            uint64_t count = static_cast<uint64_t>(std::popcount(mask));
+            if (lines % CHECKPOINT_LINES + count < CHECKPOINT_LINES) {
+                lines += count;
+                continue;
+            }
+            while (mask) {
+                record(static_cast<uint64_t>(p - m_data) + std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (p = FindNewline(p, end); p < end; p = FindNewline(p + 1, end)) {
+            record(static_cast<uint64_t>(p - m_data));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_checkpoints.insert(m_checkpoints.end(), found.begin(), found.end());
+        }
+        found.clear();
+        m_lines.store(lines, std::memory_order_release);
+        m_scanned.store(blockEnd, std::memory_order_relaxed);
+
+        // Durchsuchte Seiten nicht im Speicher halten; angezeigte Zeilen laedt das System bei Bedarf nach
+        m_file.Release(pos, blockEnd - pos);
+        pos = blockEnd;
+
+        // Nach dem ersten Block sofort melden: die erste Seite ist dann meist schon vollstaendig
+        auto now = std::chrono::steady_clock::now();
+        if (m_progress && (firstBlock || now - lastProgress >= std::chrono::milliseconds(100))) {
+            firstBlock = false;
+            lastProgress = now;
+            m_progress();
+        }
+    }
+
+    // Letzte Zeile ohne abschliessenden Umbruch
+    if (!m_stop && m_size > 0 && m_data[m_size - 1] != '\n') lines++;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lines.store(lines, std::memory_order_release);
+        m_complete = true;
+    }
+    m_done.notify_all();
+    if (m_progress && !m_stop) m_progress();
+}
+
+bool LineIndex::LineRange(uint64_t line, uint64_t& begin, uint64_t& end) const {
+    if (line >= Lines()) return false;
+    begin = CheckpointOffset(line);
+    for (uint64_t skip = line % CHECKPOINT_LINES; skip > 0; --skip) {
+        begin = NextLine(begin);
+    }
+    end = static_cast<uint64_t>(FindNewline(m_data + begin, m_data + m_size) - m_data);
+    return true;
+}
+
+uint64_t LineIndex::CheckpointOffset(uint64_t line) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_checkpoints[static_cast<size_t>(line / CHECKPOINT_LINES)];
+}
+
+uint64_t LineIndex::NextLine(uint64_t from) const {
+    const char* newline = FindNewline(m_data + from, m_data + m_size);
+    return newline < m_data + m_size ? static_cast<uint64_t>(newline - m_data) + 1 : m_size;
+}
+
+size_t LineIndex::ResidentBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return sizeof(*this) + m_checkpoints.capacity() * sizeof(uint64_t);
+}
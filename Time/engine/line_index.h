@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class MappedFile;
+
+/**
+ * Zeilenindex einer eingeblendeten Datei, der im Hintergrund aufgebaut wird.
+ *
+ * Ein eigener Thread sucht die Zeilenumbrueche (SSE2, 64 Bytes je Schritt) und merkt sich nur
+ * den Anfang jeder CHECKPOINT_LINES-ten Zeile. Der Index bleibt so auch bei sehr grossen
+ * Dateien klein; eine beliebige Zeile findet LineRange() ab dem naechsten Stuetzpunkt mit
+ * hoechstens CHECKPOINT_LINES - 1 weiteren Umbruechen. Bereits durchsuchte Seiten werden
+ * wieder aus dem Arbeitsspeicher entlassen.
+ */
+class LineIndex {
+public:
+    static constexpr uint64_t CHECKPOINT_LINES = 256;
+    static constexpr uint64_t BLOCK_BYTES = 4 << 20; // Schrittweite fuer Fortschritt und Abbruch
+
+    // progress wird vom Indexthread hoechstens alle 100 ms und am Ende aufgerufen.
+    LineIndex(const MappedFile& file, std::function<void()> progress = nullptr);
+    ~LineIndex();
+
+    LineIndex(const LineIndex&) = delete;
+    LineIndex& operator=(const LineIndex&) = delete;
+
+    // Anzahl der Zeilen, deren Ende bereits bekannt ist (am Ende: alle Zeilen).
+    uint64_t Lines() const { return m_lines.load(std::memory_order_acquire); }
+    bool Complete() const { return m_complete.load(std::memory_order_acquire); }
+    uint64_t ScannedBytes() const { return m_scanned.load(std::memory_order_relaxed); }
+
+    // Wartet, bis der Index vollstaendig ist (Headless-Ausgabe, Tests).
+    void Wait() const;
+
+    // Bytebereich [begin, end) der Zeile line ohne '\n'; false, wenn sie (noch) nicht bekannt ist.
+    bool LineRange(uint64_t line, uint64_t& begin, uint64_t& end) const;
+
+    // Stuetzpunkt, ab dem LineRange(line) sucht (line muss bekannt sein).
+    uint64_t CheckpointOffset(uint64_t line) const;
+
+    // Anfang der naechsten Zeile nach dem Umbruch ab from bzw. das Dateiende.
+    uint64_t NextLine(uint64_t from) const;
+
+    size_t ResidentBytes() const;
+
+private:
+    void Scan();
+
+    const MappedFile& m_file;
+    const char* m_data;
+    uint64_t m_size;
+    std::function<void()> m_progress;
+
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_done;
+    std::vector<uint64_t> m_checkpoints; // Anfang der Zeilen 0, 256, 512, ...
+    std::atomic<uint64_t> m_lines{ 0 };
+    std::atomic<uint64_t> m_scanned{ 0 };
+    std::atomic<bool> m_complete{ false };
+    std::atomic<bool> m_stop{ false };
+    std::thread m_thread;
+};
+
+// Sucht das erste '\n' in [data, end); liefert end, wenn keines vorkommt.
+const char* FindNewline(const char* data, const char* end);
+
+// Anzahl der '\n' in [data, end) (SSE2, 64 Bytes je Schritt), fuer Zeilennummern bei FIND /N.
+uint64_t CountNewlines(const char* data, const char* end);
@@ -0,0 +1,116 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "utf8.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::wstring& path, std::wstring& error) {
+    Close();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = L"Datei nicht gefunden oder konnte nicht geoeffnet werden.";
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        error = L"Dateigroesse konnte nicht ermittelt werden.";
+        return false;
+    }
+    m_file = file;
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    m_open = true;
+    if (m_size == 0) return true; // leere Dateien lassen sich nicht einblenden
+
+    m_mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mapping) {
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_data) {
+        Close();
+        error = L"Datei konnte nicht in den Speicher eingeblendet werden.";
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+void MappedFile::Release(uint64_t offset, uint64_t length) const {
+    if (!m_data || offset >= m_size) return;
+    length = (offset + length > m_size) ? m_size - offset : length;
+    // Nicht gesperrte Seiten: VirtualUnlock entfernt sie aus dem Working Set
+    VirtualUnlock(const_cast<char*>(m_data) + offset, static_cast<SIZE_T>(length));
+}
+
+#else
+
+bool MappedFile::Open(const std::wstring& path, std::wstring& error) {
+    Close();
+    int fd = open(WideToUtf8(path).c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        if (fd >= 0) close(fd);
+        error = L"Datei nicht gefunden oder konnte nicht geoeffnet werden.";
+        return false;
+    }
+    m_size = static_cast<uint64_t>(st.st_size);
+    m_open = true;
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            Close();
+            error = L"Datei konnte nicht in den Speicher eingeblendet werden.";
+            return false;
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    close(fd); // die Einblendung bleibt auch ohne Dateideskriptor gueltig
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+void MappedFile::Release(uint64_t offset, uint64_t length) const {
+    if (!m_data || offset >= m_size) return;
+    // Auf ganze Seiten erweitern; Seiten einer nur lesend eingeblendeten Datei laedt das System
+    // bei erneutem Zugriff einfach wieder aus dem Dateicache
+    const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t begin = offset / page * page;
+    uint64_t end = std::min(offset + length, m_size);
+    if (begin >= end) return;
+    madvise(const_cast<char*>(m_data) + begin, end - begin, MADV_DONTNEED);
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Schreibgeschuetzt in den Adressraum eingeblendete Datei (Win32: MapViewOfFile, sonst mmap).
+ * Der Inhalt wird erst beim Zugriff seitenweise vom Betriebssystem geladen, das Oeffnen kostet
+ * unabhaengig von der Dateigroesse gleich viel.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Liefert false und eine Fehlermeldung, wenn die Datei nicht geoeffnet werden kann.
+    bool Open(const std::wstring& path, std::wstring& error);
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+    const char* Data() const { return m_data; }
+    uint64_t Size() const { return m_size; }
+
+    // Gelesene Seiten aus dem Arbeitsspeicher des Prozesses entlassen (sie bleiben im
+    // Dateicache des Systems); haelt den belegten Speicher bei einem Durchlauf klein.
+    void Release(uint64_t offset, uint64_t length) const;
+
+private:
+    const char* m_data = nullptr;
+    uint64_t m_size = 0;
+    bool m_open = false;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
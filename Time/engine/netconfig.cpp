@@ -0,0 +1,453 @@
+#include "netconfig.h"
+#include "netstat.h"
+#include "perf.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <fstream>
+#endif
+
+namespace {
+
+std::wstring FormatMac(const NetAdapter& adapter) {
+    std::wstring text;
+    wchar_t hex[4];
+    for (uint8_t i = 0; i < adapter.macLength; ++i) {
+        swprintf(hex, 4, i == 0 ? L"%02X" : L"-%02X", adapter.mac[i]);
+        text += hex;
+    }
+    return text;
+}
+
+std::wstring FormatMask(uint8_t prefixLength) {
+    std::array<uint8_t, 16> mask = {};
+    for (uint8_t bit = 0; bit < prefixLength && bit < 32; ++bit) mask[bit / 8] |= static_cast<uint8_t>(0x80 >> (bit % 8));
+    return FormatAddress(4, mask);
+}
+
+void AppendValue(std::wstring& text, const std::wstring& value) {
+    if (!text.empty()) text += L'\n';
+    text += value;
+}
+
+// Leere Felder bleiben ungesetzt und werden mit SetSkipEmpty nicht angezeigt
+void SetIfAny(ResultTable& table, size_t column, const std::wstring& value) {
+    if (!value.empty()) table.Set(column, value);
+}
+
+const wchar_t* KindPrefix(AdapterKind kind) {
+    switch (kind) {
+    case AdapterKind::Ethernet: return L"Ethernet-Adapter ";
+    case AdapterKind::Wireless: return L"Drahtlos-LAN-Adapter ";
+    case AdapterKind::Loopback: return L"Loopback-Adapter ";
+    case AdapterKind::Tunnel: return L"Tunneladapter ";
+    default: return L"Adapter ";
+    }
+}
+
+} // namespace
+
+NetConfigCache::NetConfigCache(std::unique_ptr<NetConfigSource> source)
+    : m_source(std::move(source)) {
+    m_thread = std::thread([this] { WatchLoop(); });
+}
+
+NetConfigCache::~NetConfigCache() {
+    m_stop = true;
+    m_source->Interrupt();
+    m_thread.join();
+}
+
+std::shared_ptr<const NetSnapshot> NetConfigCache::Current() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_snapshot;
+}
+
+std::shared_ptr<const NetSnapshot> NetConfigCache::Wait(JobContext& job, std::wstring& error) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_attempted && !job.Cancelled()) m_loaded.wait_for(lock, std::chrono::milliseconds(50));
+    if (!m_snapshot) error = m_error;
+    return m_snapshot;
+}
+
+void NetConfigCache::WatchLoop() {
+    Perf::SetThreadName(L"Netzwerk");
+    Reload();
+    while (!m_stop) {
+        bool failed = !Current();
+        bool changed = m_source->WaitForChange(failed ? RETRY : std::chrono::milliseconds(3600 * 1000));
+        if (m_stop) break;
+        if (!changed && !failed) continue;
+        // Weitere Meldungen desselben Schubs abwarten, hoechstens 20 Runden
+        for (int round = 0; round < 20 && !m_stop && m_source->WaitForChange(SETTLE); ++round) {}
+        if (!m_stop) Reload();
+    }
+}
+
+void NetConfigCache::Reload() {
+    PerfSpan span(L"NetConfig");
+    auto start = std::chrono::steady_clock::now();
+    auto snapshot = std::make_shared<NetSnapshot>();
+    std::wstring error;
+    bool loaded = m_source->Load(snapshot->adapters, error);
+    snapshot->loadMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_attempted = true;
+    if (loaded) {
+        snapshot->version = ++m_version;
+        m_snapshot = std::move(snapshot);
+        m_error.clear();
+    }
+    else if (!m_snapshot) {
+        m_error = error; // ein spaeterer Fehler behaelt den letzten guten Stand
+    }
+    m_loaded.notify_all();
+}
+
+std::shared_ptr<ResultTable> FormatIpConfig(const NetSnapshot& snapshot, bool all) {
+    auto table = std::make_shared<ResultTable>(ResultTable::Layout::List);
+    table->AddCaption(L"Windows IP-Konfiguration");
+    table->SetHeading(std::wstring(), L":");
+    table->SetIndent(2);
+    table->SetLabelWidth(36);
+    table->SetSkipEmpty(true);
+    size_t heading = table->AddTextColumn(std::wstring());
+    size_t media = table->AddTextColumn(L"Medienstatus");
+    size_t suffix = table->AddTextColumn(L"Verbindungsspezifisches DNS-Suffix");
+    size_t description = all ? table->AddTextColumn(L"Beschreibung") : SIZE_MAX;
+    size_t mac = all ? table->AddTextColumn(L"Physische Adresse") : SIZE_MAX;
+    size_t mtu = all ? table->AddNumberColumn(L"MTU") : SIZE_MAX;
+    size_t ipv6 = table->AddTextColumn(L"IPv6-Adresse");
+    size_t linkLocal = table->AddTextColumn(L"Verbindungslokale IPv6-Adresse");
+    size_t ipv4 = table->AddTextColumn(L"IPv4-Adresse");
+    size_t mask = table->AddTextColumn(L"Subnetzmaske");
+    size_t gateway = table->AddTextColumn(L"Standardgateway");
+    size_t dns = all ? table->AddTextColumn(L"DNS-Server") : SIZE_MAX;
+
+    std::wstring v6, local, v4, masks, gateways, servers;
+    for (const NetAdapter& adapter : snapshot.adapters) {
+        if (adapter.kind == AdapterKind::Loopback && !all) continue; // wie ipconfig.exe
+        table->AddRow();
+        table->Set(heading, KindPrefix(adapter.kind) + adapter.name);
+        if (all) {
+            SetIfAny(*table, description, adapter.description);
+            SetIfAny(*table, mac, FormatMac(adapter));
+            if (adapter.mtu) table->Set(mtu, static_cast<uint64_t>(adapter.mtu));
+        }
+        if (!adapter.up) {
+            table->Set(media, L"Medium getrennt");
+            continue;
+        }
+        table->Set(suffix, adapter.dnsSuffix); // wie ipconfig.exe auch leer
+
+        v6.clear(), local.clear(), v4.clear(), masks.clear(), gateways.clear(), servers.clear();
+        for (const NetAddress& address : adapter.addresses) {
+            if (address.family == 4) {
+                AppendValue(v4, FormatAddress(4, address.bytes));
+                AppendValue(masks, FormatMask(address.prefixLength));
+            }
+            else if (address.IsLinkLocal()) {
+                AppendValue(local, FormatAddress(6, address.bytes) + L"%" + std::to_wstring(adapter.index));
+            }
+            else {
+                AppendValue(v6, FormatAddress(6, address.bytes));
+            }
+        }
+        for (const NetAddress& address : adapter.gateways) AppendValue(gateways, FormatAddress(address.family, address.bytes));
+        for (const NetAddress& address : adapter.dnsServers) AppendValue(servers, FormatAddress(address.family, address.bytes));
+        SetIfAny(*table, ipv6, v6);
+        SetIfAny(*table, linkLocal, local);
+        SetIfAny(*table, ipv4, v4);
+        SetIfAny(*table, mask, masks);
+        table->Set(gateway, gateways);
+        if (all) SetIfAny(*table, dns, servers);
+    }
+    if (table->Rows() == 0) table->AddCaption(L"Keine Netzwerkadapter gefunden.");
+    return table;
+}
+
+#ifdef __linux__
+
+namespace {
+
+const char RESOLV_CONF[] = "/etc/resolv.conf";
+
+/**
+ * Netlink-Quelle: ein Socket fuer die Abfragen (Dump), ein zweiter in den Gruppen fuer Links,
+ * Adressen und Routen, der nur Aenderungen meldet. Getrennt, damit Meldungen nie mitten in eine
+ * Antwort geraten. DNS steht in /etc/resolv.conf; dessen Aenderungszeit wird beim Warten
+ * mitgeprueft. Ein eventfd weckt WaitForChange fuer das Beenden.
+ */
+class NetlinkConfigSource : public NetConfigSource {
+public:
+    NetlinkConfigSource() {
+        m_query = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+        m_notify = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+        m_wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (m_notify >= 0) {
+            sockaddr_nl address = {};
+            address.nl_family = AF_NETLINK;
+            address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+            if (bind(m_notify, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(m_notify);
+                m_notify = -1;
+            }
+        }
+        m_resolvStamp = ResolvStamp();
+    }
+
+    ~NetlinkConfigSource() override {
+        if (m_query >= 0) close(m_query);
+        if (m_notify >= 0) close(m_notify);
+        if (m_wake >= 0) close(m_wake);
+    }
+
+    bool Load(std::vector<NetAdapter>& adapters, std::wstring& error) override {
+        adapters.clear();
+        if (m_query < 0) {
+            error = L"Netlink-Socket konnte nicht geoeffnet werden.";
+            return false;
+        }
+        bool loaded = Dump(RTM_GETLINK, AF_UNSPEC, [&](const nlmsghdr* message) { AddLink(message, adapters); })
+            && Dump(RTM_GETADDR, AF_UNSPEC, [&](const nlmsghdr* message) { AddAddress(message, adapters); })
+            && Dump(RTM_GETROUTE, AF_UNSPEC, [&](const nlmsghdr* message) { AddGateway(message, adapters); });
+        if (!loaded) {
+            error = L"Netzwerkkonfiguration konnte nicht ueber Netlink gelesen werden.";
+            return false;
+        }
+        std::sort(adapters.begin(), adapters.end(), [](const NetAdapter& a, const NetAdapter& b) { return a.index < b.index; });
+        ReadResolvConf(adapters);
+        return true;
+    }
+
+    bool WaitForChange(std::chrono::milliseconds timeout) override {
+        // DNS hat keine Netlink-Meldung: resolv.conf hoechstens alle 2 s pruefen
+        constexpr std::chrono::milliseconds RESOLV_INTERVAL{ 2000 };
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            int64_t stamp = ResolvStamp();
+            if (stamp != m_resolvStamp) {
+                m_resolvStamp = stamp;
+                return true;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) return false;
+            pollfd fds[2] = { { m_wake, POLLIN, 0 }, { m_notify, POLLIN, 0 } };
+            int result = poll(fds, m_notify >= 0 ? 2 : 1, static_cast<int>(std::min(remaining, RESOLV_INTERVAL).count()));
+            if (result < 0 && errno != EINTR) return false;
+            if (fds[0].revents & POLLIN) {
+                uint64_t count;
+                (void)!read(m_wake, &count, sizeof(count));
+                return false;
+            }
+            if (m_notify >= 0 && (fds[1].revents & (POLLIN | POLLERR))) {
+                // Alles abholen; ENOBUFS (Meldungen verloren) heisst ebenfalls: neu laden
+                while (recv(m_notify, m_buffer.data(), m_buffer.size(), MSG_DONTWAIT) > 0 || errno == ENOBUFS) {}
+                return true;
+            }
+        }
+    }
+
+    void Interrupt() override {
+        uint64_t one = 1;
+        (void)!write(m_wake, &one, sizeof(one));
+    }
+
+private:
+    template <typename Handler>
+    bool Dump(uint16_t type, uint8_t family, Handler handler) {
+        struct {
+            nlmsghdr header;
+            rtgenmsg body;
+        } request = {};
+        request.header.nlmsg_len = sizeof(request);
+        request.header.nlmsg_type = type;
+        request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        request.header.nlmsg_seq = ++m_sequence;
+        request.body.rtgen_family = family;
+        if (send(m_query, &request, sizeof(request), 0) < 0) return false;
+
+        for (;;) {
+            ssize_t length = recv(m_query, m_buffer.data(), m_buffer.size(), 0);
+            if (length < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            int remaining = static_cast<int>(length);
+            for (const nlmsghdr* message = reinterpret_cast<const nlmsghdr*>(m_buffer.data()); NLMSG_OK(message, remaining);
+                message = NLMSG_NEXT(message, remaining)) {
+                if (message->nlmsg_seq != m_sequence) continue; // Rest einer frueheren Abfrage
+                if (message->nlmsg_type == NLMSG_DONE) return true;
+                if (message->nlmsg_type == NLMSG_ERROR) return false;
+                handler(message);
+            }
+        }
+    }
+
+    static NetAdapter* FindAdapter(std::vector<NetAdapter>& adapters, uint32_t index) {
+        for (NetAdapter& adapter : adapters) {
+            if (adapter.index == index) return &adapter;
+        }
+        return nullptr;
+    }
+
+    static void CopyAddress(NetAddress& address, const rtattr* attribute) {
+        size_t size = std::min<size_t>(RTA_PAYLOAD(attribute), address.bytes.size());
+        std::memcpy(address.bytes.data(), RTA_DATA(attribute), size);
+    }
+
+    static void AddLink(const nlmsghdr* message, std::vector<NetAdapter>& adapters) {
+        if (message->nlmsg_type != RTM_NEWLINK) return;
+        const auto* info = static_cast<const ifinfomsg*>(NLMSG_DATA(message));
+        NetAdapter& adapter = adapters.emplace_back();
+        adapter.index = static_cast<uint32_t>(info->ifi_index);
+        adapter.up = (info->ifi_flags & IFF_UP) && (info->ifi_flags & IFF_RUNNING);
+        switch (info->ifi_type) {
+        case ARPHRD_ETHER: adapter.kind = AdapterKind::Ethernet; break;
+        case ARPHRD_IEEE80211: adapter.kind = AdapterKind::Wireless; break;
+        case ARPHRD_LOOPBACK: adapter.kind = AdapterKind::Loopback; break;
+        case ARPHRD_TUNNEL: case ARPHRD_TUNNEL6: case ARPHRD_SIT: case ARPHRD_IPGRE: case ARPHRD_NONE:
+            adapter.kind = AdapterKind::Tunnel;
+            break;
+        default: break;
+        }
+        int length = static_cast<int>(IFLA_PAYLOAD(message));
+        for (const rtattr* attribute = IFLA_RTA(info); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+            if (attribute->rta_type == IFLA_IFNAME) {
+                adapter.name = Utf8ToWide(static_cast<const char*>(RTA_DATA(attribute)));
+            }
+            else if (attribute->rta_type == IFLA_MTU && RTA_PAYLOAD(attribute) >= sizeof(uint32_t)) {
+                std::memcpy(&adapter.mtu, RTA_DATA(attribute), sizeof(uint32_t));
+            }
+            else if (attribute->rta_type == IFLA_ADDRESS) {
+                adapter.macLength = static_cast<uint8_t>(std::min<size_t>(RTA_PAYLOAD(attribute), adapter.mac.size()));
+                std::memcpy(adapter.mac.data(), RTA_DATA(attribute), adapter.macLength);
+            }
+        }
+        // WLAN meldet sich als Ethernet; erkennbar am wireless-Verzeichnis in sysfs
+        if (adapter.kind == AdapterKind::Ethernet && access(("/sys/class/net/" + WideToUtf8(adapter.name) + "/wireless").c_str(), F_OK) == 0) {
+            adapter.kind = AdapterKind::Wireless;
+        }
+    }
+
+    static void AddAddress(const nlmsghdr* message, std::vector<NetAdapter>& adapters) {
+        if (message->nlmsg_type != RTM_NEWADDR) return;
+        const auto* info = static_cast<const ifaddrmsg*>(NLMSG_DATA(message));
+        if (info->ifa_family != AF_INET && info->ifa_family != AF_INET6) return;
+        NetAdapter* adapter = FindAdapter(adapters, info->ifa_index);
+        if (!adapter) return;
+        NetAddress address;
+        address.family = info->ifa_family == AF_INET ? 4 : 6;
+        address.prefixLength = info->ifa_prefixlen;
+        bool found = false;
+        int length = static_cast<int>(IFA_PAYLOAD(message));
+        for (const rtattr* attribute = IFA_RTA(info); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+            // IFA_LOCAL ist die eigene Adresse; IFA_ADDRESS bei Punkt-zu-Punkt die Gegenstelle
+            if (attribute->rta_type == IFA_LOCAL || (attribute->rta_type == IFA_ADDRESS && !found)) {
+                CopyAddress(address, attribute);
+                found = true;
+            }
+        }
+        if (found) adapter->addresses.push_back(address);
+    }
+
+    static void AddGateway(const nlmsghdr* message, std::vector<NetAdapter>& adapters) {
+        if (message->nlmsg_type != RTM_NEWROUTE) return;
+        const auto* info = static_cast<const rtmsg*>(NLMSG_DATA(message));
+        if (info->rtm_dst_len != 0 || info->rtm_type != RTN_UNICAST) return; // nur Standardrouten
+        if (info->rtm_family != AF_INET && info->rtm_family != AF_INET6) return;
+        NetAddress gateway;
+        gateway.family = info->rtm_family == AF_INET ? 4 : 6;
+        uint32_t table = info->rtm_table;
+        uint32_t index = 0;
+        bool found = false;
+        int length = static_cast<int>(RTM_PAYLOAD(message));
+        for (const rtattr* attribute = RTM_RTA(info); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+            if (attribute->rta_type == RTA_GATEWAY) {
+                CopyAddress(gateway, attribute);
+                found = true;
+            }
+            else if (attribute->rta_type == RTA_OIF && RTA_PAYLOAD(attribute) >= sizeof(uint32_t)) {
+                std::memcpy(&index, RTA_DATA(attribute), sizeof(uint32_t));
+            }
+            else if (attribute->rta_type == RTA_TABLE && RTA_PAYLOAD(attribute) >= sizeof(uint32_t)) {
+                std::memcpy(&table, RTA_DATA(attribute), sizeof(uint32_t));
+            }
+        }
+        if (!found || table != RT_TABLE_MAIN) return;
+        if (NetAdapter* adapter = FindAdapter(adapters, index)) adapter->gateways.push_back(gateway);
+    }
+
+    static int64_t ResolvStamp() {
+        struct stat info;
+        if (stat(RESOLV_CONF, &info) != 0) return 0;
+        return (static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec) ^ static_cast<int64_t>(info.st_ino);
+    }
+
+    // Linux kennt DNS-Server nur systemweit: sie gelten fuer alle verbundenen Adapter
+    static void ReadResolvConf(std::vector<NetAdapter>& adapters) {
+        std::ifstream file(RESOLV_CONF);
+        std::string line;
+        std::vector<NetAddress> servers;
+        std::wstring suffix;
+        while (std::getline(file, line)) {
+            size_t start = line.find_first_not_of(" \t");
+            if (start == std::string::npos || line[start] == '#' || line[start] == ';') continue;
+            size_t keyEnd = line.find_first_of(" \t", start);
+            if (keyEnd == std::string::npos) continue;
+            std::string key = line.substr(start, keyEnd - start);
+            size_t valueStart = line.find_first_not_of(" \t", keyEnd);
+            if (valueStart == std::string::npos) continue;
+            std::string value = line.substr(valueStart, line.find_first_of(" \t\r", valueStart) - valueStart);
+            if (key == "nameserver") {
+                NetAddress server;
+                if (inet_pton(AF_INET, value.c_str(), server.bytes.data()) == 1) server.family = 4;
+                else if (inet_pton(AF_INET6, value.substr(0, value.find('%')).c_str(), server.bytes.data()) == 1) server.family = 6;
+                else continue;
+                servers.push_back(server);
+            }
+            else if ((key == "search" || key == "domain") && suffix.empty()) {
+                suffix = Utf8ToWide(value);
+            }
+        }
+        for (NetAdapter& adapter : adapters) {
+            if (adapter.kind == AdapterKind::Loopback) continue;
+            adapter.dnsServers = servers;
+            adapter.dnsSuffix = suffix;
+        }
+    }
+
+    int m_query = -1;
+    int m_notify = -1;
+    int m_wake = -1;
+    uint32_t m_sequence = 0;
+    int64_t m_resolvStamp = 0;
+    std::vector<char> m_buffer = std::vector<char>(64 * 1024);
+};
+
+} // namespace
+
+std::unique_ptr<NetConfigSource> CreateNetlinkConfigSource() {
+    return std::make_unique<NetlinkConfigSource>();
+}
+
+#endif
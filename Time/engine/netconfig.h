@@ -0,0 +1,116 @@
+#pragma once
+
+#include "executor.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Eine Adresse eines Adapters in Netzwerk-Bytereihenfolge, IPv4 in den ersten vier Bytes.
+ */
+struct NetAddress {
+    std::array<uint8_t, 16> bytes = {};
+    uint8_t family = 4;       // 4 oder 6
+    uint8_t prefixLength = 0; // nur Unicast-Adressen
+
+    bool IsLinkLocal() const { return family == 6 && bytes[0] == 0xFE && (bytes[1] & 0xC0) == 0x80; }
+};
+
+enum class AdapterKind : uint8_t { Ethernet, Wireless, Loopback, Tunnel, Other };
+
+struct NetAdapter {
+    uint32_t index = 0;
+    std::wstring name;        // Win32: Anzeigename ("Ethernet"), Linux: eth0
+    std::wstring description; // Win32: Treiber, Linux: leer
+    AdapterKind kind = AdapterKind::Other;
+    bool up = false;          // verbunden (Medium vorhanden)
+    uint32_t mtu = 0;
+    std::array<uint8_t, 8> mac = {};
+    uint8_t macLength = 0;
+    std::wstring dnsSuffix;
+    std::vector<NetAddress> addresses;
+    std::vector<NetAddress> gateways;
+    std::vector<NetAddress> dnsServers;
+};
+
+/**
+ * Stand der Netzwerkkonfiguration; unveraenderlich, mehrere Leser teilen ihn.
+ */
+struct NetSnapshot {
+    std::vector<NetAdapter> adapters;
+    uint64_t version = 0;     // 1 = erstes Laden, danach je Aenderung eins mehr
+    uint64_t loadMicros = 0;  // Dauer des Ladens
+};
+
+/**
+ * Quelle der Netzwerkkonfiguration mit Aenderungsmeldungen (Win32: GetAdaptersAddresses und
+ * NotifyIpInterfaceChange/NotifyUnicastIpAddressChange, Linux: Netlink). Load und
+ * WaitForChange ruft nur der Ueberwachungsthread des Caches auf, Interrupt jeder Thread.
+ */
+class NetConfigSource {
+public:
+    virtual ~NetConfigSource() = default;
+
+    // Vollstaendiger Stand; false und Meldung, wenn nichts gelesen werden konnte.
+    virtual bool Load(std::vector<NetAdapter>& adapters, std::wstring& error) = 0;
+
+    // Wartet hoechstens timeout auf eine Aenderung (Schnittstelle, Adresse, Route, DNS); true,
+    // wenn eine gemeldet wurde. Kehrt nach Interrupt sofort zurueck.
+    virtual bool WaitForChange(std::chrono::milliseconds timeout) = 0;
+
+    virtual void Interrupt() = 0;
+};
+
+/**
+ * IPCONFIG aus dem Speicher: ein Thread laedt die Konfiguration einmal und danach nur, wenn die
+ * Quelle eine Aenderung meldet. Aenderungen kommen in Schueben (Adresse, Route, DNS nach einem
+ * Verbindungsaufbau); nach der ersten Meldung wird SETTLE lang gesammelt und dann einmal neu
+ * geladen. Leser bekommen den jeweils letzten Stand ohne zu warten.
+ */
+class NetConfigCache {
+public:
+    static constexpr std::chrono::milliseconds SETTLE{ 100 };
+    static constexpr std::chrono::milliseconds RETRY{ 5000 }; // nach einem Fehler beim Laden
+
+    explicit NetConfigCache(std::unique_ptr<NetConfigSource> source);
+    ~NetConfigCache();
+
+    NetConfigCache(const NetConfigCache&) = delete;
+    NetConfigCache& operator=(const NetConfigCache&) = delete;
+
+    // Letzter Stand; nullptr, solange das erste Laden laeuft oder fehlgeschlagen ist.
+    std::shared_ptr<const NetSnapshot> Current() const;
+
+    // Wartet auf den ersten Stand; nullptr bei Abbruch oder Fehler (error).
+    std::shared_ptr<const NetSnapshot> Wait(JobContext& job, std::wstring& error);
+
+private:
+    void WatchLoop();
+    void Reload();
+
+    std::unique_ptr<NetConfigSource> m_source;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_loaded;
+    std::shared_ptr<const NetSnapshot> m_snapshot;
+    std::wstring m_error;
+    bool m_attempted = false; // erstes Laden beendet (mit oder ohne Erfolg)
+    uint64_t m_version = 0;
+    std::atomic<bool> m_stop{ false };
+    std::thread m_thread;
+};
+
+// IPCONFIG [/ALL]: Adapter mit allen Adressen; /ALL zusaetzlich Beschreibung, MAC, MTU und DNS.
+std::shared_ptr<ResultTable> FormatIpConfig(const NetSnapshot& snapshot, bool all);
+
+#ifdef __linux__
+// Netlink-Quelle (RTM_GETLINK/GETADDR/GETROUTE, Gruppen fuer Aenderungen) plus /etc/resolv.conf.
+std::unique_ptr<NetConfigSource> CreateNetlinkConfigSource();
+#endif
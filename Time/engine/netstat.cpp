@@ -0,0 +1,401 @@
+#include "netstat.h"
+#include "clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <iterator>
+#include <sstream>
+#include <tuple>
+
+namespace {
+
+// Hoechstens so viele Aenderungen je Durchgang als Tabelle, der Rest wird nur gezaehlt
+constexpr size_t MAX_CHANGE_ROWS = 100;
+
+uint64_t LoadWord(const uint8_t* bytes) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+uint64_t Mix(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    return hash * 0xBF58476D1CE4E5B9ull;
+}
+
+uint64_t HashEndpoints(const Connection& c) {
+    uint64_t hash = static_cast<uint64_t>(c.protocol) << 40 | static_cast<uint64_t>(c.family) << 32
+        | static_cast<uint64_t>(c.localPort) << 16 | c.remotePort;
+    hash = Mix(hash, LoadWord(c.localAddress.data()));
+    hash = Mix(hash, LoadWord(c.localAddress.data() + 8));
+    hash = Mix(hash, LoadWord(c.remoteAddress.data()));
+    hash = Mix(hash, LoadWord(c.remoteAddress.data() + 8));
+    return hash ^ (hash >> 31);
+}
+
+bool ParseHex(std::string_view text, uint64_t& value) {
+    if (text.empty() || text.size() > 16) return false;
+    value = 0;
+    for (char c : text) {
+        int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10 : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+        if (digit < 0) return false;
+        value = value << 4 | static_cast<uint64_t>(digit);
+    }
+    return true;
+}
+
+// "0100007F:0CEA": Adresse als 32-Bit-Woerter in Host-Reihenfolge (wie der Kernel sie ausgibt)
+bool ParseProcEndpoint(std::string_view text, uint8_t family, std::array<uint8_t, 16>& address, uint16_t& port) {
+    size_t colon = text.find(':');
+    size_t digits = family == 4 ? 8 : 32;
+    if (colon != digits) return false;
+    for (size_t word = 0; word < digits / 8; ++word) {
+        uint64_t value;
+        if (!ParseHex(text.substr(word * 8, 8), value)) return false;
+        uint32_t raw = static_cast<uint32_t>(value);
+        memcpy(address.data() + word * 4, &raw, sizeof(raw));
+    }
+    uint64_t value;
+    if (!ParseHex(text.substr(colon + 1), value) || value > 0xFFFF) return false;
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+// Status aus /proc/net/tcp (include/net/tcp_states.h) nach TcpState
+TcpState ProcTcpState(uint64_t state) {
+    static const TcpState STATES[] = {
+        TcpState::None, TcpState::Established, TcpState::SynSent, TcpState::SynReceived,
+        TcpState::FinWait1, TcpState::FinWait2, TcpState::TimeWait, TcpState::Closed,
+        TcpState::CloseWait, TcpState::LastAck, TcpState::Listen, TcpState::Closing,
+    };
+    return state < std::size(STATES) ? STATES[state] : TcpState::None;
+}
+
+auto SortKey(const Connection& c) {
+    return std::tie(c.protocol, c.family, c.localAddress, c.localPort, c.remoteAddress, c.remotePort);
+}
+
+std::wstring RemoteEndpoint(const Connection& c) {
+    bool wildcard = c.protocol == NetProtocol::Udp && c.remotePort == 0;
+    return FormatEndpoint(c.family, c.remoteAddress, c.remotePort, wildcard);
+}
+
+/**
+ * Spalten wie bisher (Proto, Adressen, Status) plus PID wie netstat -o; mit change eine
+ * zusaetzliche erste Spalte fuer die Art der Aenderung.
+ */
+struct ConnectionColumns {
+    size_t change = SIZE_MAX;
+    size_t proto;
+    size_t local;
+    size_t remote;
+    size_t state;
+    size_t pid;
+
+    ConnectionColumns(ResultTable& table, bool withChange) {
+        table.SetIndent(2);
+        table.SetGap(2);
+        table.SetRule(false);
+        if (withChange) change = table.AddTextColumn(L"Aenderung");
+        proto = table.AddTextColumn(L"Proto");
+        local = table.AddTextColumn(L"Lokale Adresse");
+        remote = table.AddTextColumn(L"Remoteadresse");
+        state = table.AddTextColumn(L"Status");
+        pid = table.AddNumberColumn(L"PID");
+    }
+
+    void Add(ResultTable& table, const Connection& c, std::wstring_view stateText) const {
+        table.AddRow();
+        table.Set(proto, c.protocol == NetProtocol::Tcp ? L"TCP" : L"UDP");
+        table.Set(local, FormatEndpoint(c.family, c.localAddress, c.localPort, false));
+        table.Set(remote, RemoteEndpoint(c));
+        table.Set(state, stateText);
+        if (c.pid) table.Set(pid, static_cast<uint64_t>(c.pid));
+    }
+};
+
+} // namespace
+
+bool Connection::SameEndpoints(const Connection& other) const {
+    return protocol == other.protocol && family == other.family && localPort == other.localPort
+        && remotePort == other.remotePort && localAddress == other.localAddress && remoteAddress == other.remoteAddress;
+}
+
+void ConnectionTracker::BuildIndex() {
+    size_t capacity = 16;
+    while (capacity < m_current.size() * 2) capacity *= 2;
+    m_slots.assign(capacity, -1);
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < m_current.size(); ++i) {
+        size_t slot = HashEndpoints(m_current[i]) & mask;
+        while (m_slots[slot] >= 0) slot = (slot + 1) & mask;
+        m_slots[slot] = static_cast<int32_t>(i);
+    }
+}
+
+int32_t ConnectionTracker::FindUnmatched(const Connection& connection) const {
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = HashEndpoints(connection) & mask; m_slots[slot] >= 0; slot = (slot + 1) & mask) {
+        int32_t index = m_slots[slot];
+        if (!m_matched[index] && m_current[index].SameEndpoints(connection)) return index;
+    }
+    return -1;
+}
+
+const std::vector<ConnectionChange>& ConnectionTracker::Update(std::vector<Connection>& snapshot) {
+    m_changes.clear();
+    if (m_initialized) {
+        m_matched.assign(m_current.size(), 0);
+        for (const Connection& connection : snapshot) {
+            int32_t index = FindUnmatched(connection);
+            if (index < 0) {
+                m_changes.push_back({ ConnectionChange::Kind::Opened, TcpState::None, 0, connection });
+                continue;
+            }
+            m_matched[index] = 1;
+            const Connection& previous = m_current[index];
+            if (previous.state != connection.state || previous.pid != connection.pid) {
+                m_changes.push_back({ ConnectionChange::Kind::Changed, previous.state, previous.pid, connection });
+            }
+        }
+        for (size_t i = 0; i < m_current.size(); ++i) {
+            if (!m_matched[i]) m_changes.push_back({ ConnectionChange::Kind::Closed, TcpState::None, 0, m_current[i] });
+        }
+    }
+    m_initialized = true;
+    m_current.swap(snapshot);
+    BuildIndex();
+    return m_changes;
+}
+
+bool ParseNetstatArguments(const std::wstring& arguments, NetstatOptions& options, std::wstring& error) {
+    std::wstringstream iss(arguments);
+    std::wstring token;
+    while (iss >> token) {
+        bool option = token.size() == 2 && (token[0] == L'-' || token[0] == L'/');
+        if (!option || std::towlower(token[1]) != L'r') {
+            error = L"Ungueltige Option '" + token + L"' (erlaubt: -r <sekunden>).";
+            return false;
+        }
+        std::wstring value;
+        if (!(iss >> value)) {
+            error = L"Wert fuer Option '" + token + L"' fehlt.";
+            return false;
+        }
+        wchar_t* end = nullptr;
+        unsigned long seconds = wcstoul(value.c_str(), &end, 10);
+        if (value.empty() || *end != L'\0' || !std::iswdigit(value[0]) || seconds < 1 || seconds > 3600) {
+            error = L"Ungueltiger Wert '" + value + L"' fuer Option '" + token + L"' (erlaubt: 1 bis 3600).";
+            return false;
+        }
+        options.intervalSeconds = static_cast<uint32_t>(seconds);
+    }
+    return true;
+}
+
+const wchar_t* TcpStateName(TcpState state) {
+    switch (state) {
+    case TcpState::None: return L"";
+    case TcpState::Closed: return L"CLOSED";
+    case TcpState::Listen: return L"LISTEN";
+    case TcpState::SynSent: return L"SYN-SENT";
+    case TcpState::SynReceived: return L"SYN-RECEIVED";
+    case TcpState::Established: return L"ESTABLISHED";
+    case TcpState::FinWait1: return L"FIN-WAIT-1";
+    case TcpState::FinWait2: return L"FIN-WAIT-2";
+    case TcpState::CloseWait: return L"CLOSE-WAIT";
+    case TcpState::Closing: return L"CLOSING";
+    case TcpState::LastAck: return L"LAST-ACK";
+    case TcpState::TimeWait: return L"TIME-WAIT";
+    case TcpState::DeleteTcb: return L"DELETE-TCB";
+    }
+    return L"UNKNOWN";
+}
+
+std::wstring FormatAddress(uint8_t family, const std::array<uint8_t, 16>& address) {
+    wchar_t text[64];
+    int length = 0;
+    const uint8_t* a = address.data();
+    if (family == 4) {
+        swprintf(text, 64, L"%u.%u.%u.%u", a[0], a[1], a[2], a[3]);
+        return text;
+    }
+    static const uint8_t MAPPED_PREFIX[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+    if (memcmp(a, MAPPED_PREFIX, sizeof(MAPPED_PREFIX)) == 0) {
+        swprintf(text, 64, L"::ffff:%u.%u.%u.%u", a[12], a[13], a[14], a[15]);
+        return text;
+    }
+    // Laengste Folge von mindestens zwei Nullgruppen wird zu "::"
+    uint16_t groups[8];
+    for (int i = 0; i < 8; ++i) groups[i] = static_cast<uint16_t>(a[i * 2] << 8 | a[i * 2 + 1]);
+    int bestStart = -1;
+    int bestLength = 1;
+    for (int i = 0; i < 8;) {
+        int j = i;
+        while (j < 8 && groups[j] == 0) ++j;
+        if (j - i > bestLength) {
+            bestStart = i;
+            bestLength = j - i;
+        }
+        i = j == i ? i + 1 : j;
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (i == bestStart) {
+            text[length++] = L':';
+            if (i == 0) text[length++] = L':';
+            i += bestLength - 1;
+            continue;
+        }
+        length += swprintf(text + length, 64 - length, i < 7 ? L"%x:" : L"%x", groups[i]);
+    }
+    text[length] = L'\0';
+    return text;
+}
+
+std::wstring FormatEndpoint(uint8_t family, const std::array<uint8_t, 16>& address, uint16_t port, bool wildcard) {
+    if (wildcard) return L"*:*";
+    std::wstring text = family == 4 ? FormatAddress(family, address) : L"[" + FormatAddress(family, address) + L"]";
+    return text + L":" + std::to_wstring(port);
+}
+
+bool ParseProcNet(std::string_view text, NetProtocol protocol, uint8_t family,
+    std::vector<Connection>& out, std::vector<uint64_t>& inodes) {
+    // Erste Zeile ist die Ueberschrift
+    size_t pos = text.find('\n');
+    pos = pos == std::string_view::npos ? text.size() : pos + 1;
+
+    std::string_view fields[10];
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t count = 0;
+        for (size_t i = 0; i < line.size() && count < std::size(fields);) {
+            while (i < line.size() && line[i] == ' ') ++i;
+            size_t start = i;
+            while (i < line.size() && line[i] != ' ') ++i;
+            if (i > start) fields[count++] = line.substr(start, i - start);
+        }
+        if (count == 0) continue;
+        if (count < std::size(fields)) return false;
+
+        Connection connection;
+        connection.protocol = protocol;
+        connection.family = family;
+        uint64_t state;
+        uint64_t inode;
+        if (!ParseProcEndpoint(fields[1], family, connection.localAddress, connection.localPort)
+            || !ParseProcEndpoint(fields[2], family, connection.remoteAddress, connection.remotePort)
+            || !ParseHex(fields[3], state)) {
+            return false;
+        }
+        inode = 0;
+        for (char c : fields[9]) {
+            if (c < '0' || c > '9') return false;
+            inode = inode * 10 + static_cast<uint64_t>(c - '0');
+        }
+        if (protocol == NetProtocol::Tcp) connection.state = ProcTcpState(state);
+        out.push_back(connection);
+        inodes.push_back(inode);
+    }
+    return true;
+}
+
+void RunNetstat(JobContext& job, ConnectionSource& source, const NetstatOptions& options) {
+    std::vector<Connection> snapshot;
+    std::wstring error;
+    if (!source.Snapshot(snapshot, error)) {
+        job.AddError(L"FEHLER: " + error);
+        return;
+    }
+
+    if (options.intervalSeconds == 0) {
+        std::sort(snapshot.begin(), snapshot.end(), [](const Connection& a, const Connection& b) { return SortKey(a) < SortKey(b); });
+        auto table = std::make_shared<ResultTable>();
+        table->AddCaption(L"Aktive Verbindungen");
+        ConnectionColumns columns(*table, false);
+        table->Reserve(snapshot.size(), snapshot.size() * 64);
+        for (const Connection& c : snapshot) columns.Add(*table, c, TcpStateName(c.state));
+        job.AddTable(std::move(table));
+        return;
+    }
+
+    job.AddHistory(L"Verbindungen werden alle " + std::to_wstring(options.intervalSeconds)
+        + L" Sekunde(n) verglichen, angezeigt werden nur Aenderungen (Strg+C beendet).");
+    ConnectionTracker tracker;
+    tracker.Update(snapshot);
+
+    ClockFormatter clock;
+    uint64_t opened = 0;
+    uint64_t closed = 0;
+    uint64_t changed = 0;
+    auto status = [&] {
+        size_t tcp = std::count_if(tracker.Current().begin(), tracker.Current().end(),
+            [](const Connection& c) { return c.protocol == NetProtocol::Tcp; });
+        return L"Stand " + std::wstring(clock.Now().time, 8) + L": " + std::to_wstring(tracker.Current().size())
+            + L" Sockets (TCP " + std::to_wstring(tcp) + L", UDP " + std::to_wstring(tracker.Current().size() - tcp)
+            + L") | seit Beginn: " + std::to_wstring(opened) + L" neu, " + std::to_wstring(closed) + L" beendet, "
+            + std::to_wstring(changed) + L" geaendert";
+    };
+    job.SetLiveLine(status());
+
+    auto next = std::chrono::steady_clock::now();
+    for (;;) {
+        // Fester Takt wie bei PING, Strg+C beendet die Pause sofort
+        next += std::chrono::seconds(options.intervalSeconds);
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) next = now;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+        if (!job.Sleep(static_cast<uint32_t>(wait)) || job.Cancelled()) break;
+
+        if (!source.Snapshot(snapshot, error)) {
+            job.AddError(L"FEHLER: " + error);
+            break;
+        }
+        const std::vector<ConnectionChange>& changes = tracker.Update(snapshot);
+        if (!changes.empty()) {
+            size_t counts[3] = {};
+            for (const ConnectionChange& change : changes) counts[static_cast<size_t>(change.kind)]++;
+            opened += counts[0];
+            closed += counts[1];
+            changed += counts[2];
+
+            auto table = std::make_shared<ResultTable>();
+            std::wstring caption = std::wstring(clock.Now().time, 8) + L": " + std::to_wstring(counts[0]) + L" neu, "
+                + std::to_wstring(counts[1]) + L" beendet, " + std::to_wstring(counts[2]) + L" geaendert";
+            if (changes.size() > MAX_CHANGE_ROWS) {
+                caption += L" (die ersten " + std::to_wstring(MAX_CHANGE_ROWS) + L" angezeigt)";
+            }
+            table->AddCaption(std::move(caption));
+            ConnectionColumns columns(*table, true);
+            size_t rows = std::min(changes.size(), MAX_CHANGE_ROWS);
+            table->Reserve(rows, rows * 80);
+            for (size_t i = 0; i < rows; ++i) {
+                const ConnectionChange& change = changes[i];
+                const Connection& c = change.connection;
+                switch (change.kind) {
+                case ConnectionChange::Kind::Opened:
+                    columns.Add(*table, c, TcpStateName(c.state));
+                    table->Set(columns.change, L"neu");
+                    break;
+                case ConnectionChange::Kind::Closed:
+                    columns.Add(*table, c, TcpStateName(c.state));
+                    table->Set(columns.change, L"beendet");
+                    break;
+                case ConnectionChange::Kind::Changed:
+                    columns.Add(*table, c, change.previousState == c.state ? std::wstring(TcpStateName(c.state))
+                        : std::wstring(TcpStateName(change.previousState)) + L" -> " + TcpStateName(c.state));
+                    table->Set(columns.change, change.previousState != c.state ? L"Status" : L"PID");
+                    break;
+                }
+            }
+            job.AddTable(std::move(table));
+        }
+        job.SetLiveLine(status());
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "executor.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class NetProtocol : uint8_t { Tcp, Udp };
+
+// Werte wie MIB_TCP_STATE (Win32); UDP-Sockets haben keinen Status.
+enum class TcpState : uint8_t {
+    None, Closed, Listen, SynSent, SynReceived, Established, FinWait1, FinWait2, CloseWait,
+    Closing, LastAck, TimeWait, DeleteTcb
+};
+
+/**
+ * Eine Zeile von NETSTAT. Adressen in Netzwerk-Bytereihenfolge, IPv4 in den ersten vier Bytes;
+ * UDP hat keine Gegenstelle (remote leer, Port 0).
+ */
+struct Connection {
+    std::array<uint8_t, 16> localAddress = {};
+    std::array<uint8_t, 16> remoteAddress = {};
+    uint16_t localPort = 0;
+    uint16_t remotePort = 0;
+    uint32_t pid = 0; // 0 = unbekannt
+    NetProtocol protocol = NetProtocol::Tcp;
+    uint8_t family = 4; // 4 oder 6
+    TcpState state = TcpState::None;
+
+    // Gleicher Socket (Protokoll, Familie, beide Endpunkte); Status und PID zaehlen nicht.
+    bool SameEndpoints(const Connection& other) const;
+};
+
+/**
+ * Liefert den aktuellen Stand der Sockets (TCP und UDP, IPv4 und IPv6, jeweils mit PID). Das
+ * Frontend stellt die Implementierung bereit (Win32: GetExtendedTcpTable/GetExtendedUdpTable,
+ * Headless: /proc/net); eine Quelle gehoert genau einem NETSTAT-Job und darf ihre Puffer von
+ * Aufruf zu Aufruf wiederverwenden.
+ */
+class ConnectionSource {
+public:
+    virtual ~ConnectionSource() = default;
+
+    // Ersetzt den Inhalt von connections; false und Meldung, wenn keine Tabelle lesbar war.
+    virtual bool Snapshot(std::vector<Connection>& connections, std::wstring& error) = 0;
+};
+
+/**
+ * Aenderung zwischen zwei Staenden.
+ */
+struct ConnectionChange {
+    enum class Kind : uint8_t { Opened, Closed, Changed };
+
+    Kind kind;
+    TcpState previousState; // Changed
+    uint32_t previousPid;   // Changed
+    Connection connection;  // Closed: der alte Stand
+};
+
+/**
+ * Vergleicht aufeinanderfolgende Staende fuer NETSTAT -r. Der vorherige Stand ist ueber eine
+ * Hashtabelle (offene Adressierung, Schluessel = Endpunkte) indiziert, ein Vergleich kostet
+ * damit O(n) statt O(n^2). Gleiche Endpunkte duerfen mehrfach vorkommen (z.B. SO_REUSEPORT);
+ * jeder alte Eintrag wird hoechstens einem neuen zugeordnet. Staende, Index und Aenderungsliste
+ * werden wiederverwendet, im Dauerbetrieb faellt keine Speicheranforderung an.
+ */
+class ConnectionTracker {
+public:
+    // Uebernimmt snapshot als neuen Stand (snapshot erhaelt den alten zurueck) und liefert die
+    // Aenderungen; der erste Aufruf meldet keine.
+    const std::vector<ConnectionChange>& Update(std::vector<Connection>& snapshot);
+
+    const std::vector<Connection>& Current() const { return m_current; }
+
+private:
+    void BuildIndex();
+    int32_t FindUnmatched(const Connection& connection) const;
+
+    std::vector<Connection> m_current;
+    std::vector<int32_t> m_slots; // Index in m_current oder -1
+    std::vector<uint8_t> m_matched;
+    std::vector<ConnectionChange> m_changes;
+    bool m_initialized = false;
+};
+
+/**
+ * Optionen von NETSTAT.
+ */
+struct NetstatOptions {
+    uint32_t intervalSeconds = 0; // -r <sekunden>: nur Aenderungen bis Strg+C, 0 = einmalige Tabelle
+};
+
+bool ParseNetstatArguments(const std::wstring& arguments, NetstatOptions& options, std::wstring& error);
+
+const wchar_t* TcpStateName(TcpState state);
+
+// "a.b.c.d" bzw. IPv6 nach RFC 5952 (laengste Nullfolge als ::), ohne Klammern und Port.
+std::wstring FormatAddress(uint8_t family, const std::array<uint8_t, 16>& address);
+
+// "a.b.c.d:port" bzw. "[v6]:port" (RFC 5952, laengste Nullfolge als ::); Port 0 bei UDP als *.
+std::wstring FormatEndpoint(uint8_t family, const std::array<uint8_t, 16>& address, uint16_t port, bool wildcard);
+
+// Zerlegt den Inhalt von /proc/net/tcp, tcp6, udp oder udp6 und haengt die Sockets an out an;
+// inodes erhaelt parallel die Inode jedes Sockets (fuer die Zuordnung zur PID). Liefert false,
+// wenn eine Zeile nicht dem erwarteten Format entspricht.
+bool ParseProcNet(std::string_view text, NetProtocol protocol, uint8_t family,
+    std::vector<Connection>& out, std::vector<uint64_t>& inodes);
+
+// Fuehrt NETSTAT aus: einmalige Tabelle oder mit -r fortlaufende Aenderungen, bis Strg+C/STOP.
+void RunNetstat(JobContext& job, ConnectionSource& source, const NetstatOptions& options);
@@ -0,0 +1,344 @@
+#include "perf.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+std::atomic<bool> Perf::s_enabled{ false };
+
+namespace {
+
+/**
+ * Ring eines Threads. head zaehlt alle geschriebenen Eintraege; Eintrag i liegt in
+ * slots[i % RING_EVENTS]. Nur der besitzende Thread schreibt.
+ */
+struct PerfRing {
+    struct Slot {
+        std::atomic<const wchar_t*> name{ nullptr };
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> duration{ 0 };
+    };
+
+    std::unique_ptr<Slot[]> slots = std::make_unique<Slot[]>(Perf::RING_EVENTS);
+    std::atomic<uint64_t> head{ 0 };
+    std::atomic<bool> owned{ false };
+    // Nur unter Registry::mutex
+    uint64_t discardBelow = 0; // RESET: aeltere Eintraege nicht mehr melden
+    uint32_t thread = 0;       // fortlaufende Nummer in der Spur
+    const wchar_t* label = nullptr;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<PerfRing>> rings;
+    uint32_t nextThread = 0;
+    std::atomic<uint64_t> dropped{ 0 };
+};
+
+// Absichtlich nie freigegeben: Threads koennen noch beim Programmende ihren Ring zurueckgeben
+Registry& Rings() {
+    static Registry* registry = new Registry;
+    return *registry;
+}
+
+struct ThreadRing {
+    PerfRing* ring = nullptr;
+    bool unavailable = false; // alle MAX_THREADS Ringe belegt
+    const wchar_t* name = nullptr;
+
+    ~ThreadRing() {
+        if (ring) ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+PerfRing* AcquireRing() {
+    Registry& registry = Rings();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    PerfRing* ring = nullptr;
+    for (const auto& candidate : registry.rings) {
+        if (!candidate->owned.load(std::memory_order_acquire)) {
+            ring = candidate.get();
+            break;
+        }
+    }
+    if (!ring) {
+        if (registry.rings.size() >= Perf::MAX_THREADS) return nullptr;
+        registry.rings.push_back(std::make_unique<PerfRing>());
+        ring = registry.rings.back().get();
+    }
+    // Ein wiederverwendeter Ring beginnt leer; Leser halten dieselbe Sperre
+    ring->owned.store(true, std::memory_order_relaxed);
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->discardBelow = 0;
+    ring->thread = ++registry.nextThread;
+    ring->label = t_ring.name;
+    return ring;
+}
+
+struct CollectedEvent {
+    const wchar_t* name;
+    uint64_t start;
+    uint64_t duration;
+    uint32_t thread;
+};
+
+struct CollectedThread {
+    uint32_t thread;
+    const wchar_t* label;
+};
+
+/**
+ * Liest alle Ringe. Eintraege werden erst kopiert und danach mit einem erneut gelesenen head
+ * geprueft: alles, was der Besitzer inzwischen ueberschrieben haben kann, entfaellt.
+ */
+Perf::Stats Collect(std::vector<CollectedEvent>* events, std::vector<CollectedThread>* threads) {
+    Registry& registry = Rings();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    Perf::Stats stats;
+    stats.dropped = registry.dropped.load(std::memory_order_relaxed);
+    std::vector<CollectedEvent> copied;
+    for (const auto& ring : registry.rings) {
+        stats.ringBytes += sizeof(PerfRing) + Perf::RING_EVENTS * sizeof(PerfRing::Slot);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = std::max(ring->discardBelow, head > Perf::RING_EVENTS ? head - Perf::RING_EVENTS : 0);
+        if (head <= ring->discardBelow) continue;
+        ++stats.threads;
+        stats.overwritten += first - ring->discardBelow;
+        if (!events) {
+            stats.events += head - first;
+            continue;
+        }
+
+        copied.clear();
+        for (uint64_t i = first; i < head; ++i) {
+            const PerfRing::Slot& slot = ring->slots[i & (Perf::RING_EVENTS - 1)];
+            copied.push_back({ slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                slot.duration.load(std::memory_order_relaxed), ring->thread });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring->head.load(std::memory_order_relaxed);
+        for (uint64_t i = first; i < head; ++i) {
+            if (i + Perf::RING_EVENTS <= after) continue; // waehrend des Kopierens ueberschrieben
+            events->push_back(copied[i - first]);
+            ++stats.events;
+        }
+        if (threads) threads->push_back({ ring->thread, ring->label });
+    }
+    return stats;
+}
+
+// Zeichenkette fuer JSON: Anfuehrungszeichen, Backslash und Steuerzeichen maskiert
+void AppendJsonString(std::string& out, const wchar_t* text) {
+    out += '"';
+    for (char c : WideToUtf8(text ? text : L"?")) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+fs::path ToPath(const std::wstring& path) {
+#ifdef _WIN32
+    return fs::path(path);
+#else
+    return fs::path(WideToUtf8(path));
+#endif
+}
+
+std::wstring FormatMicros(double micros) {
+    wchar_t text[32];
+    if (micros < 1000.0) swprintf(text, 32, L"%.0f us", micros);
+    else if (micros < 1000000.0) swprintf(text, 32, L"%.1f ms", micros / 1000.0);
+    else swprintf(text, 32, L"%.2f s", micros / 1000000.0);
+    return text;
+}
+
+} // namespace
+
+void PerfHistogram::Add(uint64_t nanos) {
+    uint64_t micros = nanos / 1000;
+    size_t bucket = micros == 0 ? 0 : std::min<size_t>(BUCKETS - 1, std::bit_width(micros) - 1);
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(nanos, std::memory_order_relaxed);
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (nanos > max && !m_max.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+void PerfHistogram::Reset() {
+    for (auto& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+std::wstring PerfHistogram::Format(const wchar_t* title) const {
+    uint64_t counts[BUCKETS];
+    uint64_t count = 0;
+    uint64_t largest = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        count += counts[i];
+        largest = std::max(largest, counts[i]);
+    }
+    std::wstring text = title;
+    if (count == 0) return text + L": keine Messwerte\n";
+
+    // Perzentile als Obergrenze der Klasse, in der sie liegen
+    auto percentile = [&](double q) {
+        uint64_t target = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= target) return L"<" + FormatMicros(static_cast<double>(uint64_t{ 2 } << i));
+        }
+        return std::wstring(L"?");
+    };
+    text += L": " + std::to_wstring(count) + L", Mittel " + FormatMicros(m_total.load(std::memory_order_relaxed) / 1000.0 / count) +
+        L", p50 " + percentile(0.5) + L", p90 " + percentile(0.9) + L", p99 " + percentile(0.99) +
+        L", max " + FormatMicros(m_max.load(std::memory_order_relaxed) / 1000.0) + L"\n";
+
+    size_t first = 0;
+    size_t last = BUCKETS - 1;
+    while (counts[first] == 0) ++first;
+    while (counts[last] == 0) --last;
+    wchar_t line[128];
+    for (size_t i = first; i <= last; ++i) {
+        std::wstring range = (i == 0 ? std::wstring(L"0") : FormatMicros(static_cast<double>(uint64_t{ 1 } << i))) + L" - " +
+            (i == BUCKETS - 1 ? std::wstring(L"...") : FormatMicros(static_cast<double>(uint64_t{ 2 } << i)));
+        size_t bar = static_cast<size_t>((counts[i] * 30 + largest - 1) / largest);
+        swprintf(line, 128, L"    %-20ls |%-30ls| %llu\n", range.c_str(), std::wstring(bar, L'#').c_str(),
+            static_cast<unsigned long long>(counts[i]));
+        text += line;
+    }
+    return text;
+}
+
+void Perf::Enable(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Perf::Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count()) | 1;
+}
+
+void Perf::Record(const wchar_t* name, uint64_t start, uint64_t end) {
+    ThreadRing& local = t_ring;
+    if (!local.ring) {
+        if (!local.unavailable) local.ring = AcquireRing();
+        if (!local.ring) {
+            local.unavailable = true;
+            Rings().dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    PerfRing& ring = *local.ring;
+    uint64_t index = ring.head.load(std::memory_order_relaxed);
+    // Wer beim Lesen schon die neuen Werte sieht, sieht danach auch mindestens diesen head
+    std::atomic_thread_fence(std::memory_order_release);
+    PerfRing::Slot& slot = ring.slots[index & (RING_EVENTS - 1)];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(end > start ? end - start : 0, std::memory_order_relaxed);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+void Perf::SetThreadName(const wchar_t* name) {
+    t_ring.name = name;
+}
+
+void Perf::Reset() {
+    Registry& registry = Rings();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& ring : registry.rings) ring->discardBelow = ring->head.load(std::memory_order_acquire);
+        registry.dropped.store(0, std::memory_order_relaxed);
+    }
+    Frames().Reset();
+    Commands().Reset();
+    Jobs().Reset();
+}
+
+PerfHistogram& Perf::Frames() {
+    static PerfHistogram histogram;
+    return histogram;
+}
+
+PerfHistogram& Perf::Commands() {
+    static PerfHistogram histogram;
+    return histogram;
+}
+
+PerfHistogram& Perf::Jobs() {
+    static PerfHistogram histogram;
+    return histogram;
+}
+
+Perf::Stats Perf::Statistics() {
+    return Collect(nullptr, nullptr);
+}
+
+bool Perf::WriteChromeTrace(const std::wstring& path, size_t& events, std::wstring& error) {
+    std::vector<CollectedEvent> collected;
+    std::vector<CollectedThread> threads;
+    Collect(&collected, &threads);
+    std::sort(collected.begin(), collected.end(),
+        [](const CollectedEvent& a, const CollectedEvent& b) { return a.start < b.start; });
+    uint64_t origin = collected.empty() ? 0 : collected.front().start;
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Time\"}}";
+    char number[160];
+    for (const CollectedThread& thread : threads) {
+        snprintf(number, sizeof(number), ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", thread.thread);
+        json += number;
+        if (thread.label) AppendJsonString(json, thread.label);
+        else json += "\"Thread " + std::to_string(thread.thread) + "\"";
+        json += "}}";
+    }
+    for (const CollectedEvent& event : collected) {
+        json += ",\n{\"name\":";
+        AppendJsonString(json, event.name);
+        snprintf(number, sizeof(number), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            (event.start - origin) / 1000.0, event.duration / 1000.0, event.thread);
+        json += number;
+    }
+    json += "\n]}\n";
+
+    std::ofstream file(ToPath(path), std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(json.data(), static_cast<std::streamsize>(json.size()))) {
+        error = L"'" + path + L"' konnte nicht geschrieben werden.";
+        return false;
+    }
+    events = collected.size();
+    return true;
+}
+
+void PerfSpan::Finish() {
+    uint64_t end = Perf::Now();
+    Perf::Record(m_name, m_start, end);
+    if (m_histogram) m_histogram->Add(end - m_start);
+}
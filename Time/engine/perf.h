@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * Verteilung von Dauern (Bildzeit, Befehlslatenz) in Zweierpotenz-Klassen ab 1 us; Klasse i
+ * umfasst [2^i, 2^(i+1)) us, die letzte alles darueber. Add ist von jedem Thread aus erlaubt.
+ */
+class PerfHistogram {
+public:
+    static constexpr size_t BUCKETS = 24;
+
+    void Add(uint64_t nanos);
+    void Reset();
+
+    uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+
+    // Anzahl, Median, p90, p99, Maximum und je belegter Klasse ein Balken.
+    std::wstring Format(const wchar_t* title) const;
+
+private:
+    std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<uint64_t> m_total{ 0 };
+    std::atomic<uint64_t> m_max{ 0 };
+};
+
+/**
+ * Spuraufzeichnung fuer PERF. Jeder Thread schreibt abgeschlossene Spannen ohne Sperre in einen
+ * eigenen Ring (RING_EVENTS Eintraege, die aeltesten werden ueberschrieben); nur das erstmalige
+ * Zuteilen eines Rings nimmt eine Sperre. Beendete Threads geben ihren Ring zur Wiederverwendung
+ * frei. Lesen (Statistik, DUMP) ist jederzeit von einem anderen Thread aus moeglich: Eintraege,
+ * die waehrenddessen ueberschrieben worden sein koennten, werden verworfen.
+ *
+ * Ausgeschaltet (Standard) kostet eine Spanne nur das Lesen des Schalters und einen Sprung;
+ * am Ende des Blocks wird lediglich die (dann leere) Startzeit auf dem Stack geprueft.
+ */
+class Perf {
+public:
+    static constexpr size_t RING_EVENTS = 16384; // je Thread, Zweierpotenz
+    static constexpr size_t MAX_THREADS = 64;    // weitere Threads zeichnen nicht auf
+
+    static bool Enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void Enable(bool enabled);
+
+    // Zeitstempel in ns (steady_clock), nie 0.
+    static uint64_t Now();
+
+    // name muss eine Zeichenkettenkonstante sein (es wird nur der Zeiger gespeichert).
+    static void Record(const wchar_t* name, uint64_t start, uint64_t end);
+
+    // Name des aufrufenden Threads in der Spur (z.B. "UI"), vor seiner ersten Spanne.
+    static void SetThreadName(const wchar_t* name);
+
+    // Verwirft alle Spannen und Histogramme.
+    static void Reset();
+
+    static PerfHistogram& Frames();   // CellRenderer::Render
+    static PerfHistogram& Commands(); // ProcessCommand bis zur Rueckkehr des Handlers
+    static PerfHistogram& Jobs();     // Laufzeit der Jobs auf den Arbeitsthreads
+
+    struct Stats {
+        size_t threads = 0;
+        uint64_t events = 0;      // noch im Ring
+        uint64_t overwritten = 0; // aus vollen Ringen verdraengt
+        uint64_t dropped = 0;     // Threads ohne Ring
+        size_t ringBytes = 0;
+    };
+    static Stats Statistics();
+
+    // Alle Spannen im Trace-Event-Format von Chrome (chrome://tracing, Perfetto).
+    static bool WriteChromeTrace(const std::wstring& path, size_t& events, std::wstring& error);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * Misst den umschlossenen Block als Spanne; mit histogram auch dessen Verteilung.
+ */
+class PerfSpan {
+public:
+    explicit PerfSpan(const wchar_t* name, PerfHistogram* histogram = nullptr)
+        : m_name(name), m_histogram(histogram), m_start(Perf::Enabled() ? Perf::Now() : 0) {}
+
+    ~PerfSpan() {
+        if (m_start != 0) Finish();
+    }
+
+    PerfSpan(const PerfSpan&) = delete;
+    PerfSpan& operator=(const PerfSpan&) = delete;
+
+private:
+    void Finish();
+
+    const wchar_t* m_name;
+    PerfHistogram* m_histogram;
+    uint64_t m_start;
+};
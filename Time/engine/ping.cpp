@@ -0,0 +1,262 @@
+#include "ping.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cwchar>
+#include <cwctype>
+#include <sstream>
+
+namespace {
+
+bool ParseNumber(const std::wstring& text, uint32_t minimum, uint32_t maximum, uint32_t& value) {
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](wchar_t c) { return c >= L'0' && c <= L'9'; })) {
+        return false;
+    }
+    if (text.size() > 10) return false;
+    unsigned long long parsed = std::stoull(text);
+    if (parsed < minimum || parsed > maximum) return false;
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+} // namespace
+
+bool ParsePingArguments(const std::wstring& arguments, std::wstring& host, PingOptions& options, std::wstring& error) {
+    std::wstringstream iss(arguments);
+    std::wstring token;
+    host.clear();
+    while (iss >> token) {
+        if (token.size() < 2 || (token[0] != L'-' && token[0] != L'/')) {
+            if (!host.empty()) {
+                error = L"Mehr als ein Host angegeben ('" + token + L"').";
+                return false;
+            }
+            host = token;
+            continue;
+        }
+
+        wchar_t option = static_cast<wchar_t>(std::towlower(token[1]));
+        if (token.size() != 2) option = 0;
+        if (option == L't') {
+            options.continuous = true;
+            continue;
+        }
+        if (option == L'4' || option == L'6') {
+            options.family = option == L'4' ? 4 : 6;
+            continue;
+        }
+
+        // Optionen mit Wert
+        uint32_t* target = nullptr;
+        uint32_t minimum = 0;
+        uint32_t maximum = 0;
+        switch (option) {
+        case L'n': target = &options.count; minimum = 1; maximum = UINT32_MAX; break;
+        case L'l': target = &options.payloadBytes; minimum = 0; maximum = 65500; break;
+        case L'i': target = &options.intervalMs; minimum = 0; maximum = 3600000; break;
+        case L'w': target = &options.timeoutMs; minimum = 1; maximum = 600000; break;
+        default:
+            error = L"Ungueltige Option '" + token + L"'.";
+            return false;
+        }
+        std::wstring value;
+        if (!(iss >> value)) {
+            error = L"Wert fuer Option '" + token + L"' fehlt.";
+            return false;
+        }
+        if (!ParseNumber(value, minimum, maximum, *target)) {
+            error = L"Ungueltiger Wert '" + value + L"' fuer Option '" + token + L"' (erlaubt: "
+                + std::to_wstring(minimum) + L" bis " + std::to_wstring(maximum) + L").";
+            return false;
+        }
+    }
+    if (host.empty()) {
+        error = L"Hostname oder IP-Adresse erforderlich.";
+        return false;
+    }
+    return true;
+}
+
+// --- FakePingProber ---
+
+FakePingProber::FakePingProber(uint32_t baseMicros, uint32_t jitterMicros, uint32_t lossPercent, uint32_t seed)
+    : m_baseMicros(baseMicros), m_jitterMicros(jitterMicros),
+      m_lossPercent(std::min<uint32_t>(lossPercent, 100)), m_state(seed ? seed : 1) {
+}
+
+bool FakePingProber::Open(const std::wstring& host, int family, std::wstring& address, std::wstring& error) {
+    (void)error;
+    address = family == 6 ? L"::1" : L"127.0.0.1";
+    if (host != L"localhost") address = host;
+    return true;
+}
+
+PingReply FakePingProber::Echo(uint32_t payloadBytes, uint32_t timeoutMs) {
+    PingReply reply;
+    if (Next() % 100 < m_lossPercent) return reply; // Timeout
+    // Groessere Pakete brauchen etwas laenger (ca. 1 us je 100 Bytes)
+    uint32_t rtt = m_baseMicros + (m_jitterMicros ? Next() % (m_jitterMicros + 1) : 0) + payloadBytes / 100;
+    if (rtt > static_cast<uint64_t>(timeoutMs) * 1000) return reply;
+    reply.status = PingReply::Status::Ok;
+    reply.rttMicros = rtt;
+    return reply;
+}
+
+// xorshift32: schnell und fuer gleiche Startwerte immer gleich
+uint32_t FakePingProber::Next() {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return m_state;
+}
+
+// --- RttHistogram ---
+
+size_t RttHistogram::IndexOf(uint32_t micros) {
+    if (micros < SUB_BUCKETS) return micros;
+    int msb = 31 - std::countl_zero(micros);
+    int shift = msb - SUB_BUCKET_BITS;
+    return (static_cast<size_t>(shift + 1) << SUB_BUCKET_BITS) + ((micros >> shift) - SUB_BUCKETS);
+}
+
+uint32_t RttHistogram::LowerBound(size_t index) {
+    size_t block = index >> SUB_BUCKET_BITS;
+    uint32_t sub = static_cast<uint32_t>(index & (SUB_BUCKETS - 1));
+    if (block == 0) return sub;
+    return static_cast<uint32_t>((SUB_BUCKETS + sub) << (block - 1));
+}
+
+uint32_t RttHistogram::Width(size_t index) {
+    size_t block = index >> SUB_BUCKET_BITS;
+    return block == 0 ? 1u : 1u << (block - 1);
+}
+
+void RttHistogram::Add(uint32_t micros) {
+    m_buckets[IndexOf(micros)]++;
+    m_count++;
+}
+
+void RttHistogram::Clear() {
+    m_buckets.fill(0);
+    m_count = 0;
+}
+
+uint32_t RttHistogram::Percentile(double percent) const {
+    if (m_count == 0) return 0;
+    percent = std::clamp(percent, 0.0, 100.0);
+    uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percent / 100.0 * m_count)), 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) return LowerBound(i) + (Width(i) - 1) / 2;
+    }
+    return LowerBound(BUCKET_COUNT - 1);
+}
+
+// --- PingStatistics ---
+
+void PingStatistics::AddReply(uint32_t rttMicros) {
+    if (m_received > 0) {
+        // Jitter wie RFC 3550: gleitender Mittelwert der Differenz aufeinanderfolgender Laufzeiten
+        double delta = std::fabs(static_cast<double>(rttMicros) - static_cast<double>(m_last));
+        m_jitter += (delta - m_jitter) / 16.0;
+    }
+    m_last = rttMicros;
+    m_sent++;
+    m_received++;
+    m_min = std::min(m_min, rttMicros);
+    m_max = std::max(m_max, rttMicros);
+    m_sum += rttMicros;
+    m_histogram.Add(rttMicros);
+}
+
+uint32_t PingStatistics::LossPercent() const {
+    return m_sent ? static_cast<uint32_t>((Lost() * 100 + m_sent / 2) / m_sent) : 0;
+}
+
+uint32_t PingStatistics::AverageMicros() const {
+    return m_received ? static_cast<uint32_t>(m_sum / m_received) : 0;
+}
+
+uint32_t PingStatistics::PercentileMicros(double percent) const {
+    // Stufenmitte auf den tatsaechlich gemessenen Bereich begrenzen
+    return m_received ? std::clamp(m_histogram.Percentile(percent), m_min, m_max) : 0;
+}
+
+std::wstring PingStatistics::StatusText() const {
+    std::wstringstream ss;
+    ss << L"Gesendet=" << m_sent << L" Empfangen=" << m_received << L" Verlust=" << LossPercent() << L"%";
+    if (m_received) {
+        ss << L" | Min=" << FormatRtt(MinMicros()) << L" Mittel=" << FormatRtt(AverageMicros())
+           << L" Max=" << FormatRtt(MaxMicros()) << L" Jitter=" << FormatRtt(JitterMicros())
+           << L" p50=" << FormatRtt(PercentileMicros(50)) << L" p99=" << FormatRtt(PercentileMicros(99));
+    }
+    return ss.str();
+}
+
+std::wstring FormatRtt(uint32_t micros) {
+    wchar_t text[32];
+    // Unter einer Millisekunde (Loopback, LAN) drei Nachkommastellen, sonst eine
+    if (micros < 1000) swprintf(text, 32, L"0.%03ums", micros);
+    else swprintf(text, 32, L"%u.%ums", (micros + 50) / 1000, (micros + 50) / 100 % 10);
+    return text;
+}
+
+void RunPing(JobContext& job, PingProber& prober, const std::wstring& host, const PingOptions& options) {
+    std::wstring address;
+    std::wstring error;
+    if (!prober.Open(host, options.family, address, error)) {
+        job.AddError(L"FEHLER: " + error);
+        return;
+    }
+
+    std::wstring target = address == host ? address : host + L" [" + address + L"]";
+    job.AddHistory(L"Ping wird ausgefuehrt fuer " + target + L" mit " + std::to_wstring(options.payloadBytes)
+        + L" Bytes Daten:");
+
+    PingStatistics stats;
+    auto next = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; options.continuous || i < options.count; ++i) {
+        if (job.Cancelled()) break;
+        PingReply reply = prober.Echo(options.payloadBytes, options.timeoutMs);
+
+        std::wstring line = L"Antwort " + std::to_wstring(i + 1) + L": ";
+        if (reply.status == PingReply::Status::Ok) {
+            stats.AddReply(reply.rttMicros);
+            line += L"Zeit=" + FormatRtt(reply.rttMicros);
+        }
+        else {
+            stats.AddLoss();
+            line += reply.status == PingReply::Status::Timeout ? L"Zeitueberschreitung" : reply.error;
+        }
+        job.SetLiveLine(line + L" | " + stats.StatusText());
+
+        // Fester Takt ab Sendebeginn, Strg+C beendet die Pause sofort
+        bool last = !options.continuous && i + 1 >= options.count;
+        if (last) break;
+        next += std::chrono::milliseconds(options.intervalMs);
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        else {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+            if (wait > 0 && !job.Sleep(static_cast<uint32_t>(wait))) break;
+        }
+    }
+
+    std::wstringstream ss;
+    ss << L"\nPing-Statistik fuer " << address << L":\n"
+       << L"    Pakete: Gesendet = " << stats.Sent() << L", Empfangen = " << stats.Received()
+       << L", Verloren = " << stats.Lost() << L" (" << stats.LossPercent() << L"% Verlust)";
+    if (stats.Received()) {
+        ss << L",\nCa. Zeitangaben in Millisek.:\n"
+           << L"    Minimum = " << FormatRtt(stats.MinMicros()) << L", Maximum = " << FormatRtt(stats.MaxMicros())
+           << L", Mittelwert = " << FormatRtt(stats.AverageMicros()) << L"\n"
+           << L"    Jitter = " << FormatRtt(stats.JitterMicros()) << L", p50 = " << FormatRtt(stats.PercentileMicros(50))
+           << L", p99 = " << FormatRtt(stats.PercentileMicros(99));
+    }
+    job.AddHistory(ss.str());
+}
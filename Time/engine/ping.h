@@ -0,0 +1,138 @@
+#pragma once
+
+#include "executor.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+/**
+ * Optionen von PING (Schreibweise wie ping.exe, '-' oder '/').
+ */
+struct PingOptions {
+    uint32_t count = 4;          // -n <anzahl>
+    bool continuous = false;     // -t: bis Strg+C / STOP
+    uint32_t payloadBytes = 32;  // -l <groesse>
+    uint32_t intervalMs = 1000;  // -i <ms>: Abstand zwischen zwei Anfragen
+    uint32_t timeoutMs = 1000;   // -w <ms>: Wartezeit je Antwort
+    int family = 0;              // -4 / -6, 0 = wie aufgeloest
+};
+
+// Zerlegt die Argumente hinter PING (Originalschreibweise). Liefert false und eine
+// Fehlermeldung bei unbekannten Optionen, fehlenden Werten oder fehlendem Host.
+bool ParsePingArguments(const std::wstring& arguments, std::wstring& host, PingOptions& options, std::wstring& error);
+
+/**
+ * Ergebnis einer einzelnen Echo-Anfrage.
+ */
+struct PingReply {
+    enum class Status { Ok, Timeout, Error };
+
+    Status status = Status::Timeout;
+    uint32_t rttMicros = 0;
+    std::wstring error; // Error: Meldung des Systems, z.B. "Zielhost nicht erreichbar."
+};
+
+/**
+ * Sendet Echo-Anfragen an ein Ziel. Das Frontend liefert die Implementierung (Win32: ICMP fuer
+ * IPv4 und IPv6, Headless: UDP ueber Loopback oder simuliert); die Auswertung in RunPing ist
+ * fuer alle gleich. Ein Prober gehoert genau einem PING-Job und laeuft auf dessen Thread.
+ */
+class PingProber {
+public:
+    virtual ~PingProber() = default;
+
+    // Loest host auf (family 0, 4 oder 6) und merkt sich das Ziel; address erhaelt die Textform.
+    virtual bool Open(const std::wstring& host, int family, std::wstring& address, std::wstring& error) = 0;
+
+    virtual PingReply Echo(uint32_t payloadBytes, uint32_t timeoutMs) = 0;
+};
+
+/**
+ * Simuliertes Ziel mit reproduzierbaren Laufzeiten (fuer Tests ohne Netzwerk): Basiszeit plus
+ * gleichverteilter Schwankung, ein Anteil der Anfragen geht verloren.
+ */
+class FakePingProber : public PingProber {
+public:
+    FakePingProber(uint32_t baseMicros = 800, uint32_t jitterMicros = 400, uint32_t lossPercent = 0, uint32_t seed = 1);
+
+    bool Open(const std::wstring& host, int family, std::wstring& address, std::wstring& error) override;
+    PingReply Echo(uint32_t payloadBytes, uint32_t timeoutMs) override;
+
+private:
+    uint32_t Next();
+
+    uint32_t m_baseMicros;
+    uint32_t m_jitterMicros;
+    uint32_t m_lossPercent;
+    uint32_t m_state;
+};
+
+/**
+ * Histogramm der Antwortzeiten mit fester Groesse (log-linear wie HdrHistogram): Werte unter 64 us
+ * exakt, darueber 32 Stufen je Zweierpotenz, also hoechstens ca. 3 % Abweichung bei Perzentilen.
+ * Belegt unabhaengig von der Anzahl der Pakete immer gleich viel Speicher (PING -t).
+ */
+class RttHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void Add(uint32_t micros);
+    void Clear();
+
+    uint64_t Count() const { return m_count; }
+
+    // Wert, unter dem percent Prozent der Messungen liegen (Mitte der Stufe), 0 ohne Messungen.
+    uint32_t Percentile(double percent) const;
+
+    static size_t IndexOf(uint32_t micros);
+    static uint32_t LowerBound(size_t index);
+    static uint32_t Width(size_t index);
+
+private:
+    std::array<uint32_t, BUCKET_COUNT> m_buckets{};
+    uint64_t m_count = 0;
+};
+
+/**
+ * Laufende Statistik eines PING: Verlust, Min/Mittel/Max, Jitter (gleitend wie RFC 3550) und
+ * Perzentile aus dem Histogramm.
+ */
+class PingStatistics {
+public:
+    void AddReply(uint32_t rttMicros);
+    void AddLoss() { m_sent++; }
+
+    uint64_t Sent() const { return m_sent; }
+    uint64_t Received() const { return m_received; }
+    uint64_t Lost() const { return m_sent - m_received; }
+    uint32_t LossPercent() const;
+
+    uint32_t MinMicros() const { return m_received ? m_min : 0; }
+    uint32_t MaxMicros() const { return m_max; }
+    uint32_t AverageMicros() const;
+    uint32_t JitterMicros() const { return static_cast<uint32_t>(m_jitter); }
+    uint32_t PercentileMicros(double percent) const;
+
+    // Einzeilige Zusammenfassung fuer die laufend aktualisierte Statuszeile.
+    std::wstring StatusText() const;
+
+private:
+    uint64_t m_sent = 0;
+    uint64_t m_received = 0;
+    uint32_t m_min = UINT32_MAX;
+    uint32_t m_max = 0;
+    uint64_t m_sum = 0;
+    uint32_t m_last = 0;
+    double m_jitter = 0.0;
+    RttHistogram m_histogram;
+};
+
+// Formatiert Mikrosekunden als Millisekunden mit einer Nachkommastelle ("12.3ms", "<0.1ms").
+std::wstring FormatRtt(uint32_t micros);
+
+// Fuehrt PING aus: Kopfzeile, eine Statuszeile, die pro Antwort ersetzt statt verlaengert wird,
+// und am Ende die Statistik (auch nach Strg+C).
+void RunPing(JobContext& job, PingProber& prober, const std::wstring& host, const PingOptions& options);
@@ -0,0 +1,365 @@
+#include "pipeline.h"
+#include "line_index.h"
+#include "mapped_file.h"
+#include "perf.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <exception>
+#include <map>
+#include <thread>
+
+namespace {
+
+constexpr std::chrono::milliseconds WAIT_SLICE{ 50 }; // so oft pruefen Wartende den Abbruch
+
+/**
+ * Gemeinsamer Zugang aller Stufen zum Job: Ausgaben kommen von mehreren Threads, der Job selbst
+ * (ohne Executor: direkt der Verlauf) erwartet sie nur von einem.
+ */
+class SharedJobContext : public JobContext {
+public:
+    explicit SharedJobContext(JobContext& job)
+        : m_job(job) {
+    }
+
+    void AddHistory(const std::wstring& text) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job.AddHistory(text);
+    }
+
+    void AddError(const std::wstring& text) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job.AddError(text);
+    }
+
+    void SetLiveLine(uint32_t slot, const std::wstring& text) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job.SetLiveLine(slot, text);
+    }
+
+    void AddTable(std::shared_ptr<ResultTable> table) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job.AddTable(std::move(table));
+    }
+
+    bool Cancelled() const override { return m_job.Cancelled(); }
+    bool Sleep(uint32_t milliseconds) override { return m_job.Sleep(milliseconds); }
+
+private:
+    JobContext& m_job;
+    std::mutex m_mutex;
+};
+
+/**
+ * JobContext der Quelle: zerlegt ihre Ausgabe in Zeilen und schreibt sie in die erste
+ * Warteschlange. Fehlermeldungen (AddError) gehen wie stderr an der Pipeline vorbei direkt in
+ * den Verlauf.
+ * Statuszeilen (PING-Statistik) werden erst am Ende mit ihrem letzten Stand weitergegeben.
+ */
+class PipeSourceContext : public JobContext {
+public:
+    PipeSourceContext(JobContext& job, RecordQueue& out)
+        : m_job(job), m_out(out) {
+    }
+
+    void AddHistory(const std::wstring& text) override {
+        RecordBatch batch;
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t end = text.find(L'\n', start);
+            if (end == std::wstring::npos) end = text.size();
+            std::wstring_view line(text.data() + start, end - start);
+            if (!line.empty() && line.back() == L'\r') line.remove_suffix(1);
+            if (end < text.size() || !line.empty()) batch.emplace_back(line); // wie Scrollback::Append
+            start = end + 1;
+        }
+        if (!batch.empty()) m_out.Write(batch);
+    }
+
+    void AddError(const std::wstring& text) override {
+        m_job.AddError(text);
+    }
+
+    void SetLiveLine(uint32_t slot, const std::wstring& text) override {
+        m_live[slot] = text.substr(0, text.find(L'\n'));
+    }
+
+    void AddTable(std::shared_ptr<ResultTable> table) override {
+        RecordBatch batch;
+        for (size_t i = 0; i < table->LineCount() && !Cancelled(); ++i) {
+            table->FormatLine(i, batch.emplace_back());
+            if (batch.size() >= OutputBlock::MAX_LINES) m_out.Write(batch);
+        }
+        if (!batch.empty()) m_out.Write(batch);
+    }
+
+    bool Cancelled() const override { return m_job.Cancelled() || m_out.Abandoned(); }
+
+    bool Sleep(uint32_t milliseconds) override {
+        // In Scheiben, damit ein Ende der Leser (z.B. Filterfehler) nicht den ganzen Schlaf dauert
+        while (milliseconds > 0 && !Cancelled()) {
+            uint32_t slice = std::min<uint32_t>(milliseconds, static_cast<uint32_t>(WAIT_SLICE.count()));
+            if (!m_job.Sleep(slice)) return false;
+            milliseconds -= slice;
+        }
+        return !Cancelled();
+    }
+
+    // Letzter Stand der Statuszeilen, in der Reihenfolge ihrer Nummern
+    void Finish() {
+        RecordBatch batch;
+        for (auto& [slot, text] : m_live) batch.push_back(std::move(text));
+        m_live.clear();
+        if (!batch.empty()) m_out.Write(batch);
+    }
+
+private:
+    JobContext& m_job;
+    RecordQueue& m_out;
+    std::map<uint32_t, std::wstring> m_live;
+};
+
+/**
+ * Fuehrt eine Stufe aus wie CommandExecutor::WorkerLoop einen Job: eine Ausnahme (z.B.
+ * std::bad_alloc beim Sortieren) wird als Fehlermeldung ausgegeben, statt den Thread und damit
+ * das ganze Programm zu beenden. Die Warteschlangen der Stufe schliesst der Aufrufer danach.
+ */
+template <typename Stage>
+void RunStage(JobContext& job, Stage&& stage) {
+    try {
+        stage();
+    }
+    catch (const std::exception& e) {
+        std::string what = e.what();
+        job.AddError(L"FEHLER: " + std::wstring(what.begin(), what.end()));
+    }
+    catch (...) {
+        job.AddError(L"FEHLER: Befehl mit unbekanntem Fehler abgebrochen.");
+    }
+}
+
+wchar_t FoldWide(wchar_t c) {
+    if (c < 0x80) return c >= L'a' && c <= L'z' ? static_cast<wchar_t>(c - (L'a' - L'A')) : c;
+    return static_cast<wchar_t>(std::towupper(c));
+}
+
+} // namespace
+
+bool RecordQueue::Write(RecordBatch& batch) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_batches.size() >= MAX_BATCHES && !m_abandoned && !m_job.Cancelled()) {
+        m_changed.wait_for(lock, WAIT_SLICE);
+    }
+    if (m_abandoned || m_job.Cancelled()) {
+        batch.clear();
+        return false;
+    }
+    m_batches.push_back(std::move(batch));
+    batch.clear();
+    m_changed.notify_all();
+    return true;
+}
+
+bool RecordQueue::Read(RecordBatch& batch) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_batches.empty() && !m_closed && !m_job.Cancelled()) {
+        m_changed.wait_for(lock, WAIT_SLICE);
+    }
+    if (m_batches.empty() || m_job.Cancelled()) return false;
+    batch = std::move(m_batches.front());
+    m_batches.pop_front();
+    m_changed.notify_all();
+    return true;
+}
+
+void RecordQueue::Close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_changed.notify_all();
+}
+
+void RecordQueue::Abandon() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_abandoned = true;
+    m_batches.clear();
+    m_changed.notify_all();
+}
+
+bool RecordQueue::Abandoned() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_abandoned;
+}
+
+bool JobSink::Write(RecordBatch& batch) {
+    for (const std::wstring& line : batch) m_out.Add(line);
+    batch.clear();
+    m_out.Flush(); // jeder Schub sofort: PING | FIND zeigt jede Antwort, sobald sie kommt
+    return true;
+}
+
+void RunPipeline(JobContext& job, const PipeSource& source, const std::vector<PipeFilter>& filters) {
+    if (filters.empty()) {
+        source(job);
+        return;
+    }
+    SharedJobContext shared(job);
+    std::deque<RecordQueue> queues; // queues[i] ist die Eingabe von filters[i]
+    for (size_t i = 0; i < filters.size(); ++i) queues.emplace_back(job);
+
+    std::vector<std::thread> threads;
+    try {
+        threads.emplace_back([&] {
+            Perf::SetThreadName(L"Pipeline");
+            RunStage(shared, [&] {
+                PipeSourceContext context(shared, queues.front());
+                source(context);
+                context.Finish();
+            });
+            queues.front().Close();
+        });
+        for (size_t i = 0; i + 1 < filters.size(); ++i) {
+            threads.emplace_back([&, i] {
+                Perf::SetThreadName(L"Pipeline");
+                RunStage(shared, [&] { filters[i](shared, queues[i], queues[i + 1]); });
+                queues[i].Abandon(); // ungelesener Rest: die Stufe davor hoert auf
+                queues[i + 1].Close();
+            });
+        }
+    }
+    catch (...) {
+        // Ein Thread liess sich nicht starten: die laufenden Stufen beenden und einsammeln, dann
+        // meldet der Executor den Fehler
+        for (RecordQueue& queue : queues) {
+            queue.Abandon();
+            queue.Close();
+        }
+        for (std::thread& thread : threads) thread.join();
+        throw;
+    }
+    RunStage(shared, [&] {
+        JobSink sink(shared);
+        filters.back()(shared, queues.back(), sink);
+    });
+    queues.back().Abandon();
+    for (std::thread& thread : threads) thread.join();
+}
+
+bool SplitPipeline(std::wstring_view line, std::vector<std::wstring>& stages) {
+    stages.clear();
+    bool inQuotes = false;
+    size_t start = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == L'"') inQuotes = !inQuotes;
+        else if (line[i] == L'|' && !inQuotes) {
+            stages.emplace_back(line.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    if (stages.empty()) return false;
+    stages.emplace_back(line.substr(start));
+    for (std::wstring& stage : stages) {
+        size_t first = stage.find_first_not_of(L" \t");
+        size_t last = stage.find_last_not_of(L" \t");
+        stage = first == std::wstring::npos ? std::wstring() : stage.substr(first, last - first + 1);
+    }
+    return true;
+}
+
+void StreamFileLines(JobContext& job, const std::wstring& path) {
+    MappedFile file;
+    std::wstring error;
+    if (!file.Open(path, error)) {
+        job.AddError(L"FEHLER: " + error);
+        return;
+    }
+    OutputBlock out(job);
+    std::wstring line;
+    const char* data = file.Data();
+    const char* end = data + file.Size();
+    for (const char* pos = data; pos < end && !job.Cancelled();) {
+        const char* newline = FindNewline(pos, end);
+        DecodeTextLine(std::string_view(pos, static_cast<size_t>(newline - pos)), line);
+        out.Add(line);
+        pos = newline + 1;
+    }
+}
+
+bool ParseSortArguments(const std::wstring& arguments, SortOptions& options, std::wstring& error) {
+    size_t pos = 0;
+    while (pos < arguments.size()) {
+        if (std::iswspace(arguments[pos])) {
+            ++pos;
+            continue;
+        }
+        size_t end = pos;
+        bool inQuotes = false;
+        std::wstring token;
+        for (; end < arguments.size() && (inQuotes || !std::iswspace(arguments[end])); ++end) {
+            if (arguments[end] == L'"') inQuotes = !inQuotes;
+            else token += arguments[end];
+        }
+        bool option = arguments[pos] == L'/';
+        pos = end;
+        if (option && token.size() == 2 && std::towlower(token[1]) == L'r') {
+            options.reverse = true;
+        }
+        else if (option && token.size() > 2 && token[1] == L'+') {
+            wchar_t* numberEnd = nullptr;
+            unsigned long column = std::wcstoul(token.c_str() + 2, &numberEnd, 10);
+            if (*numberEnd != L'\0' || column == 0) {
+                error = L"Ungueltige Spalte '" + token + L"' (z.B. /+10).";
+                return false;
+            }
+            options.column = column - 1;
+        }
+        else if (option) {
+            error = L"Ungueltige Option '" + token + L"' (erlaubt: /R /+n).";
+            return false;
+        }
+        else if (options.file.empty()) {
+            options.file = token;
+        }
+        else {
+            error = L"Nur eine Datei moeglich.";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Sortieren braucht die ganze Eingabe; gesammelt wird Zeile fuer Zeile, verglichen ueber einen
+ * einmal berechneten Schluessel (Grossbuchstaben ab der Spalte). Gleiche Schluessel behalten
+ * ihre Reihenfolge.
+ */
+void SortLines(JobContext& job, RecordQueue& in, RecordSink& out, const SortOptions& options) {
+    struct Entry {
+        std::wstring key;
+        std::wstring line;
+    };
+    std::vector<Entry> entries;
+    RecordBatch batch;
+    while (in.Read(batch)) {
+        for (std::wstring& line : batch) {
+            Entry& entry = entries.emplace_back();
+            if (options.column < line.size()) {
+                entry.key.resize(line.size() - options.column);
+                std::transform(line.begin() + static_cast<ptrdiff_t>(options.column), line.end(), entry.key.begin(), FoldWide);
+            }
+            entry.line = std::move(line);
+        }
+        batch.clear();
+    }
+    if (job.Cancelled()) return;
+
+    std::stable_sort(entries.begin(), entries.end(), [&options](const Entry& a, const Entry& b) {
+        return options.reverse ? b.key < a.key : a.key < b.key;
+    });
+    for (Entry& entry : entries) {
+        batch.push_back(std::move(entry.line));
+        if (batch.size() >= OutputBlock::MAX_LINES && !out.Write(batch)) return;
+    }
+    if (!batch.empty()) out.Write(batch);
+}
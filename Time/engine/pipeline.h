@@ -0,0 +1,104 @@
+#pragma once
+
+#include "executor.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Zeilen, die zwischen zwei Stufen einer Pipeline als ein Stueck weitergereicht werden.
+using RecordBatch = std::vector<std::wstring>;
+
+/**
+ * Ausgang einer Pipeline-Stufe. Write uebernimmt die Zeilen (batch ist danach leer) und liefert
+ * false, sobald niemand mehr liest: die Stufe hoert dann auf.
+ */
+class RecordSink {
+public:
+    virtual ~RecordSink() = default;
+    virtual bool Write(RecordBatch& batch) = 0;
+};
+
+/**
+ * Begrenzte Warteschlange zwischen zwei Stufen. Ist sie voll, wartet der Schreiber, bis der Leser
+ * aufgeholt hat (Gegendruck): ein schneller Erzeuger vor einem langsamen Filter haelt hoechstens
+ * MAX_BATCHES Schuebe im Speicher. Beide Seiten pruefen beim Warten den Abbruch des Jobs.
+ */
+class RecordQueue : public RecordSink {
+public:
+    static constexpr size_t MAX_BATCHES = 16;
+
+    explicit RecordQueue(const JobContext& job)
+        : m_job(job) {
+    }
+
+    bool Write(RecordBatch& batch) override;
+
+    // Naechster Schub; false, wenn der Schreiber fertig ist und alles gelesen wurde.
+    bool Read(RecordBatch& batch);
+
+    // Schreiber fertig: der Leser bekommt noch den Rest.
+    void Close();
+
+    // Leser fertig (z.B. nach einem Fehler): weitere Writes liefern false.
+    void Abandon();
+    bool Abandoned() const;
+
+private:
+    const JobContext& m_job;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<RecordBatch> m_batches;
+    bool m_closed = false;
+    bool m_abandoned = false;
+};
+
+/**
+ * Letzte Stufe: gibt jeden Schub sofort als ein AddHistory des Jobs aus.
+ */
+class JobSink : public RecordSink {
+public:
+    explicit JobSink(JobContext& job)
+        : m_out(job) {
+    }
+
+    bool Write(RecordBatch& batch) override;
+
+private:
+    OutputBlock m_out;
+};
+
+// Erste Stufe: ein gewoehnlicher Befehl, seine Ausgabe wird in Zeilen zerlegt weitergereicht.
+using PipeSource = JobFunction;
+// Weitere Stufen: lesen aus in, schreiben nach out; Fehler gehen direkt an job.
+using PipeFilter = std::function<void(JobContext& job, RecordQueue& in, RecordSink& out)>;
+
+/**
+ * Fuehrt eine Pipeline im Job aus. Quelle und alle Filter bis auf den letzten laufen auf eigenen
+ * Threads, der letzte Filter auf dem Thread des Jobs; verbunden sind sie durch RecordQueues.
+ * Kehrt erst zurueck, wenn alle Stufen beendet sind.
+ */
+void RunPipeline(JobContext& job, const PipeSource& source, const std::vector<PipeFilter>& filters);
+
+// Zerlegt eine Befehlszeile an '|' ausserhalb von Anfuehrungszeichen; false, wenn es keines gibt.
+bool SplitPipeline(std::wstring_view line, std::vector<std::wstring>& stages);
+
+// Quelle fuer TYPE in einer Pipeline und SORT <datei>: die Zeilen einer Textdatei.
+void StreamFileLines(JobContext& job, const std::wstring& path);
+
+/**
+ * SORT: Zeilen ohne Beachtung der Gross-/Kleinschreibung sortieren, ab Spalte /+n, /R absteigend.
+ */
+struct SortOptions {
+    bool reverse = false;
+    size_t column = 0; // /+n, 0-basiert
+    std::wstring file; // leer = Eingabe aus der Pipeline
+};
+
+bool ParseSortArguments(const std::wstring& arguments, SortOptions& options, std::wstring& error);
+void SortLines(JobContext& job, RecordQueue& in, RecordSink& out, const SortOptions& options);
@@ -0,0 +1,237 @@
+#include "renderer.h"
+#include "console.h"
+#include "glyphs.h"
+#include "perf.h"
+#include "screen.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+void Framebuffer::Allocate(int width, int height) {
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_stride = m_width;
+    m_owned.assign(static_cast<size_t>(m_width) * m_height, 0);
+    m_pixels = m_owned.data();
+}
+
+void Framebuffer::Attach(uint32_t* pixels, int width, int height, int stride) {
+    m_owned.clear();
+    m_owned.shrink_to_fit();
+    m_pixels = pixels;
+    m_width = width;
+    m_height = height;
+    m_stride = stride;
+}
+
+void Framebuffer::Detach() {
+    Attach(nullptr, 0, 0, 0);
+}
+
+void Framebuffer::Fill(PixelRect rect, uint32_t color) {
+    int left = std::max(rect.left, 0);
+    int top = std::max(rect.top, 0);
+    int right = std::min(rect.right, m_width);
+    int bottom = std::min(rect.bottom, m_height);
+    if (left >= right || top >= bottom) return;
+    for (int y = top; y < bottom; ++y) {
+        std::fill_n(Row(y) + left, right - left, color);
+    }
+}
+
+void Framebuffer::ScrollRows(int top, int bottom, int dy) {
+    top = std::max(top, 0);
+    bottom = std::min(bottom, m_height);
+    if (dy == 0 || top >= bottom) return;
+    const size_t bytes = static_cast<size_t>(m_width) * sizeof(uint32_t);
+    if (dy < 0) {
+        for (int y = top; y - dy < bottom; ++y) {
+            memcpy(Row(y), Row(y - dy), bytes);
+        }
+    }
+    else {
+        for (int y = bottom - 1; y - dy >= top; --y) {
+            memcpy(Row(y), Row(y - dy), bytes);
+        }
+    }
+}
+
+CellRenderer::CellRenderer(GlyphAtlas& atlas, Framebuffer& target)
+    : m_atlas(atlas), m_target(target) {
+}
+
+void CellRenderer::SetColors(uint32_t foreground, uint32_t background) {
+    m_foreground = foreground;
+    m_background = background;
+}
+
+int CellRenderer::VisibleRows() const {
+    return m_target.Height() / m_atlas.CellHeight();
+}
+
+PixelRect CellRenderer::RowRect(int row) const {
+    int height = m_atlas.CellHeight();
+    return { 0, (row + 1) * height, m_target.Width(), (row + 2) * height };
+}
+
+PixelRect CellRenderer::CursorRect(const ScreenModel& screen) const {
+    PixelRect row = RowRect(screen.CursorRow());
+    int x = DEFAULT_X_PADDING + screen.CursorColumn() * m_atlas.CellWidth();
+    return { x, row.top, x + m_atlas.CellWidth(), row.bottom };
+}
+
+PixelRect CellRenderer::ScrollArea(const ScreenModel& screen) const {
+    int height = m_atlas.CellHeight();
+    return { 0, (screen.ScrollTop() + 1) * height, m_target.Width(), (screen.Rows() + 1) * height };
+}
+
+/**
+ * Kopiert eine Glyphe an (x, y): Pixel = (Maske & Vordergrund) | (~Maske & Hintergrund).
+ * Zellen am Rand werden beschnitten.
+ */
+void CellRenderer::BlitGlyph(const uint32_t* mask, int x, int y) {
+    const int cellWidth = m_atlas.CellWidth();
+    const int cellHeight = m_atlas.CellHeight();
+    int x0 = std::max(0, -x);
+    int x1 = std::min(cellWidth, m_target.Width() - x);
+    int y0 = std::max(0, -y);
+    int y1 = std::min(cellHeight, m_target.Height() - y);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const uint32_t fg = m_foreground;
+    const uint32_t bg = m_background;
+#if TIME_HAVE_SSE2
+    const __m128i fg4 = _mm_set1_epi32(static_cast<int>(fg));
+    const __m128i bg4 = _mm_set1_epi32(static_cast<int>(bg));
+#endif
+    for (int row = y0; row < y1; ++row) {
+        const uint32_t* src = mask + static_cast<size_t>(row) * cellWidth;
+        uint32_t* dst = m_target.Row(y + row) + x;
+        int col = x0;
+#if TIME_HAVE_SSE2
+        for (; col + 4 <= x1; col += 4) {
+            __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + col));
+            __m128i px = _mm_or_si128(_mm_and_si128(m, fg4), _mm_andnot_si128(m, bg4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + col), px);
+        }
+#endif
+        for (; col < x1; ++col) {
+            dst[col] = (src[col] & fg) | (~src[col] & bg);
+        }
+    }
+}
+
+void CellRenderer::DrawText(int x, int y, std::wstring_view text) {
+    const int cellWidth = m_atlas.CellWidth();
+    for (wchar_t ch : text) {
+        if (x >= m_target.Width()) break;
+        BlitGlyph(m_atlas.Glyph(ch), x, y);
+        x += cellWidth;
+    }
+}
+
+/**
+ * Cursor am Zeilenende: '_' bzw. Leerzeichen. Steht er auf einem Zeichen (Cursor mitten in der
+ * Eingabe), wird das Zeichen im sichtbaren Takt invers gezeichnet, sonst normal.
+ */
+void CellRenderer::DrawCursorCell(const ScreenModel& screen, const ConsoleEngine& console) {
+    PixelRect rect = CursorRect(screen);
+    std::wstring_view text = screen.RowText(console, screen.CursorRow());
+    size_t column = static_cast<size_t>(screen.CursorColumn());
+    wchar_t ch = column < text.size() ? text[column] : L' ';
+    if (ch == L' ') {
+        BlitGlyph(m_atlas.Glyph(screen.CursorVisible() ? L'_' : L' '), rect.left, rect.top);
+        return;
+    }
+    if (screen.CursorVisible()) std::swap(m_foreground, m_background);
+    BlitGlyph(m_atlas.Glyph(ch), rect.left, rect.top);
+    if (screen.CursorVisible()) std::swap(m_foreground, m_background);
+}
+
+void CellRenderer::DrawRow(const ScreenModel& screen, const ConsoleEngine& console, int row) {
+    PixelRect rect = RowRect(row);
+    m_target.Fill(rect, m_background);
+    std::wstring_view text = screen.RowText(console, row);
+    DrawText(DEFAULT_X_PADDING, rect.top, text);
+    int first = 0;
+    int count = 0;
+    if (screen.Highlight(row, first, count)) {
+        // Suchtreffer invers
+        std::swap(m_foreground, m_background);
+        const int cellWidth = m_atlas.CellWidth();
+        for (int column = first; column < first + count && static_cast<size_t>(column) < text.size(); ++column) {
+            BlitGlyph(m_atlas.Glyph(text[column]), DEFAULT_X_PADDING + column * cellWidth, rect.top);
+        }
+        std::swap(m_foreground, m_background);
+    }
+    if (screen.CursorVisible() && screen.CursorRow() == row) {
+        DrawCursorCell(screen, console);
+    }
+}
+
+void CellRenderer::DrawCells(const ScreenModel& screen, const ConsoleEngine& console, const CellSpan& cells) {
+    std::wstring_view text = screen.RowText(console, cells.row);
+    const int cellWidth = m_atlas.CellWidth();
+    const int top = RowRect(cells.row).top;
+    for (int column = cells.first; column < cells.first + cells.count; ++column) {
+        wchar_t ch = static_cast<size_t>(column) < text.size() ? text[column] : L' ';
+        BlitGlyph(m_atlas.Glyph(ch), DEFAULT_X_PADDING + column * cellWidth, top);
+    }
+}
+
+const std::vector<PixelRect>& CellRenderer::Render(const ScreenModel& screen, const ConsoleEngine& console, const FrameDamage& damage) {
+    PerfSpan span(L"Render", &Perf::Frames());
+    m_changed.clear();
+    const int height = m_atlas.CellHeight();
+
+    if (damage.scrollRows != 0) {
+        PixelRect area = ScrollArea(screen);
+        m_target.ScrollRows(area.top, area.bottom, -damage.scrollRows * height);
+    }
+
+    for (const RowSpan& span : damage.rows) {
+        for (int row = span.first; row < span.first + span.count; ++row) {
+            DrawRow(screen, console, row);
+        }
+        m_changed.push_back({ 0, (span.first + 1) * height, m_target.Width(), (span.first + span.count + 1) * height });
+    }
+
+    const int width = m_atlas.CellWidth();
+    for (const CellSpan& cells : damage.cells) {
+        DrawCells(screen, console, cells);
+        int left = DEFAULT_X_PADDING + cells.first * width;
+        m_changed.push_back({ left, (cells.row + 1) * height, left + cells.count * width, (cells.row + 2) * height });
+    }
+
+    if (damage.cursor) {
+        DrawCursorCell(screen, console);
+        m_changed.push_back(CursorRect(screen));
+    }
+    return m_changed;
+}
+
+void CellRenderer::RenderAll(const ScreenModel& screen, const ConsoleEngine& console) {
+    m_target.Fill({ 0, 0, m_target.Width(), m_target.Height() }, m_background);
+    for (int row = 0; row < screen.Rows(); ++row) {
+        DrawRow(screen, console, row);
+    }
+}
+
+bool WritePpm(const Framebuffer& frame, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file << "P6\n" << frame.Width() << ' ' << frame.Height() << "\n255\n";
+    std::vector<char> line(static_cast<size_t>(frame.Width()) * 3);
+    for (int y = 0; y < frame.Height(); ++y) {
+        const uint32_t* src = frame.Row(y);
+        for (int x = 0; x < frame.Width(); ++x) {
+            line[x * 3 + 0] = static_cast<char>(src[x] >> 16);
+            line[x * 3 + 1] = static_cast<char>(src[x] >> 8);
+            line[x * 3 + 2] = static_cast<char>(src[x]);
+        }
+        file.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ConsoleEngine;
+class GlyphAtlas;
+class ScreenModel;
+struct CellSpan;
+struct FrameDamage;
+
+/**
+ * Rechteck in Pixeln (right/bottom exklusiv, wie RECT).
+ */
+struct PixelRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+/**
+ * 32-Bit-Pixelpuffer (0x00RRGGBB, entspricht einer DIB-Section mit 32 bpp). Der Speicher
+ * gehoert entweder dem Puffer selbst (Headless, Tests) oder wird von aussen eingehaengt
+ * (Win32: Pixel der DIB-Section des Hintergrundpuffers).
+ */
+class Framebuffer {
+public:
+    void Allocate(int width, int height);
+    void Attach(uint32_t* pixels, int width, int height, int stride); // stride in Pixeln
+    void Detach();
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    int Stride() const { return m_stride; }
+    uint32_t* Row(int y) { return m_pixels + static_cast<size_t>(y) * m_stride; }
+    const uint32_t* Row(int y) const { return m_pixels + static_cast<size_t>(y) * m_stride; }
+
+    // Beide Funktionen beschneiden auf den Puffer.
+    void Fill(PixelRect rect, uint32_t color);
+    // Verschiebt die Pixelzeilen [top, bottom) um dy (negativ = nach oben), wie ScrollDC.
+    void ScrollRows(int top, int bottom, int dy);
+
+private:
+    std::vector<uint32_t> m_owned;
+    uint32_t* m_pixels = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    int m_stride = 0;
+};
+
+/**
+ * Zeichnet den Bildschirminhalt zellenweise aus dem Glyphen-Atlas in einen Framebuffer.
+ * Pro Zeichen wird nur eine vorgerasterte Maske kopiert (SSE2, vier Pixel pro Schritt), es gibt
+ * keine Textausgabe des Betriebssystems mehr im Zeichenpfad. Render() setzt genau die
+ * FrameDamage des ScreenModel um und liefert die geaenderten Pixelbereiche, die das Frontend
+ * anschliessend invalidiert bzw. kopiert.
+ *
+ * Aufteilung wie bisher: Bildschirmzeile r beginnt bei y = (r + 1) * Zellhoehe, der Text
+ * 20 Pixel vom linken Rand. Von der Uhr werden nur die geaenderten Zellen neu gezeichnet.
+ */
+class CellRenderer {
+public:
+    static constexpr int DEFAULT_X_PADDING = 20;
+    static constexpr uint32_t DEFAULT_FOREGROUND = 0x00DCDCC8; // RGB(220, 220, 200)
+    static constexpr uint32_t DEFAULT_BACKGROUND = 0x00000000;
+
+    CellRenderer(GlyphAtlas& atlas, Framebuffer& target);
+
+    void SetColors(uint32_t foreground, uint32_t background);
+
+    // Anzahl Bildschirmzeilen fuer die aktuelle Puffergroesse (fuer ScreenModel::Resize).
+    int VisibleRows() const;
+
+    // Uebernimmt die Aenderungen eines Frames; der Rueckgabewert bleibt bis zum naechsten
+    // Aufruf gueltig. Ein Verschieben steht nicht darin, sondern in ScrollArea().
+    const std::vector<PixelRect>& Render(const ScreenModel& screen, const ConsoleEngine& console, const FrameDamage& damage);
+
+    // Zeichnet den ganzen Puffer neu (Hintergrund plus alle Zeilen).
+    void RenderAll(const ScreenModel& screen, const ConsoleEngine& console);
+
+    PixelRect RowRect(int row) const;
+    PixelRect CursorRect(const ScreenModel& screen) const;
+    PixelRect ScrollArea(const ScreenModel& screen) const;
+
+    // Text ab Pixelposition (x, y), ein Zeichen pro Zelle; Hintergrund wird mitgezeichnet.
+    void DrawText(int x, int y, std::wstring_view text);
+
+private:
+    void DrawRow(const ScreenModel& screen, const ConsoleEngine& console, int row);
+    void DrawCells(const ScreenModel& screen, const ConsoleEngine& console, const CellSpan& cells);
+    void DrawCursorCell(const ScreenModel& screen, const ConsoleEngine& console);
+    void BlitGlyph(const uint32_t* mask, int x, int y);
+
+    GlyphAtlas& m_atlas;
+    Framebuffer& m_target;
+    uint32_t m_foreground = DEFAULT_FOREGROUND;
+    uint32_t m_background = DEFAULT_BACKGROUND;
+    std::vector<PixelRect> m_changed;
+};
+
+// Speichert den Puffer als binaeres PPM (P6), z.B. fuer Referenzbilder im Headless-Modus.
+bool WritePpm(const Framebuffer& frame, const std::string& path);
@@ -0,0 +1,198 @@
+#include "scheduler.h"
+
+#include <algorithm>
+#include <bit>
+
+TimerWheel::TimerWheel(uint64_t now, uint32_t resolutionMs, size_t slotCount)
+    : m_resolution(std::max<uint32_t>(resolutionMs, 1)) {
+    // Slotanzahl auf ganze 64-Bit-Woerter der Belegungsmaske runden
+    slotCount = std::max<size_t>((slotCount + 63) / 64, 1) * 64;
+    m_slots.assign(slotCount, -1);
+    m_slotBits.assign(slotCount / 64, 0);
+    m_currentTick = now / m_resolution;
+}
+
+TimerWheel::TimerId TimerWheel::MakeId(int32_t index) const {
+    return (static_cast<uint64_t>(m_entries[index].generation) << 32) | static_cast<uint32_t>(index + 1);
+}
+
+int32_t TimerWheel::AllocateEntry() {
+    if (m_freeList >= 0) {
+        int32_t index = m_freeList;
+        m_freeList = m_entries[index].next;
+        return index;
+    }
+    m_entries.emplace_back();
+    return static_cast<int32_t>(m_entries.size() - 1);
+}
+
+void TimerWheel::ReleaseEntry(int32_t index) {
+    Entry& entry = m_entries[index];
+    entry.callback = nullptr;
+    entry.state = State::Free;
+    entry.generation++; // alte Ids werden ungueltig
+    entry.prev = -1;
+    entry.next = m_freeList;
+    m_freeList = index;
+    m_pending--;
+}
+
+void TimerWheel::MarkSlot(size_t slot, bool used) {
+    uint64_t bit = 1ull << (slot % 64);
+    if (used) m_slotBits[slot / 64] |= bit;
+    else m_slotBits[slot / 64] &= ~bit;
+}
+
+int64_t TimerWheel::NextUsedSlot(size_t from) const {
+    const size_t words = m_slotBits.size();
+    size_t word = from / 64;
+    uint64_t bits = m_slotBits[word] & (~0ull << (from % 64));
+    // Ein Wort mehr als vorhanden, damit nach dem Umlauf auch die Bits vor from geprueft werden
+    for (size_t i = 0; i <= words; ++i) {
+        if (bits) return static_cast<int64_t>(word * 64 + std::countr_zero(bits));
+        word = (word + 1) % words;
+        bits = m_slotBits[word];
+    }
+    return -1;
+}
+
+void TimerWheel::Insert(int32_t index) {
+    Entry& entry = m_entries[index];
+    uint64_t tick = std::max(entry.deadline / m_resolution, m_currentTick);
+    if (tick - m_currentTick >= m_slots.size()) {
+        entry.state = State::Overflow;
+        m_overflow.push_back(index);
+        return;
+    }
+    size_t slot = SlotOf(tick);
+    entry.state = State::Wheel;
+    entry.slot = static_cast<uint32_t>(slot);
+    entry.prev = -1;
+    entry.next = m_slots[slot];
+    if (entry.next >= 0) m_entries[entry.next].prev = index;
+    m_slots[slot] = index;
+    MarkSlot(slot, true);
+}
+
+void TimerWheel::Unlink(int32_t index) {
+    Entry& entry = m_entries[index];
+    if (entry.prev >= 0) m_entries[entry.prev].next = entry.next;
+    else m_slots[entry.slot] = entry.next;
+    if (entry.next >= 0) m_entries[entry.next].prev = entry.prev;
+    if (m_slots[entry.slot] < 0) MarkSlot(entry.slot, false);
+    entry.prev = -1;
+    entry.next = -1;
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(uint64_t deadline, Callback callback) {
+    int32_t index = AllocateEntry();
+    Entry& entry = m_entries[index];
+    entry.deadline = deadline;
+    entry.sequence = m_sequence++;
+    entry.callback = std::move(callback);
+    m_pending++;
+    Insert(index);
+    return MakeId(index);
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+    uint32_t low = static_cast<uint32_t>(id);
+    if (low == 0 || low > m_entries.size()) return false;
+    int32_t index = static_cast<int32_t>(low - 1);
+    Entry& entry = m_entries[index];
+    if (entry.state == State::Free || entry.generation != static_cast<uint32_t>(id >> 32)) return false;
+
+    if (entry.state == State::Wheel) {
+        Unlink(index);
+    }
+    else if (entry.state == State::Overflow) {
+        m_overflow.erase(std::find(m_overflow.begin(), m_overflow.end(), index));
+    }
+    ReleaseEntry(index);
+    return true;
+}
+
+size_t TimerWheel::RunDue(uint64_t now) {
+    std::vector<DueTimer> due;
+    due.swap(m_due); // Kapazitaet wiederverwenden, Callbacks duerfen RunDue erneut aufrufen
+    due.clear();
+
+    // Faellige Termine aus den Slots der vergangenen Ticks einsammeln (hoechstens ein Umlauf)
+    uint64_t target = std::max(now / m_resolution, m_currentTick);
+    uint64_t span = std::min<uint64_t>(target - m_currentTick + 1, m_slots.size());
+    const size_t slotCount = m_slots.size();
+    uint64_t offset = 0;
+    while (offset < span) {
+        size_t from = SlotOf(m_currentTick + offset);
+        int64_t slot = NextUsedSlot(from);
+        if (slot < 0) break;
+        offset += (static_cast<size_t>(slot) + slotCount - from) % slotCount;
+        if (offset >= span) break;
+
+        int32_t index = m_slots[static_cast<size_t>(slot)];
+        while (index >= 0) {
+            int32_t next = m_entries[index].next;
+            if (m_entries[index].deadline <= now) {
+                Unlink(index);
+                m_entries[index].state = State::Due;
+                due.push_back({ m_entries[index].deadline, m_entries[index].sequence, MakeId(index) });
+            }
+            index = next;
+        }
+        offset++;
+    }
+    m_currentTick = target;
+
+    // Ueberlauf: faellige Termine ausfuehren, inzwischen nahe Termine in den Ring uebernehmen
+    if (!m_overflow.empty()) {
+        std::vector<int32_t> waiting;
+        waiting.swap(m_overflow);
+        for (int32_t index : waiting) {
+            if (m_entries[index].deadline <= now) {
+                m_entries[index].state = State::Due;
+                due.push_back({ m_entries[index].deadline, m_entries[index].sequence, MakeId(index) });
+            }
+            else {
+                Insert(index);
+            }
+        }
+    }
+
+    std::sort(due.begin(), due.end(), [](const DueTimer& a, const DueTimer& b) {
+        return a.deadline != b.deadline ? a.deadline < b.deadline : a.sequence < b.sequence;
+    });
+
+    size_t ran = 0;
+    for (const DueTimer& timer : due) {
+        int32_t index = static_cast<int32_t>(static_cast<uint32_t>(timer.id) - 1);
+        Entry& entry = m_entries[index];
+        // Ein frueherer Callback kann den Termin bereits abgebrochen haben
+        if (entry.state != State::Due || entry.generation != static_cast<uint32_t>(timer.id >> 32)) continue;
+        Callback callback = std::move(entry.callback);
+        ReleaseEntry(index);
+        callback(now);
+        ran++;
+    }
+
+    due.clear();
+    if (m_due.capacity() < due.capacity()) m_due.swap(due);
+    return ran;
+}
+
+uint64_t TimerWheel::NextDeadline() const {
+    int64_t slot = NextUsedSlot(SlotOf(m_currentTick));
+    if (slot >= 0) {
+        // Alle Ring-Termine liegen im Tick-Fenster ab m_currentTick, der erste belegte Slot
+        // enthaelt also den fruehesten Tick
+        uint64_t earliest = NO_DEADLINE;
+        for (int32_t index = m_slots[static_cast<size_t>(slot)]; index >= 0; index = m_entries[index].next) {
+            earliest = std::min(earliest, m_entries[index].deadline);
+        }
+        return earliest;
+    }
+    uint64_t earliest = NO_DEADLINE;
+    for (int32_t index : m_overflow) {
+        earliest = std::min(earliest, m_entries[index].deadline);
+    }
+    return earliest;
+}
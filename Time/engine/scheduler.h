@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Einfacher Timer-Wheel-Scheduler fuer einmalige Termine (Millisekunden).
+ *
+ * Der Scheduler liest selbst keine Uhr: alle Zeiten werden vom Aufrufer uebergeben. Das
+ * Win32-Frontend verwendet GetTickCount64(), Headless und Tests eine virtuelle Uhr, die einfach
+ * auf NextDeadline() vorgestellt wird. Das Frontend schlaeft jeweils bis NextDeadline() und
+ * ruft dann RunDue() auf, statt in einem festen Intervall aufzuwachen.
+ *
+ * Termine innerhalb von slotCount * resolutionMs liegen in einem Ring von Listen (Einfuegen
+ * und Entfernen in O(1), der naechste belegte Slot wird ueber eine Bitmaske gefunden); weiter
+ * entfernte Termine warten in einer Ueberlaufliste, bis sie in den Ring passen. Wiederholte
+ * Termine plant der Callback selbst neu, typischerweise auf die naechste Intervallgrenze.
+ */
+class TimerWheel {
+public:
+    using TimerId = uint64_t;
+    using Callback = std::function<void(uint64_t now)>;
+
+    static constexpr uint64_t NO_DEADLINE = ~0ull;
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    explicit TimerWheel(uint64_t now = 0, uint32_t resolutionMs = 1, size_t slotCount = 1024);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Plant callback fuer deadline; ein Termin in der Vergangenheit ist beim naechsten
+    // RunDue() faellig.
+    TimerId Schedule(uint64_t deadline, Callback callback);
+
+    // Liefert false, wenn der Termin nicht (mehr) existiert.
+    bool Cancel(TimerId id);
+
+    // Fuehrt alle Termine mit deadline <= now in Terminreihenfolge aus und liefert ihre Anzahl.
+    // Callbacks duerfen neue Termine planen und andere abbrechen.
+    size_t RunDue(uint64_t now);
+
+    // Fruehester geplanter Termin oder NO_DEADLINE.
+    uint64_t NextDeadline() const;
+
+    size_t Pending() const { return m_pending; }
+
+private:
+    enum class State : uint8_t { Free, Wheel, Overflow, Due };
+
+    struct Entry {
+        uint64_t deadline = 0;
+        uint64_t sequence = 0; // Reihenfolge bei gleichem Termin
+        Callback callback;
+        uint32_t generation = 0;
+        uint32_t slot = 0;
+        int32_t prev = -1;
+        int32_t next = -1; // naechster Eintrag im Slot bzw. in der Freiliste
+        State state = State::Free;
+    };
+
+    struct DueTimer {
+        uint64_t deadline;
+        uint64_t sequence;
+        TimerId id;
+    };
+
+    int32_t AllocateEntry();
+    void ReleaseEntry(int32_t index);
+    void Insert(int32_t index);
+    void Unlink(int32_t index);
+    size_t SlotOf(uint64_t tick) const { return static_cast<size_t>(tick % m_slots.size()); }
+    void MarkSlot(size_t slot, bool used);
+    int64_t NextUsedSlot(size_t from) const; // -1, wenn kein Slot belegt ist
+    TimerId MakeId(int32_t index) const;
+
+    uint32_t m_resolution;
+    uint64_t m_currentTick;
+
+    std::vector<Entry> m_entries;
+    int32_t m_freeList = -1;
+    std::vector<int32_t> m_slots;      // Listenkopf je Slot
+    std::vector<uint64_t> m_slotBits;  // belegte Slots
+    std::vector<int32_t> m_overflow;
+    std::vector<DueTimer> m_due; // Arbeitspuffer fuer RunDue
+    uint64_t m_sequence = 0;
+    size_t m_pending = 0;
+};
+
+// Naechste Grenze eines festen Rasters nach now (z.B. naechste volle Sekunde, naechster
+// Blinkwechsel), damit Wechsel genau auf der Grenze statt bis zu einem Intervall spaeter liegen.
+inline uint64_t NextBoundary(uint64_t now, uint64_t period) {
+    return (now / period + 1) * period;
+}
@@ -0,0 +1,206 @@
+#include "screen.h"
+#include "console.h"
+
+#include <algorithm>
+
+void ScreenModel::Resize(int rows) {
+    m_rows = std::max(rows, 0);
+    m_shown.assign(m_rows, EMPTY_ROW);
+    m_next.assign(m_rows, EMPTY_ROW);
+    m_shownStamps.assign(m_rows, 0);
+    m_nextStamps.assign(m_rows, 0);
+    m_rowText.assign(m_rows, std::wstring());
+    m_clockText.assign(ClockPanel::ROWS, std::wstring());
+    m_cursorRow = -1;
+    m_fullRedraw = true;
+}
+
+const FrameDamage& ScreenModel::Update(const ConsoleEngine& console, bool cursorVisible) {
+    m_damage.scrollRows = 0;
+    m_damage.rows.clear();
+    m_damage.cells.clear();
+    m_damage.cursor = false;
+    if (m_rows == 0) return m_damage;
+
+    // Uhr oben, sofern darunter noch Platz fuer Verlauf und Eingabezeile bleibt
+    const ClockPanel* clock = console.Clock();
+    if (clock && m_rows <= ClockPanel::ROWS + 1) clock = nullptr;
+    int top = clock ? ClockPanel::ROWS : 0;
+    if (top != m_top) {
+        m_top = top;
+        m_fullRedraw = true;
+    }
+
+    // Neuen Inhalt bestimmen (gleiche Aufteilung wie das bisherige WM_PAINT)
+    const Scrollback& history = console.History();
+    uint64_t first = history.TotalLines() - history.Size();
+    int endLine = static_cast<int>(history.Size()) - console.ScrollOffset();
+    int startLine = std::max(endLine - (m_rows - 1 - top), 0);
+
+    std::fill(m_next.begin(), m_next.end(), EMPTY_ROW);
+    std::fill(m_nextStamps.begin(), m_nextStamps.end(), 0);
+    int row = 0;
+    for (; row < top; ++row) {
+        m_next[row] = CLOCK_ROW + row;
+    }
+    if (FileViewer* viewer = console.Viewer()) {
+        // Dateianzeige: eine Seite Dateizeilen, die Statuszeile ganz unten
+        int pageRows = std::max(m_rows - 1 - top, 1);
+        viewer->Materialize(viewer->TopLine(), pageRows);
+        int lines = static_cast<int>(viewer->MaterializedLines());
+        for (int r = 0; r < lines; ++r) {
+            m_next[top + r] = VIEWER_ROW + viewer->TopLine() + r;
+            m_nextStamps[top + r] = viewer->Generation();
+        }
+        row = m_rows - 1;
+    }
+    else {
+        for (int i = startLine; i < endLine && row < m_rows; ++i) {
+            m_nextStamps[row] = history.EditStamp(first + i);
+            m_next[row++] = first + i;
+        }
+    }
+
+    int cursorRow = -1;
+    int cursorColumn = 0;
+    m_nextBottomText.clear();
+    if ((console.IsCountdownActive() || console.ScrollOffset() == 0 || console.IsViewing() || console.IsSearching()) && row < m_rows) {
+        m_next[row] = BOTTOM_ROW;
+        m_nextBottomText = console.BottomLine(false);
+        if (console.ShowsCursor()) {
+            cursorRow = row;
+            cursorColumn = console.CursorColumn();
+        }
+    }
+
+    std::vector<char>& dirty = m_dirty;
+    dirty.assign(m_rows, 0);
+    if (m_fullRedraw) {
+        std::fill(dirty.begin(), dirty.end(), 1);
+        m_fullRedraw = false;
+        for (int r = 0; r < top; ++r) {
+            m_clockText[r] = clock->Row(r);
+        }
+    }
+    else {
+        // Uhr: nur die Zellen, deren Zeichen sich geaendert haben
+        for (int r = 0; r < top; ++r) {
+            DiffClockRow(r, m_clockText[r], clock->Row(r));
+        }
+
+        // Verschiebung erkennen: neue Ausgabe am Ende oder PageUp/PageDown bewegen alle
+        // Verlaufszeilen um dieselbe Anzahl Zeilen.
+        int shift = 0;
+        if (top < m_rows && m_shown[top] < CLOCK_ROW && m_next[top] < CLOCK_ROW) {
+            long long delta = static_cast<long long>(m_next[top] - m_shown[top]);
+            int area = m_rows - top;
+            if (delta != 0 && delta > -area && delta < area) shift = static_cast<int>(delta);
+        }
+
+        int clean = 0;
+        for (int r = top; r < m_rows; ++r) {
+            int old = r + shift;
+            bool same = old >= top && old < m_rows && m_shown[old] == m_next[r]
+                && m_shownStamps[old] == m_nextStamps[r]
+                && (m_next[r] != BOTTOM_ROW || m_bottomText == m_nextBottomText);
+            dirty[r] = !same;
+            clean += same ? 1 : 0;
+        }
+        if (shift != 0 && clean == 0) {
+            // Verschieben lohnt nicht, alles wird ohnehin neu gezeichnet
+            shift = 0;
+            std::fill(dirty.begin() + top, dirty.end(), 1);
+        }
+        m_damage.scrollRows = shift;
+
+        // Cursor: nur Blinken -> nur die Zelle; sonst alte und neue Zeile neu zeichnen
+        int oldCursorRow = m_cursorRow >= 0 ? m_cursorRow - shift : -1;
+        if (oldCursorRow < top || oldCursorRow >= m_rows) oldCursorRow = -1;
+        bool visible = cursorRow >= 0 && cursorVisible;
+        bool oldVisible = m_cursorRow >= 0 && m_cursorVisible;
+        if (cursorRow == oldCursorRow && cursorColumn == m_cursorColumn) {
+            if (cursorRow >= 0 && visible != oldVisible && !dirty[cursorRow]) {
+                m_damage.cursor = true;
+            }
+        }
+        else {
+            if (oldCursorRow >= 0) dirty[oldCursorRow] = 1;
+            if (cursorRow >= 0) dirty[cursorRow] = 1;
+        }
+    }
+
+    // Suchtreffer: die Zeilen des alten und des neuen Treffers neu zeichnen
+    uint64_t highlightSeq = EMPTY_ROW;
+    int highlightColumn = 0;
+    int highlightLength = 0;
+    if (!console.IsViewing() && !console.SearchHighlight(highlightSeq, highlightColumn, highlightLength)) {
+        highlightSeq = EMPTY_ROW;
+    }
+    if (highlightSeq != m_highlightSeq || highlightColumn != m_highlightColumn || highlightLength != m_highlightLength) {
+        for (int r = top; r < m_rows; ++r) {
+            if (m_next[r] != EMPTY_ROW && (m_next[r] == highlightSeq || m_next[r] == m_highlightSeq)) dirty[r] = 1;
+        }
+        m_highlightSeq = highlightSeq;
+        m_highlightColumn = highlightColumn;
+        m_highlightLength = highlightLength;
+    }
+
+    for (int r = 0; r < m_rows; ++r) {
+        if (!dirty[r]) continue;
+        if (!m_damage.rows.empty() && m_damage.rows.back().first + m_damage.rows.back().count == r) {
+            m_damage.rows.back().count++;
+        }
+        else {
+            m_damage.rows.push_back({ r, 1 });
+        }
+    }
+
+    m_shown.swap(m_next);
+    m_shownStamps.swap(m_nextStamps);
+    m_bottomText.swap(m_nextBottomText);
+    m_firstSeq = first;
+    m_cursorRow = cursorRow;
+    m_cursorColumn = cursorColumn;
+    m_cursorVisible = cursorVisible;
+    return m_damage;
+}
+
+bool ScreenModel::Highlight(int row, int& first, int& count) const {
+    if (row < 0 || row >= m_rows || m_highlightSeq == EMPTY_ROW || m_shown[row] != m_highlightSeq) return false;
+    first = m_highlightColumn;
+    count = m_highlightLength;
+    return true;
+}
+
+std::wstring_view ScreenModel::RowText(const ConsoleEngine& console, int row) const {
+    if (row < 0 || row >= m_rows) return std::wstring_view();
+    uint64_t id = m_shown[row];
+    if (id == EMPTY_ROW) return std::wstring_view();
+    if (id == BOTTOM_ROW) return m_bottomText;
+    if (id >= CLOCK_ROW) return m_clockText[static_cast<size_t>(id - CLOCK_ROW)];
+    if (id >= VIEWER_ROW) {
+        const FileViewer* viewer = console.Viewer();
+        return viewer ? viewer->Line(id - VIEWER_ROW) : std::wstring_view();
+    }
+    return console.History().Line(static_cast<size_t>(id - m_firstSeq), m_rowText[row]);
+}
+
+/**
+ * Vergleicht eine Zeile der Uhr zeichenweise mit dem zuletzt gezeichneten Stand und meldet die
+ * geaenderten Abschnitte als Zellen; pro Sekunde ist das meist nur die letzte Ziffer.
+ */
+void ScreenModel::DiffClockRow(int row, const std::wstring& shown, std::wstring_view next) {
+    size_t length = std::max(shown.size(), next.size());
+    auto at = [](std::wstring_view text, size_t i) { return i < text.size() ? text[i] : L' '; };
+    size_t column = 0;
+    while (column < length) {
+        if (at(shown, column) == at(next, column)) {
+            ++column;
+            continue;
+        }
+        size_t start = column;
+        while (column < length && at(shown, column) != at(next, column)) ++column;
+        m_damage.cells.push_back({ row, static_cast<int>(start), static_cast<int>(column - start) });
+    }
+    m_clockText[row].assign(next);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ConsoleEngine;
+
+/**
+ * Zusammenhaengender Bereich von Bildschirmzeilen.
+ */
+struct RowSpan {
+    int first;
+    int count;
+};
+
+/**
+ * Zusammenhaengende Zellen einer Bildschirmzeile.
+ */
+struct CellSpan {
+    int row;
+    int first;
+    int count;
+};
+
+/**
+ * Aenderungen seit dem letzten Frame. Das Frontend verschiebt zuerst den vorhandenen Inhalt
+ * um scrollRows Zeilen (positiv = nach oben) und zeichnet dann nur die Zeilen in rows, die
+ * Zellen in cells sowie ggf. die Cursorzelle neu.
+ */
+struct FrameDamage {
+    int scrollRows = 0;
+    std::vector<RowSpan> rows;
+    std::vector<CellSpan> cells; // geaenderte Ziffern der Uhr (ihre Zeilen stehen nicht in rows)
+    bool cursor = false; // Cursorzelle neu zeichnen (ihre Zeile steht nicht in rows)
+
+    bool Empty() const { return scrollRows == 0 && rows.empty() && cells.empty() && !cursor; }
+};
+
+/**
+ * Gespeicherter Bildschirmzustand der Konsole (welche Verlaufszeile steht in welcher
+ * Bildschirmzeile, Inhalt der Eingabezeile, Cursorposition). Update() vergleicht ihn mit dem
+ * aktuellen Stand der Konsole und liefert nur die geaenderten Zeilen, sodass das Frontend
+ * nicht bei jedem Tastendruck oder Cursor-Blinken den ganzen Bildschirm neu zeichnen muss.
+ *
+ * Aufteilung wie bisher im WM_PAINT: die Verlaufszeilen fuellen die oberen Zeilen, die
+ * Eingabezeile (bzw. der Countdown) folgt direkt darunter. Ist die Uhr eingeschaltet (CLOCK),
+ * belegt sie die obersten ClockPanel::ROWS Zeilen; verschoben wird dann nur der Bereich darunter,
+ * und von der Uhr werden nur die Zellen gemeldet, deren Zeichen sich geaendert haben.
+ */
+class ScreenModel {
+public:
+    // Anzahl sichtbarer Zeilen; erzwingt ein vollstaendiges Neuzeichnen.
+    void Resize(int rows);
+    void InvalidateAll() { m_fullRedraw = true; }
+
+    const FrameDamage& Update(const ConsoleEngine& console, bool cursorVisible);
+
+    int Rows() const { return m_rows; }
+    // Erste Zeile des verschiebbaren Bereichs (unter der Uhr)
+    int ScrollTop() const { return m_top; }
+    std::wstring_view RowText(const ConsoleEngine& console, int row) const;
+
+    int CursorRow() const { return m_cursorRow; }
+    int CursorColumn() const { return m_cursorColumn; }
+    bool CursorVisible() const { return m_cursorRow >= 0 && m_cursorVisible; }
+
+    // Hervorgehobene Zellen der Zeile (Treffer der Verlaufssuche); false = keine.
+    bool Highlight(int row, int& first, int& count) const;
+
+private:
+    static constexpr uint64_t EMPTY_ROW = ~0ull;
+    static constexpr uint64_t BOTTOM_ROW = ~0ull - 1;
+    static constexpr uint64_t CLOCK_ROW = ~0ull - 64;   // + Zeile der Uhr
+    static constexpr uint64_t VIEWER_ROW = 1ull << 62; // + Zeilennummer der angezeigten Datei (TYPE)
+
+    void MarkDirty(int row);
+    void DiffClockRow(int row, const std::wstring& shown, std::wstring_view next);
+
+    int m_rows = 0;
+    int m_top = 0;
+    bool m_fullRedraw = true;
+
+    // Inhalt je Bildschirmzeile: fortlaufende Verlaufsnummer, Dateizeile, BOTTOM_ROW oder EMPTY_ROW
+    std::vector<uint64_t> m_shown;
+    std::vector<uint64_t> m_next;
+    // Aenderungsstempel ersetzter Verlaufszeilen (Scrollback::EditStamp) bzw. Nummer der
+    // Dateianzeige (FileViewer::Generation), sonst 0
+    std::vector<uint32_t> m_shownStamps;
+    std::vector<uint32_t> m_nextStamps;
+    uint64_t m_firstSeq = 0; // Verlaufsnummer von Index 0 beim letzten Update
+
+    std::vector<char> m_dirty;
+
+    std::wstring m_bottomText;
+    mutable std::vector<std::wstring> m_rowText; // formatierte Tabellenzeilen (Scrollback::Line)
+    std::wstring m_nextBottomText;
+    std::vector<std::wstring> m_clockText; // zuletzt gezeichnete Zeilen der Uhr
+
+    // Hervorgehobener Suchtreffer: Verlaufsnummer (EMPTY_ROW = keiner), Spalte, Laenge
+    uint64_t m_highlightSeq = EMPTY_ROW;
+    int m_highlightColumn = 0;
+    int m_highlightLength = 0;
+
+    int m_cursorRow = -1;
+    int m_cursorColumn = 0;
+    bool m_cursorVisible = false;
+
+    FrameDamage m_damage;
+};
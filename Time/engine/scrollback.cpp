@@ -0,0 +1,293 @@
+#include "scrollback.h"
+
+#include <algorithm>
+#include <bit>
+#include <cwchar>
+
+Scrollback::Scrollback(size_t maxLines, size_t chunkChars)
+    : m_maxLines(std::max<size_t>(maxLines, 1)),
+      m_chunkChars(std::max<size_t>(chunkChars, 64)) {
+}
+
+void Scrollback::Append(std::wstring_view text) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t nl = text.find(L'\n', pos);
+        if (nl == std::wstring_view::npos) {
+            AppendLine(text.substr(pos));
+            break;
+        }
+        AppendLine(text.substr(pos, nl - pos));
+        pos = nl + 1;
+    }
+}
+
+void Scrollback::AppendLine(std::wstring_view line) {
+    if (m_count == m_maxLines) {
+        EvictOldest();
+    }
+
+    uint32_t chunkSeq = 0;
+    wchar_t* text = Allocate(line.size(), chunkSeq);
+    if (!line.empty()) {
+        wmemcpy(text, line.data(), line.size());
+    }
+
+    m_index.Add(m_totalLines, line);
+    PushLine({ text, static_cast<uint32_t>(line.size()), chunkSeq });
+    m_textChars += line.size();
+}
+
+void Scrollback::AppendTable(std::shared_ptr<ResultTable> table, std::wstring prefix) {
+    size_t lines = table ? table->LineCount() : 0;
+    if (lines == 0) return;
+    table->Compact();
+    m_tables.push_back({ std::move(table), std::move(prefix), m_totalLines });
+    uint32_t tableSeq = m_firstTable + static_cast<uint32_t>(m_tables.size() - 1);
+    for (size_t i = 0; i < lines; ++i) {
+        if (m_count == m_maxLines) {
+            EvictOldest();
+        }
+        // Nur die Gruppe im Index anlegen (wie eine leere Zeile); den Text erfasst IndexTables
+        m_index.Add(m_totalLines, std::wstring_view());
+        PushLine({ nullptr, static_cast<uint32_t>(i), tableSeq });
+    }
+}
+
+/**
+ * Traegt die Zeilen aller seit dem letzten Find angehaengten Tabellen in den Index ein. Jede
+ * Tabelle wird dafuer genau einmal formatiert; bereits verdraengte Zeilen werden uebersprungen.
+ */
+void Scrollback::IndexTables() const {
+    const uint32_t endTable = m_firstTable + static_cast<uint32_t>(m_tables.size());
+    const uint64_t first = m_totalLines - m_count;
+    for (uint32_t tableSeq = std::max(m_indexedTables, m_firstTable); tableSeq < endTable; ++tableSeq) {
+        const TableRef& table = m_tables[tableSeq - m_firstTable];
+        const size_t lines = table.table->LineCount();
+        size_t i = first > table.firstSequence ? static_cast<size_t>(first - table.firstSequence) : 0;
+        for (; i < lines; ++i) {
+            LineRef ref{ nullptr, static_cast<uint32_t>(i), tableSeq };
+            m_index.Add(table.firstSequence + i, FormatTableLine(ref, m_findScratch));
+        }
+    }
+    m_indexedTables = endTable;
+}
+
+void Scrollback::PushLine(const LineRef& ref) {
+    if (m_lines.size() < m_maxLines && m_head == 0) {
+        // Ring waechst noch; Kapazitaet nie ueber m_maxLines hinaus
+        if (m_lines.size() == m_lines.capacity()) {
+            m_lines.reserve(std::min(m_maxLines, std::max<size_t>(64, m_lines.capacity() * 2)));
+        }
+        m_lines.push_back(ref);
+    }
+    else {
+        m_lines[(m_head + m_count) % m_lines.size()] = ref;
+    }
+    m_count++;
+    m_totalLines++;
+}
+
+std::wstring_view Scrollback::FormatTableLine(const LineRef& ref, std::wstring& scratch) const {
+    const TableRef& table = m_tables[ref.chunk - m_firstTable];
+    scratch = table.prefix;
+    table.table->FormatLine(ref.length, scratch);
+    return scratch;
+}
+
+bool Scrollback::ReplaceLine(uint64_t sequence, std::wstring_view line) {
+    uint64_t first = m_totalLines - m_count;
+    if (sequence < first || sequence >= m_totalLines) return false;
+
+    LineRef& ref = m_lines[(m_head + static_cast<size_t>(sequence - first)) % m_lines.size()];
+    if (!ref.text) return false; // Tabellenzeilen sind unveraenderlich
+    Edit& edit = m_edits.try_emplace(sequence, Edit{ 0, ref.length }).first->second;
+    if (line.size() <= edit.capacity) {
+        // Der Speicher der Zeile gehoert dem Verlauf, der Text passt an dieselbe Stelle
+        if (!line.empty()) wmemcpy(const_cast<wchar_t*>(ref.text), line.data(), line.size());
+    }
+    else {
+        // Mit Reserve neu anlegen; der alte Platz wird mit seinem Chunk frei
+        size_t capacity = line.size() + line.size() / 2;
+        uint32_t chunkSeq = 0;
+        wchar_t* text = Allocate(capacity, chunkSeq);
+        wmemcpy(text, line.data(), line.size());
+        m_chunks[ref.chunk - m_firstChunk].liveLines--;
+        ref.text = text;
+        ref.chunk = chunkSeq;
+        edit.capacity = static_cast<uint32_t>(capacity);
+        ReleaseEmptyChunks();
+    }
+    m_textChars = m_textChars - ref.length + line.size();
+    ref.length = static_cast<uint32_t>(line.size());
+    m_index.Add(sequence, line);
+
+    if (++m_editCounter == 0) m_editCounter = 1;
+    edit.stamp = m_editCounter;
+    return true;
+}
+
+/**
+ * Reserviert Platz fuer eine Zeile im aktuellen Chunk oder beginnt einen neuen.
+ * Zeilen, die groesser als ein Chunk sind, erhalten einen eigenen Chunk passender Groesse.
+ */
+wchar_t* Scrollback::Allocate(size_t length, uint32_t& chunkSeq) {
+    if (m_chunks.empty() || m_chunks.back().capacity - m_chunks.back().used < length) {
+        Chunk chunk;
+        if (length <= m_chunkChars && m_spare.data) {
+            chunk = std::move(m_spare);
+            m_spare = Chunk();
+            chunk.used = 0;
+            chunk.liveLines = 0;
+        }
+        else {
+            chunk.capacity = std::max(length, m_chunkChars);
+            chunk.data.reset(new wchar_t[chunk.capacity]);
+        }
+        m_chunks.push_back(std::move(chunk));
+    }
+
+    Chunk& chunk = m_chunks.back();
+    wchar_t* text = chunk.data.get() + chunk.used;
+    chunk.used += length;
+    chunk.liveLines++;
+    chunkSeq = m_firstChunk + static_cast<uint32_t>(m_chunks.size() - 1);
+    return text;
+}
+
+void Scrollback::EvictOldest() {
+    LineRef& ref = m_lines[m_head];
+    if (!m_edits.empty()) m_edits.erase(m_totalLines - m_count);
+    if (!ref.text) {
+        // Mit ihrer letzten Zeile verlaesst die (dann aelteste) Tabelle den Verlauf
+        if (ref.length + 1 == m_tables.front().table->LineCount()) {
+            m_tables.pop_front();
+            m_firstTable++;
+        }
+    }
+    else {
+        m_chunks[ref.chunk - m_firstChunk].liveLines--;
+        m_textChars -= ref.length;
+    }
+    m_head = (m_head + 1) % m_lines.size();
+    m_count--;
+    m_evictedLines++;
+    m_index.Trim(m_totalLines - m_count);
+    ReleaseEmptyChunks();
+}
+
+/**
+ * Gibt Chunks am Anfang frei, deren Zeilen alle verdraengt wurden. Der aktuelle
+ * Schreib-Chunk bleibt erhalten.
+ */
+void Scrollback::ReleaseEmptyChunks() {
+    while (m_chunks.size() > 1 && m_chunks.front().liveLines == 0) {
+        Chunk& front = m_chunks.front();
+        if (!m_spare.data && front.capacity == m_chunkChars) {
+            m_spare = std::move(front);
+        }
+        m_chunks.pop_front();
+        m_firstChunk++;
+    }
+}
+
+void Scrollback::Clear() {
+    // Einen Chunk als Reserve behalten, damit die naechsten Ausgaben nicht sofort allozieren
+    for (Chunk& chunk : m_chunks) {
+        if (!m_spare.data && chunk.capacity == m_chunkChars) {
+            m_spare = std::move(chunk);
+        }
+    }
+    m_firstChunk += static_cast<uint32_t>(m_chunks.size());
+    m_chunks.clear();
+    m_firstTable += static_cast<uint32_t>(m_tables.size());
+    m_tables.clear();
+    m_edits.clear();
+    m_index.Clear(m_totalLines);
+    m_lines.clear();
+    m_lines.shrink_to_fit();
+    m_head = 0;
+    m_count = 0;
+    m_textChars = 0;
+}
+
+void Scrollback::SetMaxLines(size_t maxLines) {
+    maxLines = std::max<size_t>(maxLines, 1);
+    while (m_count > maxLines) {
+        EvictOldest();
+    }
+
+    // Ring linearisieren, damit er mit der neuen Groesse weiterwachsen kann
+    std::vector<LineRef> lines;
+    lines.reserve(m_count);
+    for (size_t i = 0; i < m_count; ++i) {
+        lines.push_back(m_lines[(m_head + i) % m_lines.size()]);
+    }
+    m_lines = std::move(lines);
+    m_head = 0;
+    m_maxLines = maxLines;
+}
+
+/**
+ * Laeuft Block fuer Block (HistoryIndex::BLOCK_LINES Zeilen) in Suchrichtung und liest nur die
+ * Zeilen der Bloecke, die der Index als moeglich meldet; Gruppen ohne Kandidaten werden ganz
+ * uebersprungen.
+ */
+bool Scrollback::Find(const HistoryIndex::Query& query, size_t from, bool backward, Match& match) const {
+    if (query.folded.empty() || m_count == 0) return false;
+    IndexTables();
+    if (from >= m_count) {
+        if (!backward) return false;
+        from = m_count - 1;
+    }
+    const uint64_t first = m_totalLines - m_count;
+    const uint64_t end = m_totalLines; // ausschliesslich
+    const uint64_t blockLines = HistoryIndex::BLOCK_LINES;
+    const uint64_t groupLines = blockLines * HistoryIndex::GROUP_BLOCKS;
+    uint64_t sequence = first + from;
+    while (sequence >= first && sequence < end) {
+        uint64_t group = sequence / groupLines;
+        uint64_t candidates = m_index.Candidates(sequence, query);
+        uint64_t block = sequence / blockLines % HistoryIndex::GROUP_BLOCKS;
+        // Kandidaten in Suchrichtung ab dem aktuellen Block
+        candidates &= backward ? (~uint64_t{ 0 } >> (63 - block)) : (~uint64_t{ 0 } << block);
+        while (candidates) {
+            uint64_t next = backward ? 63 - static_cast<uint64_t>(std::countl_zero(candidates)) : static_cast<uint64_t>(std::countr_zero(candidates));
+            candidates &= ~(uint64_t{ 1 } << next);
+            uint64_t blockFirst = group * groupLines + next * blockLines;
+            uint64_t lo = std::max(blockFirst, first);
+            uint64_t hi = std::min(blockFirst + blockLines, end); // ausschliesslich
+            if (next != block) sequence = backward ? hi - 1 : lo;
+            for (; sequence >= lo && sequence < hi; backward ? --sequence : ++sequence) {
+                std::wstring_view line = Line(static_cast<size_t>(sequence - first), m_findScratch);
+                size_t column = HistoryIndex::FindFolded(line, query);
+                if (column != std::wstring_view::npos) {
+                    match = { static_cast<size_t>(sequence - first), column };
+                    return true;
+                }
+                if (backward && sequence == 0) return false;
+            }
+        }
+        // Naechste Gruppe in Suchrichtung
+        if (backward) {
+            if (group == 0) return false;
+            sequence = group * groupLines - 1;
+        }
+        else {
+            sequence = (group + 1) * groupLines;
+        }
+    }
+    return false;
+}
+
+size_t Scrollback::ResidentBytes() const {
+    size_t bytes = sizeof(*this) + m_lines.capacity() * sizeof(LineRef) + m_index.ResidentBytes();
+    for (const Chunk& chunk : m_chunks) {
+        bytes += sizeof(Chunk) + chunk.capacity * sizeof(wchar_t);
+    }
+    bytes += m_spare.capacity * sizeof(wchar_t);
+    for (const TableRef& table : m_tables) {
+        bytes += sizeof(TableRef) + table.table->ResidentBytes() + table.prefix.capacity() * sizeof(wchar_t);
+    }
+    return bytes;
+}
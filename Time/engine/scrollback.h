@@ -0,0 +1,165 @@
+#pragma once
+
+#include "history_index.h"
+#include "table.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Begrenzter Konsolenverlauf.
+ *
+ * Der Text aller Zeilen liegt hintereinander in grossen Speicherbloecken (Chunks); pro Zeile
+ * wird nur ein Verweis (Zeiger, Laenge, Chunk) in einem Ring mit fester Maximalgroesse gehalten.
+ * Ist der Ring voll, verdraengt jede neue Zeile die aelteste in O(1). Ein Chunk wird freigegeben
+ * (bzw. als Reserve behalten), sobald keine seiner Zeilen mehr im Verlauf ist, sodass der
+ * Speicherverbrauch auch bei wochenlanger Laufzeit konstant bleibt.
+ *
+ * Tabellen (ResultTable) belegen je Ausgabezeile nur einen Platzhalter im Ring; der Text einer
+ * solchen Zeile entsteht erst beim Lesen (Line) und wird nicht im Verlauf gespeichert.
+ *
+ * Zeilen werden als std::wstring_view geliefert und bleiben gueltig, bis sie verdraengt werden
+ * oder Clear() aufgerufen wird (Tabellenzeilen: bis zur naechsten Verwendung von scratch).
+ *
+ * Jede Zeile kommt in einen HistoryIndex, der mit den verdraengten Zeilen schrumpft; Find sucht
+ * darueber. Textzeilen werden beim Anhaengen erfasst, Tabellenzeilen erst beim naechsten Find
+ * (dann einmal formatiert), damit das Anhaengen einer Tabelle nichts formatiert.
+ */
+class Scrollback {
+public:
+    static constexpr size_t DEFAULT_MAX_LINES = 10000;
+    static constexpr size_t DEFAULT_CHUNK_CHARS = 16 * 1024;
+
+    explicit Scrollback(size_t maxLines = DEFAULT_MAX_LINES, size_t chunkChars = DEFAULT_CHUNK_CHARS);
+
+    Scrollback(const Scrollback&) = delete;
+    Scrollback& operator=(const Scrollback&) = delete;
+
+    // Haengt Text an; jede durch '\n' getrennte Teilzeichenkette wird eine Zeile
+    // (gleiche Semantik wie std::getline: ein abschliessendes '\n' erzeugt keine Leerzeile).
+    void Append(std::wstring_view text);
+
+    // Haengt genau eine Zeile an (auch eine leere); '\n' wird nicht ausgewertet.
+    void AppendLine(std::wstring_view line);
+
+    // Haengt alle Ausgabezeilen einer Tabelle an, ohne sie zu formatieren; prefix wird jeder
+    // Zeile vorangestellt (Jobnummer bei Hintergrundbefehlen). Die Tabelle gehoert danach dem
+    // Verlauf und wird nicht mehr veraendert.
+    void AppendTable(std::shared_ptr<ResultTable> table, std::wstring prefix = std::wstring());
+
+    // Ersetzt den Text einer vorhandenen Zeile (fortlaufende Nummer wie TotalLines()), z.B. eine
+    // Statuszeile, die laufend aktualisiert wird. Ist der neue Text nicht laenger, wird er an Ort
+    // und Stelle ueberschrieben. Liefert false, wenn die Zeile nicht mehr im Verlauf ist.
+    bool ReplaceLine(uint64_t sequence, std::wstring_view line);
+
+    // Aenderungszaehler ersetzter Zeilen (0 = nie ersetzt), damit das Frontend sie neu zeichnet.
+    uint32_t EditStamp(uint64_t sequence) const {
+        if (m_edits.empty()) return 0;
+        auto it = m_edits.find(sequence);
+        return it != m_edits.end() ? it->second.stamp : 0;
+    }
+
+    void Clear();
+
+    // Aendert die maximale Zeilenzahl; ueberzaehlige alte Zeilen werden verdraengt.
+    void SetMaxLines(size_t maxLines);
+    size_t MaxLines() const { return m_maxLines; }
+
+    size_t Size() const { return m_count; }
+    bool Empty() const { return m_count == 0; }
+
+    // Zeile i, 0 ist die aelteste noch vorhandene Zeile. Tabellenzeilen werden in scratch
+    // formatiert, alle anderen direkt aus dem Chunk geliefert.
+    std::wstring_view Line(size_t i, std::wstring& scratch) const {
+        const LineRef& ref = m_lines[(m_head + i) % m_lines.size()];
+        if (!ref.text) return FormatTableLine(ref, scratch);
+        return std::wstring_view(ref.text, ref.length);
+    }
+
+    /**
+     * Fundstelle von Find: Zeile (Index wie Line) und Spalte.
+     */
+    struct Match {
+        size_t line;
+        size_t column;
+    };
+
+    // Naechste Zeile ab Index from (einschliesslich), die den Suchtext (HistoryIndex::Prepare)
+    // ohne Gross-/Kleinschreibung enthaelt; backward sucht zu aelteren Zeilen. Liefert false,
+    // wenn es keine weitere gibt.
+    bool Find(const HistoryIndex::Query& query, size_t from, bool backward, Match& match) const;
+
+    // Zaehler
+    uint64_t TotalLines() const { return m_totalLines; }     // jemals angehaengte Zeilen (fortlaufende Nummer)
+    uint64_t EvictedLines() const { return m_evictedLines; } // durch das Limit verdraengte Zeilen
+    size_t ChunkCount() const { return m_chunks.size(); }
+    size_t ResidentBytes() const;                            // belegter Speicher inkl. Verwaltung
+    size_t TextBytes() const { return m_textChars * sizeof(wchar_t); } // Nutzdaten der vorhandenen Zeilen
+
+private:
+    struct Chunk {
+        std::unique_ptr<wchar_t[]> data;
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t liveLines = 0;
+    };
+
+    // Tabellenzeile: text == nullptr, length = Ausgabezeile der Tabelle, chunk = Tabellennummer
+    struct LineRef {
+        const wchar_t* text;
+        uint32_t length;
+        uint32_t chunk; // fortlaufende Chunk-Nummer (Index = chunk - m_firstChunk)
+    };
+
+    struct TableRef {
+        std::shared_ptr<const ResultTable> table;
+        std::wstring prefix;
+        uint64_t firstSequence; // fortlaufende Nummer der ersten Ausgabezeile
+    };
+
+    void PushLine(const LineRef& ref);
+    std::wstring_view FormatTableLine(const LineRef& ref, std::wstring& scratch) const;
+    void IndexTables() const;
+    wchar_t* Allocate(size_t length, uint32_t& chunkSeq);
+    void EvictOldest();
+    void ReleaseEmptyChunks();
+
+    size_t m_maxLines;
+    size_t m_chunkChars;
+
+    std::vector<LineRef> m_lines; // Ring, waechst bis m_maxLines
+    size_t m_head = 0;
+    size_t m_count = 0;
+
+    std::deque<Chunk> m_chunks;
+    uint32_t m_firstChunk = 0;
+    Chunk m_spare; // wiederverwendeter Chunk, vermeidet Allokationen im Dauerbetrieb
+
+    // Tabellen mit noch vorhandenen Zeilen, aelteste zuerst (Index = Nummer - m_firstTable)
+    std::deque<TableRef> m_tables;
+    uint32_t m_firstTable = 0;
+    mutable uint32_t m_indexedTables = 0; // Tabellen mit kleinerer Nummer stehen im Index
+
+    mutable HistoryIndex m_index; // Find ergaenzt die Tabellenzeilen
+    mutable std::wstring m_findScratch;
+
+    size_t m_textChars = 0;
+    uint64_t m_totalLines = 0;
+    uint64_t m_evictedLines = 0;
+
+    // Nur ersetzte Zeilen, die noch vorhanden sind. capacity ist der fuer die Zeile reservierte
+    // Platz: waechst sie, wird mit Reserve neu angelegt, damit eine Statuszeile mit schwankender
+    // Laenge nicht bei jeder Aktualisierung neuen Speicher verbraucht.
+    struct Edit {
+        uint32_t stamp;
+        uint32_t capacity;
+    };
+    std::unordered_map<uint64_t, Edit> m_edits;
+    uint32_t m_editCounter = 0;
+};
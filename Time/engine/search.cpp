@@ -0,0 +1,693 @@
+#include "search.h"
+#include "dirwalk.h"
+#include "line_index.h"
+#include "mapped_file.h"
+#include "simd.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstring>
+#include <cwctype>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+unsigned char FoldAscii(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + 32) : c;
+}
+
+bool IsAsciiLetter(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool IsWordByte(unsigned char c) {
+    return c == '_' || c >= 0x80 || (c >= '0' && c <= '9') || IsAsciiLetter(c);
+}
+
+/**
+ * Token der Befehlszeile von FIND/FINDSTR. Anfuehrungszeichen duerfen auch mitten im Token
+ * stehen (/C:"zwei Worte") und werden entfernt.
+ */
+struct Token {
+    std::wstring text;
+    bool quoted = false; // beginnt mit einem Anfuehrungszeichen: nie eine Option
+};
+
+std::vector<Token> Tokenize(const std::wstring& arguments) {
+    std::vector<Token> tokens;
+    size_t pos = 0;
+    while (pos < arguments.size()) {
+        if (std::iswspace(arguments[pos])) {
+            ++pos;
+            continue;
+        }
+        Token& token = tokens.emplace_back();
+        token.quoted = arguments[pos] == L'"';
+        bool inQuotes = false;
+        for (; pos < arguments.size() && (inQuotes || !std::iswspace(arguments[pos])); ++pos) {
+            if (arguments[pos] == L'"') inQuotes = !inQuotes;
+            else token.text += arguments[pos];
+        }
+    }
+    return tokens;
+}
+
+// Buchstaben einer Option wie /I oder /IN (zusammengefasst); false, wenn es keine Option ist
+bool OptionLetters(const Token& token, std::wstring& letters) {
+    if (token.quoted || token.text.size() < 2 || (token.text[0] != L'/' && token.text[0] != L'-')) return false;
+    letters.clear();
+    for (size_t i = 1; i < token.text.size(); ++i) {
+        if (!std::iswalpha(token.text[i])) return false;
+        letters += static_cast<wchar_t>(std::towlower(token.text[i]));
+    }
+    return true;
+}
+
+bool WildcardMatch(const wchar_t* pattern, const wchar_t* name) {
+    const wchar_t* star = nullptr;
+    const wchar_t* resume = nullptr;
+    while (*name) {
+#ifdef _WIN32
+        bool same = std::towlower(*pattern) == std::towlower(*name);
+#else
+        bool same = *pattern == *name;
+#endif
+        if (*pattern == L'?' || (*pattern && *pattern != L'*' && same)) {
+            ++pattern;
+            ++name;
+        }
+        else if (*pattern == L'*') {
+            star = pattern++;
+            resume = name;
+        }
+        else if (star) {
+            pattern = star + 1;
+            name = ++resume;
+        }
+        else {
+            return false;
+        }
+    }
+    while (*pattern == L'*') ++pattern;
+    return *pattern == L'\0';
+}
+
+struct SearchFile {
+    std::wstring name; // wie angegeben bzw. Verzeichnis des Musters plus Dateiname
+    std::wstring path;
+    std::wstring error;
+};
+
+// Loest Dateiangaben auf; * und ? sind nur im letzten Namensteil erlaubt.
+std::vector<SearchFile> ExpandFiles(const std::wstring& base, const std::vector<std::wstring>& arguments, bool& wildcard) {
+    std::vector<SearchFile> files;
+    std::vector<DirectoryEntry> entries;
+    for (const std::wstring& argument : arguments) {
+        size_t separator = LastSeparator(argument);
+        std::wstring namePattern = separator == std::wstring::npos ? argument : argument.substr(separator + 1);
+        if (namePattern.find_first_of(L"*?") == std::wstring::npos) {
+            files.push_back({ argument, ResolvePath(base, argument), std::wstring() });
+            continue;
+        }
+        wildcard = true;
+        std::wstring prefix = separator == std::wstring::npos ? std::wstring() : argument.substr(0, separator + 1);
+        std::wstring directory = ResolvePath(base, prefix);
+        std::wstring error;
+        entries.clear();
+        size_t first = files.size();
+        if (ReadDirectory(directory, EntryDetail::Files, entries, error)) {
+            for (const DirectoryEntry& entry : entries) {
+                if (entry.directory || !WildcardMatch(namePattern.c_str(), entry.name.c_str())) continue;
+                files.push_back({ prefix + entry.name, JoinPath(directory, entry.name), std::wstring() });
+            }
+        }
+        std::sort(files.begin() + first, files.end(), [](const SearchFile& a, const SearchFile& b) { return a.name < b.name; });
+        if (files.size() == first) files.push_back({ argument, std::wstring(), L"Datei nicht gefunden" });
+    }
+    return files;
+}
+
+/**
+ * Ergebnis einer Datei, von einem Arbeitsthread gefuellt und vom Job in Dateireihenfolge
+ * ausgegeben.
+ */
+struct FileResult {
+    std::vector<std::wstring> lines; // noch nicht ausgegeben
+    uint64_t count = 0;
+    std::wstring error;
+    bool done = false;
+};
+
+// In einer Pipeline liest die Suche die Ausgabe der vorigen Stufe statt Dateien
+bool CheckPipedSearch(const wchar_t* what, const SearchOptions& options, std::wstring& error) {
+    if (options.patterns.empty()) {
+        error = std::wstring(what) + L" erforderlich.";
+        return false;
+    }
+    if (!options.files.empty()) {
+        error = L"In einer Pipeline keine Datei angeben ('" + options.files.front() + L"'), gelesen wird die Ausgabe davor.";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool TextPattern::Compile(const std::wstring& pattern, bool regex, bool ignoreCase, std::wstring& error) {
+    m_regex = regex;
+    m_ignoreCase = ignoreCase;
+    m_anchorStart = false;
+    m_anchorEnd = false;
+    m_atoms.clear();
+    m_literal.clear();
+
+    std::string bytes = WideToUtf8(pattern);
+    if (bytes.empty()) {
+        error = L"Leerer Suchtext.";
+        return false;
+    }
+    if (!regex) {
+        m_literal = bytes;
+        if (ignoreCase) std::transform(m_literal.begin(), m_literal.end(), m_literal.begin(), [](char c) { return static_cast<char>(FoldAscii(static_cast<unsigned char>(c))); });
+        return true;
+    }
+
+    auto literalAtom = [&](unsigned char c) {
+        Atom& atom = m_atoms.emplace_back();
+        atom.Add(c);
+        if (ignoreCase && IsAsciiLetter(c)) atom.Add(static_cast<unsigned char>(c ^ 0x20));
+        atom.literal = ignoreCase ? FoldAscii(c) : c;
+    };
+
+    size_t i = 0;
+    if (bytes[0] == '^') {
+        m_anchorStart = true;
+        i = 1;
+    }
+    for (; i < bytes.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(bytes[i]);
+        if (c == '$' && i + 1 == bytes.size()) {
+            m_anchorEnd = true;
+        }
+        else if (c == '.') {
+            Atom& atom = m_atoms.emplace_back();
+            atom.set = { ~0ull, ~0ull, ~0ull, ~0ull };
+            atom.set[0] &= ~(1ull << '\n');
+        }
+        else if (c == '*' && !m_atoms.empty() && m_atoms.back().kind == Atom::Kind::Bytes && !m_atoms.back().star) {
+            m_atoms.back().star = true;
+        }
+        else if (c == '[') {
+            size_t close = bytes.find(']', i + 2); // "[]...]" enthaelt ']'
+            if (close == std::string::npos) {
+                error = L"Ungueltiger Ausdruck: ']' fehlt.";
+                return false;
+            }
+            Atom& atom = m_atoms.emplace_back();
+            size_t k = i + 1;
+            bool negate = bytes[k] == '^' && k + 1 < close;
+            if (negate) ++k;
+            for (; k < close; ++k) {
+                unsigned char from = static_cast<unsigned char>(bytes[k]);
+                unsigned char to = from;
+                if (k + 2 < close && bytes[k + 1] == '-') {
+                    to = static_cast<unsigned char>(bytes[k + 2]);
+                    k += 2;
+                }
+                for (unsigned value = from; value <= to; ++value) {
+                    atom.Add(static_cast<unsigned char>(value));
+                    if (ignoreCase && IsAsciiLetter(static_cast<unsigned char>(value))) atom.Add(static_cast<unsigned char>(value ^ 0x20));
+                }
+            }
+            if (negate) {
+                for (uint64_t& word : atom.set) word = ~word;
+                atom.set[0] &= ~(1ull << '\n');
+            }
+            i = close;
+        }
+        else if (c == '\\' && i + 1 < bytes.size()) {
+            unsigned char next = static_cast<unsigned char>(bytes[++i]);
+            if (next == '<' || next == '>') {
+                m_atoms.emplace_back().kind = next == '<' ? Atom::Kind::WordStart : Atom::Kind::WordEnd;
+            }
+            else {
+                literalAtom(next);
+            }
+        }
+        else {
+            literalAtom(c);
+        }
+    }
+
+    // Laengste Folge einzelner Zeichen ohne *: muss in jeder passenden Zeile vorkommen
+    std::string run;
+    for (size_t k = 0; k <= m_atoms.size(); ++k) {
+        bool literal = k < m_atoms.size() && m_atoms[k].kind == Atom::Kind::Bytes && !m_atoms[k].star && m_atoms[k].literal >= 0;
+        bool skip = k < m_atoms.size() && m_atoms[k].kind != Atom::Kind::Bytes; // Wortgrenzen unterbrechen nicht
+        if (literal) {
+            run += static_cast<char>(m_atoms[k].literal);
+        }
+        else if (!skip) {
+            if (run.size() > m_literal.size()) m_literal = run;
+            run.clear();
+        }
+    }
+    return true;
+}
+
+/**
+ * Sucht das Literal: SSE2 vergleicht 16 Startpositionen auf einmal mit dem ersten und dem
+ * letzten Byte; nur wo beide passen, wird das ganze Literal verglichen. Bei ignoreCase wird ein
+ * Buchstabe per OR 0x20 auf Kleinbuchstaben abgebildet, was fuer Buchstaben genau die beiden
+ * Schreibweisen trifft.
+ */
+const char* TextPattern::FindLiteral(const char* begin, const char* end) const {
+    const size_t length = m_literal.size();
+    if (static_cast<size_t>(end - begin) < length) return end;
+    const char* literal = m_literal.data();
+    const unsigned char first = static_cast<unsigned char>(literal[0]);
+    const unsigned char last = static_cast<unsigned char>(literal[length - 1]);
+    const char* limit = end - length; // letzte moegliche Startposition
+
+    auto verify = [&](const char* p) {
+        if (!m_ignoreCase) return memcmp(p, literal, length) == 0;
+        for (size_t k = 0; k < length; ++k) {
+            if (FoldAscii(static_cast<unsigned char>(p[k])) != static_cast<unsigned char>(literal[k])) return false;
+        }
+        return true;
+    };
+
+    const char* p = begin;
+#if TIME_HAVE_SSE2
+    const __m128i firstByte = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i lastByte = _mm_set1_epi8(static_cast<char>(last));
+    const __m128i foldFirst = _mm_set1_epi8(m_ignoreCase && IsAsciiLetter(first) ? 0x20 : 0);
+    const __m128i foldLast = _mm_set1_epi8(m_ignoreCase && IsAsciiLetter(last) ? 0x20 : 0);
+    for (; limit - p >= 15; p += 16) {
+        __m128i head = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), foldFirst);
+        __m128i tail = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + length - 1)), foldLast);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, firstByte), _mm_cmpeq_epi8(tail, lastByte))));
+        while (mask) {
+            const char* candidate = p + std::countr_zero(mask);
+            if (verify(candidate)) return candidate;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; p <= limit; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if ((m_ignoreCase ? FoldAscii(c) : c) == first && verify(p)) return p;
+    }
+    return end;
+}
+
+const char* TextPattern::FindCandidate(const char* begin, const char* end) const {
+    return m_literal.empty() ? begin : FindLiteral(begin, end);
+}
+
+bool TextPattern::Match(size_t index, const char* p, const char* lineBegin, const char* lineEnd) const {
+    for (; index < m_atoms.size(); ++index) {
+        const Atom& atom = m_atoms[index];
+        if (atom.kind == Atom::Kind::WordStart) {
+            bool before = p > lineBegin && IsWordByte(static_cast<unsigned char>(p[-1]));
+            if (before || p == lineEnd || !IsWordByte(static_cast<unsigned char>(*p))) return false;
+            continue;
+        }
+        if (atom.kind == Atom::Kind::WordEnd) {
+            bool after = p < lineEnd && IsWordByte(static_cast<unsigned char>(*p));
+            if (after || p == lineBegin || !IsWordByte(static_cast<unsigned char>(p[-1]))) return false;
+            continue;
+        }
+        if (atom.star) {
+            // Gierig, dann schrittweise zurueck; Stellen, an denen das folgende Zeichen nicht
+            // passen kann, werden ohne Rekursion uebersprungen
+            const Atom* next = index + 1 < m_atoms.size() && m_atoms[index + 1].kind == Atom::Kind::Bytes && !m_atoms[index + 1].star
+                ? &m_atoms[index + 1] : nullptr;
+            const char* q = p;
+            while (q < lineEnd && atom.Accepts(static_cast<unsigned char>(*q))) ++q;
+            for (;; --q) {
+                bool possible = !next || (q < lineEnd && next->Accepts(static_cast<unsigned char>(*q)));
+                if (possible && Match(index + 1, q, lineBegin, lineEnd)) return true;
+                if (q == p) return false;
+            }
+        }
+        if (p == lineEnd || !atom.Accepts(static_cast<unsigned char>(*p))) return false;
+        ++p;
+    }
+    return !m_anchorEnd || p == lineEnd;
+}
+
+bool TextPattern::MatchLine(const char* begin, const char* end) const {
+    if (!m_regex) return FindLiteral(begin, end) != end;
+    if (!m_literal.empty() && FindLiteral(begin, end) == end) return false;
+    if (m_anchorStart) return Match(0, begin, begin, end);
+    const Atom* first = m_atoms.empty() ? nullptr : &m_atoms[0];
+    bool filter = first && first->kind == Atom::Kind::Bytes && !first->star;
+    for (const char* p = begin; p <= end; ++p) {
+        if (filter && (p == end || !first->Accepts(static_cast<unsigned char>(*p)))) continue;
+        if (Match(0, p, begin, end)) return true;
+    }
+    return false;
+}
+
+LineScanner::LineScanner(const std::vector<TextPattern>& patterns, bool invert, bool lineNumbers)
+    : m_patterns(patterns), m_invert(invert), m_lineNumbers(lineNumbers) {
+    m_everyLine = std::any_of(patterns.begin(), patterns.end(), [](const TextPattern& pattern) { return !pattern.HasLiteral(); });
+}
+
+bool LineScanner::Matches(const char* begin, const char* end) const {
+    if (end > begin && end[-1] == '\r') --end;
+    return std::any_of(m_patterns.begin(), m_patterns.end(), [&](const TextPattern& pattern) { return pattern.MatchLine(begin, end); });
+}
+
+uint64_t LineScanner::NumberOf(const char* lineBegin) {
+    if (!m_lineNumbers) return 0;
+    m_lines += CountNewlines(m_counted, lineBegin);
+    m_counted = lineBegin;
+    return m_lines + 1;
+}
+
+void LineScanner::ReportRange(const char* begin, const char* end, const LineFunction& found, uint64_t& reported) {
+    while (begin < end) {
+        const char* lineEnd = FindNewline(begin, end);
+        found(NumberOf(begin), begin, lineEnd);
+        ++reported;
+        begin = lineEnd < end ? lineEnd + 1 : end;
+    }
+}
+
+uint64_t LineScanner::Scan(const char* begin, const char* end, const LineFunction& found) {
+    if (!m_counted) m_counted = begin;
+    m_next.assign(m_patterns.size(), nullptr);
+    uint64_t reported = 0;
+    const char* pos = begin;
+    while (pos < end) {
+        // Naechster Kandidat aller Alternativen; ohne Literal ist jede Zeile einer
+        const char* candidate = end;
+        if (m_everyLine) {
+            candidate = pos;
+        }
+        else {
+            for (size_t i = 0; i < m_patterns.size(); ++i) {
+                if (!m_next[i] || m_next[i] < pos) m_next[i] = m_patterns[i].FindCandidate(pos, end);
+                candidate = std::min(candidate, m_next[i]);
+            }
+        }
+        if (candidate == end) break;
+
+        const char* lineBegin = candidate;
+        while (lineBegin > pos && lineBegin[-1] != '\n') --lineBegin;
+        const char* lineEnd = FindNewline(candidate, end);
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+        bool match = Matches(lineBegin, lineEnd);
+        if (m_invert) {
+            ReportRange(pos, match ? lineBegin : next, found, reported);
+        }
+        else if (match) {
+            found(NumberOf(lineBegin), lineBegin, lineEnd);
+            ++reported;
+        }
+        pos = next;
+    }
+    if (m_invert) ReportRange(pos, end, found, reported);
+    if (m_lineNumbers) {
+        m_lines += CountNewlines(m_counted, end);
+        m_counted = end;
+    }
+    return reported;
+}
+
+bool ParseFindArguments(const std::wstring& arguments, SearchOptions& options, std::wstring& error, bool piped) {
+    options.findstr = false;
+    options.regex = false;
+    std::wstring letters;
+    for (const Token& token : Tokenize(arguments)) {
+        if (OptionLetters(token, letters)) {
+            for (wchar_t letter : letters) {
+                switch (letter) {
+                case L'v': options.invert = true; break;
+                case L'c': options.count = true; break;
+                case L'n': options.lineNumbers = true; break;
+                case L'i': options.ignoreCase = true; break;
+                default:
+                    error = L"Ungueltige Option '" + token.text + L"' (erlaubt: /V /C /N /I).";
+                    return false;
+                }
+            }
+        }
+        else if (options.patterns.empty()) {
+            options.patterns.push_back(token.text);
+        }
+        else {
+            options.files.push_back(token.text);
+        }
+    }
+    if (piped) return CheckPipedSearch(L"Suchtext", options, error);
+    if (options.patterns.empty() || options.files.empty()) {
+        error = L"Suchtext und Datei erforderlich, z.B. FIND \"Fehler\" log.txt.";
+        return false;
+    }
+    return true;
+}
+
+bool ParseFindstrArguments(const std::wstring& arguments, SearchOptions& options, std::wstring& error, bool piped) {
+    options.findstr = true;
+    std::wstring letters;
+    int mode = 0; // /R = 1, /L = -1, sonst je nach Muster
+    bool explicitStrings = false;
+    bool havePattern = false;
+    for (const Token& token : Tokenize(arguments)) {
+        const std::wstring& text = token.text;
+        if (!token.quoted && text.size() > 3 && (text[0] == L'/' || text[0] == L'-') && std::towlower(text[1]) == L'c' && text[2] == L':') {
+            options.patterns.push_back(text.substr(3)); // /C:text, auch mit Leerzeichen
+            explicitStrings = true;
+        }
+        else if (OptionLetters(token, letters)) {
+            for (wchar_t letter : letters) {
+                switch (letter) {
+                case L'r': mode = 1; break;
+                case L'l': mode = -1; break;
+                case L'i': options.ignoreCase = true; break;
+                case L'n': options.lineNumbers = true; break;
+                case L'c': options.count = true; break;
+                case L'v': options.invert = true; break;
+                default:
+                    error = L"Ungueltige Option '" + text + L"' (erlaubt: /R /L /I /N /C /V /C:text).";
+                    return false;
+                }
+            }
+        }
+        else if (!explicitStrings && !havePattern) {
+            // Mehrere Worte sind Alternativen
+            havePattern = true;
+            size_t pos = 0;
+            while (pos < text.size()) {
+                size_t end = text.find(L' ', pos);
+                if (end == std::wstring::npos) end = text.size();
+                if (end > pos) options.patterns.push_back(text.substr(pos, end - pos));
+                pos = end + 1;
+            }
+        }
+        else {
+            options.files.push_back(text);
+        }
+    }
+    // Ohne Angabe: regulaere Ausdruecke, ausser bei /C:text (wie FINDSTR)
+    options.regex = mode == 1 || (mode == 0 && !explicitStrings);
+    if (piped) return CheckPipedSearch(L"Suchmuster", options, error);
+    if (options.patterns.empty() || options.files.empty()) {
+        error = L"Suchmuster und Datei erforderlich, z.B. FINDSTR /N \"Fehler.*Timeout\" *.log.";
+        return false;
+    }
+    return true;
+}
+
+void RunSearch(JobContext& job, const std::wstring& base, const SearchOptions& options) {
+    std::vector<TextPattern> patterns(options.patterns.size());
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        std::wstring error;
+        if (!patterns[i].Compile(options.patterns[i], options.regex, options.ignoreCase, error)) {
+            job.AddError(L"FEHLER: " + error);
+            return;
+        }
+    }
+    bool wildcard = false;
+    std::vector<SearchFile> files = ExpandFiles(base, options.files, wildcard);
+    const bool showNames = options.findstr && (files.size() > 1 || wildcard);
+
+    // Arbeitsthreads durchsuchen je eine Datei; Ergebnisse spaeterer Dateien warten hoechstens
+    // MAX_PENDING Zeilen weit auf die Ausgabe der frueheren
+    constexpr size_t MAX_PENDING = 16384;
+    constexpr uint64_t BLOCK_BYTES = 16 << 20;
+    std::vector<FileResult> results(files.size());
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t current = 0;
+    std::atomic<size_t> nextFile{ 0 };
+
+    auto searchFile = [&](size_t index) {
+        const SearchFile& file = files[index];
+        FileResult& result = results[index];
+        std::vector<std::wstring> batch;
+        auto publish = [&](bool done) {
+            std::unique_lock<std::mutex> lock(mutex);
+            std::move(batch.begin(), batch.end(), std::back_inserter(result.lines));
+            batch.clear();
+            result.done = done;
+            changed.notify_all();
+            while (!done && index != current && result.lines.size() > MAX_PENDING && !job.Cancelled()) {
+                changed.wait_for(lock, std::chrono::milliseconds(50));
+            }
+        };
+
+        MappedFile mapped;
+        std::wstring error = file.error;
+        if (error.empty() && !mapped.Open(file.path, error)) error = L"Datei nicht gefunden";
+        if (!error.empty()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            result.error = error;
+            result.done = true;
+            changed.notify_all();
+            return;
+        }
+
+        LineScanner scanner(patterns, options.invert, options.lineNumbers);
+        std::wstring decoded;
+        std::wstring prefix = showNames ? file.name + L":" : std::wstring();
+        auto found = [&](uint64_t lineNumber, const char* begin, const char* end) {
+            if (options.count) return;
+            DecodeTextLine(std::string_view(begin, static_cast<size_t>(end - begin)), decoded);
+            std::wstring line;
+            if (options.findstr) {
+                line = prefix;
+                if (options.lineNumbers) line += std::to_wstring(lineNumber) + L":";
+            }
+            else if (options.lineNumbers) {
+                line = L"[" + std::to_wstring(lineNumber) + L"]";
+            }
+            line += decoded;
+            batch.push_back(std::move(line));
+            if (batch.size() >= 256) publish(false);
+        };
+
+        // Blockweise bis zum naechsten Zeilenende: Abbruch pruefen, gelesene Seiten freigeben
+        const char* data = mapped.Data();
+        const uint64_t size = mapped.Size();
+        uint64_t count = 0;
+        for (uint64_t pos = 0; pos < size && !job.Cancelled();) {
+            uint64_t blockEnd = std::min(pos + BLOCK_BYTES, size);
+            if (blockEnd < size) blockEnd = std::min<uint64_t>(static_cast<uint64_t>(FindNewline(data + blockEnd, data + size) - data) + 1, size);
+            count += scanner.Scan(data + pos, data + blockEnd, found);
+            mapped.Release(pos, blockEnd - pos);
+            pos = blockEnd;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            result.count = count;
+        }
+        publish(true);
+    };
+
+    unsigned threads = std::clamp(std::thread::hardware_concurrency(), 1u, 8u);
+    threads = static_cast<unsigned>(std::min<size_t>(threads, files.size()));
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t index = nextFile++; index < files.size() && !job.Cancelled(); index = nextFile++) searchFile(index);
+        });
+    }
+
+    // Ausgabe in Dateireihenfolge, jede Datei gestreamt, sobald Zeilen vorliegen
+    {
+        OutputBlock out(job);
+        std::vector<std::wstring> lines;
+        for (size_t index = 0; index < files.size() && !job.Cancelled(); ++index) {
+            const SearchFile& file = files[index];
+            bool header = !options.findstr && !options.count; // erst, wenn die Datei lesbar ist
+            bool done = false;
+            std::wstring error;
+            uint64_t count = 0;
+            while (!done && !job.Cancelled()) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait_for(lock, std::chrono::milliseconds(50), [&] { return !results[index].lines.empty() || results[index].done; });
+                    lines.swap(results[index].lines);
+                    done = results[index].done;
+                    error = results[index].error;
+                    count = results[index].count;
+                    changed.notify_all();
+                }
+                if (header && error.empty() && (done || !lines.empty())) {
+                    out.Add(L"---------- " + file.name);
+                    header = false;
+                }
+                for (const std::wstring& line : lines) out.Add(line);
+                lines.clear();
+            }
+            if (!done) break;
+            if (!error.empty()) {
+                out.AddError(L"FEHLER: " + error + L" - " + file.name);
+            }
+            else if (options.count) {
+                if (!options.findstr) out.Add(L"---------- " + file.name + L": " + std::to_wstring(count));
+                else out.Add((showNames ? file.name + L":" : std::wstring()) + std::to_wstring(count));
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            current = index + 1;
+            changed.notify_all();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changed.notify_all();
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+void FilterLines(JobContext& job, RecordQueue& in, RecordSink& out, const SearchOptions& options) {
+    std::vector<TextPattern> patterns(options.patterns.size());
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        std::wstring error;
+        if (!patterns[i].Compile(options.patterns[i], options.regex, options.ignoreCase, error)) {
+            job.AddError(L"FEHLER: " + error);
+            return;
+        }
+    }
+
+    // Zeilen kommen als UTF-16; die Muster arbeiten auf UTF-8 wie bei Dateien
+    RecordBatch batch;
+    RecordBatch found;
+    std::string bytes;
+    uint64_t number = 0;
+    uint64_t count = 0;
+    while (in.Read(batch)) {
+        for (std::wstring& line : batch) {
+            ++number;
+            bytes = WideToUtf8(line);
+            bool match = false;
+            for (const TextPattern& pattern : patterns) {
+                if (pattern.MatchLine(bytes.data(), bytes.data() + bytes.size())) {
+                    match = true;
+                    break;
+                }
+            }
+            if (match == options.invert) continue;
+            ++count;
+            if (options.count) continue;
+            if (options.lineNumbers) {
+                line.insert(0, options.findstr ? std::to_wstring(number) + L":" : L"[" + std::to_wstring(number) + L"]");
+            }
+            found.push_back(std::move(line));
+        }
+        batch.clear();
+        if (!found.empty() && !out.Write(found)) return;
+    }
+    if (options.count && !job.Cancelled()) {
+        found.push_back(std::to_wstring(count));
+        out.Write(found);
+    }
+}
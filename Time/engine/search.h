@@ -0,0 +1,111 @@
+#pragma once
+
+#include "executor.h"
+#include "pipeline.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Ein Suchmuster von FIND/FINDSTR, uebersetzt in Bytes (UTF-8). Literale werden mit einem
+ * SSE2-Filter auf erstes und letztes Byte gesucht (16 Positionen je Schritt, nur Kandidaten
+ * werden verglichen). Regulaere Ausdruecke im Umfang von FINDSTR (. * ^ $ [..] [^..] \< \> \x)
+ * werden zeilenweise per Backtracking geprueft; ihr laengstes Pflichtliteral dient als Filter,
+ * so dass nur Zeilen mit diesem Literal ueberhaupt geprueft werden.
+ *
+ * Gross-/Kleinschreibung wird nur fuer ASCII ignoriert.
+ */
+class TextPattern {
+public:
+    bool Compile(const std::wstring& pattern, bool regex, bool ignoreCase, std::wstring& error);
+
+    // Erste Stelle in [begin, end), an der eine passende Zeile beginnen koennte: das
+    // Pflichtliteral bzw. begin selbst, wenn es keines gibt; end, wenn das Muster nicht vorkommt.
+    const char* FindCandidate(const char* begin, const char* end) const;
+
+    // Passt das Muster auf die Zeile [begin, end) (ohne '\n')?
+    bool MatchLine(const char* begin, const char* end) const;
+
+    bool HasLiteral() const { return !m_literal.empty(); }
+
+private:
+    // Menge zulaessiger Bytes einer Position; star = beliebig oft
+    struct Atom {
+        enum class Kind : uint8_t { Bytes, WordStart, WordEnd };
+        Kind kind = Kind::Bytes;
+        bool star = false;
+        int16_t literal = -1; // genau ein Zeichen (bei ignoreCase klein), sonst -1
+        std::array<uint64_t, 4> set = {};
+
+        void Add(unsigned char c) { set[c >> 6] |= 1ull << (c & 63); }
+
+        bool Accepts(unsigned char c) const { return (set[c >> 6] >> (c & 63)) & 1; }
+    };
+
+    const char* FindLiteral(const char* begin, const char* end) const;
+    bool Match(size_t atom, const char* p, const char* lineBegin, const char* lineEnd) const;
+
+    bool m_regex = false;
+    bool m_ignoreCase = false;
+    bool m_anchorStart = false;
+    bool m_anchorEnd = false;
+    std::vector<Atom> m_atoms;
+    std::string m_literal; // Literal bzw. Pflichtliteral des Ausdrucks; bei ignoreCase klein
+};
+
+/**
+ * Alternativen (FINDSTR "a b" sucht a oder b) und Optionen einer Suche.
+ */
+struct SearchOptions {
+    bool findstr = false;     // Ausgabeformat und Standard fuer regulaere Ausdruecke
+    bool regex = false;
+    bool ignoreCase = false;  // /I
+    bool count = false;       // /C
+    bool lineNumbers = false; // /N
+    bool invert = false;      // /V: nicht passende Zeilen
+    std::vector<std::wstring> patterns;
+    std::vector<std::wstring> files; // auch mit * und ? im Dateinamen
+};
+
+// piped: Stufe einer Pipeline, ohne Dateien (die Eingabe ist die Ausgabe der Stufe davor)
+bool ParseFindArguments(const std::wstring& arguments, SearchOptions& options, std::wstring& error, bool piped = false);
+bool ParseFindstrArguments(const std::wstring& arguments, SearchOptions& options, std::wstring& error, bool piped = false);
+
+/**
+ * Durchsucht eine Datei zeilenweise, ohne die Zeilen einzeln abzulaufen: gesucht wird nur der
+ * naechste Kandidat, erst um ihn herum werden die Zeilengrenzen bestimmt. Ein Scanner je
+ * Datei; die Muster sind unveraenderlich und werden von allen Threads gemeinsam genutzt.
+ */
+class LineScanner {
+public:
+    using LineFunction = std::function<void(uint64_t lineNumber, const char* begin, const char* end)>;
+
+    LineScanner(const std::vector<TextPattern>& patterns, bool invert, bool lineNumbers);
+
+    // Ruft found fuer jede passende (mit invert: nicht passende) Zeile in [begin, end) auf;
+    // begin muss ein Zeilenanfang sein. Zeilennummern zaehlen ueber mehrere Aufrufe weiter (nur
+    // mit lineNumbers, sonst 0). Liefert die Anzahl der gemeldeten Zeilen.
+    uint64_t Scan(const char* begin, const char* end, const LineFunction& found);
+
+private:
+    bool Matches(const char* begin, const char* end) const;
+    uint64_t NumberOf(const char* lineBegin);
+    void ReportRange(const char* begin, const char* end, const LineFunction& found, uint64_t& reported);
+
+    const std::vector<TextPattern>& m_patterns;
+    std::vector<const char*> m_next; // naechster Kandidat je Muster im aktuellen Puffer
+    bool m_invert;
+    bool m_lineNumbers;
+    bool m_everyLine = false;        // ein Muster ohne Literal: jede Zeile pruefen
+    uint64_t m_lines = 0;            // Zeilen vor m_counted
+    const char* m_counted = nullptr;
+};
+
+// FIND/FINDSTR: Dateien parallel durchsuchen, Ausgabe in der Reihenfolge der Dateien.
+void RunSearch(JobContext& job, const std::wstring& base, const SearchOptions& options);
+
+// FIND/FINDSTR als Filter einer Pipeline: gleiche Muster und Ausgabeformate, Zeilen aus in.
+void FilterLines(JobContext& job, RecordQueue& in, RecordSink& out, const SearchOptions& options);
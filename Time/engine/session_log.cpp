@@ -0,0 +1,452 @@
+#include "session_log.h"
+#include "dirwalk.h"
+#include "mapped_file.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint8_t RECORD_LINE = 1;     // line = Nummer der Zeile
+constexpr uint8_t RECORD_REPLACE = 2;  // line = Nummer der ersetzten Zeile
+constexpr uint8_t RECORD_COMMAND = 3;  // line = Nummer der naechsten Zeile
+constexpr uint8_t RECORD_CLEAR = 4;    // line = Nummer der naechsten Zeile
+
+constexpr char SEGMENT_MAGIC[8] = { 'T', 'L', 'O', 'G', 1, 0, 0, 0 }; // Version 1
+
+// Kopf jedes Eintrags im Protokoll, danach bytes Byte UTF-8-Text; der Index enthaelt je Eintrag
+// dessen Offset als uint32_t
+struct RecordHeader {
+    uint32_t bytes;
+    uint8_t type;
+    uint8_t reserved[3];
+    uint64_t line;
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader muss 16 Byte gross sein");
+
+fs::path ToPath(const std::wstring& path) {
+#ifdef _WIN32
+    return fs::path(path);
+#else
+    return fs::path(WideToUtf8(path));
+#endif
+}
+
+/**
+ * Eingeblendetes Segment. Ein beim Absturz nur teilweise geschriebener Eintrag am Ende zaehlt
+ * nicht mit.
+ */
+class MappedSegment {
+public:
+    bool Open(const std::wstring& log, const std::wstring& index) {
+        std::wstring error;
+        if (!m_log.Open(log, error) || !m_index.Open(index, error)) return false;
+        if (m_log.Size() < sizeof(SEGMENT_MAGIC) || memcmp(m_log.Data(), SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) return false;
+        m_records = static_cast<uint32_t>(m_index.Size() / sizeof(uint32_t));
+        while (m_records > 0 && !Valid(m_records - 1)) --m_records;
+        return true;
+    }
+
+    uint32_t Records() const { return m_records; }
+
+    RecordHeader Header(uint32_t record) const {
+        RecordHeader header;
+        memcpy(&header, m_log.Data() + Offset(record), sizeof(header));
+        return header;
+    }
+
+    std::string_view Text(uint32_t record, const RecordHeader& header) const {
+        return std::string_view(m_log.Data() + Offset(record) + sizeof(RecordHeader), header.bytes);
+    }
+
+    // Replay: erster gelesener Eintrag bzw. erster, der zum wiederhergestellten Verlauf gehoert
+    uint32_t first = 0;
+    uint32_t firstLine = 0;
+
+private:
+    uint32_t Offset(uint32_t record) const {
+        uint32_t offset;
+        memcpy(&offset, m_index.Data() + static_cast<size_t>(record) * sizeof(uint32_t), sizeof(offset));
+        return offset;
+    }
+
+    bool Valid(uint32_t record) const {
+        uint64_t offset = Offset(record);
+        if (offset < sizeof(SEGMENT_MAGIC) || offset + sizeof(RecordHeader) > m_log.Size()) return false;
+        return offset + sizeof(RecordHeader) + Header(record).bytes <= m_log.Size();
+    }
+
+    MappedFile m_log;
+    MappedFile m_index;
+    uint32_t m_records = 0;
+};
+
+} // namespace
+
+SessionLog::SessionLog()
+    : SessionLog(Options()) {
+}
+
+SessionLog::SessionLog(const Options& options)
+    : m_options(options) {
+    // Offsets im Index sind 32 Bit breit
+    m_options.segmentBytes = std::clamp<uint64_t>(m_options.segmentBytes, 64 * 1024, 1ull << 30);
+    m_options.maxSegments = std::max<uint32_t>(m_options.maxSegments, 2);
+}
+
+SessionLog::~SessionLog() {
+    Close();
+}
+
+std::wstring SessionLog::SegmentPath(uint32_t number, const wchar_t* extension) const {
+    wchar_t name[32];
+    swprintf(name, 32, L"%08u%ls", number, extension);
+    return JoinPath(m_directory, name);
+}
+
+bool SessionLog::Open(const std::wstring& directory, std::wstring& error) {
+    Close();
+    std::error_code ec;
+    fs::create_directories(ToPath(directory), ec);
+    std::vector<DirectoryEntry> entries;
+    if (!ReadDirectory(directory, EntryDetail::Files, entries, error)) return false;
+    m_directory = directory;
+
+    // Segmente: acht Ziffern plus .log bzw. .idx
+    std::map<uint32_t, uint64_t> found;
+    for (const DirectoryEntry& entry : entries) {
+        const std::wstring& name = entry.name;
+        if (entry.directory || name.size() != 12 || (name.compare(8, 4, L".log") != 0 && name.compare(8, 4, L".idx") != 0)) continue;
+        if (!std::all_of(name.begin(), name.begin() + 8, [](wchar_t c) { return c >= L'0' && c <= L'9'; })) continue;
+        found[static_cast<uint32_t>(wcstoul(name.c_str(), nullptr, 10))] += entry.size;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        m_segments.clear();
+        for (const auto& [number, bytes] : found) m_segments.push_back({ number, bytes });
+    }
+
+    // Nummerierung fortsetzen: letzter Eintrag, der die naechste Zeilennummer kennt
+    m_nextLine = 0;
+    for (auto it = m_segments.rbegin(); it != m_segments.rend(); ++it) {
+        MappedSegment segment;
+        if (!segment.Open(SegmentPath(it->number, L".log"), SegmentPath(it->number, L".idx"))) continue;
+        uint32_t record = segment.Records();
+        for (; record > 0; --record) {
+            RecordHeader header = segment.Header(record - 1);
+            if (header.type == RECORD_REPLACE) continue;
+            m_nextLine = header.type == RECORD_LINE ? header.line + 1 : header.line;
+            break;
+        }
+        if (record > 0) break;
+    }
+    m_lineBase = m_nextLine;
+
+    m_failed = false;
+    m_stop = false;
+    m_open = true;
+    m_writer = std::thread([this] { WriterLoop(); });
+    return true;
+}
+
+void SessionLog::Close() {
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+    m_log.close();
+    m_index.close();
+    m_segmentOpen = false;
+    m_open = false;
+}
+
+size_t SessionLog::Segments() const {
+    std::lock_guard<std::mutex> lock(m_segmentsMutex);
+    return m_segments.size();
+}
+
+void SessionLog::Replay(size_t maxLines, size_t maxCommands, RestoredSession& restored) const {
+    restored.text.clear();
+    restored.lines.clear();
+    restored.commands.clear();
+    if (!m_open) return;
+    std::vector<Segment> segments;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        segments.assign(m_segments.begin(), m_segments.end());
+    }
+
+    // Rueckwaerts ueber die Indizes: Zeilen bis maxLines oder zum letzten CLS, Befehle auch
+    // darueber hinaus (wie cmd.exe behaelt CLS die Befehlsliste)
+    std::vector<std::unique_ptr<MappedSegment>> mapped; // neuestes zuerst
+    size_t lines = 0;
+    size_t commands = 0;
+    uint64_t textBytes = 0; // UTF-8 der uebernommenen Zeilen: obere Schranke ihrer Zeichenzahl
+    bool linesComplete = maxLines == 0;
+    for (auto it = segments.rbegin(); it != segments.rend() && !(linesComplete && commands >= maxCommands); ++it) {
+        auto segment = std::make_unique<MappedSegment>();
+        if (!segment->Open(SegmentPath(it->number, L".log"), SegmentPath(it->number, L".idx"))) continue;
+        uint32_t record = segment->Records();
+        segment->firstLine = linesComplete ? record : 0;
+        while (record > 0 && !(linesComplete && commands >= maxCommands)) {
+            RecordHeader header = segment->Header(--record);
+            if (header.type == RECORD_COMMAND) {
+                ++commands;
+            }
+            else if (!linesComplete && header.type == RECORD_CLEAR) {
+                linesComplete = true;
+                segment->firstLine = record + 1;
+            }
+            else if (!linesComplete && (header.type == RECORD_LINE || header.type == RECORD_REPLACE)) {
+                textBytes += header.bytes;
+                if (header.type == RECORD_LINE && ++lines == maxLines) {
+                    linesComplete = true;
+                    segment->firstLine = record;
+                }
+            }
+        }
+        segment->first = record;
+        mapped.push_back(std::move(segment));
+    }
+
+    // Vorwaerts umwandeln; ersetzte Zeilen ueber ihre Nummer finden (aufsteigend)
+    std::vector<uint64_t> numbers;
+    numbers.reserve(lines);
+    restored.lines.reserve(lines);
+    restored.text.reserve(static_cast<size_t>(textBytes));
+    for (auto it = mapped.rbegin(); it != mapped.rend(); ++it) {
+        const MappedSegment& segment = **it;
+        for (uint32_t record = segment.first; record < segment.Records(); ++record) {
+            RecordHeader header = segment.Header(record);
+            std::string_view text = segment.Text(record, header);
+            if (header.type == RECORD_COMMAND) {
+                restored.commands.push_back(Utf8ToWide(text));
+            }
+            else if (record < segment.firstLine) {
+                continue;
+            }
+            else if (header.type == RECORD_LINE) {
+                numbers.push_back(header.line);
+                size_t offset = restored.text.size();
+                AppendUtf8(text, restored.text);
+                restored.lines.push_back({ offset, restored.text.size() - offset });
+            }
+            else if (header.type == RECORD_REPLACE) {
+                // Neuer Text ans Ende, der alte bleibt ungenutzt stehen
+                auto found = std::lower_bound(numbers.begin(), numbers.end(), header.line);
+                if (found == numbers.end() || *found != header.line) continue;
+                size_t offset = restored.text.size();
+                AppendUtf8(text, restored.text);
+                restored.lines[found - numbers.begin()] = { offset, restored.text.size() - offset };
+            }
+        }
+    }
+    if (restored.commands.size() > maxCommands) {
+        restored.commands.erase(restored.commands.begin(), restored.commands.end() - static_cast<ptrdiff_t>(maxCommands));
+    }
+}
+
+void SessionLog::Begin(uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lineBase = m_nextLine - sequence;
+}
+
+void SessionLog::Push(Pending&& pending) {
+    if (m_pending.size() >= MAX_PENDING) {
+        ++m_dropped;
+        return;
+    }
+    m_pending.push_back(std::move(pending));
+    // Nur wecken, wenn der Schreibthread darauf wartet: erster Eintrag bzw. volle Charge
+    if (m_pending.size() == 1 || m_pending.size() == BATCH_RECORDS) m_wake.notify_one();
+}
+
+void SessionLog::AppendLine(uint64_t sequence, std::wstring_view line) {
+    if (!m_open) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t number = m_lineBase + sequence;
+    m_nextLine = std::max(m_nextLine, number + 1);
+    Push({ RECORD_LINE, number, std::wstring(line), nullptr });
+}
+
+void SessionLog::AppendTable(uint64_t firstSequence, std::shared_ptr<const ResultTable> table, const std::wstring& prefix) {
+    if (!m_open || !table || table->LineCount() == 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t number = m_lineBase + firstSequence;
+    m_nextLine = std::max(m_nextLine, number + table->LineCount());
+    Push({ RECORD_LINE, number, prefix, std::move(table) });
+}
+
+void SessionLog::ReplaceLine(uint64_t sequence, std::wstring_view line) {
+    if (!m_open) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t number = m_lineBase + sequence;
+    // Statuszeilen aendern sich oft mehrmals, bevor geschrieben wird: dann nur den Text ersetzen
+    size_t scanned = 0;
+    for (auto it = m_pending.rbegin(); it != m_pending.rend() && scanned < 64; ++it, ++scanned) {
+        if (!it->table && it->line == number && (it->type == RECORD_LINE || it->type == RECORD_REPLACE)) {
+            it->text.assign(line);
+            return;
+        }
+    }
+    Push({ RECORD_REPLACE, number, std::wstring(line), nullptr });
+}
+
+void SessionLog::AppendCommand(std::wstring_view command) {
+    if (!m_open) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Push({ RECORD_COMMAND, m_nextLine, std::wstring(command), nullptr });
+}
+
+void SessionLog::Clear() {
+    if (!m_open) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Push({ RECORD_CLEAR, m_nextLine, std::wstring(), nullptr });
+}
+
+void SessionLog::Flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_writer.joinable()) return;
+    m_flushRequested = true;
+    m_wake.notify_one();
+    m_written.wait(lock, [this] { return m_pending.empty() && !m_writing; });
+}
+
+/**
+ * Wartet auf den ersten Eintrag, sammelt dann bis zu FLUSH_INTERVAL weitere und schreibt alle in
+ * einem Zug. Ohne Eintraege schlaeft der Thread, statt periodisch aufzuwachen.
+ */
+void SessionLog::WriterLoop() {
+    std::vector<Pending> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stop || m_flushRequested || !m_pending.empty(); });
+        if (!m_pending.empty()) {
+            m_wake.wait_for(lock, FLUSH_INTERVAL, [this] { return m_stop || m_flushRequested || m_pending.size() >= BATCH_RECORDS; });
+        }
+        if (m_pending.empty()) {
+            m_flushRequested = false;
+            m_written.notify_all();
+            if (m_stop) break;
+            continue;
+        }
+        batch.swap(m_pending);
+        m_writing = true;
+        lock.unlock();
+        WriteBatch(batch);
+        batch.clear();
+        lock.lock();
+        m_writing = false;
+    }
+}
+
+void SessionLog::WriteBatch(std::vector<Pending>& batch) {
+    for (const Pending& pending : batch) {
+        if (!pending.table) {
+            AddRecord(pending.type, pending.line, pending.text);
+            continue;
+        }
+        size_t lines = pending.table->LineCount();
+        for (size_t i = 0; i < lines; ++i) {
+            m_scratch = pending.text;
+            pending.table->FormatLine(i, m_scratch);
+            AddRecord(RECORD_LINE, pending.line + i, m_scratch);
+        }
+    }
+    WriteBuffers();
+    ++m_batches;
+}
+
+void SessionLog::AddRecord(uint8_t type, uint64_t line, std::wstring_view text) {
+    if (m_failed) {
+        ++m_dropped;
+        return;
+    }
+    std::string bytes = WideToUtf8(text);
+    uint64_t size = sizeof(RecordHeader) + bytes.size();
+    if (!m_segmentOpen || (m_logBytes > sizeof(SEGMENT_MAGIC) && m_logBytes + size > m_options.segmentBytes)) {
+        WriteBuffers();
+        if (!StartSegment()) {
+            m_failed = true;
+            ++m_dropped;
+            return;
+        }
+    }
+
+    RecordHeader header = {};
+    header.bytes = static_cast<uint32_t>(bytes.size());
+    header.type = type;
+    header.line = line;
+    uint32_t offset = static_cast<uint32_t>(m_logBytes);
+    m_logBuffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_logBuffer += bytes;
+    m_indexBuffer.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    m_logBytes += size;
+    ++m_writtenRecords;
+}
+
+// Protokoll vor dem Index: ein Index-Eintrag zeigt nie auf ungeschriebene Daten
+void SessionLog::WriteBuffers() {
+    if (!m_segmentOpen || m_logBuffer.empty()) return;
+    m_log.write(m_logBuffer.data(), static_cast<std::streamsize>(m_logBuffer.size()));
+    m_log.flush();
+    m_index.write(m_indexBuffer.data(), static_cast<std::streamsize>(m_indexBuffer.size()));
+    m_index.flush();
+    if (!m_log || !m_index) m_failed = true;
+    uint64_t bytes = m_logBuffer.size() + m_indexBuffer.size();
+    m_writtenBytes += bytes;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        m_segments.back().bytes += bytes;
+    }
+    m_logBuffer.clear();
+    m_indexBuffer.clear();
+}
+
+bool SessionLog::StartSegment() {
+    m_log.close();
+    m_index.close();
+    m_segmentOpen = false;
+    uint32_t number;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        number = m_segments.empty() ? 1 : m_segments.back().number + 1;
+    }
+    m_log.open(ToPath(SegmentPath(number, L".log")), std::ios::binary | std::ios::trunc);
+    m_index.open(ToPath(SegmentPath(number, L".idx")), std::ios::binary | std::ios::trunc);
+    if (!m_log || !m_index) return false;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        m_segments.push_back({ number, 0 });
+    }
+    m_logBuffer.assign(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    m_indexBuffer.clear();
+    m_logBytes = sizeof(SEGMENT_MAGIC);
+    m_segmentOpen = true;
+    PruneSegments();
+    return true;
+}
+
+// Aelteste Segmente loeschen; das aktuelle bleibt immer erhalten
+void SessionLog::PruneSegments() {
+    std::lock_guard<std::mutex> lock(m_segmentsMutex);
+    uint64_t total = 0;
+    for (const Segment& segment : m_segments) total += segment.bytes;
+    while (m_segments.size() > 1 && (m_segments.size() > m_options.maxSegments || total > m_options.maxBytes)) {
+        std::error_code ec;
+        fs::remove(ToPath(SegmentPath(m_segments.front().number, L".log")), ec);
+        fs::remove(ToPath(SegmentPath(m_segments.front().number, L".idx")), ec);
+        total -= m_segments.front().bytes;
+        m_segments.pop_front();
+    }
+}
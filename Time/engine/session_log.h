@@ -0,0 +1,159 @@
+#pragma once
+
+#include "table.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * Verlauf und Befehle frueherer Sitzungen, wie SessionLog::Replay sie liefert.
+ */
+struct RestoredSession {
+    // Verlaufszeilen, aelteste zuerst; ihr Text liegt hintereinander in text, damit das
+    // Wiederherstellen nicht je Zeile Speicher anfordert
+    struct Extent {
+        size_t offset;
+        size_t length;
+    };
+    std::wstring text;
+    std::vector<Extent> lines;
+    std::vector<std::wstring> commands; // zuletzt bestaetigte Befehle, aelteste zuerst
+
+    std::wstring_view Line(size_t i) const { return std::wstring_view(text).substr(lines[i].offset, lines[i].length); }
+};
+
+/**
+ * Sitzungsprotokoll: Verlaufszeilen und bestaetigte Befehle werden fortlaufend in Segmente
+ * (00000001.log, ...) eines Verzeichnisses angehaengt, damit der Verlauf einen Neustart
+ * uebersteht.
+ *
+ * Der UI-Thread reiht Eintraege nur ein (eine Kopie des Textes, Tabellen als Verweis); ein
+ * eigener Thread wandelt sie nach UTF-8 und schreibt sie gesammelt, hoechstens alle
+ * FLUSH_INTERVAL ein Schreibaufruf je Datei. Ersetzte Statuszeilen, die noch nicht geschrieben
+ * sind, werden in der Warteschlange ueberschrieben statt erneut eingereiht.
+ *
+ * Zu jedem Segment gehoert ein Index (00000001.idx) mit dem Offset jedes Eintrags. Replay
+ * blendet beide ein und laeuft vom Ende des neuesten Segments rueckwaerts, bis genug Zeilen
+ * gefunden sind; gelesen und umgewandelt werden nur diese. Jede Sitzung beginnt ein neues
+ * Segment, ein Segment wird nach segmentBytes gewechselt; die aeltesten werden geloescht,
+ * sobald maxBytes oder maxSegments ueberschritten sind.
+ */
+class SessionLog {
+public:
+    struct Options {
+        uint64_t segmentBytes = 4ull << 20;
+        uint64_t maxBytes = 64ull << 20; // alle Segmente zusammen
+        uint32_t maxSegments = 64;
+    };
+
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 250 };
+    static constexpr size_t BATCH_RECORDS = 4096;   // so viele Eintraege wecken den Schreibthread sofort
+    static constexpr size_t MAX_PENDING = 262144;   // darueber hinaus wird verworfen (Datentraeger haengt)
+
+    SessionLog();
+    explicit SessionLog(const Options& options);
+    ~SessionLog();
+
+    SessionLog(const SessionLog&) = delete;
+    SessionLog& operator=(const SessionLog&) = delete;
+
+    // Legt das Verzeichnis bei Bedarf an und startet den Schreibthread. Das erste Segment dieser
+    // Sitzung entsteht erst mit dem ersten Eintrag.
+    bool Open(const std::wstring& directory, std::wstring& error);
+
+    // Schreibt alle eingereihten Eintraege und beendet den Schreibthread.
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+
+    // Die letzten maxLines Zeilen (ein CLS beendet die Suche, was davor lag, war nicht mehr
+    // sichtbar) und die letzten maxCommands Befehle. Nach Open, vor dem ersten Eintrag dieser
+    // Sitzung.
+    void Replay(size_t maxLines, size_t maxCommands, RestoredSession& restored) const;
+
+    // Verlaufszeilen werden mit der fortlaufenden Nummer des Scrollback angegeben
+    // (Scrollback::TotalLines); Begin legt fest, welche Nummer die naechste Zeile hat.
+    void Begin(uint64_t sequence);
+    void AppendLine(uint64_t sequence, std::wstring_view line);
+    // Die Tabelle wird erst vom Schreibthread formatiert; sie darf sich nicht mehr aendern.
+    void AppendTable(uint64_t firstSequence, std::shared_ptr<const ResultTable> table, const std::wstring& prefix);
+    void ReplaceLine(uint64_t sequence, std::wstring_view line);
+    void AppendCommand(std::wstring_view command);
+    void Clear();
+
+    // Wartet, bis alle eingereihten Eintraege geschrieben sind.
+    void Flush();
+
+    // Zaehler
+    uint64_t WrittenRecords() const { return m_writtenRecords; }
+    uint64_t WrittenBytes() const { return m_writtenBytes; }
+    uint64_t Batches() const { return m_batches; }
+    uint64_t DroppedRecords() const { return m_dropped; }
+    size_t Segments() const;
+
+private:
+    // Eintrag in der Warteschlange; eine Tabelle ergibt beim Schreiben table->LineCount() Zeilen
+    struct Pending {
+        uint8_t type;      // RECORD_* in session_log.cpp
+        uint64_t line;
+        std::wstring text; // bei Tabellen das Praefix
+        std::shared_ptr<const ResultTable> table;
+    };
+
+    struct Segment {
+        uint32_t number;
+        uint64_t bytes; // Protokoll und Index
+    };
+
+    void Push(Pending&& pending); // m_mutex gehalten
+    void WriterLoop();
+    void WriteBatch(std::vector<Pending>& batch);
+    void AddRecord(uint8_t type, uint64_t line, std::wstring_view text);
+    void WriteBuffers();
+    bool StartSegment();
+    void PruneSegments();
+    std::wstring SegmentPath(uint32_t number, const wchar_t* extension) const;
+
+    Options m_options;
+    std::wstring m_directory;
+    bool m_open = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;     // Schreibthread
+    std::condition_variable m_written;  // Flush
+    std::vector<Pending> m_pending;
+    bool m_stop = false;
+    bool m_flushRequested = false;
+    bool m_writing = false;
+    std::thread m_writer;
+
+    uint64_t m_lineBase = 0; // Nummer im Protokoll = m_lineBase + Scrollback-Nummer
+    uint64_t m_nextLine = 0; // Nummer der naechsten Zeile im Protokoll (ueber Sitzungen fortlaufend)
+
+    // Nur Schreibthread (bzw. Open, bevor er laeuft)
+    mutable std::mutex m_segmentsMutex;
+    std::deque<Segment> m_segments;
+    bool m_segmentOpen = false;
+    std::ofstream m_log;
+    std::ofstream m_index;
+    uint64_t m_logBytes = 0;   // Groesse des aktuellen Segments inkl. Puffer
+    std::string m_logBuffer;
+    std::string m_indexBuffer;
+    std::wstring m_scratch;
+    bool m_failed = false;
+
+    std::atomic<uint64_t> m_writtenRecords{ 0 };
+    std::atomic<uint64_t> m_writtenBytes{ 0 };
+    std::atomic<uint64_t> m_batches{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+// SSE2 ist auf x64 immer vorhanden; fuer 32-Bit-MSVC nur mit /arch:SSE2 (Standard seit VS2012).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TIME_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define TIME_HAVE_SSE2 0
+#endif
@@ -0,0 +1,34 @@
+#include "startup.h"
+
+#include <cwchar>
+
+StartupTrace::StartupTrace(Clock::time_point origin)
+    : m_origin(origin) {
+    m_steps.reserve(8);
+}
+
+void StartupTrace::Mark(const wchar_t* name) {
+    if (Has(name)) return;
+    int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_origin).count();
+    m_steps.push_back({ name, micros });
+}
+
+int64_t StartupTrace::Micros(const wchar_t* name) const {
+    for (const Step& step : m_steps) {
+        if (step.name == name || wcscmp(step.name, name) == 0) return step.micros;
+    }
+    return -1;
+}
+
+std::wstring StartupTrace::Format() const {
+    if (m_steps.empty()) return L"Keine Startzeiten erfasst.";
+    std::wstring text = L"Programmstart:\n";
+    int64_t previous = 0;
+    wchar_t line[128];
+    for (const Step& step : m_steps) {
+        swprintf(line, 128, L"    %-28ls %9.1f ms   (+%.1f ms)\n", step.name, step.micros / 1000.0, (step.micros - previous) / 1000.0);
+        text += line;
+        previous = step.micros;
+    }
+    return text;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Zeitpunkte des Programmstarts (STARTUP). Gemessen wird ab origin; das Fenster setzt dafuer den
+ * Beginn des Prozesses ein, damit Laden und Initialisierung der Laufzeitbibliothek mitzaehlen.
+ * Jeder Schritt wird nur beim ersten Mark festgehalten, spaetere Aufrufe kosten einen Vergleich.
+ * Nur UI-Thread.
+ */
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Die drei Kennzahlen; weitere Schritte (z.B. das Wiederherstellen der Sitzung) stehen dazwischen
+    static constexpr const wchar_t* WINDOW = L"Fenster erzeugt";
+    static constexpr const wchar_t* FIRST_PAINT = L"Erstes Bild";
+    static constexpr const wchar_t* INTERACTIVE = L"Eingabebereit";
+
+    explicit StartupTrace(Clock::time_point origin = Clock::now());
+
+    // name muss eine Zeichenkettenkonstante sein (es wird nur der Zeiger gespeichert).
+    void Mark(const wchar_t* name);
+    bool Has(const wchar_t* name) const { return Micros(name) >= 0; }
+
+    // Mikrosekunden seit origin; -1 = (noch) nicht erreicht.
+    int64_t Micros(const wchar_t* name) const;
+
+    // Je Schritt der Zeitpunkt und der Abstand zum vorigen.
+    std::wstring Format() const;
+
+private:
+    struct Step {
+        const wchar_t* name;
+        int64_t micros;
+    };
+
+    Clock::time_point m_origin;
+    std::vector<Step> m_steps;
+};
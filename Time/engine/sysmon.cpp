@@ -0,0 +1,473 @@
+#include "sysmon.h"
+#include "clock.h"
+#include "perf.h"
+#include "top.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cwchar>
+#include <cwctype>
+#include <sstream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#endif
+
+namespace {
+
+constexpr size_t SPARK_WIDTH = 60;    // Zeichen je Sparkline, die letzten 60 Stichproben
+constexpr size_t MAX_CORE_LINES = 16; // weitere Kerne werden nur gezaehlt
+
+// Durchsatz aus zwei Zaehlerstaenden; ein zurueckgesetzter Zaehler ergibt 0
+float Rate(uint64_t current, uint64_t previous, double seconds) {
+    return current >= previous && seconds > 0.0 ? static_cast<float>((current - previous) / seconds) : 0.0f;
+}
+
+float Percent(uint64_t busy, uint64_t total) {
+    return total ? static_cast<float>(std::min(100.0, 100.0 * static_cast<double>(busy) / static_cast<double>(total))) : 0.0f;
+}
+
+float Maximum(const SampleRing& values, size_t width) {
+    float maximum = 0.0f;
+    size_t size = values.Size();
+    for (size_t i = size > width ? size - width : 0; i < size; ++i) maximum = std::max(maximum, values[i]);
+    return maximum;
+}
+
+std::wstring FormatRate(float bytesPerSecond) {
+    return FormatBytes(static_cast<uint64_t>(bytesPerSecond)) + L"/s";
+}
+
+} // namespace
+
+SystemMonitor::SystemMonitor(std::unique_ptr<SystemSampler> sampler, uint32_t intervalMillis)
+    : m_sampler(std::move(sampler)), m_interval(std::clamp(intervalMillis, MIN_INTERVAL, MAX_INTERVAL)) {
+    m_history.intervalMillis = m_interval;
+    m_thread = std::thread([this] { SampleLoop(); });
+}
+
+SystemMonitor::~SystemMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+}
+
+void SystemMonitor::SetInterval(uint32_t intervalMillis) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_interval = std::clamp(intervalMillis, MIN_INTERVAL, MAX_INTERVAL);
+        m_history.intervalMillis = m_interval;
+    }
+    m_changed.notify_all();
+}
+
+void SystemMonitor::Read(SystemHistory& history) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    history = m_history;
+}
+
+bool SystemMonitor::WaitForSample(JobContext& job, uint64_t seen) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_history.samples <= seen) {
+        if (job.Cancelled()) return false;
+        m_changed.wait_for(lock, std::chrono::milliseconds(50));
+    }
+    return !job.Cancelled();
+}
+
+void SystemMonitor::SampleLoop() {
+    using Clock = std::chrono::steady_clock;
+    Perf::SetThreadName(L"Systemmonitor");
+
+    SystemSample samples[2];
+    size_t current = 0;
+    bool havePrevious = false;
+    std::wstring error;
+    const uint64_t cpuStart = m_sampler->ThreadCpuMicros();
+    const auto start = Clock::now();
+    auto previousTime = start;
+    auto tick = start;
+    double sampleMicrosTotal = 0.0;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        lock.unlock();
+        auto begin = Clock::now();
+        bool ok;
+        {
+            PerfSpan span(L"SystemSample");
+            ok = m_sampler->Sample(samples[current], error);
+        }
+        auto end = Clock::now();
+        uint64_t cpuMicros = m_sampler->ThreadCpuMicros();
+        double sampleMicros = std::chrono::duration<double, std::micro>(end - begin).count();
+        sampleMicrosTotal += sampleMicros;
+        double elapsedMicros = std::chrono::duration<double, std::micro>(end - start).count();
+        lock.lock();
+
+        m_history.lastSampleMicros = sampleMicros;
+        m_history.cpuTimeMeasured = cpuMicros != 0;
+        if (elapsedMicros > 0.0) {
+            double used = cpuMicros != 0 ? static_cast<double>(cpuMicros - cpuStart) : sampleMicrosTotal;
+            m_history.overheadPercent = 100.0 * used / elapsedMicros;
+        }
+        if (ok) {
+            double seconds = std::chrono::duration<double>(begin - previousTime).count();
+            Take(samples[current], havePrevious ? &samples[current ^ 1] : nullptr, seconds);
+            previousTime = begin;
+            havePrevious = true;
+            current ^= 1;
+            m_history.error.clear();
+        }
+        else {
+            m_history.error = error;
+        }
+        ++m_history.samples;
+        m_changed.notify_all();
+
+        // Fester Takt; ein neuer Abstand (SetInterval) weckt die Wartezeit und gilt sofort
+        for (;;) {
+            auto due = tick + std::chrono::milliseconds(m_interval);
+            if (m_stop || Clock::now() >= due) {
+                tick = std::max(due, Clock::now() - std::chrono::milliseconds(m_interval));
+                break;
+            }
+            m_changed.wait_until(lock, due);
+        }
+    }
+}
+
+void SystemMonitor::Take(const SystemSample& current, const SystemSample* previous, double seconds) {
+    SystemHistory& h = m_history;
+    h.commit.Push(static_cast<float>(current.commitBytes));
+    h.available.Push(static_cast<float>(current.availableBytes));
+    h.commitLimitBytes = current.commitLimitBytes;
+    h.totalBytes = current.totalBytes;
+    if (!previous) return; // Auslastung und Durchsatz erst ab dem zweiten Stand
+
+    if (h.cores.size() != current.cores.size()) h.cores.resize(current.cores.size());
+    uint64_t busy = 0;
+    uint64_t total = 0;
+    for (size_t i = 0; i < current.cores.size(); ++i) {
+        SystemSample::Core delta;
+        if (i < previous->cores.size() && current.cores[i].total >= previous->cores[i].total
+            && current.cores[i].busy >= previous->cores[i].busy) {
+            delta.busy = current.cores[i].busy - previous->cores[i].busy;
+            delta.total = current.cores[i].total - previous->cores[i].total;
+        }
+        h.cores[i].Push(Percent(delta.busy, delta.total));
+        busy += delta.busy;
+        total += delta.total;
+    }
+    h.cpu.Push(Percent(busy, total));
+    h.diskRead.Push(Rate(current.diskReadBytes, previous->diskReadBytes, seconds));
+    h.diskWrite.Push(Rate(current.diskWriteBytes, previous->diskWriteBytes, seconds));
+    h.netReceived.Push(Rate(current.netReceivedBytes, previous->netReceivedBytes, seconds));
+    h.netSent.Push(Rate(current.netSentBytes, previous->netSentBytes, seconds));
+}
+
+bool ParseSystemInfoArguments(const std::wstring& arguments, SystemInfoOptions& options, std::wstring& error) {
+    std::wstringstream iss(arguments);
+    std::wstring token;
+    while (iss >> token) {
+        std::wstring upper = token;
+        for (wchar_t& c : upper) c = static_cast<wchar_t>(std::towupper(c));
+        if (upper == L"/WATCH") {
+            options.watch = true;
+            continue;
+        }
+        if (upper != L"/I" && upper != L"-I") {
+            error = L"Ungueltige Option '" + token + L"' (erlaubt: /WATCH [/I ms]).";
+            return false;
+        }
+        std::wstring value;
+        if (!(iss >> value)) {
+            error = L"Wert fuer Option '" + token + L"' fehlt.";
+            return false;
+        }
+        wchar_t* end = nullptr;
+        unsigned long millis = wcstoul(value.c_str(), &end, 10);
+        if (value.empty() || *end != L'\0' || millis < SystemMonitor::MIN_INTERVAL || millis > SystemMonitor::MAX_INTERVAL) {
+            error = L"Ungueltiger Wert '" + value + L"' fuer Option '" + token + L"' (erlaubt: "
+                + std::to_wstring(SystemMonitor::MIN_INTERVAL) + L" bis " + std::to_wstring(SystemMonitor::MAX_INTERVAL) + L" ms).";
+            return false;
+        }
+        options.intervalMillis = static_cast<uint32_t>(millis);
+        options.intervalSet = true;
+    }
+    if (options.intervalSet && !options.watch) {
+        error = L"/I gilt nur zusammen mit /WATCH.";
+        return false;
+    }
+    return true;
+}
+
+void AppendSparkline(std::wstring& out, const SampleRing& values, float maximum, size_t width) {
+    size_t size = values.Size();
+    size_t first = size > width ? size - width : 0;
+    out.append(width - (size - first), L' ');
+    for (size_t i = first; i < size; ++i) {
+        int level = maximum > 0.0f ? static_cast<int>(values[i] / maximum * 8.0f) : 0;
+        out += static_cast<wchar_t>(L'\x2581' + std::clamp(level, 0, 7));
+    }
+}
+
+void RunSystemWatch(JobContext& job, const SystemMonitor& monitor) {
+    SystemHistory history;
+    ClockFormatter clock;
+    std::vector<std::wstring> shown; // zuletzt gesendete Statuszeilen
+    std::vector<std::wstring> lines;
+    wchar_t text[160];
+
+    // Bezeichnung, Wert und Sparkline; suffix z.B. die Skala bei Durchsatzwerten
+    auto add = [&](const wchar_t* label, const std::wstring& value, const SampleRing& values, float maximum,
+        const std::wstring& suffix = std::wstring()) {
+        swprintf(text, 160, L"%-13ls%-22ls", label, value.c_str());
+        std::wstring& line = lines.emplace_back(text);
+        AppendSparkline(line, values, maximum, SPARK_WIDTH);
+        line += suffix;
+    };
+    auto percent = [&](float value) {
+        swprintf(text, 160, L"%5.1f %%", value);
+        return std::wstring(text);
+    };
+    auto rate = [&](const wchar_t* label, const SampleRing& values) {
+        float maximum = Maximum(values, SPARK_WIDTH);
+        add(label, FormatRate(values.Last()), values, maximum, L"  max " + FormatRate(maximum));
+    };
+
+    uint64_t seen = 0;
+    while (monitor.WaitForSample(job, seen)) {
+        monitor.Read(history);
+        seen = history.samples;
+
+        lines.clear();
+        swprintf(text, 160, L"SYSTEMINFO %.8ls - Stichprobe alle %u ms, Strg+C beendet", clock.Now().time, history.intervalMillis);
+        lines.emplace_back(text);
+        // Die Last erst ab der zweiten Stichprobe: vorher ist die Laufzeit kaum laenger als die erste
+        if (history.samples < 2) {
+            swprintf(text, 160, L"Sampler: %llu Stichprobe, %.0f us", static_cast<unsigned long long>(history.samples),
+                history.lastSampleMicros);
+        }
+        else {
+            swprintf(text, 160, L"Sampler: %llu Stichproben, zuletzt %.0f us, Last %.3f %% %ls",
+                static_cast<unsigned long long>(history.samples), history.lastSampleMicros, history.overheadPercent,
+                history.cpuTimeMeasured ? L"CPU" : L"Laufzeit");
+        }
+        lines.emplace_back(text);
+        if (!history.error.empty()) lines.push_back(L"FEHLER: " + history.error);
+
+        add(L"CPU", history.cpu.Size() ? percent(history.cpu.Last()) : std::wstring(L"-"), history.cpu, 100.0f);
+        size_t coreLines = history.cores.size() > MAX_CORE_LINES ? MAX_CORE_LINES - 1 : history.cores.size();
+        for (size_t i = 0; i < coreLines; ++i) {
+            wchar_t label[16];
+            swprintf(label, 16, L"  Kern %zu", i);
+            add(label, percent(history.cores[i].Last()), history.cores[i], 100.0f);
+        }
+        if (coreLines < history.cores.size()) {
+            swprintf(text, 160, L"  ... %zu weitere Kerne", history.cores.size() - coreLines);
+            lines.emplace_back(text);
+        }
+        add(L"Zugesichert", FormatBytes(static_cast<uint64_t>(history.commit.Last())) + L" / " + FormatBytes(history.commitLimitBytes),
+            history.commit, static_cast<float>(history.commitLimitBytes));
+        add(L"Verfuegbar", FormatBytes(static_cast<uint64_t>(history.available.Last())) + L" / " + FormatBytes(history.totalBytes),
+            history.available, static_cast<float>(history.totalBytes));
+        rate(L"Lesen", history.diskRead);
+        rate(L"Schreiben", history.diskWrite);
+        rate(L"Empfangen", history.netReceived);
+        rate(L"Gesendet", history.netSent);
+
+        // Nur geaenderte Zeilen senden; weggefallene (weniger Kerne, Fehler behoben) leeren
+        const size_t sent = shown.size();
+        shown.resize(std::max(sent, lines.size()));
+        for (size_t i = 0; i < shown.size(); ++i) {
+            const std::wstring& line = i < lines.size() ? lines[i] : std::wstring();
+            if (i < sent && shown[i] == line) continue;
+            shown[i] = line;
+            job.SetLiveLine(static_cast<uint32_t>(i), line);
+        }
+    }
+}
+
+#ifdef __linux__
+
+namespace {
+
+/**
+ * SystemSampler fuer Linux. Die vier /proc-Dateien werden einmal geoeffnet und bei jeder
+ * Stichprobe mit pread ab Offset 0 in einen wiederverwendeten Puffer gelesen; die Zahlen werden
+ * direkt aus dem Puffer zerlegt. Als Datentraeger zaehlen die Geraete aus /sys/block ohne
+ * loop, ram, zram und dm- (deren Zugriffe stecken schon im darunterliegenden Geraet).
+ */
+class ProcSystemSampler : public SystemSampler {
+public:
+    ProcSystemSampler() {
+        m_stat = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+        m_meminfo = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+        m_diskstats = open("/proc/diskstats", O_RDONLY | O_CLOEXEC);
+        m_netdev = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+        if (DIR* dir = opendir("/sys/block")) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name[0] == '.' || name.starts_with("loop") || name.starts_with("ram") || name.starts_with("zram")
+                    || name.starts_with("dm-")) {
+                    continue;
+                }
+                m_disks.push_back(std::move(name));
+            }
+            closedir(dir);
+        }
+    }
+
+    ~ProcSystemSampler() override {
+        for (int fd : { m_stat, m_meminfo, m_diskstats, m_netdev }) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    bool Sample(SystemSample& sample, std::wstring& error) override {
+        if (!ReadFile(m_stat) || !ReadStat(sample)) {
+            error = L"/proc/stat konnte nicht gelesen werden.";
+            return false;
+        }
+        if (!ReadFile(m_meminfo)) {
+            error = L"/proc/meminfo konnte nicht gelesen werden.";
+            return false;
+        }
+        ReadMeminfo(sample);
+        // Datentraeger und Netzwerk sind optional (z.B. in Containern ohne /sys/block)
+        sample.diskReadBytes = sample.diskWriteBytes = 0;
+        if (ReadFile(m_diskstats)) ReadDiskstats(sample);
+        sample.netReceivedBytes = sample.netSentBytes = 0;
+        if (ReadFile(m_netdev)) ReadNetdev(sample);
+        return true;
+    }
+
+    uint64_t ThreadCpuMicros() override {
+        timespec now;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) return 0;
+        return static_cast<uint64_t>(now.tv_sec) * 1000000 + static_cast<uint64_t>(now.tv_nsec) / 1000;
+    }
+
+private:
+    bool ReadFile(int fd) {
+        if (fd < 0) return false;
+        size_t length = 0;
+        for (;;) {
+            ssize_t count = pread(fd, m_buffer.data() + length, m_buffer.size() - length - 1, static_cast<off_t>(length));
+            if (count < 0) return false;
+            if (count == 0) break;
+            length += static_cast<size_t>(count);
+            if (length + 1 == m_buffer.size()) m_buffer.resize(m_buffer.size() * 2);
+        }
+        m_buffer[length] = '\0';
+        return length > 0;
+    }
+
+    static uint64_t Number(const char*& p) {
+        char* end;
+        uint64_t value = strtoull(p, &end, 10);
+        p = end;
+        return value;
+    }
+
+    static const char* NextLine(const char* p) {
+        p = strchr(p, '\n');
+        return p ? p + 1 : nullptr;
+    }
+
+    // "cpuN user nice system idle iowait irq softirq steal ..."; guest steckt schon in user
+    bool ReadStat(SystemSample& sample) {
+        size_t count = 0;
+        for (const char* p = m_buffer.data(); p && p[0] == 'c' && p[1] == 'p' && p[2] == 'u'; p = NextLine(p)) {
+            if (p[3] == ' ') continue; // Summe ueber alle Kerne
+            p += 3;
+            Number(p); // Kernnummer
+            uint64_t fields[8] = {};
+            for (uint64_t& field : fields) field = Number(p);
+            uint64_t idle = fields[3] + fields[4];
+            uint64_t total = 0;
+            for (uint64_t field : fields) total += field;
+            if (count == sample.cores.size()) sample.cores.emplace_back();
+            sample.cores[count].busy = total - idle;
+            sample.cores[count].total = total;
+            ++count;
+        }
+        sample.cores.resize(count);
+        return count > 0;
+    }
+
+    void ReadMeminfo(SystemSample& sample) {
+        for (const char* p = m_buffer.data(); p; p = NextLine(p)) {
+            const char* colon = strchr(p, ':');
+            if (!colon) break;
+            size_t length = static_cast<size_t>(colon - p);
+            uint64_t* target = nullptr;
+            if (length == 8 && memcmp(p, "MemTotal", 8) == 0) target = &sample.totalBytes;
+            else if (length == 12 && memcmp(p, "MemAvailable", 12) == 0) target = &sample.availableBytes;
+            else if (length == 12 && memcmp(p, "Committed_AS", 12) == 0) target = &sample.commitBytes;
+            else if (length == 11 && memcmp(p, "CommitLimit", 11) == 0) target = &sample.commitLimitBytes;
+            if (!target) continue;
+            const char* value = colon + 1;
+            *target = Number(value) * 1024; // kB
+        }
+    }
+
+    // "major minor name reads merged sektoren ms writes merged sektoren ..."; Sektoren zu 512 Bytes
+    void ReadDiskstats(SystemSample& sample) {
+        for (const char* p = m_buffer.data(); p && *p; p = NextLine(p)) {
+            Number(p);
+            Number(p);
+            while (*p == ' ') ++p;
+            const char* name = p;
+            while (*p && *p != ' ') ++p;
+            std::string_view device(name, static_cast<size_t>(p - name));
+            if (std::find(m_disks.begin(), m_disks.end(), device) == m_disks.end()) continue;
+            uint64_t fields[7];
+            for (uint64_t& field : fields) field = Number(p);
+            sample.diskReadBytes += fields[2] * 512;
+            sample.diskWriteBytes += fields[6] * 512;
+        }
+    }
+
+    // Zwei Kopfzeilen, dann "name: rx-bytes rx-pakete ... (8 Felder) tx-bytes ..."
+    void ReadNetdev(SystemSample& sample) {
+        const char* p = NextLine(m_buffer.data());
+        for (p = p ? NextLine(p) : nullptr; p && *p; p = NextLine(p)) {
+            while (*p == ' ') ++p;
+            const char* colon = strchr(p, ':');
+            if (!colon) break;
+            bool loopback = colon - p == 2 && memcmp(p, "lo", 2) == 0;
+            p = colon + 1;
+            uint64_t fields[9];
+            for (uint64_t& field : fields) field = Number(p);
+            if (loopback) continue;
+            sample.netReceivedBytes += fields[0];
+            sample.netSentBytes += fields[8];
+        }
+    }
+
+    int m_stat = -1;
+    int m_meminfo = -1;
+    int m_diskstats = -1;
+    int m_netdev = -1;
+    std::vector<std::string> m_disks;
+    std::vector<char> m_buffer = std::vector<char>(16 * 1024);
+};
+
+} // namespace
+
+std::unique_ptr<SystemSampler> CreateProcSystemSampler() {
+    return std::make_unique<ProcSystemSampler>();
+}
+
+#endif
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "executor.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Zaehlerstaende des Systems zu einem Zeitpunkt. CPU-, Datentraeger- und Netzwerkzaehler laufen
+ * seit dem Systemstart hoch; Auslastung und Durchsatz ergeben sich erst aus zwei Staenden.
+ */
+struct SystemSample {
+    struct Core {
+        uint64_t busy = 0;  // beliebige Einheit (Win32: 100 ns, Linux: Ticks)
+        uint64_t total = 0; // dieselbe Einheit, inklusive Leerlauf
+    };
+
+    std::vector<Core> cores;       // je logischem Prozessor; wird ueberschrieben, nicht neu angelegt
+    uint64_t commitBytes = 0;      // zugesicherter Speicher
+    uint64_t commitLimitBytes = 0;
+    uint64_t availableBytes = 0;   // sofort verfuegbarer physischer Speicher
+    uint64_t totalBytes = 0;
+    uint64_t diskReadBytes = 0;
+    uint64_t diskWriteBytes = 0;
+    uint64_t netReceivedBytes = 0; // ohne Loopback
+    uint64_t netSentBytes = 0;
+};
+
+/**
+ * Liest die Zaehler des Systems. Das Frontend stellt die Implementierung bereit (Win32:
+ * NtQuerySystemInformation, GlobalMemoryStatusEx, IOCTL_DISK_PERFORMANCE und GetIfTable2;
+ * Headless: /proc). Sample und ThreadCpuMicros ruft nur der Thread von SystemMonitor auf.
+ */
+class SystemSampler {
+public:
+    virtual ~SystemSampler() = default;
+
+    // Ersetzt den Inhalt von sample; false und Meldung, wenn nichts gelesen werden konnte.
+    virtual bool Sample(SystemSample& sample, std::wstring& error) = 0;
+
+    // Verbrauchte CPU-Zeit des aufrufenden Threads in us, fuer die eigene Last des Samplers.
+    // 0 = nicht messbar; dann zaehlt die Dauer der Stichproben.
+    virtual uint64_t ThreadCpuMicros() { return 0; }
+};
+
+/**
+ * Verlauf fester Groesse: die letzten CAPACITY Werte, der aelteste wird ueberschrieben.
+ */
+class SampleRing {
+public:
+    static constexpr size_t CAPACITY = 120;
+
+    void Push(float value) {
+        m_values[m_count % CAPACITY] = value;
+        ++m_count;
+    }
+
+    size_t Size() const { return m_count < CAPACITY ? static_cast<size_t>(m_count) : CAPACITY; }
+
+    // i = 0 ist der aelteste noch gespeicherte Wert.
+    float operator[](size_t i) const { return m_values[(m_count - Size() + i) % CAPACITY]; }
+    float Last() const { return m_count ? m_values[(m_count - 1) % CAPACITY] : 0.0f; }
+
+private:
+    std::array<float, CAPACITY> m_values = {};
+    uint64_t m_count = 0;
+};
+
+/**
+ * Verlauf aller Messgroessen; Prozentwerte 0..100, Speicher in Bytes, Durchsatz in Bytes/s.
+ */
+struct SystemHistory {
+    std::vector<SampleRing> cores;
+    SampleRing cpu;
+    SampleRing commit;
+    SampleRing available;
+    SampleRing diskRead;
+    SampleRing diskWrite;
+    SampleRing netReceived;
+    SampleRing netSent;
+    uint64_t commitLimitBytes = 0;
+    uint64_t totalBytes = 0;
+
+    uint64_t samples = 0;          // Stichproben seit dem Start
+    uint32_t intervalMillis = 0;
+    double lastSampleMicros = 0.0; // Dauer der letzten Stichprobe
+    double overheadPercent = 0.0;  // eigene CPU-Zeit des Samplers im Verhaeltnis zur Laufzeit
+    bool cpuTimeMeasured = false;  // false: overheadPercent beruht auf der Dauer der Stichproben
+    std::wstring error;            // letzter Fehler, leer nach einer erfolgreichen Stichprobe
+};
+
+/**
+ * Hintergrund-Sampler fuer SYSTEMINFO /WATCH: ein Thread liest im eingestellten Abstand die
+ * Zaehler, bildet die Differenz zum vorigen Stand und haengt die Werte an Ringe fester Groesse.
+ * Er laeuft nach dem ersten /WATCH weiter, damit ein erneuter Aufruf den Verlauf sofort zeigt.
+ * Zwei Zaehlerstaende werden abwechselnd benutzt, so dass eine Stichprobe keinen Speicher
+ * anfordert; die eigene CPU-Zeit wird gemessen und mit angezeigt.
+ */
+class SystemMonitor {
+public:
+    static constexpr uint32_t DEFAULT_INTERVAL = 1000; // ms
+    static constexpr uint32_t MIN_INTERVAL = 100;
+    static constexpr uint32_t MAX_INTERVAL = 60000;
+
+    SystemMonitor(std::unique_ptr<SystemSampler> sampler, uint32_t intervalMillis);
+    ~SystemMonitor();
+
+    SystemMonitor(const SystemMonitor&) = delete;
+    SystemMonitor& operator=(const SystemMonitor&) = delete;
+
+    // Neuer Abstand; gilt ab der naechsten Stichprobe.
+    void SetInterval(uint32_t intervalMillis);
+
+    // Kopiert den Verlauf nach history (ohne neue Speicheranforderung, wenn history schon
+    // einmal befuellt wurde).
+    void Read(SystemHistory& history) const;
+
+    // Wartet, bis mehr als seen Stichproben vorliegen; false bei Abbruch des Jobs.
+    bool WaitForSample(JobContext& job, uint64_t seen) const;
+
+private:
+    void SampleLoop();
+    void Take(const SystemSample& current, const SystemSample* previous, double seconds);
+
+    std::unique_ptr<SystemSampler> m_sampler;
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_changed;
+    SystemHistory m_history;
+    uint32_t m_interval;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+/**
+ * Optionen von SYSTEMINFO.
+ */
+struct SystemInfoOptions {
+    bool watch = false;          // /WATCH
+    uint32_t intervalMillis = SystemMonitor::DEFAULT_INTERVAL; // /I <ms>
+    bool intervalSet = false;    // /I angegeben: laufenden Monitor umstellen
+};
+
+bool ParseSystemInfoArguments(const std::wstring& arguments, SystemInfoOptions& options, std::wstring& error);
+
+// Zeichnet values (0..maximum) als Blockzeichen U+2581..U+2588, die neuesten rechts; fehlende
+// Werte links als Leerzeichen.
+void AppendSparkline(std::wstring& out, const SampleRing& values, float maximum, size_t width);
+
+// Fuehrt SYSTEMINFO /WATCH aus, bis Strg+C/STOP: ein Block von Statuszeilen mit einer Sparkline
+// je Messgroesse, nach jeder Stichprobe des Monitors neu gezeichnet.
+void RunSystemWatch(JobContext& job, const SystemMonitor& monitor);
+
+#ifdef __linux__
+// /proc/stat, /proc/meminfo, /proc/diskstats und /proc/net/dev; die Dateien bleiben offen.
+std::unique_ptr<SystemSampler> CreateProcSystemSampler();
+#endif
@@ -0,0 +1,280 @@
+#include "table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cwchar>
+#include <limits>
+
+namespace {
+
+size_t DigitCount(uint64_t value) {
+    size_t digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+void AppendNumber(uint64_t value, std::wstring& out) {
+    wchar_t digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = static_cast<wchar_t>(L'0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count) out += digits[--count];
+}
+
+// Liefert die Laenge; text muss mindestens 32 Zeichen fassen
+size_t FormatReal(uint64_t bits, wchar_t* text) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    int length = swprintf(text, 32, L"%.10g", value);
+    return length > 0 ? static_cast<size_t>(length) : 0;
+}
+
+} // namespace
+
+ResultTable::ResultTable(Layout layout)
+    : m_layout(layout) {
+}
+
+size_t ResultTable::AddTextColumn(std::wstring title) {
+    return AddColumn(std::move(title), std::wstring(), Type::Text);
+}
+
+size_t ResultTable::AddNumberColumn(std::wstring title, std::wstring suffix) {
+    return AddColumn(std::move(title), std::move(suffix), Type::Number);
+}
+
+size_t ResultTable::AddRealColumn(std::wstring title) {
+    return AddColumn(std::move(title), std::wstring(), Type::Real);
+}
+
+size_t ResultTable::AddColumn(std::wstring title, std::wstring suffix, Type type) {
+    uint32_t width = static_cast<uint32_t>(title.size());
+    m_columns.push_back({ std::move(title), std::move(suffix), type, width, std::vector<uint64_t>(m_rows, EMPTY_CELL) });
+    return m_columns.size() - 1;
+}
+
+void ResultTable::AddCaption(std::wstring line) {
+    m_captions.push_back(std::move(line));
+}
+
+void ResultTable::SetHeading(std::wstring prefix, std::wstring suffix) {
+    m_heading = true;
+    m_headingPrefix = std::move(prefix);
+    m_headingSuffix = std::move(suffix);
+}
+
+void ResultTable::Reserve(size_t rows, size_t textChars) {
+    for (Column& column : m_columns) column.cells.reserve(rows);
+    m_text.reserve(textChars);
+}
+
+void ResultTable::Compact() {
+    for (Column& column : m_columns) column.cells.shrink_to_fit();
+    m_text.shrink_to_fit();
+    m_listEnds.shrink_to_fit();
+}
+
+void ResultTable::AddRow() {
+    for (Column& column : m_columns) column.cells.push_back(EMPTY_CELL);
+    m_rows++;
+    if (m_skipEmpty) m_listEnds.push_back((m_listEnds.empty() ? 0 : m_listEnds.back()) + (m_heading ? 2 : 0));
+}
+
+// Zeilen einer Zelle im List-Layout mit SetSkipEmpty: 0 fuer leer, sonst ein Wert je Zeile
+size_t ResultTable::CellLines(const Column& column, uint64_t cell) const {
+    if (cell == EMPTY_CELL) return 0;
+    if (column.type != Type::Text) return 1;
+    const wchar_t* text = m_text.data() + (cell >> 20);
+    return 1 + static_cast<size_t>(std::count(text, text + (cell & MAX_TEXT_LENGTH), L'\n'));
+}
+
+void ResultTable::SetCell(Column& column, uint64_t cell) {
+    if (m_skipEmpty && !(m_heading && &column == &m_columns[0])) {
+        m_listEnds.back() += CellLines(column, cell) - CellLines(column, column.cells.back());
+    }
+    column.cells.back() = cell;
+    column.width = std::max(column.width, static_cast<uint32_t>(CellLength(column, cell)));
+}
+
+void ResultTable::Set(size_t column, std::wstring_view text) {
+    if (column >= m_columns.size() || m_rows == 0) return;
+    Column& target = m_columns[column];
+    if (target.type != Type::Text) return;
+    text = text.substr(0, MAX_TEXT_LENGTH);
+    uint64_t cell = static_cast<uint64_t>(m_text.size()) << 20 | text.size();
+    m_text.append(text);
+    SetCell(target, cell);
+}
+
+void ResultTable::Set(size_t column, uint64_t value) {
+    if (column >= m_columns.size() || m_rows == 0) return;
+    Column& target = m_columns[column];
+    if (target.type != Type::Number) return;
+    uint64_t cell = std::min(value, EMPTY_CELL - 1);
+    SetCell(target, cell);
+}
+
+void ResultTable::SetReal(size_t column, double value) {
+    if (column >= m_columns.size() || m_rows == 0) return;
+    Column& target = m_columns[column];
+    if (target.type != Type::Real) return;
+    // Einheitliches NaN, damit kein Bitmuster mit EMPTY_CELL zusammenfaellt
+    if (std::isnan(value)) value = std::numeric_limits<double>::quiet_NaN();
+    uint64_t cell;
+    std::memcpy(&cell, &value, sizeof(cell));
+    SetCell(target, cell);
+}
+
+size_t ResultTable::LineCount() const {
+    size_t lines = m_captions.size();
+    if (m_layout == Layout::Columns) {
+        if (m_columns.empty()) return lines;
+        return lines + 1 + (m_rule ? 1 : 0) + m_rows;
+    }
+    if (m_skipEmpty) return lines + (m_listEnds.empty() ? 0 : m_listEnds.back());
+    size_t fields = m_columns.size() - (m_heading && !m_columns.empty() ? 1 : 0);
+    return lines + m_rows * (fields + (m_heading ? 2 : 0));
+}
+
+size_t ResultTable::CellLength(const Column& column, uint64_t cell) const {
+    if (cell == EMPTY_CELL) return 0;
+    if (column.type == Type::Text) return static_cast<size_t>(cell & MAX_TEXT_LENGTH);
+    if (column.type == Type::Real) {
+        wchar_t text[32];
+        return FormatReal(cell, text);
+    }
+    return DigitCount(cell) + column.suffix.size();
+}
+
+void ResultTable::AppendCell(const Column& column, uint64_t cell, std::wstring& out) const {
+    if (cell == EMPTY_CELL) return;
+    if (column.type == Type::Text) {
+        out.append(m_text, static_cast<size_t>(cell >> 20), static_cast<size_t>(cell & MAX_TEXT_LENGTH));
+        return;
+    }
+    if (column.type == Type::Real) {
+        wchar_t text[32];
+        out.append(text, FormatReal(cell, text));
+        return;
+    }
+    AppendNumber(cell, out);
+    out += column.suffix;
+}
+
+void ResultTable::FormatLine(size_t line, std::wstring& out) const {
+    if (line < m_captions.size()) {
+        out += m_captions[line];
+        return;
+    }
+    line -= m_captions.size();
+    if (m_layout == Layout::List) {
+        FormatListLine(line, out);
+        return;
+    }
+
+    // Kopf, Trennlinie und Datensatz teilen sich die Ausrichtung; die letzte Spalte wird nicht
+    // mit Leerzeichen aufgefuellt
+    size_t header = m_rule ? 2 : 1;
+    out.append(m_indent, L' ');
+    for (size_t c = 0; c < m_columns.size(); ++c) {
+        const Column& column = m_columns[c];
+        bool last = c + 1 == m_columns.size();
+        if (c > 0) out.append(m_gap, L' ');
+        if (line == 1 && m_rule) {
+            out.append(column.width, L'=');
+            continue;
+        }
+
+        size_t length = line == 0 ? column.title.size() : CellLength(column, column.cells[line - header]);
+        size_t pad = column.width - length;
+        bool right = column.type != Type::Text;
+        if (right) out.append(pad, L' ');
+        if (line == 0) out += column.title;
+        else AppendCell(column, column.cells[line - header], out);
+        if (!right && !last) out.append(pad, L' ');
+    }
+}
+
+void ResultTable::FormatListLine(size_t line, std::wstring& out) const {
+    size_t first = m_heading ? 1 : 0;
+    size_t row;
+    size_t field;
+    if (m_skipEmpty) {
+        row = static_cast<size_t>(std::upper_bound(m_listEnds.begin(), m_listEnds.end(), line) - m_listEnds.begin());
+        field = line - (row > 0 ? m_listEnds[row - 1] : 0);
+    }
+    else {
+        size_t block = m_columns.size() - first + (m_heading ? 2 : 0);
+        row = line / block;
+        field = line % block;
+    }
+
+    if (m_heading) {
+        if (field == 0) return; // Leerzeile vor jedem Datensatz
+        if (field == 1) {
+            out += m_headingPrefix;
+            AppendCell(m_columns[0], m_columns[0].cells[row], out);
+            out += m_headingSuffix;
+            return;
+        }
+        field -= 2;
+    }
+
+    if (m_skipEmpty) {
+        // field zaehlt hier Zeilen: Feld und Wert darin suchen
+        for (size_t c = first; c < m_columns.size(); ++c) {
+            const Column& column = m_columns[c];
+            uint64_t cell = column.cells[row];
+            size_t count = CellLines(column, cell);
+            if (field >= count) {
+                field -= count;
+                continue;
+            }
+            size_t label = std::max(column.title.size(), static_cast<size_t>(std::max(m_labelWidth, 0)));
+            if (field == 0) {
+                out.append(m_indent, L' ');
+                out += column.title;
+                for (size_t pos = column.title.size(); pos < label; ++pos) out += pos % 2 == 0 ? L'.' : L' ';
+                out += L": ";
+            }
+            else {
+                out.append(static_cast<size_t>(m_indent) + label + 2, L' ');
+            }
+            if (column.type != Type::Text) {
+                AppendCell(column, cell, out);
+                return;
+            }
+            std::wstring_view text(m_text.data() + (cell >> 20), static_cast<size_t>(cell & MAX_TEXT_LENGTH));
+            for (size_t skip = 0; skip < field; ++skip) text.remove_prefix(text.find(L'\n') + 1);
+            out += text.substr(0, text.find(L'\n'));
+            return;
+        }
+        return;
+    }
+
+    const Column& column = m_columns[first + field];
+    out.append(m_indent, L' ');
+    out += column.title;
+    // Auffuellen wie ipconfig.exe: Punkte auf geraden, Leerzeichen auf ungeraden Spalten
+    for (size_t pos = column.title.size(); pos < static_cast<size_t>(m_labelWidth); ++pos) {
+        out += pos % 2 == 0 ? L'.' : L' ';
+    }
+    out += L": ";
+    AppendCell(column, column.cells[row], out);
+}
+
+size_t ResultTable::ResidentBytes() const {
+    size_t bytes = sizeof(*this) + m_text.capacity() * sizeof(wchar_t) + m_listEnds.capacity() * sizeof(size_t);
+    for (const Column& column : m_columns) {
+        bytes += sizeof(Column) + column.cells.capacity() * sizeof(uint64_t)
+            + (column.title.capacity() + column.suffix.capacity()) * sizeof(wchar_t);
+    }
+    for (const std::wstring& caption : m_captions) bytes += sizeof(caption) + caption.capacity() * sizeof(wchar_t);
+    return bytes;
+}
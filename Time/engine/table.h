@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Tabellarisches Ergebnis eines Befehls (TASKLIST, NETSTAT, IPCONFIG, SYSTEMINFO).
+ *
+ * Statt jede Zeile sofort per std::wstringstream zu formatieren, legt der Befehl typisierte
+ * Werte spaltenweise ab: Zahlen als uint64_t bzw. double, Texte als Verweis in einen gemeinsamen
+ * Textpuffer.
+ * Die Spaltenbreiten werden beim Befuellen mitgefuehrt; formatiert wird eine Zeile erst, wenn
+ * sie angezeigt wird (FormatLine). Die fertige Tabelle geht in einem Stueck in den Verlauf
+ * (ConsoleEngine::AddTable bzw. JobContext::AddTable) und ist danach unveraenderlich.
+ *
+ * Layout::Columns: Titelzeilen, Spaltenkoepfe, Trennlinie, eine Zeile je Datensatz.
+ * Layout::List:    Titelzeilen, je Datensatz optional eine Ueberschrift aus Spalte 0 und darunter
+ *                  eine Zeile "Bezeichnung: Wert" je weiterer Spalte (wie IPCONFIG).
+ *                  Mit SetSkipEmpty entfallen leere Felder, und ein Text mit '\n' steht als
+ *                  mehrere Werte untereinander (mehrere Adressen eines Adapters).
+ */
+class ResultTable {
+public:
+    enum class Layout { Columns, List };
+
+    explicit ResultTable(Layout layout = Layout::Columns);
+
+    // Spalten festlegen, bevor die erste Zeile angelegt wird. Texte sind linksbuendig, Zahlen
+    // rechtsbuendig; suffix wird an jede Zahl angehaengt (z.B. " MB"). Liefert die Spaltennummer.
+    size_t AddTextColumn(std::wstring title);
+    size_t AddNumberColumn(std::wstring title, std::wstring suffix = std::wstring());
+    // Gleitkommazahlen mit 10 signifikanten Stellen (CALC/TABLE).
+    size_t AddRealColumn(std::wstring title);
+
+    // Zeilen vor der eigentlichen Tabelle (z.B. "Aktive Verbindungen").
+    void AddCaption(std::wstring line);
+
+    // Columns: Einrueckung der Zeilen, Abstand zwischen den Spalten, Trennlinie aus '='.
+    // List: Einrueckung der Wertzeilen.
+    void SetIndent(int indent) { m_indent = indent; }
+    void SetGap(int gap) { m_gap = gap; }
+    void SetRule(bool rule) { m_rule = rule; }
+
+    // List: Spalte 0 wird zur Ueberschrift prefix + Wert + suffix, davor eine Leerzeile.
+    void SetHeading(std::wstring prefix, std::wstring suffix);
+    // List: Bezeichnungen mit ". . ." auf diese Breite auffuellen (0 = nicht auffuellen).
+    void SetLabelWidth(int width) { m_labelWidth = width; }
+    // List: leere Felder weglassen, Werte mit '\n' auf Folgezeilen; vor der ersten Zeile setzen.
+    void SetSkipEmpty(bool skip) { m_skipEmpty = skip; }
+
+    void Reserve(size_t rows, size_t textChars);
+
+    // Gibt ungenutzte Reserve frei, sobald die Tabelle vollstaendig ist (Scrollback::AppendTable).
+    void Compact();
+
+    // Neue Zeile, deren Spalten leer sind, bis sie per Set gefuellt werden.
+    void AddRow();
+    void Set(size_t column, std::wstring_view text);
+    void Set(size_t column, uint64_t value);
+    void SetReal(size_t column, double value);
+
+    size_t Columns() const { return m_columns.size(); }
+    size_t Rows() const { return m_rows; }
+
+    // Anzahl der Ausgabezeilen inkl. Titel, Kopf und Ueberschriften.
+    size_t LineCount() const;
+
+    // Haengt Ausgabezeile line (0 .. LineCount()-1) an out an.
+    void FormatLine(size_t line, std::wstring& out) const;
+
+    size_t ResidentBytes() const;
+
+private:
+    enum class Type { Text, Number, Real };
+
+    struct Column {
+        std::wstring title;
+        std::wstring suffix;
+        Type type;
+        uint32_t width;              // breitester Wert bzw. Titel (Columns)
+        std::vector<uint64_t> cells; // Text: Offset << 20 | Laenge, Zahl: Wert, Real: Bits des double; EMPTY_CELL = leer
+    };
+
+    static constexpr uint64_t EMPTY_CELL = ~0ull;
+    static constexpr uint64_t MAX_TEXT_LENGTH = (1u << 20) - 1;
+
+    size_t AddColumn(std::wstring title, std::wstring suffix, Type type);
+    size_t CellLength(const Column& column, uint64_t cell) const;
+    void AppendCell(const Column& column, uint64_t cell, std::wstring& out) const;
+    void FormatListLine(size_t line, std::wstring& out) const;
+    size_t CellLines(const Column& column, uint64_t cell) const;
+    void SetCell(Column& column, uint64_t cell);
+
+    Layout m_layout;
+    std::vector<Column> m_columns;
+    std::vector<std::wstring> m_captions;
+    std::wstring m_text; // Inhalt aller Textzellen hintereinander
+    size_t m_rows = 0;
+
+    int m_indent = 0;
+    int m_gap = 1;
+    bool m_rule = true;
+    bool m_heading = false;
+    std::wstring m_headingPrefix;
+    std::wstring m_headingSuffix;
+    int m_labelWidth = 0;
+    bool m_skipEmpty = false;
+    std::vector<size_t> m_listEnds; // SetSkipEmpty: erste Zeile nach jedem Datensatz (ohne Titel)
+};
@@ -0,0 +1,248 @@
+#include "top.h"
+#include "clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cwchar>
+#include <cwctype>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// Reihenfolge der Anzeige: CPU-Anteil, dann Arbeitssatz absteigend, dann PID
+bool Before(const ProcessRow& a, const ProcessRow& b) {
+    if (a.cpuPercent != b.cpuPercent) return a.cpuPercent > b.cpuPercent;
+    if (a.sample.workingSetBytes != b.sample.workingSetBytes) return a.sample.workingSetBytes > b.sample.workingSetBytes;
+    return a.sample.pid < b.sample.pid;
+}
+
+size_t HashPid(uint32_t pid, size_t mask) {
+    return static_cast<size_t>((pid * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+bool ParseCount(const std::wstring& text, uint32_t minimum, uint32_t maximum, uint32_t& value) {
+    if (text.empty() || text.size() > 9 || !std::all_of(text.begin(), text.end(), [](wchar_t c) { return c >= L'0' && c <= L'9'; })) {
+        return false;
+    }
+    unsigned long parsed = wcstoul(text.c_str(), nullptr, 10);
+    if (parsed < minimum || parsed > maximum) return false;
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+std::wstring FormatCount(uint32_t count) {
+    return count == ProcessSample::NO_COUNT ? std::wstring(L"-") : std::to_wstring(count);
+}
+
+} // namespace
+
+void ProcessSample::SetName(const wchar_t* text, size_t length) {
+    length = std::min(length, NAME_LENGTH - 1);
+    wmemcpy(name, text, length);
+    name[length] = L'\0';
+}
+
+void ProcessMonitor::BuildIndex() {
+    size_t capacity = 16;
+    while (capacity < m_rows.size() * 2) capacity *= 2;
+    m_slots.assign(capacity, -1);
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < m_rows.size(); ++i) {
+        size_t slot = HashPid(m_rows[i].sample.pid, mask);
+        while (m_slots[slot] >= 0) slot = (slot + 1) & mask;
+        m_slots[slot] = static_cast<int32_t>(i);
+    }
+}
+
+int32_t ProcessMonitor::Find(uint32_t pid) const {
+    if (m_slots.empty()) return -1;
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = HashPid(pid, mask); m_slots[slot] >= 0; slot = (slot + 1) & mask) {
+        if (m_rows[m_slots[slot]].sample.pid == pid) return m_slots[slot];
+    }
+    return -1;
+}
+
+/**
+ * Einfuegesortieren mit Budget: bei fast sortierter Eingabe linear. Verschiebt sich zu viel
+ * (z.B. beim ersten Stand oder wenn viele Prozesse gleichzeitig Last erzeugen), uebernimmt
+ * std::sort.
+ */
+void ProcessMonitor::Sort() {
+    size_t budget = m_rows.size() * 4 + 64;
+    for (size_t i = 1; i < m_rows.size(); ++i) {
+        if (!Before(m_rows[i], m_rows[i - 1])) continue;
+        ProcessRow row = m_rows[i];
+        size_t j = i;
+        while (j > 0 && Before(row, m_rows[j - 1])) {
+            m_rows[j] = m_rows[j - 1];
+            --j;
+            if (--budget == 0) {
+                m_rows[j] = row;
+                std::sort(m_rows.begin(), m_rows.end(), Before);
+                return;
+            }
+        }
+        m_rows[j] = row;
+    }
+}
+
+void ProcessMonitor::Update(const std::vector<ProcessSample>& samples, uint64_t elapsedMicros, unsigned cpus) {
+    m_hasDeltas = !m_rows.empty() && elapsedMicros > 0;
+    const double capacity = static_cast<double>(elapsedMicros) * std::max(cpus, 1u);
+
+    // Neue Stichprobe je alter Zeile (gleiche PID)
+    m_sampleOf.assign(m_rows.size(), -1);
+    m_placed.assign(samples.size(), 0);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        int32_t old = Find(samples[i].pid);
+        if (old >= 0 && m_sampleOf[old] < 0) m_sampleOf[old] = static_cast<int32_t>(i);
+    }
+
+    m_next.clear();
+    m_threads = 0;
+    m_cpuPercent = 0.0;
+    auto emit = [&](size_t index, const ProcessRow* previous) {
+        ProcessRow& row = m_next.emplace_back();
+        row.sample = samples[index];
+        m_placed[index] = 1;
+        m_threads += row.sample.threads;
+        // Gleiche PID mit anderer Startzeit ist ein neuer Prozess: erst ab der naechsten Stichprobe
+        if (m_hasDeltas && previous && previous->sample.startTime == row.sample.startTime
+            && row.sample.cpuMicros >= previous->sample.cpuMicros) {
+            row.cpuPercent = std::min(100.0, static_cast<double>(row.sample.cpuMicros - previous->sample.cpuMicros) * 100.0 / capacity);
+            m_cpuPercent += row.cpuPercent;
+        }
+    };
+    // Zuerst in der bisherigen Reihenfolge, neue Prozesse hinten: fast sortiert
+    for (size_t old = 0; old < m_rows.size(); ++old) {
+        if (m_sampleOf[old] >= 0) emit(static_cast<size_t>(m_sampleOf[old]), &m_rows[old]);
+    }
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (!m_placed[i]) emit(i, nullptr);
+    }
+    m_cpuPercent = std::min(m_cpuPercent, 100.0);
+
+    m_rows.swap(m_next);
+    Sort();
+    BuildIndex();
+}
+
+bool ParseTopArguments(const std::wstring& arguments, TopOptions& options, std::wstring& error) {
+    std::wstringstream iss(arguments);
+    std::wstring token;
+    while (iss >> token) {
+        wchar_t option = token.size() == 2 && (token[0] == L'-' || token[0] == L'/')
+            ? static_cast<wchar_t>(std::towlower(token[1])) : 0;
+        uint32_t* target = nullptr;
+        uint32_t maximum = 0;
+        switch (option) {
+        case L'n': target = &options.rows; maximum = 200; break;
+        case L'i': target = &options.intervalSeconds; maximum = 3600; break;
+        default:
+            error = L"Ungueltige Option '" + token + L"' (erlaubt: -n <anzahl>, -i <sekunden>).";
+            return false;
+        }
+        std::wstring value;
+        if (!(iss >> value)) {
+            error = L"Wert fuer Option '" + token + L"' fehlt.";
+            return false;
+        }
+        if (!ParseCount(value, 1, maximum, *target)) {
+            error = L"Ungueltiger Wert '" + value + L"' fuer Option '" + token + L"' (erlaubt: 1 bis "
+                + std::to_wstring(maximum) + L").";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::wstring FormatBytes(uint64_t bytes) {
+    wchar_t text[32];
+    if (bytes < 1024ull * 1024) swprintf(text, 32, L"%llu KB", static_cast<unsigned long long>(bytes / 1024));
+    else if (bytes < 1024ull * 1024 * 1024) swprintf(text, 32, L"%.1f MB", bytes / (1024.0 * 1024));
+    else swprintf(text, 32, L"%.2f GB", bytes / (1024.0 * 1024 * 1024));
+    return text;
+}
+
+void RunTop(JobContext& job, ProcessSampler& sampler, const TopOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const unsigned cpus = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::vector<ProcessSample> samples;
+    std::wstring error;
+    ProcessMonitor monitor;
+    ClockFormatter clock;
+    std::vector<std::wstring> shown; // zuletzt gesendete Statuszeilen
+    std::vector<std::wstring> lines;
+    double sampleMillis = 0.0;
+
+    auto show = [&] {
+        lines.clear();
+        const std::vector<ProcessRow>& rows = monitor.Rows();
+        wchar_t text[160];
+        wchar_t cpu[16];
+        if (monitor.HasDeltas()) swprintf(cpu, 16, L"%.1f %%", monitor.CpuPercent());
+        else wcscpy(cpu, L"-");
+        swprintf(text, 160, L"TOP %.8ls - Prozesse: %zu, Threads: %llu, CPU: %ls", clock.Now().time, rows.size(),
+            static_cast<unsigned long long>(monitor.Threads()), cpu);
+        lines.emplace_back(text);
+        swprintf(text, 160, L"Stichprobe: %.2f ms alle %u s (%.3f %% Rechenzeit), Strg+C beendet", sampleMillis,
+            options.intervalSeconds, sampleMillis / (options.intervalSeconds * 10.0));
+        lines.emplace_back(text);
+        swprintf(text, 160, L"%7ls  %-31ls %6ls  %11ls  %7ls  %7ls", L"PID", L"Name", L"CPU %", L"Arbeitssatz", L"Threads", L"Handles");
+        lines.emplace_back(text);
+        for (uint32_t i = 0; i < options.rows; ++i) {
+            if (i >= rows.size()) {
+                lines.emplace_back();
+                continue;
+            }
+            const ProcessRow& row = rows[i];
+            if (monitor.HasDeltas()) swprintf(cpu, 16, L"%.1f", row.cpuPercent);
+            else wcscpy(cpu, L"-");
+            swprintf(text, 160, L"%7u  %-31ls %6ls  %11ls  %7ls  %7ls", row.sample.pid, row.sample.name, cpu,
+                FormatBytes(row.sample.workingSetBytes).c_str(), FormatCount(row.sample.threads).c_str(),
+                FormatCount(row.sample.handles).c_str());
+            lines.emplace_back(text);
+        }
+        // Nur geaenderte Zeilen senden; nur diese werden im Verlauf ersetzt und neu gezeichnet
+        const size_t sent = shown.size();
+        shown.resize(lines.size());
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (i < sent && shown[i] == lines[i]) continue;
+            shown[i] = lines[i];
+            job.SetLiveLine(static_cast<uint32_t>(i), lines[i]);
+        }
+    };
+
+    auto take = [&]() {
+        auto start = Clock::now();
+        bool ok = sampler.Sample(samples, error);
+        sampleMillis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (!ok) job.AddError(L"FEHLER: " + error);
+        return ok;
+    };
+
+    if (!take()) return;
+    auto last = Clock::now();
+    monitor.Update(samples, 0, cpus);
+    show();
+
+    auto next = last;
+    for (;;) {
+        // Fester Takt wie bei PING, Strg+C beendet die Pause sofort
+        next += std::chrono::seconds(options.intervalSeconds);
+        auto now = Clock::now();
+        if (next < now) next = now;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+        if (!job.Sleep(static_cast<uint32_t>(wait)) || job.Cancelled()) break;
+
+        if (!take()) break;
+        now = Clock::now();
+        uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - last).count());
+        last = now;
+        monitor.Update(samples, elapsed, cpus);
+        show();
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "executor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Messwerte eines Prozesses zu einem Zeitpunkt. Feste Groesse ohne eigenen Speicher, damit ein
+ * Stand bei jeder Stichprobe ohne Speicheranforderung neu befuellt werden kann.
+ */
+struct ProcessSample {
+    static constexpr uint32_t NO_COUNT = ~0u; // Wert auf diesem System nicht verfuegbar
+    static constexpr size_t NAME_LENGTH = 32; // laengere Namen werden abgeschnitten
+
+    uint32_t pid = 0;
+    uint32_t threads = 0;
+    uint32_t handles = NO_COUNT;
+    uint64_t startTime = 0;       // beliebige Einheit; unterscheidet wiederverwendete PIDs
+    uint64_t cpuMicros = 0;       // Benutzer- plus Kernelzeit seit Prozessstart
+    uint64_t workingSetBytes = 0;
+    wchar_t name[NAME_LENGTH] = {};
+
+    void SetName(const wchar_t* text, size_t length);
+};
+
+/**
+ * Liest den aktuellen Stand aller Prozesse. Das Frontend stellt die Implementierung bereit
+ * (Win32: NtQuerySystemInformation, ein Aufruf fuer alle Prozesse; Headless: /proc); ein Sampler
+ * gehoert genau einem TOP-Job und darf seine Puffer wiederverwenden.
+ */
+class ProcessSampler {
+public:
+    virtual ~ProcessSampler() = default;
+
+    // Ersetzt den Inhalt von samples; false und Meldung, wenn nichts gelesen werden konnte.
+    virtual bool Sample(std::vector<ProcessSample>& samples, std::wstring& error) = 0;
+};
+
+/**
+ * Zeile der TOP-Anzeige: letzter Stand plus CPU-Anteil seit der vorigen Stichprobe.
+ */
+struct ProcessRow {
+    ProcessSample sample;
+    double cpuPercent = 0.0; // Anteil an allen Prozessoren
+};
+
+/**
+ * Vergleicht aufeinanderfolgende Stichproben. Der vorige Stand ist ueber eine flache Hashtabelle
+ * (PID -> Zeile, offene Adressierung) indiziert. Die neuen Zeilen werden in der Reihenfolge der
+ * vorigen Sortierung angelegt und dann per Einfuegesortieren nachsortiert: da sich die Rangfolge
+ * zwischen zwei Stichproben kaum aendert, kostet das fast nur einen Durchlauf. Wird es zu teuer,
+ * wird vollstaendig sortiert.
+ */
+class ProcessMonitor {
+public:
+    // Neuer Stand aus samples; elapsedMicros ist der Abstand zur vorigen Stichprobe (0 = keine
+    // CPU-Anteile), cpus die Anzahl logischer Prozessoren.
+    void Update(const std::vector<ProcessSample>& samples, uint64_t elapsedMicros, unsigned cpus);
+
+    // Nach CPU-Anteil, dann Arbeitssatz absteigend.
+    const std::vector<ProcessRow>& Rows() const { return m_rows; }
+    uint64_t Threads() const { return m_threads; }
+    double CpuPercent() const { return m_cpuPercent; }
+    bool HasDeltas() const { return m_hasDeltas; }
+
+private:
+    void BuildIndex();
+    int32_t Find(uint32_t pid) const;
+    void Sort();
+
+    std::vector<ProcessRow> m_rows;
+    std::vector<ProcessRow> m_next;
+    std::vector<int32_t> m_slots;  // Index in m_rows oder -1
+    std::vector<int32_t> m_sampleOf; // je alter Zeile: Index der neuen Stichprobe oder -1
+    std::vector<uint8_t> m_placed;
+    uint64_t m_threads = 0;
+    double m_cpuPercent = 0.0;
+    bool m_hasDeltas = false;
+};
+
+/**
+ * Optionen von TOP.
+ */
+struct TopOptions {
+    uint32_t rows = 20;            // -n <anzahl>
+    uint32_t intervalSeconds = 2;  // -i <sekunden>
+};
+
+bool ParseTopArguments(const std::wstring& arguments, TopOptions& options, std::wstring& error);
+
+// "512 KB", "12.3 MB", "1.50 GB"
+std::wstring FormatBytes(uint64_t bytes);
+
+// Fuehrt TOP aus, bis Strg+C/STOP: ein Block von Statuszeilen, von dem pro Stichprobe nur die
+// geaenderten Zeilen ersetzt werden.
+void RunTop(JobContext& job, ProcessSampler& sampler, const TopOptions& options);
@@ -0,0 +1,118 @@
+#include "utf8.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+std::wstring Utf8ToWide(std::string_view text) {
+    std::wstring out;
+    AppendUtf8(text, out);
+    return out;
+}
+
+void AppendUtf8(std::string_view text, std::wstring& out) {
+    out.reserve(out.size() + text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        // ASCII-Abschnitte in einem Stueck uebernehmen (achtbyteweise gepruefter Anfang)
+        size_t ascii = i;
+        while (ascii + 8 <= text.size()) {
+            uint64_t block;
+            memcpy(&block, text.data() + ascii, sizeof(block));
+            if (block & 0x8080808080808080ull) break;
+            ascii += 8;
+        }
+        while (ascii < text.size() && static_cast<unsigned char>(text[ascii]) < 0x80) ++ascii;
+        if (ascii > i) {
+            size_t start = out.size();
+            out.resize(start + (ascii - i));
+            wchar_t* target = out.data() + start;
+            for (size_t k = i; k < ascii; ++k) *target++ = static_cast<wchar_t>(text[k]);
+            i = ascii;
+            if (i == text.size()) break;
+        }
+
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        char32_t cp;
+        size_t extra;
+        if ((c & 0xE0) == 0xC0) { cp = c & 0x1F; extra = 1; }
+        else if ((c & 0xF0) == 0xE0) { cp = c & 0x0F; extra = 2; }
+        else if ((c & 0xF8) == 0xF0) { cp = c & 0x07; extra = 3; }
+        else { out += L'\xFFFD'; ++i; continue; }
+
+        if (i + extra >= text.size()) {
+            // Abgeschnittene Bytefolge am Ende
+            out += L'\xFFFD';
+            break;
+        }
+        bool valid = true;
+        for (size_t k = 1; k <= extra; ++k) {
+            unsigned char cc = static_cast<unsigned char>(text[i + k]);
+            if ((cc & 0xC0) != 0x80) { valid = false; break; }
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+        if (!valid) { out += L'\xFFFD'; ++i; continue; }
+        i += extra + 1;
+
+        if constexpr (sizeof(wchar_t) == 2) {
+            // Windows: Zeichen ausserhalb der BMP als Surrogatpaar
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                out += static_cast<wchar_t>(0xD800 + (cp >> 10));
+                out += static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+                continue;
+            }
+        }
+        out += static_cast<wchar_t>(cp);
+    }
+}
+
+std::string WideToUtf8(std::wstring_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        char32_t cp = static_cast<char32_t>(text[i]);
+        if constexpr (sizeof(wchar_t) == 2) {
+            if (cp >= 0xD800 && cp < 0xDC00 && i + 1 < text.size()) {
+                char32_t low = static_cast<char32_t>(text[i + 1]);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+        }
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        }
+        else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+    return out;
+}
+
+void DecodeTextLine(std::string_view bytes, std::wstring& out) {
+    if (!bytes.empty() && bytes.back() == '\r') bytes.remove_suffix(1);
+    bool ascii = std::all_of(bytes.begin(), bytes.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+    if (ascii) {
+        out.assign(bytes.begin(), bytes.end());
+        return;
+    }
+    out = Utf8ToWide(bytes);
+    if (out.find(L'\xFFFD') != std::wstring::npos) {
+        out.resize(bytes.size());
+        std::transform(bytes.begin(), bytes.end(), out.begin(), [](char c) { return static_cast<wchar_t>(static_cast<unsigned char>(c)); });
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Konvertierung zwischen UTF-8 (Dateien, stdin/stdout) und std::wstring (Konsolenverlauf).
+// Ungueltige Bytefolgen werden durch U+FFFD ersetzt.
+std::wstring Utf8ToWide(std::string_view text);
+std::string WideToUtf8(std::wstring_view text);
+
+// Wie Utf8ToWide, haengt aber an out an (ohne eigene Allokation je Aufruf).
+void AppendUtf8(std::string_view text, std::wstring& out);
+
+// Eine Zeile einer Textdatei (TYPE, FIND) ohne abschliessendes '\r'. Ohne gueltiges UTF-8 werden
+// die Bytes als Latin-1 gelesen (entspricht weitgehend der ANSI-Codepage).
+void DecodeTextLine(std::string_view bytes, std::wstring& out);
@@ -0,0 +1,238 @@
+#include "vecmath.h"
+#include "simd.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace {
+
+const double PI_OVER_180 = 0.017453292519943295769;
+
+// Grad auf r in [-45, 45] und den Quadranten reduzieren; fmod und die Subtraktion sind exakt
+double ReduceDegrees(double degrees, int& quadrant) {
+    double r = std::fmod(degrees, 360.0);
+    double q = std::nearbyint(r / 90.0);
+    quadrant = static_cast<int>(q) & 3;
+    return r - q * 90.0;
+}
+
+#if TIME_HAVE_SSE2
+
+// Addiert und wieder abgezogen rundet diese Zahl auf eine ganze Zahl (fuer |x| < 2^51); die
+// unteren Mantissenbits enthalten danach die ganze Zahl im Zweierkomplement.
+const double ROUND_MAGIC = 6755399441055744.0;
+
+// Polynome aus Cephes (sin.c, exp.c, log.c)
+const double SIN_COEF[] = { 1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+    -1.98412698295895385996E-4, 8.33333333332211858878E-3, -1.66666666666666307295E-1 };
+const double COS_COEF[] = { -1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7,
+    2.48015872888517045348E-5, -1.38888888888730564116E-3, 4.16666666666665929218E-2 };
+const double EXP_P[] = { 1.26177193074810590878E-4, 3.02994407707441961300E-2, 9.99999999999999999910E-1 };
+const double EXP_Q[] = { 3.00198505138664455042E-6, 2.52448340349684104192E-3, 2.27265548208155028766E-1,
+    2.00000000000000000009E0 };
+const double LOG_P[] = { 1.01875663804580931796E-4, 4.97494994976747001425E-1, 4.70579119878881725854E0,
+    1.44989225341610930846E1, 1.79368678507819816313E1, 7.70838733755885391666E0 };
+const double LOG_Q[] = { 1.0, 1.12873587189167450590E1, 4.52279145837532221105E1, 8.29875266912776603211E1,
+    7.11544750618563894466E1, 2.31251620126765340583E1 };
+
+template <size_t N>
+inline __m128d Polynomial(__m128d x, const double (&coef)[N]) {
+    __m128d y = _mm_set1_pd(coef[0]);
+    for (size_t i = 1; i < N; ++i) {
+        y = _mm_add_pd(_mm_mul_pd(y, x), _mm_set1_pd(coef[i]));
+    }
+    return y;
+}
+
+inline __m128d Select(__m128d mask, __m128d yes, __m128d no) {
+    return _mm_or_pd(_mm_and_pd(mask, yes), _mm_andnot_pd(mask, no));
+}
+
+// Vergleichsergebnis der unteren 32 Bit auf die ganze 64-Bit-Lane ausdehnen
+inline __m128d LaneMask(__m128i compare32) {
+    return _mm_castsi128_pd(_mm_shuffle_epi32(compare32, _MM_SHUFFLE(2, 2, 0, 0)));
+}
+
+// Bitmaske der Lanes, die der Polynomzweig nicht abdeckt (0 = alle im Bereich)
+inline int Outside(__m128d inRange) {
+    return ~_mm_movemask_pd(inRange) & 3;
+}
+
+// in ist eine Kopie der Eingabe, da out und die Eingabe derselbe Speicher sein duerfen
+template <typename Scalar>
+inline void Store(double* out, __m128d value, int outside, const double (&in)[2], Scalar scalar) {
+    _mm_storeu_pd(out, value);
+    if (outside & 1) out[0] = scalar(in[0]);
+    if (outside & 2) out[1] = scalar(in[1]);
+}
+
+#endif
+
+} // namespace
+
+double SinDegrees(double degrees) {
+    if (!std::isfinite(degrees)) return std::numeric_limits<double>::quiet_NaN();
+    int quadrant;
+    double r = ReduceDegrees(degrees, quadrant) * PI_OVER_180;
+    double result = quadrant == 0 ? std::sin(r) : quadrant == 1 ? std::cos(r) : quadrant == 2 ? -std::sin(r) : -std::cos(r);
+    return result + 0.0; // -0 als 0 ausgeben
+}
+
+double CosDegrees(double degrees) {
+    if (!std::isfinite(degrees)) return std::numeric_limits<double>::quiet_NaN();
+    int quadrant;
+    double r = ReduceDegrees(degrees, quadrant) * PI_OVER_180;
+    double result = quadrant == 0 ? std::cos(r) : quadrant == 1 ? -std::sin(r) : quadrant == 2 ? -std::cos(r) : std::sin(r);
+    return result + 0.0;
+}
+
+double TanDegrees(double degrees) {
+    return SinDegrees(degrees) / CosDegrees(degrees);
+}
+
+void VecExp(const double* in, double* out, size_t n) {
+    size_t i = 0;
+#if TIME_HAVE_SSE2
+    const __m128d limit = _mm_set1_pd(708.0);
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    for (; i + 2 <= n; i += 2) {
+        const double saved[2] = { in[i], in[i + 1] };
+        __m128d x = _mm_loadu_pd(saved);
+        int outside = Outside(_mm_cmple_pd(_mm_andnot_pd(sign, x), limit));
+        if (outside == 3) {
+            out[i] = std::exp(saved[0]);
+            out[i + 1] = std::exp(saved[1]);
+            continue;
+        }
+        x = _mm_min_pd(_mm_max_pd(x, _mm_sub_pd(_mm_setzero_pd(), limit)), limit);
+
+        // x = n * ln2 + r, |r| <= ln2 / 2; ln2 in zwei Teilen, damit n * C1 exakt bleibt
+        __m128d k = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(1.4426950408889634074)), magic), magic);
+        x = _mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(6.93145751953125E-1)));
+        x = _mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(1.42860682030941723212E-6)));
+        __m128d xx = _mm_mul_pd(x, x);
+        __m128d p = _mm_mul_pd(x, Polynomial(xx, EXP_P));
+        __m128d r = _mm_div_pd(p, _mm_sub_pd(Polynomial(xx, EXP_Q), p));
+        r = _mm_add_pd(_mm_set1_pd(1.0), _mm_add_pd(r, r));
+
+        // 2^n direkt im Exponentenfeld zusammensetzen
+        __m128i e = _mm_add_epi32(_mm_cvtpd_epi32(k), _mm_set1_epi32(1023));
+        e = _mm_slli_epi64(_mm_shuffle_epi32(e, _MM_SHUFFLE(1, 1, 0, 0)), 52);
+        Store(out + i, _mm_mul_pd(r, _mm_castsi128_pd(e)), outside, saved, [](double v) { return std::exp(v); });
+    }
+#endif
+    for (; i < n; ++i) out[i] = std::exp(in[i]);
+}
+
+void VecLog(const double* in, double* out, size_t n) {
+    size_t i = 0;
+#if TIME_HAVE_SSE2
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128i mantissa = _mm_set_epi32(0x000FFFFF, -1, 0x000FFFFF, -1);
+    const __m128i half = _mm_set_epi32(0x3FE00000, 0, 0x3FE00000, 0);
+    for (; i + 2 <= n; i += 2) {
+        const double saved[2] = { in[i], in[i + 1] };
+        __m128d x = _mm_loadu_pd(saved);
+        int outside = Outside(_mm_and_pd(_mm_cmpge_pd(x, _mm_set1_pd(DBL_MIN)), _mm_cmple_pd(x, _mm_set1_pd(DBL_MAX))));
+        if (outside == 3) {
+            out[i] = std::log(saved[0]);
+            out[i + 1] = std::log(saved[1]);
+            continue;
+        }
+
+        // x = m * 2^e mit m in [0.5, 1)
+        __m128i bits = _mm_castpd_si128(x);
+        __m128i exponent = _mm_shuffle_epi32(_mm_srli_epi64(bits, 52), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128d e = _mm_sub_pd(_mm_cvtepi32_pd(exponent), _mm_set1_pd(1022.0));
+        __m128d m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, mantissa), half));
+
+        // m < sqrt(1/2): m verdoppeln, damit m - 1 in [-0.29, 0.41] liegt
+        __m128d small = _mm_cmplt_pd(m, _mm_set1_pd(0.70710678118654752440));
+        e = _mm_sub_pd(e, _mm_and_pd(small, one));
+        m = _mm_sub_pd(_mm_add_pd(m, _mm_and_pd(small, m)), one);
+
+        __m128d z = _mm_mul_pd(m, m);
+        __m128d y = _mm_mul_pd(m, _mm_div_pd(_mm_mul_pd(z, Polynomial(m, LOG_P)), Polynomial(m, LOG_Q)));
+        y = _mm_sub_pd(y, _mm_mul_pd(e, _mm_set1_pd(2.121944400546905827679e-4)));
+        y = _mm_sub_pd(y, _mm_mul_pd(z, _mm_set1_pd(0.5)));
+        y = _mm_add_pd(_mm_add_pd(m, y), _mm_mul_pd(e, _mm_set1_pd(0.693359375)));
+        Store(out + i, y, outside, saved, [](double v) { return std::log(v); });
+    }
+#endif
+    for (; i < n; ++i) out[i] = std::log(in[i]);
+}
+
+void VecSqrt(const double* in, double* out, size_t n) {
+    size_t i = 0;
+#if TIME_HAVE_SSE2
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_sqrt_pd(_mm_loadu_pd(in + i)));
+    }
+#endif
+    for (; i < n; ++i) out[i] = std::sqrt(in[i]);
+}
+
+void VecAbs(const double* in, double* out, size_t n) {
+    size_t i = 0;
+#if TIME_HAVE_SSE2
+    const __m128d sign = _mm_set1_pd(-0.0);
+    for (; i + 2 <= n; i += 2) {
+        _mm_storeu_pd(out + i, _mm_andnot_pd(sign, _mm_loadu_pd(in + i)));
+    }
+#endif
+    for (; i < n; ++i) out[i] = std::fabs(in[i]);
+}
+
+void VecSinCosDegrees(const double* in, double* sinOut, double* cosOut, size_t n) {
+    size_t i = 0;
+#if TIME_HAVE_SSE2
+    const __m128d magic = _mm_set1_pd(ROUND_MAGIC);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128i one = _mm_set_epi32(0, 1, 0, 1);
+    const __m128i two = _mm_set_epi32(0, 2, 0, 2);
+    for (; i + 2 <= n; i += 2) {
+        const double saved[2] = { in[i], in[i + 1] };
+        __m128d x = _mm_loadu_pd(saved);
+        int outside = Outside(_mm_cmple_pd(_mm_andnot_pd(sign, x), _mm_set1_pd(1e15)));
+        if (outside == 3) {
+            for (size_t j = 0; j < 2; ++j) {
+                if (sinOut) sinOut[i + j] = SinDegrees(saved[j]);
+                if (cosOut) cosOut[i + j] = CosDegrees(saved[j]);
+            }
+            continue;
+        }
+        x = _mm_and_pd(x, _mm_cmple_pd(_mm_andnot_pd(sign, x), _mm_set1_pd(1e15))); // NaN/gross -> 0
+
+        // x = q * 90 + r; q * 90 ist exakt, damit auch die Subtraktion
+        __m128d shifted = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(1.0 / 90.0)), magic);
+        __m128d q = _mm_sub_pd(shifted, magic);
+        __m128d r = _mm_mul_pd(_mm_sub_pd(x, _mm_mul_pd(q, _mm_set1_pd(90.0))), _mm_set1_pd(PI_OVER_180));
+        __m128i quadrant = _mm_castpd_si128(shifted);
+        __m128d odd = LaneMask(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+        __m128d upper = LaneMask(_mm_cmpeq_epi32(_mm_and_si128(quadrant, two), two));
+
+        __m128d zz = _mm_mul_pd(r, r);
+        __m128d s = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, zz), Polynomial(zz, SIN_COEF)));
+        __m128d c = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(zz, _mm_set1_pd(0.5))),
+            _mm_mul_pd(_mm_mul_pd(zz, zz), Polynomial(zz, COS_COEF)));
+
+        // Quadrant 0..3: sin = s, c, -s, -c; cos = c, -s, -c, s
+        if (sinOut) {
+            __m128d v = _mm_xor_pd(Select(odd, c, s), _mm_and_pd(upper, sign));
+            Store(sinOut + i, _mm_add_pd(v, _mm_setzero_pd()), outside, saved, SinDegrees);
+        }
+        if (cosOut) {
+            __m128d v = _mm_xor_pd(Select(odd, s, c), _mm_and_pd(_mm_xor_pd(odd, upper), sign));
+            Store(cosOut + i, _mm_add_pd(v, _mm_setzero_pd()), outside, saved, CosDegrees);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        double degrees = in[i];
+        if (sinOut) sinOut[i] = SinDegrees(degrees);
+        if (cosOut) cosOut[i] = CosDegrees(degrees);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Mathefunktionen ueber ganze Arrays fuer TABLE. Mit SSE2 werden je zwei Werte gleichzeitig
+ * berechnet (Polynome wie Cephes, Abweichung zur C-Bibliothek wenige ULP); Werte ausserhalb des
+ * Polynombereichs (NaN, Ueberlauf, subnormal) rechnet die C-Bibliothek nach. in und out duerfen
+ * gleich sein (bei VecSinCosDegrees auch mit sinOut oder cosOut).
+ *
+ * Winkel sind wie bei SIN/COS/TAN in Grad. Die Reduktion auf +-45 Grad ist exakt, daher sind
+ * z.B. sin(180) und cos(90) genau 0.
+ */
+void VecExp(const double* in, double* out, size_t n);
+void VecLog(const double* in, double* out, size_t n);
+void VecSqrt(const double* in, double* out, size_t n);
+void VecAbs(const double* in, double* out, size_t n);
+
+// sinOut oder cosOut darf nullptr sein.
+void VecSinCosDegrees(const double* in, double* sinOut, double* cosOut, size_t n);
+
+// Skalare Gegenstuecke mit derselben Winkelreduktion.
+double SinDegrees(double degrees);
+double CosDegrees(double degrees);
+double TanDegrees(double degrees);
@@ -0,0 +1,110 @@
+#include "viewer.h"
+#include "utf8.h"
+
+#include <algorithm>
+#include <sstream>
+
+bool FileViewer::Open(const std::wstring& path, const std::wstring& name, std::function<void()> progress, std::wstring& error) {
+    static uint32_t s_generation = 0;
+    m_index.reset();
+    if (!m_file.Open(path, error)) return false;
+    m_index = std::make_unique<LineIndex>(m_file, std::move(progress));
+    m_name = name;
+    m_generation = ++s_generation;
+    m_top = 0;
+    m_windowLines = 0;
+    m_windowBegin = 0;
+    m_windowEnd = 0;
+    m_windowFinal = false;
+    return true;
+}
+
+bool FileViewer::TakeProgress() {
+    uint64_t lines = m_index->Lines();
+    bool complete = m_index->Complete();
+    if (lines == m_reportedLines && complete == m_reportedComplete) return false;
+    m_reportedLines = lines;
+    m_reportedComplete = complete;
+    return true;
+}
+
+void FileViewer::ScrollBy(int64_t lines) {
+    // Letzte Seite bleibt voll; ueber den bisher indizierten Bereich hinaus geht es nicht
+    uint64_t known = m_index->Lines();
+    uint64_t last = known > static_cast<uint64_t>(m_pageRows) ? known - m_pageRows : 0;
+    if (lines < 0) {
+        uint64_t back = static_cast<uint64_t>(-lines);
+        m_top = m_top > back ? m_top - back : 0;
+    }
+    else {
+        m_top = std::min(m_top + static_cast<uint64_t>(lines), std::max(last, m_top));
+    }
+}
+
+bool FileViewer::AtEnd() const {
+    return m_index->Complete() && m_top + m_pageRows >= m_index->Lines();
+}
+
+void FileViewer::Materialize(uint64_t first, int count) {
+    count = std::max(count, 1);
+    m_pageRows = count;
+    bool complete = m_index->Complete();
+    uint64_t known = m_index->Lines();
+    if (first == m_windowFirst && m_window.size() == static_cast<size_t>(count) && m_windowFinal) return;
+
+    m_window.resize(count);
+    m_windowFirst = first;
+    m_windowLines = 0;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+    if (first < known && m_index->LineRange(first, begin, end)) {
+        // Seiten der vorherigen Anzeige aus dem Arbeitsspeicher entlassen (nicht bei jedem
+        // Aufruf fuer dieselbe Stelle, sonst muessten sie sofort neu geladen werden). Beim
+        // Seitenfehler blendet das System auch Nachbarseiten mit ein, daher etwas mehr.
+        if (m_windowEnd > m_windowBegin && (begin >= m_windowEnd || begin < m_windowBegin)) {
+            uint64_t from = m_windowBegin - std::min(m_windowBegin, RELEASE_SLACK);
+            m_file.Release(from, m_windowEnd + RELEASE_SLACK - from);
+        }
+        m_windowBegin = m_index->CheckpointOffset(first); // ab hier hat LineRange gelesen
+        // Folgezeilen schliessen direkt an, nur die erste braucht den Index
+        const char* data = m_file.Data();
+        for (int i = 0; i < count && first + i < known; ++i) {
+            if (i > 0) {
+                begin = end + 1;
+                end = static_cast<uint64_t>(FindNewline(data + begin, data + m_file.Size()) - data);
+            }
+            uint64_t length = std::min<uint64_t>(end - begin, MAX_LINE_BYTES);
+            DecodeTextLine(std::string_view(data + begin, static_cast<size_t>(length)), m_window[i]);
+            m_windowLines++;
+        }
+        m_windowEnd = end;
+    }
+    for (size_t i = m_windowLines; i < m_window.size(); ++i) m_window[i].clear();
+    m_windowFinal = complete || first + count <= known;
+}
+
+std::wstring_view FileViewer::Line(uint64_t line) const {
+    if (line < m_windowFirst || line - m_windowFirst >= m_windowLines) return std::wstring_view();
+    return m_window[static_cast<size_t>(line - m_windowFirst)];
+}
+
+std::wstring FileViewer::StatusText() const {
+    uint64_t known = m_index->Lines();
+    std::wstringstream ss;
+    ss << L"-- " << m_name << L" -- Zeilen ";
+    if (known == 0) ss << L"0";
+    else ss << m_top + 1 << L"-" << std::min<uint64_t>(m_top + m_pageRows, known);
+    ss << L" von " << known;
+    if (!m_index->Complete()) {
+        uint64_t percent = m_file.Size() ? m_index->ScannedBytes() * 100 / m_file.Size() : 100;
+        ss << L"+ (Index " << percent << L"%)";
+    }
+    ss << L" -- Bild auf/ab, Enter, Esc beendet --";
+    return ss.str();
+}
+
+size_t FileViewer::ResidentBytes() const {
+    size_t bytes = sizeof(*this) + (m_index ? m_index->ResidentBytes() : 0) + m_window.capacity() * sizeof(std::wstring);
+    for (const std::wstring& line : m_window) bytes += line.capacity() * sizeof(wchar_t);
+    return bytes;
+}
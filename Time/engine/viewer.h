@@ -0,0 +1,79 @@
+#pragma once
+
+#include "line_index.h"
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Seitenweise Anzeige einer Textdatei (TYPE) ohne sie in den Verlauf zu kopieren.
+ *
+ * Die Datei wird eingeblendet, der Zeilenindex entsteht im Hintergrund. Dekodiert werden nur
+ * die gerade sichtbaren Zeilen (Materialize), Oeffnen und Speicherbedarf haengen daher kaum von
+ * der Dateigroesse ab. Ohne gueltiges UTF-8 wird eine Zeile als Latin-1 gelesen (wie bisher
+ * std::wifstream unter Windows).
+ */
+class FileViewer {
+public:
+    static constexpr size_t MAX_LINE_BYTES = 4096; // laengere Zeilen werden abgeschnitten angezeigt
+    static constexpr uint64_t RELEASE_SLACK = 64 * 1024; // Linux "fault-around": 16 Nachbarseiten
+
+    // progress: siehe LineIndex, vom Indexthread aufgerufen.
+    bool Open(const std::wstring& path, const std::wstring& name, std::function<void()> progress, std::wstring& error);
+
+    const std::wstring& Name() const { return m_name; }
+
+    // Fortlaufende Nummer dieser Anzeige; unterscheidet gleiche Zeilennummern zweier Dateien.
+    uint32_t Generation() const { return m_generation; }
+
+    uint64_t TopLine() const { return m_top; }
+    uint64_t KnownLines() const { return m_index->Lines(); }
+    bool IndexComplete() const { return m_index->Complete(); }
+    void WaitForIndex() const { m_index->Wait(); }
+
+    // true, wenn sich der Index seit dem letzten Aufruf veraendert hat (Statuszeile neu zeichnen).
+    bool TakeProgress();
+
+    void ScrollBy(int64_t lines);
+    void PageUp() { ScrollBy(-static_cast<int64_t>(m_pageRows)); }
+    void PageDown() { ScrollBy(static_cast<int64_t>(m_pageRows)); }
+    bool AtEnd() const;
+
+    // Dekodiert die Zeilen [first, first + count) und merkt sich count als Seitengroesse.
+    void Materialize(uint64_t first, int count);
+
+    // Anzahl der tatsaechlich materialisierten Zeilen ab first (Dateiende, Index noch nicht so weit).
+    size_t MaterializedLines() const { return m_windowLines; }
+
+    // Zeile aus dem zuletzt materialisierten Bereich (sonst leer).
+    std::wstring_view Line(uint64_t line) const;
+
+    // Statuszeile, z.B. "-- log.txt -- Zeilen 1-24 von 1200 (100%) -- Bild auf/ab, Esc beendet --"
+    std::wstring StatusText() const;
+
+    size_t ResidentBytes() const;
+
+private:
+    MappedFile m_file;
+    std::unique_ptr<LineIndex> m_index;
+    std::wstring m_name;
+    uint32_t m_generation = 0;
+
+    uint64_t m_top = 0;
+    int m_pageRows = 24;
+    uint64_t m_reportedLines = 0;
+    bool m_reportedComplete = false;
+
+    // Materialisierte Zeilen
+    uint64_t m_windowFirst = 0;
+    uint64_t m_windowBegin = 0; // gelesener Bytebereich, wird beim Weiterblaettern freigegeben
+    uint64_t m_windowEnd = 0;
+    size_t m_windowLines = 0;
+    bool m_windowFinal = false; // alle angeforderten Zeilen waren bereits indiziert
+    std::vector<std::wstring> m_window;
+};
@@ -1,1077 +1,1547 @@
-#include "gui.h"
-
-// Spezifische Header für diese Implementierungsdatei
-#include <wininet.h>
-#include <iphlpapi.h>
-#include <icmpapi.h>
-#include <psapi.h>
-#include <tcpmib.h>
-#include <tlhelp32.h>
-#include <chrono>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
-#include <string>
-#include <vector>
-#include <algorithm>
-#include <cwctype>
-#include <cmath>
-#include <fstream>
-
-#pragma comment(lib, "wininet.lib")
-#pragma comment(lib, "iphlpapi.lib")
-#pragma comment(lib, "ws2_32.lib")
-
-// Handler für die benutzerdefinierte Schriftart
-HFONT g_hFont = NULL;
-
-// Countdown-Variablen
-int g_countdownSeconds = 10;
-bool g_countdownActive = false;
-bool g_isTypingEnabled = true;
-
-// Konsolen-Variablen
-std::wstring g_inputBuffer;
-std::vector<std::wstring> g_consoleHistory;
-const std::wstring PROMPT = L"C:\\> ";
-bool g_awaitingUpdateConfirmation = false;
-int g_scrollOffset = 0; // Für Scroll-Funktionalität
-
-// Konstante für PI
-const double PI = 3.14159265358979323846;
-
-// Hilfetext mit neuen Befehlen
-const std::wstring MSG_HELP =
-L"Verfuegbare Befehle:\n"
-L"  DATE           - Zeigt das aktuelle Datum an.\n"
-L"  TIME           - Zeigt die aktuelle Uhrzeit an.\n"
-L"  CLEAR / CLS    - Leert den Konsolenbildschirm.\n"
-L"  UPDATE         - Sucht und installiert automatisch Updates.\n"
-L"  EXIT           - Startet die Systemterminierung.\n"
-L"  HELP           - Zeigt diese Hilfe an.\n"
-L"  ECHO <text>    - Gibt den angegebenen Text aus.\n"
-L"  VER            - Zeigt die Version an.\n"
-L"  VOL            - Zeigt die Datentraegerbezeichnung an.\n"
-L"  DIR            - Listet den Inhalt des aktuellen Verzeichnisses auf.\n"
-L"  TYPE <file>    - Zeigt den Inhalt einer Textdatei an.\n"
-L"  HOSTNAME       - Zeigt den Computernamen an.\n"
-L"  WHOAMI         - Zeigt den aktuellen Benutzernamen an.\n"
-L"  UPTIME         - Zeigt die Systemlaufzeit an.\n\n"
-L"Netzwerk-Tools:\n"
-L"  PING <host>    - Sendet ICMP-Anfragen an einen Host.\n"
-L"  IPCONFIG       - Zeigt die Netzwerkkonfiguration an.\n"
-L"  NETSTAT        - Zeigt aktive TCP-Verbindungen an.\n\n"
-L"System-Tools:\n"
-L"  SYSTEMINFO     - Zeigt Systeminformationen an.\n"
-L"  TASKLIST       - Listet laufende Prozesse auf.\n\n"
-L"Mathematik & Konvertierung:\n"
-L"  SQRT, POW, LOG, LOG10, SIN, COS, TAN, HEX, DEC";
-
-
-// Hilfsfunktion zur Konvertierung von Grad in Radiant
-double DegToRad(double degrees) {
-    return degrees * PI / 180.0;
-}
-
-/**
- * Konvertiert einen String vollständig zu Großbuchstaben.
- */
-std::wstring ToUpper(const std::wstring& str) {
-    std::wstring s = str;
-    std::transform(s.begin(), s.end(), s.begin(),
-        [](wchar_t c) { return std::towupper(c); });
-    return s;
-}
-
-/**
- * Fügt eine oder mehrere Zeilen zum Konsolenverlauf hinzu und setzt den Scroll-Offset zurück.
- */
-void AddHistory(const std::wstring& text) {
-    std::wstringstream ss(text);
-    std::wstring line;
-    while (std::getline(ss, line, L'\n')) {
-        g_consoleHistory.push_back(line);
-    }
-    g_scrollOffset = 0; // Beim Hinzufügen neuer Inhalte nach unten scrollen
-}
-
-// *** NEUE BEFEHLSFUNKTIONEN ***
-
-void Ping(const std::wstring& host, HWND hWnd);
-void IpConfig(HWND hWnd);
-void TaskList(HWND hWnd);
-void SystemInfo(HWND hWnd);
-void Netstat(HWND hWnd);
-void Vol(HWND hWnd);
-void Dir(HWND hWnd);
-void Type(const std::wstring& filename, HWND hWnd);
-void Hostname(HWND hWnd);
-void Whoami(HWND hWnd);
-void Uptime(HWND hWnd);
-
-/**
- * IPCONFIG-Implementierung
- */
-void IpConfig(HWND hWnd) {
-    ULONG bufferSize = sizeof(IP_ADAPTER_INFO);
-    PIP_ADAPTER_INFO pAdapterInfo = (IP_ADAPTER_INFO*)malloc(bufferSize);
-    if (pAdapterInfo == NULL) {
-        AddHistory(L"FEHLER: Speicherzuweisung fehlgeschlagen.");
-        return;
-    }
-
-    if (GetAdaptersInfo(pAdapterInfo, &bufferSize) == ERROR_BUFFER_OVERFLOW) {
-        free(pAdapterInfo);
-        pAdapterInfo = (IP_ADAPTER_INFO*)malloc(bufferSize);
-        if (pAdapterInfo == NULL) {
-            AddHistory(L"FEHLER: Speicherzuweisung fehlgeschlagen.");
-            return;
-        }
-    }
-
-    if (GetAdaptersInfo(pAdapterInfo, &bufferSize) == NO_ERROR) {
-        AddHistory(L"Windows IP-Konfiguration");
-        PIP_ADAPTER_INFO pAdapter = pAdapterInfo;
-        while (pAdapter) {
-            std::string desc_s(pAdapter->Description);
-            std::string ip_s(pAdapter->IpAddressList.IpAddress.String);
-            std::string mask_s(pAdapter->IpAddressList.IpMask.String);
-            std::string gateway_s(pAdapter->GatewayList.IpAddress.String);
-
-            std::wstringstream ss;
-            ss << L"\nEthernet-Adapter " << std::wstring(desc_s.begin(), desc_s.end()) << L":\n";
-            ss << L"  IP-Adresse. . . . . . . . . . . : " << std::wstring(ip_s.begin(), ip_s.end()) << L"\n";
-            ss << L"  Subnetzmaske. . . . . . . . . . : " << std::wstring(mask_s.begin(), mask_s.end()) << L"\n";
-            ss << L"  Standardgateway . . . . . . . . : " << std::wstring(gateway_s.begin(), gateway_s.end());
-            AddHistory(ss.str());
-            pAdapter = pAdapter->Next;
-        }
-    }
-    else {
-        AddHistory(L"FEHLER: Netzwerkinformationen konnten nicht abgerufen werden.");
-    }
-
-    if (pAdapterInfo) {
-        free(pAdapterInfo);
-    }
-}
-
-void SystemInfo(HWND hWnd) {
-    SYSTEM_INFO sysInfo;
-    GetSystemInfo(&sysInfo);
-
-    OSVERSIONINFOEXW osInfo;
-    osInfo.dwOSVersionInfoSize = sizeof(OSVERSIONINFOEXW);
-#pragma warning(suppress : 4996)
-    GetVersionExW((LPOSVERSIONINFOW)&osInfo);
-
-    MEMORYSTATUSEX memStatus;
-    memStatus.dwLength = sizeof(memStatus);
-    GlobalMemoryStatusEx(&memStatus);
-
-    std::wstringstream ss;
-    ss << L"Systeminformationen:\n";
-    ss << L"  Betriebssystem: Windows (Version " << osInfo.dwMajorVersion << L"." << osInfo.dwMinorVersion << L")\n";
-    ss << L"  Prozessortyp: " << sysInfo.dwProcessorType << L"\n";
-    ss << L"  Anzahl der Prozessoren: " << sysInfo.dwNumberOfProcessors << L"\n";
-    ss << L"  Speicher (RAM): " << memStatus.ullTotalPhys / (1024 * 1024) << L" MB";
-    AddHistory(ss.str());
-}
-
-void TaskList(HWND hWnd) {
-    AddHistory(L"Abbildname              PID");
-    AddHistory(L"========================= ========");
-
-    HANDLE hProcessSnap;
-    PROCESSENTRY32W pe32;
-    hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-
-    if (hProcessSnap == INVALID_HANDLE_VALUE) {
-        AddHistory(L"FEHLER: Prozess-Snapshot konnte nicht erstellt werden.");
-        return;
-    }
-
-    pe32.dwSize = sizeof(PROCESSENTRY32W);
-
-    if (Process32FirstW(hProcessSnap, &pe32)) {
-        do {
-            std::wstringstream ss;
-            ss << std::left << std::setw(25) << pe32.szExeFile
-                << std::right << std::setw(8) << pe32.th32ProcessID;
-            AddHistory(ss.str());
-        } while (Process32NextW(hProcessSnap, &pe32));
-    }
-
-    CloseHandle(hProcessSnap);
-}
-
-const wchar_t* TcpStateToString(DWORD state) {
-    switch (state) {
-    case MIB_TCP_STATE_CLOSED: return L"CLOSED";
-    case MIB_TCP_STATE_LISTEN: return L"LISTEN";
-    case MIB_TCP_STATE_SYN_SENT: return L"SYN-SENT";
-    case MIB_TCP_STATE_SYN_RCVD: return L"SYN-RECEIVED";
-    case MIB_TCP_STATE_ESTAB: return L"ESTABLISHED";
-    case MIB_TCP_STATE_FIN_WAIT1: return L"FIN-WAIT-1";
-    case MIB_TCP_STATE_FIN_WAIT2: return L"FIN-WAIT-2";
-    case MIB_TCP_STATE_CLOSE_WAIT: return L"CLOSE-WAIT";
-    case MIB_TCP_STATE_CLOSING: return L"CLOSING";
-    case MIB_TCP_STATE_LAST_ACK: return L"LAST-ACK";
-    case MIB_TCP_STATE_TIME_WAIT: return L"TIME-WAIT";
-    case MIB_TCP_STATE_DELETE_TCB: return L"DELETE-TCB";
-    default: return L"UNKNOWN";
-    }
-}
-
-void Netstat(HWND hWnd) {
-    PMIB_TCPTABLE pTcpTable;
-    DWORD dwSize = 0;
-    wchar_t szLocalAddr[128];
-    wchar_t szRemoteAddr[128];
-    struct in_addr IpAddr;
-
-    pTcpTable = (MIB_TCPTABLE*)malloc(sizeof(MIB_TCPTABLE));
-    if (pTcpTable == NULL) {
-        AddHistory(L"FEHLER: Speicherzuweisung fehlgeschlagen.");
-        return;
-    }
-
-    if (GetTcpTable(pTcpTable, &dwSize, TRUE) == ERROR_INSUFFICIENT_BUFFER) {
-        free(pTcpTable);
-        pTcpTable = (MIB_TCPTABLE*)malloc(dwSize);
-        if (pTcpTable == NULL) {
-            AddHistory(L"FEHLER: Speicherzuweisung fehlgeschlagen.");
-            return;
-        }
-    }
-
-    if (GetTcpTable(pTcpTable, &dwSize, TRUE) == NO_ERROR) {
-        AddHistory(L"Aktive Verbindungen");
-        AddHistory(L"  Proto  Lokale Adresse         Remoteadresse          Status");
-
-        for (DWORD i = 0; i < pTcpTable->dwNumEntries; i++) {
-            IpAddr.S_un.S_addr = (u_long)pTcpTable->table[i].dwLocalAddr;
-            InetNtopW(AF_INET, &IpAddr, szLocalAddr, 128);
-
-            IpAddr.S_un.S_addr = (u_long)pTcpTable->table[i].dwRemoteAddr;
-            InetNtopW(AF_INET, &IpAddr, szRemoteAddr, 128);
-
-            std::wstringstream ss;
-            ss << L"  TCP    " << std::left << std::setw(21) << (std::wstring(szLocalAddr) + L":" + std::to_wstring(ntohs((u_short)pTcpTable->table[i].dwLocalPort)))
-                << std::left << std::setw(21) << (std::wstring(szRemoteAddr) + L":" + std::to_wstring(ntohs((u_short)pTcpTable->table[i].dwRemotePort)))
-                << TcpStateToString(pTcpTable->table[i].dwState);
-            AddHistory(ss.str());
-        }
-    }
-    else {
-        AddHistory(L"FEHLER: TCP-Tabelle konnte nicht abgerufen werden.");
-    }
-
-    if (pTcpTable != NULL) {
-        free(pTcpTable);
-    }
-}
-
-void Vol(HWND hWnd) {
-    wchar_t volumeName[MAX_PATH + 1] = { 0 };
-    wchar_t fileSystemName[MAX_PATH + 1] = { 0 };
-    DWORD serialNumber = 0;
-    DWORD maxComponentLen = 0;
-    DWORD fileSystemFlags = 0;
-
-    if (GetVolumeInformationW(L"C:\\", volumeName, ARRAYSIZE(volumeName), &serialNumber, &maxComponentLen, &fileSystemFlags, fileSystemName, ARRAYSIZE(fileSystemName))) {
-        std::wstringstream ss;
-        ss << L" Volume in Laufwerk C hat die Bezeichnung " << (wcslen(volumeName) > 0 ? volumeName : L"") << L".\n";
-        ss << L" Volumeseriennummer ist " << std::hex << std::uppercase << serialNumber;
-        AddHistory(ss.str());
-    }
-    else {
-        AddHistory(L"FEHLER: Volumeninformationen konnten nicht abgerufen werden.");
-    }
-}
-
-void Dir(HWND hWnd) {
-    wchar_t path[MAX_PATH];
-    GetModuleFileNameW(NULL, path, MAX_PATH);
-    *wcsrchr(path, L'\\') = L'\0';
-
-    std::wstring searchPath = std::wstring(path) + L"\\*";
-    WIN32_FIND_DATAW findData;
-    HANDLE hFind = FindFirstFileW(searchPath.c_str(), &findData);
-
-    if (hFind == INVALID_HANDLE_VALUE) {
-        AddHistory(L"FEHLER: Verzeichnisinhalt konnte nicht gelesen werden.");
-        return;
-    }
-
-    AddHistory(L" Inhalt von " + std::wstring(path));
-    do {
-        if (wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0) {
-            std::wstringstream ss;
-            if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-                ss << L"<DIR>    " << findData.cFileName;
-            }
-            else {
-                ss << L"         " << findData.cFileName;
-            }
-            AddHistory(ss.str());
-        }
-    } while (FindNextFileW(hFind, &findData) != 0);
-
-    FindClose(hFind);
-}
-
-void Type(const std::wstring& filename, HWND hWnd) {
-    wchar_t path[MAX_PATH];
-    GetModuleFileNameW(NULL, path, MAX_PATH);
-    *wcsrchr(path, L'\\') = L'\0';
-    std::wstring fullPath = std::wstring(path) + L"\\" + filename;
-
-    std::wifstream file(fullPath);
-    if (file.is_open()) {
-        std::wstring line;
-        while (getline(file, line)) {
-            AddHistory(line);
-        }
-        file.close();
-    }
-    else {
-        AddHistory(L"FEHLER: Datei nicht gefunden oder konnte nicht geoeffnet werden.");
-    }
-}
-
-void Hostname(HWND hWnd) {
-    wchar_t computerName[MAX_COMPUTERNAME_LENGTH + 1];
-    DWORD size = MAX_COMPUTERNAME_LENGTH + 1;
-    if (GetComputerNameW(computerName, &size)) {
-        AddHistory(computerName);
-    }
-    else {
-        AddHistory(L"FEHLER: Computername konnte nicht abgerufen werden.");
-    }
-}
-
-void Whoami(HWND hWnd) {
-    wchar_t userName[UNLEN + 1];
-    DWORD size = UNLEN + 1;
-    if (GetUserNameW(userName, &size)) {
-        AddHistory(userName);
-    }
-    else {
-        AddHistory(L"FEHLER: Benutzername konnte nicht abgerufen werden.");
-    }
-}
-
-void Uptime(HWND hWnd) {
-    ULONGLONG ticks = GetTickCount64();
-    ULONGLONG seconds = ticks / 1000;
-    ULONGLONG minutes = seconds / 60;
-    ULONGLONG hours = minutes / 60;
-    ULONGLONG days = hours / 24;
-
-    std::wstringstream ss;
-    ss << L"System-Uptime: " << days << L" Tage, "
-        << hours % 24 << L" Stunden, "
-        << minutes % 60 << L" Minuten, "
-        << seconds % 60 << L" Sekunden";
-    AddHistory(ss.str());
-}
-
-LRESULT CALLBACK BlackoutWindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
-    switch (message) {
-    case WM_ERASEBKGND:
-        // Verhindert ein Flackern und zeigt einen schwarzen Hintergrund
-        return TRUE;
-    case WM_PAINT: {
-        PAINTSTRUCT ps;
-        HDC hdc = BeginPaint(hWnd, &ps);
-        RECT clientRect;
-        GetClientRect(hWnd, &clientRect);
-
-        // Füllt das Fenster explizit mit einem schwarzen Pinsel
-        HBRUSH hBrush = (HBRUSH)GetStockObject(BLACK_BRUSH);
-        FillRect(hdc, &clientRect, hBrush);
-
-        EndPaint(hWnd, &ps);
-        break;
-    }
-    case WM_CLOSE:
-    case WM_DESTROY:
-        // Wir wollen nicht, dass diese Fenster die Anwendung beenden
-        break;
-    default:
-        return DefWindowProcW(hWnd, message, wParam, lParam);
-    }
-    return 0;
-}
-
-
-BOOL RegisterBlackoutWindowClass(HINSTANCE hInstance) {
-    WNDCLASSEXW wc = { 0 };
-    wc.cbSize = sizeof(WNDCLASSEXW);
-    wc.lpfnWndProc = BlackoutWindowProc;
-    wc.hInstance = hInstance;
-    wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-    wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH); // Stellt den schwarzen Hintergrund sicher
-    wc.lpszClassName = BLACKOUT_CLASS_NAME;
-    return (RegisterClassExW(&wc) != 0);
-}
-
-/**
- * Enum-Callback-Funktion, um fuer jeden erkannten Monitor (ausser dem Hauptmonitor)
- * ein schwarzes, randloses Fenster zu erstellen, um den Bildschirm abzudecken.
- */
-BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData) {
-    HWND hWndMain = *(HWND*)dwData;
-    MONITORINFOEX monitorInfo;
-    monitorInfo.cbSize = sizeof(monitorInfo);
-
-    if (GetMonitorInfo(hMonitor, &monitorInfo)) {
-        // Pruefen, ob es der Primaermonitor ist
-        if (!(monitorInfo.dwFlags & MONITORINFOF_PRIMARY)) {
-            // Dies ist ein Sekundaermonitor -> Erstelle ein abdeckendes Fenster
-
-            int x = monitorInfo.rcMonitor.left;
-            int y = monitorInfo.rcMonitor.top;
-            int width = monitorInfo.rcMonitor.right - monitorInfo.rcMonitor.left;
-            int height = monitorInfo.rcMonitor.bottom - monitorInfo.rcMonitor.top;
-
-            // Erstelle ein Fenster, das diesen Monitor abdeckt
-            CreateWindowExW(
-                WS_EX_TOPMOST,          // Immer im Vordergrund
-                BLACKOUT_CLASS_NAME,    // KORREKTUR: Verwende die dedizierte Blackout-Klasse
-                NULL,
-                WS_POPUP | WS_VISIBLE,  // Randlos und sichtbar
-                x, y, width, height,
-                hWndMain,               // Hauptfenster als Owner/Parent
-                NULL, NULL, NULL
-            );
-        }
-    }
-    return TRUE; // Weiter zur Aufzaehlung des naechsten Monitors
-}
-
-void CoverSecondaryMonitors(HWND hWndMain) {
-    EnumDisplayMonitors(NULL, NULL, MonitorEnumProc, (LPARAM)&hWndMain);
-}
-
-/**
- * PING-Implementierung
- */
-void Ping(const std::wstring& host, HWND hWnd) {
-    AddHistory(L"Pinging " + host + L"...");
-    UpdateClockDisplay(hWnd);
-
-    HANDLE hIcmpFile = IcmpCreateFile();
-    if (hIcmpFile == INVALID_HANDLE_VALUE) {
-        AddHistory(L"FEHLER: IcmpCreateFile fehlgeschlagen.");
-        return;
-    }
-
-    // Hostname zu IP-Adresse auflösen
-    ADDRINFOW* result = nullptr;
-    if (GetAddrInfoW(host.c_str(), NULL, NULL, &result) != 0) {
-        AddHistory(L"FEHLER: Host konnte nicht aufgeloest werden.");
-        IcmpCloseHandle(hIcmpFile);
-        return;
-    }
-
-    char sendData[32] = "Data Buffer";
-    DWORD replySize = sizeof(ICMP_ECHO_REPLY) + sizeof(sendData) + 8;
-    BYTE* replyBuffer = new BYTE[replySize];
-
-    SOCKADDR_IN* sockaddr_ipv4 = (struct sockaddr_in*)result->ai_addr;
-    IPAddr ipaddr = sockaddr_ipv4->sin_addr.S_un.S_addr;
-
-    for (int i = 0; i < 4; i++) {
-        DWORD dwRetVal = IcmpSendEcho(hIcmpFile, ipaddr, sendData, sizeof(sendData), NULL, replyBuffer, replySize, 1000);
-        if (dwRetVal != 0) {
-            PICMP_ECHO_REPLY pEchoReply = (PICMP_ECHO_REPLY)replyBuffer;
-            std::wstringstream ss;
-            // KORREKTUR: Konvertieren der IP-Adresse mit der modernen Funktion InetNtopW
-            IN_ADDR addr;
-            addr.S_un.S_addr = pEchoReply->Address;
-            wchar_t ip_wstr_buffer[INET_ADDRSTRLEN];
-
-            if (InetNtopW(AF_INET, &addr, ip_wstr_buffer, INET_ADDRSTRLEN)) {
-                ss << L"Antwort von " << ip_wstr_buffer << L": Zeit=" << pEchoReply->RoundTripTime << L"ms";
-                AddHistory(ss.str());
-            }
-        }
-        else {
-            AddHistory(L"Zeitueberschreitung der Anforderung.");
-        }
-        UpdateClockDisplay(hWnd);
-        Sleep(1000);
-    }
-
-    delete[] replyBuffer;
-    FreeAddrInfoW(result);
-    IcmpCloseHandle(hIcmpFile);
-}
-
-// ... Weitere neue Befehlsfunktionen wie IPCONFIG, TASKLIST, SYSTEMINFO etc. ...
-
-// *** INTELLIGENTE UPDATE-FUNKTIONEN ***
-
-void PerformUpdate(HWND hWnd) {
-    AddHistory(L"Update wird heruntergeladen...");
-    UpdateClockDisplay(hWnd);
-
-    HINTERNET hInternet = InternetOpen(L"ClockUpdater", INTERNET_OPEN_TYPE_DIRECT, NULL, NULL, 0);
-    if (!hInternet) {
-        AddHistory(L"FEHLER: Internetverbindung fehlgeschlagen (InternetOpen).");
-        return;
-    }
-
-    HINTERNET hUrl = InternetOpenUrlW(hInternet, L"http://wallbangbros.com/clock/time.exe", NULL, 0, INTERNET_FLAG_RELOAD | INTERNET_FLAG_PRAGMA_NOCACHE, 0);
-    if (!hUrl) {
-        AddHistory(L"FEHLER: Update-Server nicht erreichbar (InternetOpenUrl).");
-        InternetCloseHandle(hInternet);
-        return;
-    }
-
-    wchar_t localPath[MAX_PATH];
-    GetModuleFileNameW(NULL, localPath, MAX_PATH);
-    std::wstring tempPath = std::wstring(localPath) + L".tmp";
-    std::wstring oldPath = std::wstring(localPath) + L".old";
-
-    HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (hFile == INVALID_HANDLE_VALUE) {
-        AddHistory(L"FEHLER: Temporaere Update-Datei konnte nicht erstellt werden.");
-        InternetCloseHandle(hUrl); InternetCloseHandle(hInternet);
-        return;
-    }
-
-    BYTE buffer[4096];
-    DWORD bytesRead = 1;
-    BOOL downloadOk = TRUE;
-    while (InternetReadFile(hUrl, buffer, sizeof(buffer), &bytesRead) && bytesRead > 0) {
-        DWORD bytesWritten;
-        if (!WriteFile(hFile, buffer, bytesRead, &bytesWritten, NULL) || bytesWritten != bytesRead) {
-            AddHistory(L"FEHLER: Fehler beim Schreiben der Update-Datei.");
-            downloadOk = FALSE;
-            break;
-        }
-    }
-    CloseHandle(hFile);
-    InternetCloseHandle(hUrl);
-    InternetCloseHandle(hInternet);
-
-    if (!downloadOk) {
-        DeleteFileW(tempPath.c_str());
-        return;
-    }
-
-    DeleteFileW(oldPath.c_str());
-
-    if (!MoveFileW(localPath, oldPath.c_str())) {
-        AddHistory(L"FEHLER: Aktuelle Version konnte nicht umbenannt werden.");
-        DeleteFileW(tempPath.c_str());
-        return;
-    }
-
-    if (!MoveFileW(tempPath.c_str(), localPath)) {
-        AddHistory(L"FEHLER: Update konnte nicht aktiviert werden. Stelle alte Version wieder her.");
-        MoveFileW(oldPath.c_str(), localPath);
-        DeleteFileW(tempPath.c_str());
-        return;
-    }
-
-    AddHistory(L"Update erfolgreich! Die Anwendung wird jetzt neu gestartet...");
-    UpdateClockDisplay(hWnd);
-    Sleep(2000);
-
-    STARTUPINFOW si = { sizeof(si) };
-    PROCESS_INFORMATION pi;
-    if (CreateProcessW(localPath, NULL, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
-        DestroyWindow(hWnd);
-    }
-    else {
-        AddHistory(L"FEHLER: Neustart fehlgeschlagen. Bitte manuell neu starten.");
-    }
-}
-
-
-void CheckForUpdate(HWND hWnd) {
-    AddHistory(L"Suche nach Updates...");
-    UpdateClockDisplay(hWnd);
-
-    wchar_t localPath[MAX_PATH];
-    GetModuleFileNameW(NULL, localPath, MAX_PATH);
-    HANDLE hFile = CreateFileW(localPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (hFile == INVALID_HANDLE_VALUE) {
-        AddHistory(L"FEHLER: Lokale Datei konnte nicht gelesen werden.");
-        return;
-    }
-    DWORD localSize = GetFileSize(hFile, NULL);
-    CloseHandle(hFile);
-
-    HINTERNET hInternet = InternetOpen(L"ClockUpdater", INTERNET_OPEN_TYPE_DIRECT, NULL, NULL, 0);
-    if (!hInternet) {
-        AddHistory(L"FEHLER: Internetverbindung fehlgeschlagen.");
-        return;
-    }
-
-    HINTERNET hUrl = InternetOpenUrlW(hInternet, L"http://wallbangbros.com/clock/time.exe", NULL, 0, INTERNET_FLAG_RELOAD | INTERNET_FLAG_PRAGMA_NOCACHE, 0);
-    if (!hUrl) {
-        AddHistory(L"FEHLER: Update-Server nicht erreichbar.");
-        InternetCloseHandle(hInternet);
-        return;
-    }
-
-    wchar_t sizeBuffer[32] = { 0 };
-    DWORD sizeBufferLen = sizeof(sizeBuffer);
-    DWORD remoteSize = 0;
-
-    if (HttpQueryInfoW(hUrl, HTTP_QUERY_CONTENT_LENGTH, sizeBuffer, &sizeBufferLen, NULL)) {
-        remoteSize = _wtoi(sizeBuffer);
-    }
-    else {
-        AddHistory(L"FEHLER: Groesse der Update-Datei konnte nicht ermittelt werden.");
-        InternetCloseHandle(hUrl); InternetCloseHandle(hInternet);
-        return;
-    }
-
-    InternetCloseHandle(hUrl); InternetCloseHandle(hInternet);
-
-    if (remoteSize > 0 && remoteSize != localSize) {
-        AddHistory(L"Update gefunden!");
-        AddHistory(L"Moechten Sie jetzt aktualisieren? (Y/N)");
-        g_awaitingUpdateConfirmation = true;
-    }
-    else {
-        AddHistory(L"Ihre Version ist auf dem neuesten Stand.");
-    }
-}
-
-
-std::wstring GetCurrentTimeString() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm tm_buf;
-    if (localtime_s(&tm_buf, &now_c) != 0) return L"FEHLER";
-    std::wstringstream ss;
-    ss << std::put_time(&tm_buf, L"%H:%M:%S");
-    return ss.str();
-}
-
-std::wstring GetCurrentDateString() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm tm_buf;
-    if (localtime_s(&tm_buf, &now_c) != 0) return L"FEHLER";
-    std::wstringstream ss;
-    ss << std::put_time(&tm_buf, L"%d.%m.%Y");
-    return ss.str();
-}
-
-/**
- * Führt den eingegebenen Befehl aus und aktualisiert den Verlauf.
- */
-void ProcessCommand(HWND hWnd, const std::wstring& command) {
-    std::wstring trimmedCommand = command;
-    size_t end = trimmedCommand.find_last_not_of(L" \t\n\r\f\v");
-    if (end != std::wstring::npos) trimmedCommand.resize(end + 1);
-
-    if (g_awaitingUpdateConfirmation) {
-        std::wstring upperInput = ToUpper(trimmedCommand);
-        AddHistory(PROMPT + trimmedCommand);
-        if (upperInput == L"Y") {
-            PerformUpdate(hWnd);
-        }
-        else if (upperInput == L"N") {
-            AddHistory(L"Update abgebrochen.");
-        }
-        else {
-            AddHistory(L"Bitte 'Y' oder 'N' eingeben.");
-        }
-        g_awaitingUpdateConfirmation = false;
-        g_inputBuffer.clear(); UpdateClockDisplay(hWnd);
-        return;
-    }
-
-    AddHistory(PROMPT + trimmedCommand);
-    std::wstring upperCommand = ToUpper(trimmedCommand);
-
-    std::wstringstream iss(upperCommand);
-    std::wstringstream orig_iss(trimmedCommand);
-    std::wstring cmd, arg1, arg2;
-    iss >> cmd >> arg1 >> arg2;
-
-    if (cmd == L"HELP") {
-        AddHistory(MSG_HELP);
-    }
-    else if (cmd == L"DATE") {
-        AddHistory(L"Aktuelles Datum ist " + GetCurrentDateString());
-    }
-    else if (cmd == L"TIME") {
-        AddHistory(L"Aktuelle Zeit ist " + GetCurrentTimeString());
-    }
-    else if (cmd == L"CLEAR" || cmd == L"CLS") {
-        g_consoleHistory.clear();
-        g_scrollOffset = 0;
-    }
-    else if (cmd == L"UPDATE") {
-        CheckForUpdate(hWnd);
-    }
-    else if (cmd == L"EXIT") {
-        g_isTypingEnabled = false;
-        g_countdownActive = true;
-        AddHistory(L"EXIT.BAT: Terminierung gestartet. Bitte warten...");
-        SetTimer(hWnd, COUNTDOWN_TIMER_ID, 1000, NULL);
-    }
-    else if (cmd == L"PING") {
-        if (arg1.empty()) AddHistory(L"FEHLER: Hostname oder IP-Adresse erforderlich.");
-        else Ping(arg1, hWnd);
-    }
-    else if (cmd == L"IPCONFIG") {
-        IpConfig(hWnd);
-    }
-    else if (cmd == L"SYSTEMINFO") {
-        SystemInfo(hWnd);
-    }
-    else if (cmd == L"TASKLIST") {
-        TaskList(hWnd);
-    }
-    else if (cmd == L"NETSTAT") {
-        Netstat(hWnd);
-    }
-    else if (cmd == L"VOL") {
-        Vol(hWnd);
-    }
-    else if (cmd == L"DIR") {
-        Dir(hWnd);
-    }
-    else if (cmd == L"TYPE") {
-        if (arg1.empty()) AddHistory(L"FEHLER: Dateiname erforderlich.");
-        else Type(arg1, hWnd);
-    }
-    else if (cmd == L"HOSTNAME") {
-        Hostname(hWnd);
-    }
-    else if (cmd == L"WHOAMI") {
-        Whoami(hWnd);
-    }
-    else if (cmd == L"UPTIME") {
-        Uptime(hWnd);
-    }
-    else if (cmd == L"VER") {
-        AddHistory(L"Terminal Clock Version 1.1");
-    }
-    else if (cmd == L"ECHO") {
-        size_t echo_pos = trimmedCommand.find_first_of(L" \t");
-        if (echo_pos != std::wstring::npos) {
-            AddHistory(trimmedCommand.substr(echo_pos + 1));
-        }
-    }
-    else if (cmd == L"HEX") {
-        std::wstring dec_str;
-        orig_iss >> cmd >> dec_str;
-        if (dec_str.empty()) {
-            AddHistory(L"FEHLER: Fehlender Dezimal-Parameter.");
-        }
-        else {
-            try {
-                long long dec_val = std::stoll(dec_str);
-                std::wstringstream ss;
-                ss << std::hex << std::uppercase << dec_val;
-                AddHistory(dec_str + L" (DEC) = " + ss.str() + L" (HEX)");
-            }
-            catch (...) {
-                AddHistory(L"FEHLER: Ungueltige Dezimalzahl '" + dec_str + L"'.");
-            }
-        }
-    }
-    else if (cmd == L"DEC") {
-        std::wstring hex_str;
-        orig_iss >> cmd >> hex_str;
-        if (hex_str.empty()) {
-            AddHistory(L"FEHLER: Fehlender HEX-Parameter.");
-        }
-        else {
-            try {
-                long long dec_val;
-                std::wstringstream ss;
-                ss << std::hex << hex_str;
-                ss >> dec_val;
-                if (ss.fail()) throw std::runtime_error("Konvertierungsfehler");
-                AddHistory(hex_str + L" (HEX) = " + std::to_wstring(dec_val) + L" (DEC)");
-            }
-            catch (...) {
-                AddHistory(L"FEHLER: Ungueltiger HEX-String '" + hex_str + L"'.");
-            }
-        }
-    }
-    else {
-        try {
-            if (cmd == L"SQRT") {
-                if (arg1.empty()) throw std::runtime_error("Fehlender Parameter.");
-                double n = std::stod(arg1);
-                if (n < 0) throw std::runtime_error("Wurzel aus negativer Zahl nicht definiert.");
-                AddHistory(L"sqrt(" + arg1 + L") = " + std::to_wstring(sqrt(n)));
-            }
-            else if (cmd == L"POW") {
-                if (arg1.empty() || arg2.empty()) throw std::runtime_error("Zwei Parameter benoetigt.");
-                double base = std::stod(arg1);
-                double exp = std::stod(arg2);
-                AddHistory(arg1 + L"^" + arg2 + L" = " + std::to_wstring(pow(base, exp)));
-            }
-            else if (cmd == L"LOG") {
-                if (arg1.empty()) throw std::runtime_error("Fehlender Parameter.");
-                double n = std::stod(arg1);
-                if (n <= 0) throw std::runtime_error("Logarithmus nur fuer positive Zahlen definiert.");
-                AddHistory(L"ln(" + arg1 + L") = " + std::to_wstring(log(n)));
-            }
-            else if (cmd == L"LOG10") {
-                if (arg1.empty()) throw std::runtime_error("Fehlender Parameter.");
-                double n = std::stod(arg1);
-                if (n <= 0) throw std::runtime_error("Logarithmus nur fuer positive Zahlen definiert.");
-                AddHistory(L"log10(" + arg1 + L") = " + std::to_wstring(log10(n)));
-            }
-            else if (cmd == L"SIN" || cmd == L"COS" || cmd == L"TAN") {
-                if (arg1.empty()) throw std::runtime_error("Fehlender Winkel-Parameter (in Grad).");
-                double deg = std::stod(arg1);
-                double rad = DegToRad(deg);
-                double result;
-                if (cmd == L"SIN") result = sin(rad);
-                else if (cmd == L"COS") result = cos(rad);
-                else result = tan(rad);
-                AddHistory(cmd + L"(" + arg1 + L" deg) = " + std::to_wstring(result));
-            }
-            else if (!trimmedCommand.empty()) {
-                AddHistory(L"Ungueltiger Befehl oder Dateiname. Tippen Sie 'HELP'.");
-            }
-        }
-        catch (const std::exception& e) {
-            AddHistory(L"FEHLER: " + std::wstring(e.what(), e.what() + strlen(e.what())));
-        }
-        catch (...) {
-            AddHistory(L"FEHLER: Ungueltige numerische Eingabe.");
-        }
-    }
-
-    g_inputBuffer.clear();
-    UpdateClockDisplay(hWnd);
-}
-
-BOOL RegisterClockWindowClass(HINSTANCE hInstance) {
-
-    if (!RegisterBlackoutWindowClass(hInstance)) {
-        return FALSE;
-    }
-    WNDCLASSEXW wc = { 0 };
-    wc.cbSize = sizeof(WNDCLASSEXW);
-    wc.lpfnWndProc = ClockWindowProc;
-    wc.hInstance = hInstance;
-    wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-    wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
-    wc.lpszClassName = WINDOW_CLASS_NAME;
-    // Hier fügen Sie das Icon hinzu (nachdem Sie die Ressource erstellt haben)
-    // wc.hIcon = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_ICON1));
-    // wc.hIconSm = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_ICON1));
-    return (RegisterClassExW(&wc) != 0);
-}
-
-HWND CreateClockWindow(HINSTANCE hInstance, int nCmdShow) {
-    // Initialisiere Winsock
-    WSADATA wsaData;
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        // Fehlerbehandlung, z.B. eine Nachricht anzeigen und beenden
-        MessageBoxW(NULL, L"WSAStartup fehlgeschlagen", L"Fehler", MB_OK | MB_ICONERROR);
-        return NULL;
-    }
-
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-
-    g_consoleHistory.push_back(L"MS-DOS Version 6.22");
-    g_consoleHistory.push_back(L"(C)Copyright Microsoft Corporation 1981-1994.");
-    g_consoleHistory.push_back(L"Made with \x2764 by HUTAOSHUSBAND");
-    g_consoleHistory.push_back(L"");
-    g_consoleHistory.push_back(L"Tippen Sie 'HELP' fuer eine Liste der Befehle ein.");
-    g_consoleHistory.push_back(L"");
-
-    HWND hWnd = CreateWindowExW(
-        WS_EX_TOPMOST,
-        WINDOW_CLASS_NAME,
-        L"Windows 3.1 Terminal Clock",
-        WS_POPUP | WS_VISIBLE,
-        0, 0, screenWidth, screenHeight,
-        NULL, NULL, hInstance, NULL
-    );
-
-    if (hWnd) {
-        g_hFont = CreateFont(
-            screenHeight / 45, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
-            OEM_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
-            NONANTIALIASED_QUALITY, FF_MODERN | FIXED_PITCH, L"Terminal"
-        );
-        ShowWindow(hWnd, nCmdShow);
-        UpdateWindow(hWnd);
-        SetTimer(hWnd, CLOCK_TIMER_ID, 50, NULL);
-        CoverSecondaryMonitors(hWnd);
-    }
-    return hWnd;
-}
-
-void UpdateClockDisplay(HWND hWnd) {
-    InvalidateRect(hWnd, NULL, TRUE);
-}
-
-LRESULT CALLBACK ClockWindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
-    switch (message) {
-    case WM_CREATE:
-        break;
-
-    case WM_ERASEBKGND:
-        return TRUE;
-
-    case WM_CHAR: {
-        if (!g_isTypingEnabled) break;
-        if (wParam == VK_BACK) {
-            if (!g_inputBuffer.empty()) g_inputBuffer.pop_back();
-        }
-        else if (wParam == VK_ESCAPE) {
-            g_inputBuffer.clear();
-        }
-        else if (wParam >= 32 && wParam < 255) {
-            g_inputBuffer += (wchar_t)wParam;
-        }
-        UpdateClockDisplay(hWnd);
-        break;
-    }
-
-    case WM_KEYDOWN: {
-        if (wParam == VK_RETURN && g_isTypingEnabled) {
-            ProcessCommand(hWnd, g_inputBuffer);
-        }
-        // NEU: Scroll-Logik
-        else if (wParam == VK_PRIOR) { // Page Up
-            g_scrollOffset += 10;
-            if (!g_consoleHistory.empty() && g_scrollOffset > static_cast<int>(g_consoleHistory.size()) - 1) {
-                g_scrollOffset = g_consoleHistory.size() - 1;
-            }
-            UpdateClockDisplay(hWnd);
-        }
-        else if (wParam == VK_NEXT) { // Page Down
-            g_scrollOffset -= 10;
-            if (g_scrollOffset < 0) g_scrollOffset = 0;
-            UpdateClockDisplay(hWnd);
-        }
-        break;
-    }
-
-    case WM_SYSCOMMAND:
-        if (wParam == SC_CLOSE) {
-            if (!g_countdownActive) {
-                AddHistory(PROMPT + L"FEHLER: Diese Applikation kann nur durch den 'EXIT'-Befehl beendet werden.");
-                g_inputBuffer.clear();
-                UpdateClockDisplay(hWnd);
-                return 0;
-            }
-        }
-        break;
-
-    case WM_TIMER:
-        if (wParam == CLOCK_TIMER_ID) {
-            UpdateClockDisplay(hWnd);
-        }
-        else if (wParam == COUNTDOWN_TIMER_ID) {
-            if (g_countdownActive) {
-                if (g_countdownSeconds > 0) {
-                    g_countdownSeconds--;
-                    UpdateClockDisplay(hWnd);
-                }
-                if (g_countdownSeconds <= 0) {
-                    KillTimer(hWnd, COUNTDOWN_TIMER_ID);
-                    DestroyWindow(hWnd);
-                }
-            }
-        }
-        break;
-
-    case WM_PAINT: {
-        PAINTSTRUCT ps;
-        HDC hdc = BeginPaint(hWnd, &ps);
-        RECT clientRect;
-        GetClientRect(hWnd, &clientRect);
-
-        HBRUSH hBrush = (HBRUSH)GetStockObject(BLACK_BRUSH);
-        FillRect(hdc, &clientRect, hBrush);
-
-        SetTextColor(hdc, RGB(220, 220, 200));
-        SetBkMode(hdc, TRANSPARENT);
-
-        TEXTMETRIC tm;
-        HFONT hOldFont = (HFONT)SelectObject(hdc, g_hFont);
-        GetTextMetrics(hdc, &tm);
-        int lineHeight = tm.tmHeight + tm.tmExternalLeading;
-        int xPadding = 20;
-
-        int maxVisibleLines = clientRect.bottom / lineHeight;
-
-        // NEU: Scroll-Logik beim Zeichnen
-        size_t historySize = g_consoleHistory.size();
-        int endLine = static_cast<int>(historySize) - g_scrollOffset;
-        int startLine = endLine - (maxVisibleLines - 1);
-        if (startLine < 0) startLine = 0;
-
-
-        int currentLineY = lineHeight;
-
-        for (int i = startLine; i < endLine; ++i) {
-            if (i < 0 || static_cast<size_t>(i) >= historySize) continue; // KORREKTUR: Typsichere Prüfung
-            RECT rect = { xPadding, currentLineY, clientRect.right, currentLineY + lineHeight };
-            DrawTextW(hdc, g_consoleHistory[i].c_str(), -1, &rect, DT_LEFT | DT_TOP | DT_SINGLELINE | DT_NOCLIP);
-            currentLineY += lineHeight;
-        }
-
-        if (g_countdownActive) {
-            std::wstringstream shutdownSS;
-            if (g_countdownSeconds > 0) {
-                shutdownSS << L"EXIT.BAT: Terminierung in " << g_countdownSeconds << L" Sekunde(n)...";
-            }
-            else {
-                shutdownSS << L"EXIT.BAT: SYSTEM SHUTDOWN. Goodbye.";
-            }
-            RECT rect = { xPadding, currentLineY, clientRect.right, currentLineY + lineHeight };
-            DrawTextW(hdc, shutdownSS.str().c_str(), -1, &rect, DT_LEFT | DT_TOP | DT_SINGLELINE | DT_NOCLIP);
-        }
-        else if (g_scrollOffset == 0) { // Prompt nur anzeigen, wenn nicht gescrollt wird
-            std::wstring promptAndInput = PROMPT + g_inputBuffer;
-            if ((GetTickCount64() / 500) % 2 == 0) {
-                promptAndInput += L'_';
-            }
-            else {
-                promptAndInput += L' ';
-            }
-            RECT rect = { xPadding, currentLineY, clientRect.right, currentLineY + lineHeight };
-            DrawTextW(hdc, promptAndInput.c_str(), -1, &rect, DT_LEFT | DT_TOP | DT_SINGLELINE | DT_NOCLIP);
-        }
-
-        SelectObject(hdc, hOldFont);
-        EndPaint(hWnd, &ps);
-        break;
-    }
-
-    case WM_DESTROY:
-        KillTimer(hWnd, CLOCK_TIMER_ID);
-        KillTimer(hWnd, COUNTDOWN_TIMER_ID);
-        if (g_hFont) {
-            DeleteObject(g_hFont);
-            g_hFont = NULL;
-        }
-        // Winsock-Cleanup
-        WSACleanup();
-        PostQuitMessage(0);
-        break;
-
-    default:
-        return DefWindowProcW(hWnd, message, wParam, lParam);
-    }
-    return 0;
-}
-
+#include "gui.h"
+#include "engine/console.h"
+#include "engine/glyphs.h"
+#include "engine/perf.h"
+#include "engine/renderer.h"
+#include "engine/scheduler.h"
+#include "engine/screen.h"
+#include "engine/startup.h"
+
+// Spezifische Header für diese Implementierungsdatei
+#include <wininet.h>
+#include <iphlpapi.h>
+#include <icmpapi.h>
+#include <psapi.h>
+#include <tcpmib.h>
+#include <tlhelp32.h>
+#include <winioctl.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#pragma comment(lib, "wininet.lib")
+#pragma comment(lib, "iphlpapi.lib")
+#pragma comment(lib, "ws2_32.lib")
+
+// Handler für die benutzerdefinierte Schriftart
+HFONT g_hFont = NULL;
+
+// Doppelpuffer: Zeilen werden nur hier neu gezeichnet, WM_PAINT kopiert nur noch Pixel.
+// Der Puffer ist eine 32-Bit-DIB-Section, in deren Pixel der CellRenderer direkt schreibt.
+HDC g_backDC = NULL;
+HBITMAP g_backBitmap = NULL;
+HBITMAP g_oldBackBitmap = NULL;
+int g_backWidth = 0;
+int g_backHeight = 0;
+Framebuffer g_frame;
+
+// Glyphen der Fensterschrift, einmal per GDI gerastert
+std::unique_ptr<GlyphRasterizer> g_glyphRasterizer;
+std::unique_ptr<GlyphAtlas> g_glyphAtlas;
+std::unique_ptr<CellRenderer> g_renderer;
+
+// Zuletzt gezeichneter Bildschirminhalt und ob bereits ein Frame angefordert ist
+ScreenModel g_screen;
+bool g_framePending = false;
+
+// Termine (Cursor-Blinken, Countdown) auf Basis von GetTickCount64()
+TimerWheel g_timers(GetTickCount64());
+const ULONGLONG CURSOR_BLINK_MS = 500;
+const ULONGLONG COUNTDOWN_STEP_MS = 1000;
+TimerWheel::TimerId g_clockTimer = TimerWheel::INVALID_TIMER;
+
+// Beginn des Prozesses auf der steady_clock, damit STARTUP auch das Laden des Programms mitzählt
+StartupTrace::Clock::time_point ProcessStartTime() {
+    FILETIME creation, exitTime, kernel, user, now;
+    auto steadyNow = StartupTrace::Clock::now();
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) return steadyNow;
+    GetSystemTimePreciseAsFileTime(&now);
+    ULARGE_INTEGER a, b;
+    a.LowPart = creation.dwLowDateTime;
+    a.HighPart = creation.dwHighDateTime;
+    b.LowPart = now.dwLowDateTime;
+    b.HighPart = now.dwHighDateTime;
+    if (b.QuadPart < a.QuadPart) return steadyNow;
+    // FILETIME zählt in 100 ns
+    return steadyNow - std::chrono::microseconds((b.QuadPart - a.QuadPart) / 10);
+}
+
+// Fenster erzeugt, erstes Bild, eingabebereit (STARTUP)
+StartupTrace g_startup(ProcessStartTime());
+
+void ArmSchedulerTimer(HWND hWnd);
+void ScheduleBlink(HWND hWnd, ULONGLONG now);
+void ScheduleCountdownTick(HWND hWnd, ULONGLONG deadline);
+void ScheduleClockTick(HWND hWnd, ULONGLONG now);
+
+// *** NEUE BEFEHLSFUNKTIONEN ***
+
+void TaskList(JobContext& job);
+void SystemInfo(ConsoleEngine& console);
+void Vol(ConsoleEngine& console);
+std::wstring ProgramDirectory();
+void Type(const std::wstring& filename, ConsoleEngine& console);
+void Hostname(ConsoleEngine& console);
+void Whoami(ConsoleEngine& console);
+void Uptime(ConsoleEngine& console);
+
+void SystemInfo(ConsoleEngine& console) {
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+
+    // RtlGetVersion statt des veralteten GetVersionExW: liefert die echte Version, unabhängig
+    // vom Kompatibilitätsmanifest der Anwendung
+    RTL_OSVERSIONINFOW osInfo = {};
+    osInfo.dwOSVersionInfoSize = sizeof(osInfo);
+    using RtlGetVersionFunction = LONG(NTAPI*)(RTL_OSVERSIONINFOW*);
+    HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+    auto rtlGetVersion = ntdll ? reinterpret_cast<RtlGetVersionFunction>(GetProcAddress(ntdll, "RtlGetVersion")) : nullptr;
+    if (rtlGetVersion) rtlGetVersion(&osInfo);
+
+    MEMORYSTATUSEX memStatus;
+    memStatus.dwLength = sizeof(memStatus);
+    GlobalMemoryStatusEx(&memStatus);
+
+    auto table = std::make_shared<ResultTable>(ResultTable::Layout::List);
+    table->AddCaption(L"Systeminformationen:");
+    table->SetIndent(2);
+    size_t os = table->AddTextColumn(L"Betriebssystem");
+    size_t cpu = table->AddNumberColumn(L"Prozessortyp");
+    size_t count = table->AddNumberColumn(L"Anzahl der Prozessoren");
+    size_t memory = table->AddNumberColumn(L"Speicher (RAM)", L" MB");
+    table->AddRow();
+    table->Set(os, L"Windows (Version " + std::to_wstring(osInfo.dwMajorVersion) + L"." + std::to_wstring(osInfo.dwMinorVersion)
+        + L", Build " + std::to_wstring(osInfo.dwBuildNumber) + L")");
+    table->Set(cpu, static_cast<uint64_t>(sysInfo.dwProcessorType));
+    table->Set(count, static_cast<uint64_t>(sysInfo.dwNumberOfProcessors));
+    table->Set(memory, static_cast<uint64_t>(memStatus.ullTotalPhys / (1024 * 1024)));
+    console.AddTable(std::move(table));
+}
+
+void TaskList(JobContext& job) {
+    HANDLE hProcessSnap;
+    PROCESSENTRY32W pe32;
+    hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+
+    if (hProcessSnap == INVALID_HANDLE_VALUE) {
+        job.AddError(L"FEHLER: Prozess-Snapshot konnte nicht erstellt werden.");
+        return;
+    }
+
+    auto table = std::make_shared<ResultTable>();
+    size_t name = table->AddTextColumn(L"Abbildname");
+    size_t pid = table->AddNumberColumn(L"PID");
+    pe32.dwSize = sizeof(PROCESSENTRY32W);
+
+    if (Process32FirstW(hProcessSnap, &pe32)) {
+        do {
+            table->AddRow();
+            table->Set(name, pe32.szExeFile);
+            table->Set(pid, static_cast<uint64_t>(pe32.th32ProcessID));
+        } while (Process32NextW(hProcessSnap, &pe32));
+    }
+
+    CloseHandle(hProcessSnap);
+    job.AddTable(std::move(table));
+}
+
+/**
+ * NETSTAT-Quelle über die erweiterten Tabellen der IP-Hilfsbibliothek: TCP und UDP, jeweils
+ * IPv4 und IPv6, mit besitzendem Prozess. Der Puffer bleibt zwischen den Ständen erhalten
+ * (NETSTAT -r) und wächst nur, wenn eine Tabelle nicht hineinpasst.
+ */
+class IpHelperConnectionSource : public ConnectionSource {
+public:
+    bool Snapshot(std::vector<Connection>& connections, std::wstring& error) override {
+        connections.clear();
+        bool ok = false;
+        if (Fetch([this](DWORD* size) { return GetExtendedTcpTable(m_buffer.data(), size, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0); })) {
+            const auto* table = reinterpret_cast<const MIB_TCPTABLE_OWNER_PID*>(m_buffer.data());
+            for (DWORD i = 0; i < table->dwNumEntries; i++) {
+                const MIB_TCPROW_OWNER_PID& row = table->table[i];
+                Connection& c = Add(connections, NetProtocol::Tcp, 4, row.dwOwningPid);
+                memcpy(c.localAddress.data(), &row.dwLocalAddr, 4);
+                memcpy(c.remoteAddress.data(), &row.dwRemoteAddr, 4);
+                c.localPort = ntohs((u_short)row.dwLocalPort);
+                c.remotePort = ntohs((u_short)row.dwRemotePort);
+                c.state = static_cast<TcpState>(row.dwState <= MIB_TCP_STATE_DELETE_TCB ? row.dwState : 0);
+            }
+            ok = true;
+        }
+        if (Fetch([this](DWORD* size) { return GetExtendedTcpTable(m_buffer.data(), size, FALSE, AF_INET6, TCP_TABLE_OWNER_PID_ALL, 0); })) {
+            const auto* table = reinterpret_cast<const MIB_TCP6TABLE_OWNER_PID*>(m_buffer.data());
+            for (DWORD i = 0; i < table->dwNumEntries; i++) {
+                const MIB_TCP6ROW_OWNER_PID& row = table->table[i];
+                Connection& c = Add(connections, NetProtocol::Tcp, 6, row.dwOwningPid);
+                memcpy(c.localAddress.data(), row.ucLocalAddr, 16);
+                memcpy(c.remoteAddress.data(), row.ucRemoteAddr, 16);
+                c.localPort = ntohs((u_short)row.dwLocalPort);
+                c.remotePort = ntohs((u_short)row.dwRemotePort);
+                c.state = static_cast<TcpState>(row.dwState <= MIB_TCP_STATE_DELETE_TCB ? row.dwState : 0);
+            }
+            ok = true;
+        }
+        if (Fetch([this](DWORD* size) { return GetExtendedUdpTable(m_buffer.data(), size, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0); })) {
+            const auto* table = reinterpret_cast<const MIB_UDPTABLE_OWNER_PID*>(m_buffer.data());
+            for (DWORD i = 0; i < table->dwNumEntries; i++) {
+                const MIB_UDPROW_OWNER_PID& row = table->table[i];
+                Connection& c = Add(connections, NetProtocol::Udp, 4, row.dwOwningPid);
+                memcpy(c.localAddress.data(), &row.dwLocalAddr, 4);
+                c.localPort = ntohs((u_short)row.dwLocalPort);
+            }
+            ok = true;
+        }
+        if (Fetch([this](DWORD* size) { return GetExtendedUdpTable(m_buffer.data(), size, FALSE, AF_INET6, UDP_TABLE_OWNER_PID, 0); })) {
+            const auto* table = reinterpret_cast<const MIB_UDP6TABLE_OWNER_PID*>(m_buffer.data());
+            for (DWORD i = 0; i < table->dwNumEntries; i++) {
+                const MIB_UDP6ROW_OWNER_PID& row = table->table[i];
+                Connection& c = Add(connections, NetProtocol::Udp, 6, row.dwOwningPid);
+                memcpy(c.localAddress.data(), row.ucLocalAddr, 16);
+                c.localPort = ntohs((u_short)row.dwLocalPort);
+            }
+            ok = true;
+        }
+        if (!ok) error = L"TCP- und UDP-Tabellen konnten nicht abgerufen werden.";
+        return ok;
+    }
+
+private:
+    // Ruft query mit dem vorhandenen Puffer auf und vergrößert ihn, solange die Tabelle nicht
+    // hineinpasst (sie kann zwischen zwei Aufrufen wachsen).
+    template <typename Query>
+    bool Fetch(Query query) {
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            DWORD size = static_cast<DWORD>(m_buffer.size());
+            DWORD result = query(&size);
+            if (result == NO_ERROR) return true;
+            if (result != ERROR_INSUFFICIENT_BUFFER) return false;
+            m_buffer.resize(size + size / 4);
+        }
+        return false;
+    }
+
+    static Connection& Add(std::vector<Connection>& connections, NetProtocol protocol, uint8_t family, DWORD pid) {
+        Connection& c = connections.emplace_back();
+        c.protocol = protocol;
+        c.family = family;
+        c.pid = pid;
+        return c;
+    }
+
+    std::vector<uint8_t> m_buffer = std::vector<uint8_t>(64 * 1024);
+};
+
+/**
+ * IPCONFIG-Quelle: GetAdaptersAddresses liefert alle Adapter mit IPv4/IPv6-Adressen, Gateways,
+ * DNS-Servern und MTU in einem Aufruf. Änderungen melden NotifyIpInterfaceChange,
+ * NotifyUnicastIpAddressChange und NotifyRouteChange2 auf Threads des Systems; die Rückrufe
+ * setzen nur ein Flag, das WaitForChange abholt.
+ */
+class IpHelperConfigSource : public NetConfigSource {
+public:
+    IpHelperConfigSource() {
+        NotifyIpInterfaceChange(AF_UNSPEC, &IpHelperConfigSource::OnInterfaceChange, this, FALSE, &m_interfaceHandle);
+        NotifyUnicastIpAddressChange(AF_UNSPEC, &IpHelperConfigSource::OnAddressChange, this, FALSE, &m_addressHandle);
+        NotifyRouteChange2(AF_UNSPEC, &IpHelperConfigSource::OnRouteChange, this, FALSE, &m_routeHandle);
+    }
+
+    ~IpHelperConfigSource() override {
+        // CancelMibChangeNotify2 wartet, bis laufende Rückrufe beendet sind
+        if (m_interfaceHandle) CancelMibChangeNotify2(m_interfaceHandle);
+        if (m_addressHandle) CancelMibChangeNotify2(m_addressHandle);
+        if (m_routeHandle) CancelMibChangeNotify2(m_routeHandle);
+    }
+
+    bool Load(std::vector<NetAdapter>& adapters, std::wstring& error) override {
+        adapters.clear();
+        const ULONG flags = GAA_FLAG_INCLUDE_GATEWAYS | GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST;
+        ULONG result = ERROR_BUFFER_OVERFLOW;
+        for (int attempt = 0; attempt < 4 && result == ERROR_BUFFER_OVERFLOW; ++attempt) {
+            ULONG size = static_cast<ULONG>(m_buffer.size());
+            result = GetAdaptersAddresses(AF_UNSPEC, flags, NULL, reinterpret_cast<IP_ADAPTER_ADDRESSES*>(m_buffer.data()), &size);
+            if (result == ERROR_BUFFER_OVERFLOW) m_buffer.resize(size + size / 4);
+        }
+        if (result == ERROR_NO_DATA) return true;
+        if (result != NO_ERROR) {
+            error = L"Netzwerkinformationen konnten nicht abgerufen werden.";
+            return false;
+        }
+
+        for (const auto* info = reinterpret_cast<const IP_ADAPTER_ADDRESSES*>(m_buffer.data()); info; info = info->Next) {
+            NetAdapter& adapter = adapters.emplace_back();
+            adapter.index = info->IfIndex ? info->IfIndex : info->Ipv6IfIndex;
+            adapter.name = info->FriendlyName ? info->FriendlyName : L"";
+            adapter.description = info->Description ? info->Description : L"";
+            adapter.dnsSuffix = info->DnsSuffix ? info->DnsSuffix : L"";
+            adapter.up = info->OperStatus == IfOperStatusUp;
+            adapter.mtu = info->Mtu;
+            adapter.macLength = static_cast<uint8_t>(std::min<ULONG>(info->PhysicalAddressLength, static_cast<ULONG>(adapter.mac.size())));
+            memcpy(adapter.mac.data(), info->PhysicalAddress, adapter.macLength);
+            switch (info->IfType) {
+            case IF_TYPE_ETHERNET_CSMACD: adapter.kind = AdapterKind::Ethernet; break;
+            case IF_TYPE_IEEE80211: adapter.kind = AdapterKind::Wireless; break;
+            case IF_TYPE_SOFTWARE_LOOPBACK: adapter.kind = AdapterKind::Loopback; break;
+            case IF_TYPE_TUNNEL: adapter.kind = AdapterKind::Tunnel; break;
+            default: break;
+            }
+            for (const IP_ADAPTER_UNICAST_ADDRESS* address = info->FirstUnicastAddress; address; address = address->Next) {
+                NetAddress entry;
+                if (!Convert(address->Address, entry)) continue;
+                entry.prefixLength = address->OnLinkPrefixLength;
+                adapter.addresses.push_back(entry);
+            }
+            for (const IP_ADAPTER_GATEWAY_ADDRESS_LH* gateway = info->FirstGatewayAddress; gateway; gateway = gateway->Next) {
+                NetAddress entry;
+                if (Convert(gateway->Address, entry)) adapter.gateways.push_back(entry);
+            }
+            for (const IP_ADAPTER_DNS_SERVER_ADDRESS* server = info->FirstDnsServerAddress; server; server = server->Next) {
+                NetAddress entry;
+                if (Convert(server->Address, entry)) adapter.dnsServers.push_back(entry);
+            }
+        }
+        return true;
+    }
+
+    bool WaitForChange(std::chrono::milliseconds timeout) override {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_signal.wait_for(lock, timeout, [this] { return m_changed || m_interrupted; });
+        bool changed = m_changed && !m_interrupted;
+        m_changed = false;
+        m_interrupted = false;
+        return changed;
+    }
+
+    void Interrupt() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_interrupted = true;
+        m_signal.notify_all();
+    }
+
+private:
+    static bool Convert(const SOCKET_ADDRESS& address, NetAddress& entry) {
+        if (!address.lpSockaddr) return false;
+        if (address.lpSockaddr->sa_family == AF_INET) {
+            entry.family = 4;
+            memcpy(entry.bytes.data(), &reinterpret_cast<const sockaddr_in*>(address.lpSockaddr)->sin_addr, 4);
+            return true;
+        }
+        if (address.lpSockaddr->sa_family == AF_INET6) {
+            entry.family = 6;
+            memcpy(entry.bytes.data(), &reinterpret_cast<const sockaddr_in6*>(address.lpSockaddr)->sin6_addr, 16);
+            return true;
+        }
+        return false;
+    }
+
+    void Signal() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_changed = true;
+        m_signal.notify_all();
+    }
+
+    static VOID NETIOAPI_API_ OnInterfaceChange(PVOID context, PMIB_IPINTERFACE_ROW, MIB_NOTIFICATION_TYPE) {
+        static_cast<IpHelperConfigSource*>(context)->Signal();
+    }
+    static VOID NETIOAPI_API_ OnAddressChange(PVOID context, PMIB_UNICASTIPADDRESS_ROW, MIB_NOTIFICATION_TYPE) {
+        static_cast<IpHelperConfigSource*>(context)->Signal();
+    }
+    static VOID NETIOAPI_API_ OnRouteChange(PVOID context, PMIB_IPFORWARD_ROW2, MIB_NOTIFICATION_TYPE) {
+        static_cast<IpHelperConfigSource*>(context)->Signal();
+    }
+
+    std::vector<uint8_t> m_buffer = std::vector<uint8_t>(16 * 1024);
+    std::mutex m_mutex;
+    std::condition_variable m_signal;
+    bool m_changed = false;
+    bool m_interrupted = false;
+    HANDLE m_interfaceHandle = NULL;
+    HANDLE m_addressHandle = NULL;
+    HANDLE m_routeHandle = NULL;
+};
+
+/**
+ * TOP unter Windows: NtQuerySystemInformation(SystemProcessInformation) liefert alle Prozesse
+ * mit CPU-Zeiten, Arbeitssatz, Threads und Handles in einem einzigen Aufruf, ohne jeden Prozess
+ * öffnen zu müssen. Die Funktion wird zur Laufzeit aus ntdll.dll geladen.
+ */
+class NtProcessSampler : public ProcessSampler {
+public:
+    NtProcessSampler() {
+        HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        if (ntdll) m_query = reinterpret_cast<QueryFunction>(GetProcAddress(ntdll, "NtQuerySystemInformation"));
+    }
+
+    bool Sample(std::vector<ProcessSample>& samples, std::wstring& error) override {
+        samples.clear();
+        if (!m_query) {
+            error = L"NtQuerySystemInformation ist nicht verfügbar.";
+            return false;
+        }
+        LONG status = STATUS_INFO_LENGTH_MISMATCH;
+        for (int attempt = 0; attempt < 4 && status == STATUS_INFO_LENGTH_MISMATCH; ++attempt) {
+            ULONG size = 0;
+            status = m_query(SYSTEM_PROCESS_INFORMATION_CLASS, m_buffer.data(), static_cast<ULONG>(m_buffer.size()), &size);
+            if (status == STATUS_INFO_LENGTH_MISMATCH) m_buffer.resize(std::max<size_t>(size, m_buffer.size()) + size / 4);
+        }
+        if (status < 0) {
+            error = L"Prozessliste konnte nicht abgerufen werden.";
+            return false;
+        }
+
+        size_t offset = 0;
+        for (;;) {
+            const auto* info = reinterpret_cast<const ProcessInformation*>(m_buffer.data() + offset);
+            uint32_t pid = static_cast<uint32_t>(reinterpret_cast<ULONG_PTR>(info->UniqueProcessId));
+            if (pid != 0) { // Leerlaufprozess: seine "Last" ist die freie Rechenzeit
+                ProcessSample& sample = samples.emplace_back();
+                sample.pid = pid;
+                sample.threads = info->NumberOfThreads;
+                sample.handles = info->HandleCount;
+                sample.startTime = static_cast<uint64_t>(info->CreateTime.QuadPart);
+                sample.cpuMicros = static_cast<uint64_t>(info->UserTime.QuadPart + info->KernelTime.QuadPart) / 10;
+                sample.workingSetBytes = info->WorkingSetSize;
+                if (info->ImageName.Buffer) sample.SetName(info->ImageName.Buffer, info->ImageName.Length / sizeof(wchar_t));
+                else sample.SetName(L"System", 6);
+            }
+            if (info->NextEntryOffset == 0) break;
+            offset += info->NextEntryOffset;
+        }
+        return true;
+    }
+
+private:
+    static constexpr ULONG SYSTEM_PROCESS_INFORMATION_CLASS = 5;
+    static constexpr LONG STATUS_INFO_LENGTH_MISMATCH = static_cast<LONG>(0xC0000004L);
+
+    // Anfang von SYSTEM_PROCESS_INFORMATION; winternl.h deklariert die meisten Felder nur als Reserved.
+    struct ProcessInformation {
+        ULONG NextEntryOffset;
+        ULONG NumberOfThreads;
+        LARGE_INTEGER WorkingSetPrivateSize;
+        ULONG HardFaultCount;
+        ULONG NumberOfThreadsHighWatermark;
+        ULONGLONG CycleTime;
+        LARGE_INTEGER CreateTime;
+        LARGE_INTEGER UserTime;
+        LARGE_INTEGER KernelTime;
+        struct {
+            USHORT Length;
+            USHORT MaximumLength;
+            PWSTR Buffer;
+        } ImageName;
+        LONG BasePriority;
+        HANDLE UniqueProcessId;
+        HANDLE InheritedFromUniqueProcessId;
+        ULONG HandleCount;
+        ULONG SessionId;
+        ULONG_PTR UniqueProcessKey;
+        SIZE_T PeakVirtualSize;
+        SIZE_T VirtualSize;
+        ULONG PageFaultCount;
+        SIZE_T PeakWorkingSetSize;
+        SIZE_T WorkingSetSize;
+    };
+
+    using QueryFunction = LONG(NTAPI*)(ULONG, PVOID, ULONG, PULONG);
+
+    QueryFunction m_query = nullptr;
+    std::vector<uint8_t> m_buffer = std::vector<uint8_t>(512 * 1024);
+};
+
+/**
+ * SYSTEMINFO /WATCH unter Windows. Pro Stichprobe ein Aufruf je Quelle:
+ * NtQuerySystemInformation(SystemProcessorPerformanceInformation) für alle Kerne,
+ * GlobalMemoryStatusEx, IOCTL_DISK_PERFORMANCE je physischem Datenträger (Handles bleiben offen)
+ * und GetIfTable2 für die Netzwerkzähler.
+ */
+class NtSystemSampler : public SystemSampler {
+public:
+    NtSystemSampler() {
+        HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        if (ntdll) m_query = reinterpret_cast<QueryFunction>(GetProcAddress(ntdll, "NtQuerySystemInformation"));
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        m_processors.resize(std::max<DWORD>(info.dwNumberOfProcessors, 1));
+        // Zugriff 0 genügt für IOCTL_DISK_PERFORMANCE und braucht keine Administratorrechte
+        for (int i = 0; i < 16; ++i) {
+            wchar_t path[32];
+            swprintf(path, 32, L"\\\\.\\PhysicalDrive%d", i);
+            HANDLE disk = CreateFileW(path, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+            if (disk != INVALID_HANDLE_VALUE) m_disks.push_back(disk);
+        }
+    }
+
+    ~NtSystemSampler() override {
+        for (HANDLE disk : m_disks) CloseHandle(disk);
+    }
+
+    bool Sample(SystemSample& sample, std::wstring& error) override {
+        ULONG size = 0;
+        if (!m_query || m_query(SYSTEM_PROCESSOR_PERFORMANCE_CLASS, m_processors.data(),
+            static_cast<ULONG>(m_processors.size() * sizeof(ProcessorPerformance)), &size) < 0) {
+            error = L"Prozessorzeiten konnten nicht abgerufen werden.";
+            return false;
+        }
+        size_t count = std::min<size_t>(size / sizeof(ProcessorPerformance), m_processors.size());
+        sample.cores.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            // KernelTime enthält die Leerlaufzeit
+            const ProcessorPerformance& cpu = m_processors[i];
+            uint64_t total = static_cast<uint64_t>(cpu.KernelTime.QuadPart + cpu.UserTime.QuadPart);
+            sample.cores[i].total = total;
+            sample.cores[i].busy = total - static_cast<uint64_t>(cpu.IdleTime.QuadPart);
+        }
+
+        MEMORYSTATUSEX memory;
+        memory.dwLength = sizeof(memory);
+        if (GlobalMemoryStatusEx(&memory)) {
+            sample.commitBytes = memory.ullTotalPageFile - memory.ullAvailPageFile;
+            sample.commitLimitBytes = memory.ullTotalPageFile;
+            sample.availableBytes = memory.ullAvailPhys;
+            sample.totalBytes = memory.ullTotalPhys;
+        }
+
+        sample.diskReadBytes = sample.diskWriteBytes = 0;
+        for (HANDLE disk : m_disks) {
+            DISK_PERFORMANCE performance;
+            DWORD bytes = 0;
+            if (!DeviceIoControl(disk, IOCTL_DISK_PERFORMANCE, NULL, 0, &performance, sizeof(performance), &bytes, NULL)) continue;
+            sample.diskReadBytes += static_cast<uint64_t>(performance.BytesRead.QuadPart);
+            sample.diskWriteBytes += static_cast<uint64_t>(performance.BytesWritten.QuadPart);
+        }
+
+        // Nur Hardware-Schnittstellen: Filter und virtuelle Adapter zählen sonst doppelt
+        sample.netReceivedBytes = sample.netSentBytes = 0;
+        MIB_IF_TABLE2* table = NULL;
+        if (GetIfTable2(&table) == NO_ERROR) {
+            for (ULONG i = 0; i < table->NumEntries; i++) {
+                const MIB_IF_ROW2& row = table->Table[i];
+                if (row.Type == IF_TYPE_SOFTWARE_LOOPBACK || !row.InterfaceAndOperStatusFlags.HardwareInterface) continue;
+                sample.netReceivedBytes += row.InOctets;
+                sample.netSentBytes += row.OutOctets;
+            }
+            FreeMibTable(table);
+        }
+        return true;
+    }
+
+    uint64_t ThreadCpuMicros() override {
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) return 0;
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        return (k.QuadPart + u.QuadPart) / 10;
+    }
+
+private:
+    static constexpr ULONG SYSTEM_PROCESSOR_PERFORMANCE_CLASS = 8;
+
+    // SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION
+    struct ProcessorPerformance {
+        LARGE_INTEGER IdleTime;
+        LARGE_INTEGER KernelTime;
+        LARGE_INTEGER UserTime;
+        LARGE_INTEGER Reserved1[2];
+        ULONG Reserved2;
+    };
+
+    using QueryFunction = LONG(NTAPI*)(ULONG, PVOID, ULONG, PULONG);
+
+    QueryFunction m_query = nullptr;
+    std::vector<ProcessorPerformance> m_processors;
+    std::vector<HANDLE> m_disks;
+};
+
+void Vol(ConsoleEngine& console) {
+    wchar_t volumeName[MAX_PATH + 1] = { 0 };
+    wchar_t fileSystemName[MAX_PATH + 1] = { 0 };
+    DWORD serialNumber = 0;
+    DWORD maxComponentLen = 0;
+    DWORD fileSystemFlags = 0;
+
+    if (GetVolumeInformationW(L"C:\\", volumeName, ARRAYSIZE(volumeName), &serialNumber, &maxComponentLen, &fileSystemFlags, fileSystemName, ARRAYSIZE(fileSystemName))) {
+        std::wstringstream ss;
+        ss << L" Volume in Laufwerk C hat die Bezeichnung " << (wcslen(volumeName) > 0 ? volumeName : L"") << L".\n";
+        ss << L" Volumeseriennummer ist " << std::hex << std::uppercase << serialNumber;
+        console.AddHistory(ss.str());
+    }
+    else {
+        console.AddError(L"FEHLER: Volumeninformationen konnten nicht abgerufen werden.");
+    }
+}
+
+// Verzeichnis der Programmdatei; Bezug für DIR, TREE, DU und TYPE
+std::wstring ProgramDirectory() {
+    wchar_t path[MAX_PATH];
+    GetModuleFileNameW(NULL, path, MAX_PATH);
+    *wcsrchr(path, L'\\') = L'\0';
+    return path;
+}
+
+void Type(const std::wstring& filename, ConsoleEngine& console) {
+    std::wstring fullPath = ProgramDirectory() + L"\\" + filename;
+
+    // Eingeblendet und seitenweise angezeigt statt Zeile fuer Zeile in den Verlauf kopiert
+    console.ViewFile(fullPath, filename);
+}
+
+void Hostname(ConsoleEngine& console) {
+    wchar_t computerName[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD size = MAX_COMPUTERNAME_LENGTH + 1;
+    if (GetComputerNameW(computerName, &size)) {
+        console.AddHistory(computerName);
+    }
+    else {
+        console.AddError(L"FEHLER: Computername konnte nicht abgerufen werden.");
+    }
+}
+
+void Whoami(ConsoleEngine& console) {
+    wchar_t userName[UNLEN + 1];
+    DWORD size = UNLEN + 1;
+    if (GetUserNameW(userName, &size)) {
+        console.AddHistory(userName);
+    }
+    else {
+        console.AddError(L"FEHLER: Benutzername konnte nicht abgerufen werden.");
+    }
+}
+
+void Uptime(ConsoleEngine& console) {
+    ULONGLONG ticks = GetTickCount64();
+    ULONGLONG seconds = ticks / 1000;
+    ULONGLONG minutes = seconds / 60;
+    ULONGLONG hours = minutes / 60;
+    ULONGLONG days = hours / 24;
+
+    std::wstringstream ss;
+    ss << L"System-Uptime: " << days << L" Tage, "
+        << hours % 24 << L" Stunden, "
+        << minutes % 60 << L" Minuten, "
+        << seconds % 60 << L" Sekunden";
+    console.AddHistory(ss.str());
+}
+
+LRESULT CALLBACK BlackoutWindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
+    switch (message) {
+    case WM_ERASEBKGND:
+        // Verhindert ein Flackern und zeigt einen schwarzen Hintergrund
+        return TRUE;
+    case WM_PAINT: {
+        PerfSpan span(L"WM_PAINT");
+        PAINTSTRUCT ps;
+        HDC hdc = BeginPaint(hWnd, &ps);
+        RECT clientRect;
+        GetClientRect(hWnd, &clientRect);
+
+        // Füllt das Fenster explizit mit einem schwarzen Pinsel
+        HBRUSH hBrush = (HBRUSH)GetStockObject(BLACK_BRUSH);
+        FillRect(hdc, &clientRect, hBrush);
+
+        EndPaint(hWnd, &ps);
+        break;
+    }
+    case WM_CLOSE:
+    case WM_DESTROY:
+        // Wir wollen nicht, dass diese Fenster die Anwendung beenden
+        break;
+    default:
+        return DefWindowProcW(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
+
+BOOL RegisterBlackoutWindowClass(HINSTANCE hInstance) {
+    WNDCLASSEXW wc = { 0 };
+    wc.cbSize = sizeof(WNDCLASSEXW);
+    wc.lpfnWndProc = BlackoutWindowProc;
+    wc.hInstance = hInstance;
+    wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+    wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH); // Stellt den schwarzen Hintergrund sicher
+    wc.lpszClassName = BLACKOUT_CLASS_NAME;
+    return (RegisterClassExW(&wc) != 0);
+}
+
+/**
+ * Enum-Callback-Funktion, um fuer jeden erkannten Monitor (ausser dem Hauptmonitor)
+ * ein schwarzes, randloses Fenster zu erstellen, um den Bildschirm abzudecken.
+ */
+BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData) {
+    HWND hWndMain = *(HWND*)dwData;
+    MONITORINFOEX monitorInfo;
+    monitorInfo.cbSize = sizeof(monitorInfo);
+
+    if (GetMonitorInfo(hMonitor, &monitorInfo)) {
+        // Pruefen, ob es der Primaermonitor ist
+        if (!(monitorInfo.dwFlags & MONITORINFOF_PRIMARY)) {
+            // Dies ist ein Sekundaermonitor -> Erstelle ein abdeckendes Fenster
+
+            int x = monitorInfo.rcMonitor.left;
+            int y = monitorInfo.rcMonitor.top;
+            int width = monitorInfo.rcMonitor.right - monitorInfo.rcMonitor.left;
+            int height = monitorInfo.rcMonitor.bottom - monitorInfo.rcMonitor.top;
+
+            // Erstelle ein Fenster, das diesen Monitor abdeckt
+            CreateWindowExW(
+                WS_EX_TOPMOST,          // Immer im Vordergrund
+                BLACKOUT_CLASS_NAME,    // KORREKTUR: Verwende die dedizierte Blackout-Klasse
+                NULL,
+                WS_POPUP | WS_VISIBLE,  // Randlos und sichtbar
+                x, y, width, height,
+                hWndMain,               // Hauptfenster als Owner/Parent
+                NULL, NULL, NULL
+            );
+        }
+    }
+    return TRUE; // Weiter zur Aufzaehlung des naechsten Monitors
+}
+
+void CoverSecondaryMonitors(HWND hWndMain) {
+    EnumDisplayMonitors(NULL, NULL, MonitorEnumProc, (LPARAM)&hWndMain);
+}
+
+/**
+ * Netzwerkdienste werden erst beim ersten PING eingerichtet statt beim Programmstart: Winsock
+ * einmalig, ICMP-Handles kommen aus einem Pool je Adressfamilie und aufgeloeste Adressen
+ * bleiben ADDRESS_TTL lang im Cache (fehlgeschlagene Aufloesungen nicht). PING-Jobs laufen auf
+ * den Arbeitsthreads, daher ist alles per Mutex geschuetzt.
+ */
+class NetworkServices {
+public:
+    static constexpr size_t MAX_POOLED_HANDLES = 4; // je Adressfamilie
+    static constexpr std::chrono::seconds ADDRESS_TTL{ 60 };
+
+    bool EnsureWinsock(std::wstring& error) {
+        std::call_once(m_winsockOnce, [this]() {
+            WSADATA wsaData;
+            m_winsockStarted = WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+        });
+        if (!m_winsockStarted) error = L"WSAStartup fehlgeschlagen.";
+        return m_winsockStarted;
+    }
+
+    bool Resolve(const std::wstring& host, int family, SOCKADDR_STORAGE& target, int& targetFamily, std::wstring& error) {
+        if (!EnsureWinsock(error)) return false;
+        std::wstring key = std::to_wstring(family) + L"|" + host;
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_addresses.find(key);
+            if (it != m_addresses.end() && it->second.expires > now) {
+                target = it->second.address;
+                targetFamily = it->second.family;
+                return true;
+            }
+        }
+
+        // Hostname zu IPv4- oder IPv6-Adresse aufloesen, die Adressfamilie bestimmt die ICMP-Variante
+        ADDRINFOW hints = {};
+        hints.ai_family = family == 4 ? AF_INET : family == 6 ? AF_INET6 : AF_UNSPEC;
+        ADDRINFOW* result = nullptr;
+        if (GetAddrInfoW(host.c_str(), NULL, &hints, &result) != 0 || result == nullptr) {
+            error = L"Host '" + host + L"' konnte nicht aufgeloest werden.";
+            return false;
+        }
+        target = {};
+        targetFamily = result->ai_family;
+        memcpy(&target, result->ai_addr, std::min<size_t>(result->ai_addrlen, sizeof(target)));
+        FreeAddrInfoW(result);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_addresses[key] = { target, targetFamily, now + ADDRESS_TTL };
+        return true;
+    }
+
+    HANDLE AcquireIcmp(int family) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<HANDLE>& pool = Pool(family);
+            if (!pool.empty()) {
+                HANDLE handle = pool.back();
+                pool.pop_back();
+                return handle;
+            }
+        }
+        return family == AF_INET6 ? Icmp6CreateFile() : IcmpCreateFile();
+    }
+
+    void ReleaseIcmp(int family, HANDLE handle) {
+        if (handle == INVALID_HANDLE_VALUE) return;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<HANDLE>& pool = Pool(family);
+            if (pool.size() < MAX_POOLED_HANDLES) {
+                pool.push_back(handle);
+                return;
+            }
+        }
+        IcmpCloseHandle(handle);
+    }
+
+    // Beim Beenden, nachdem alle Arbeitsthreads fertig sind
+    void Shutdown() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (HANDLE handle : m_icmp4) IcmpCloseHandle(handle);
+        for (HANDLE handle : m_icmp6) IcmpCloseHandle(handle);
+        m_icmp4.clear();
+        m_icmp6.clear();
+        m_addresses.clear();
+        if (m_winsockStarted) {
+            WSACleanup();
+            m_winsockStarted = false;
+        }
+    }
+
+private:
+    struct CachedAddress {
+        SOCKADDR_STORAGE address;
+        int family;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    std::vector<HANDLE>& Pool(int family) { return family == AF_INET6 ? m_icmp6 : m_icmp4; }
+
+    std::once_flag m_winsockOnce;
+    bool m_winsockStarted = false;
+    std::mutex m_mutex;
+    std::vector<HANDLE> m_icmp4;
+    std::vector<HANDLE> m_icmp6;
+    std::map<std::wstring, CachedAddress> m_addresses;
+};
+
+NetworkServices g_network;
+
+/**
+ * PING ueber die ICMP-Hilfsfunktionen: IcmpSendEcho fuer IPv4, Icmp6SendEcho2 fuer IPv6.
+ * Optionen, Statistik und Ausgabe uebernimmt RunPing (engine/ping.cpp).
+ */
+class IcmpPingProber : public PingProber {
+public:
+    ~IcmpPingProber() override {
+        g_network.ReleaseIcmp(m_family, m_icmp);
+    }
+
+    bool Open(const std::wstring& host, int family, std::wstring& address, std::wstring& error) override {
+        if (!g_network.Resolve(host, family, m_target, m_family, error)) return false;
+
+        m_icmp = g_network.AcquireIcmp(m_family);
+        if (m_icmp == INVALID_HANDLE_VALUE) {
+            error = L"IcmpCreateFile fehlgeschlagen.";
+            return false;
+        }
+
+        wchar_t text[INET6_ADDRSTRLEN] = {};
+        const void* raw = m_family == AF_INET6
+            ? static_cast<const void*>(&reinterpret_cast<const SOCKADDR_IN6*>(&m_target)->sin6_addr)
+            : static_cast<const void*>(&reinterpret_cast<const SOCKADDR_IN*>(&m_target)->sin_addr);
+        InetNtopW(m_family, raw, text, INET6_ADDRSTRLEN);
+        address = text;
+        return true;
+    }
+
+    PingReply Echo(uint32_t payloadBytes, uint32_t timeoutMs) override {
+        if (m_request.size() != payloadBytes) {
+            // Gleiches Fuellmuster wie ping.exe
+            m_request.resize(payloadBytes);
+            for (uint32_t i = 0; i < payloadBytes; ++i) m_request[i] = static_cast<char>('a' + i % 23);
+        }
+        // Antwortpuffer laut Doku: Antwortkopf + Nutzdaten + 8 Bytes fuer ICMP-Fehlermeldungen,
+        // dazu Platz fuer den IO_STATUS_BLOCK (16 Bytes unter x64)
+        size_t header = m_family == AF_INET6 ? sizeof(ICMPV6_ECHO_REPLY) : sizeof(ICMP_ECHO_REPLY);
+        m_reply.resize(header + payloadBytes + 8 + 16);
+
+        LARGE_INTEGER frequency, start, end;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&start);
+        DWORD count;
+        if (m_family == AF_INET6) {
+            SOCKADDR_IN6 source = {};
+            source.sin6_family = AF_INET6;
+            count = Icmp6SendEcho2(m_icmp, NULL, NULL, NULL, &source, reinterpret_cast<PSOCKADDR_IN6>(&m_target),
+                m_request.data(), static_cast<WORD>(payloadBytes), NULL, m_reply.data(), static_cast<DWORD>(m_reply.size()), timeoutMs);
+        }
+        else {
+            IPAddr ipaddr = reinterpret_cast<const SOCKADDR_IN*>(&m_target)->sin_addr.S_un.S_addr;
+            count = IcmpSendEcho(m_icmp, ipaddr, m_request.data(), static_cast<WORD>(payloadBytes), NULL,
+                m_reply.data(), static_cast<DWORD>(m_reply.size()), timeoutMs);
+        }
+        QueryPerformanceCounter(&end);
+
+        ULONG status = GetLastError();
+        if (count != 0) {
+            status = m_family == AF_INET6
+                ? reinterpret_cast<const ICMPV6_ECHO_REPLY*>(m_reply.data())->Status
+                : reinterpret_cast<const ICMP_ECHO_REPLY*>(m_reply.data())->Status;
+        }
+
+        // Laufzeit selbst messen: RoundTripTime der API hat nur Millisekunden-Aufloesung
+        PingReply reply;
+        switch (status) {
+        case IP_SUCCESS:
+            reply.status = PingReply::Status::Ok;
+            reply.rttMicros = static_cast<uint32_t>((end.QuadPart - start.QuadPart) * 1000000 / frequency.QuadPart);
+            break;
+        case IP_REQ_TIMED_OUT:
+            reply.status = PingReply::Status::Timeout;
+            break;
+        case IP_DEST_HOST_UNREACHABLE:
+            reply.status = PingReply::Status::Error;
+            reply.error = L"Zielhost nicht erreichbar.";
+            break;
+        case IP_DEST_NET_UNREACHABLE:
+            reply.status = PingReply::Status::Error;
+            reply.error = L"Zielnetz nicht erreichbar.";
+            break;
+        default:
+            reply.status = PingReply::Status::Error;
+            reply.error = L"Allgemeiner Fehler (" + std::to_wstring(status) + L").";
+            break;
+        }
+        return reply;
+    }
+
+private:
+    HANDLE m_icmp = INVALID_HANDLE_VALUE;
+    int m_family = AF_INET;
+    SOCKADDR_STORAGE m_target = {};
+    std::vector<char> m_request;
+    std::vector<BYTE> m_reply;
+};
+
+// ... Weitere neue Befehlsfunktionen wie IPCONFIG, TASKLIST, SYSTEMINFO etc. ...
+
+// *** INTELLIGENTE UPDATE-FUNKTIONEN ***
+
+void PerformUpdate(ConsoleEngine& console, HWND hWnd) {
+    console.AddHistory(L"Update wird heruntergeladen...");
+    console.Host().RequestRedraw();
+
+    HINTERNET hInternet = InternetOpen(L"ClockUpdater", INTERNET_OPEN_TYPE_DIRECT, NULL, NULL, 0);
+    if (!hInternet) {
+        console.AddError(L"FEHLER: Internetverbindung fehlgeschlagen (InternetOpen).");
+        return;
+    }
+
+    HINTERNET hUrl = InternetOpenUrlW(hInternet, L"http://wallbangbros.com/clock/time.exe", NULL, 0, INTERNET_FLAG_RELOAD | INTERNET_FLAG_PRAGMA_NOCACHE, 0);
+    if (!hUrl) {
+        console.AddError(L"FEHLER: Update-Server nicht erreichbar (InternetOpenUrl).");
+        InternetCloseHandle(hInternet);
+        return;
+    }
+
+    wchar_t localPath[MAX_PATH];
+    GetModuleFileNameW(NULL, localPath, MAX_PATH);
+    std::wstring tempPath = std::wstring(localPath) + L".tmp";
+    std::wstring oldPath = std::wstring(localPath) + L".old";
+
+    HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        console.AddError(L"FEHLER: Temporaere Update-Datei konnte nicht erstellt werden.");
+        InternetCloseHandle(hUrl); InternetCloseHandle(hInternet);
+        return;
+    }
+
+    BYTE buffer[4096];
+    DWORD bytesRead = 1;
+    BOOL downloadOk = TRUE;
+    while (InternetReadFile(hUrl, buffer, sizeof(buffer), &bytesRead) && bytesRead > 0) {
+        DWORD bytesWritten;
+        if (!WriteFile(hFile, buffer, bytesRead, &bytesWritten, NULL) || bytesWritten != bytesRead) {
+            console.AddError(L"FEHLER: Fehler beim Schreiben der Update-Datei.");
+            downloadOk = FALSE;
+            break;
+        }
+    }
+    CloseHandle(hFile);
+    InternetCloseHandle(hUrl);
+    InternetCloseHandle(hInternet);
+
+    if (!downloadOk) {
+        DeleteFileW(tempPath.c_str());
+        return;
+    }
+
+    DeleteFileW(oldPath.c_str());
+
+    if (!MoveFileW(localPath, oldPath.c_str())) {
+        console.AddError(L"FEHLER: Aktuelle Version konnte nicht umbenannt werden.");
+        DeleteFileW(tempPath.c_str());
+        return;
+    }
+
+    if (!MoveFileW(tempPath.c_str(), localPath)) {
+        console.AddError(L"FEHLER: Update konnte nicht aktiviert werden. Stelle alte Version wieder her.");
+        MoveFileW(oldPath.c_str(), localPath);
+        DeleteFileW(tempPath.c_str());
+        return;
+    }
+
+    console.AddHistory(L"Update erfolgreich! Die Anwendung wird jetzt neu gestartet...");
+    console.Host().RequestRedraw();
+    Sleep(2000);
+
+    STARTUPINFOW si = { sizeof(si) };
+    PROCESS_INFORMATION pi;
+    if (CreateProcessW(localPath, NULL, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+        DestroyWindow(hWnd);
+    }
+    else {
+        console.AddError(L"FEHLER: Neustart fehlgeschlagen. Bitte manuell neu starten.");
+    }
+}
+
+
+BOOL CheckForUpdate(ConsoleEngine& console) {
+    console.AddHistory(L"Suche nach Updates...");
+    console.Host().RequestRedraw();
+
+    wchar_t localPath[MAX_PATH];
+    GetModuleFileNameW(NULL, localPath, MAX_PATH);
+    HANDLE hFile = CreateFileW(localPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        console.AddError(L"FEHLER: Lokale Datei konnte nicht gelesen werden.");
+        return FALSE;
+    }
+    DWORD localSize = GetFileSize(hFile, NULL);
+    CloseHandle(hFile);
+
+    HINTERNET hInternet = InternetOpen(L"ClockUpdater", INTERNET_OPEN_TYPE_DIRECT, NULL, NULL, 0);
+    if (!hInternet) {
+        console.AddError(L"FEHLER: Internetverbindung fehlgeschlagen.");
+        return FALSE;
+    }
+
+    HINTERNET hUrl = InternetOpenUrlW(hInternet, L"http://wallbangbros.com/clock/time.exe", NULL, 0, INTERNET_FLAG_RELOAD | INTERNET_FLAG_PRAGMA_NOCACHE, 0);
+    if (!hUrl) {
+        console.AddError(L"FEHLER: Update-Server nicht erreichbar.");
+        InternetCloseHandle(hInternet);
+        return FALSE;
+    }
+
+    wchar_t sizeBuffer[32] = { 0 };
+    DWORD sizeBufferLen = sizeof(sizeBuffer);
+    DWORD remoteSize = 0;
+
+    if (HttpQueryInfoW(hUrl, HTTP_QUERY_CONTENT_LENGTH, sizeBuffer, &sizeBufferLen, NULL)) {
+        remoteSize = _wtoi(sizeBuffer);
+    }
+    else {
+        console.AddError(L"FEHLER: Groesse der Update-Datei konnte nicht ermittelt werden.");
+        InternetCloseHandle(hUrl); InternetCloseHandle(hInternet);
+        return FALSE;
+    }
+
+    InternetCloseHandle(hUrl); InternetCloseHandle(hInternet);
+
+    if (remoteSize > 0 && remoteSize != localSize) {
+        return TRUE;
+    }
+    console.AddHistory(L"Ihre Version ist auf dem neuesten Stand.");
+    return FALSE;
+}
+
+
+/**
+ * Verbindet die plattformneutrale Konsole mit den Win32-Befehlen und dem Hauptfenster.
+ */
+class Win32ConsoleHost : public ConsoleHost {
+public:
+    HWND hWnd = NULL;
+
+    // Laufen auf den Arbeitsthreads von g_executor
+    void TaskList(JobContext& job) override { ::TaskList(job); }
+    std::wstring WorkingDirectory() override { return ProgramDirectory(); }
+    std::unique_ptr<PingProber> CreatePingProber() override { return std::make_unique<IcmpPingProber>(); }
+
+    bool ProcessMemory(uint64_t& residentBytes, uint64_t& privateBytes) override {
+        PROCESS_MEMORY_COUNTERS_EX counters = {};
+        counters.cb = sizeof(counters);
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+            return false;
+        }
+        residentBytes = counters.WorkingSetSize;
+        privateBytes = counters.PrivateUsage;
+        return true;
+    }
+    std::unique_ptr<ConnectionSource> CreateConnectionSource() override { return std::make_unique<IpHelperConnectionSource>(); }
+    std::unique_ptr<ProcessSampler> CreateProcessSampler() override { return std::make_unique<NtProcessSampler>(); }
+    std::unique_ptr<NetConfigSource> CreateNetConfigSource() override { return std::make_unique<IpHelperConfigSource>(); }
+    std::unique_ptr<SystemSampler> CreateSystemSampler() override { return std::make_unique<NtSystemSampler>(); }
+
+    void SystemInfo(ConsoleEngine& console) override { ::SystemInfo(console); }
+    void Vol(ConsoleEngine& console) override { ::Vol(console); }
+    void Type(ConsoleEngine& console, const std::wstring& filename) override { ::Type(filename, console); }
+    void Hostname(ConsoleEngine& console) override { ::Hostname(console); }
+    void Whoami(ConsoleEngine& console) override { ::Whoami(console); }
+    void Uptime(ConsoleEngine& console) override { ::Uptime(console); }
+    bool CheckForUpdate(ConsoleEngine& console) override { return ::CheckForUpdate(console) != FALSE; }
+    void PerformUpdate(ConsoleEngine& console) override { ::PerformUpdate(console, hWnd); }
+
+    void RequestRedraw() override {
+        if (hWnd) UpdateClockDisplay(hWnd);
+    }
+
+    void StartCountdown() override {
+        ScheduleCountdownTick(hWnd, GetTickCount64() + COUNTDOWN_STEP_MS);
+        ArmSchedulerTimer(hWnd);
+    }
+
+    void StartClock() override {
+        if (!hWnd || g_clockTimer != TimerWheel::INVALID_TIMER) return;
+        ScheduleClockTick(hWnd, GetTickCount64());
+        ArmSchedulerTimer(hWnd);
+    }
+};
+
+// Win32-Frontend der Konsole; Befehlsinterpreter und Verlauf liegen in engine/console.cpp
+Win32ConsoleHost g_host;
+ConsoleEngine g_console(g_host);
+
+// Arbeitsthreads für langsame Befehle; Ergebnisse kommen per WM_APP_JOBS zurück
+std::unique_ptr<CommandExecutor> g_executor;
+
+// Verlauf und Befehle über Neustarts hinweg; geschrieben wird auf einem eigenen Thread
+SessionLog g_sessionLog;
+
+// %LOCALAPPDATA%\Time\Sitzung, ersatzweise neben der Programmdatei
+std::wstring SessionDirectory() {
+    wchar_t path[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", path, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) return ProgramDirectory() + L"\\Sitzung";
+    return std::wstring(path, length) + L"\\Time\\Sitzung";
+}
+
+BOOL RegisterClockWindowClass(HINSTANCE hInstance) {
+
+    if (!RegisterBlackoutWindowClass(hInstance)) {
+        return FALSE;
+    }
+    WNDCLASSEXW wc = { 0 };
+    wc.cbSize = sizeof(WNDCLASSEXW);
+    wc.lpfnWndProc = ClockWindowProc;
+    wc.hInstance = hInstance;
+    wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+    wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
+    wc.lpszClassName = WINDOW_CLASS_NAME;
+    // Hier fügen Sie das Icon hinzu (nachdem Sie die Ressource erstellt haben)
+    // wc.hIcon = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_ICON1));
+    // wc.hIconSm = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_ICON1));
+    return (RegisterClassExW(&wc) != 0);
+}
+
+HWND CreateClockWindow(HINSTANCE hInstance, int nCmdShow) {
+    // Winsock und ICMP richtet erst der erste PING ein (NetworkServices)
+    g_console.SetStartupTrace(&g_startup);
+    Perf::SetThreadName(L"UI");
+
+    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
+    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+
+    // Letzte Sitzung wiederherstellen; das Banner nur beim allerersten Start
+    std::wstring error;
+    if (g_sessionLog.Open(SessionDirectory(), error)) {
+        RestoredSession restored;
+        g_sessionLog.Replay(Scrollback::DEFAULT_MAX_LINES, ConsoleEngine::MAX_COMMAND_HISTORY, restored);
+        g_console.RestoreSession(restored);
+        g_console.AttachSessionLog(&g_sessionLog);
+    }
+    if (g_console.History().Empty()) g_console.PrintBanner();
+    g_startup.Mark(L"Verlauf bereit");
+
+    HWND hWnd = CreateWindowExW(
+        WS_EX_TOPMOST,
+        WINDOW_CLASS_NAME,
+        L"Windows 3.1 Terminal Clock",
+        WS_POPUP | WS_VISIBLE,
+        0, 0, screenWidth, screenHeight,
+        NULL, NULL, hInstance, NULL
+    );
+
+    if (hWnd) {
+        g_startup.Mark(StartupTrace::WINDOW);
+        g_host.hWnd = hWnd;
+        g_executor = std::make_unique<CommandExecutor>(4, [hWnd]() {
+            PostMessageW(hWnd, WM_APP_JOBS, 0, 0);
+        });
+        g_console.AttachExecutor(g_executor.get());
+        g_hFont = CreateFont(
+            screenHeight / 45, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
+            OEM_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS,
+            NONANTIALIASED_QUALITY, FF_MODERN | FIXED_PITCH, L"Terminal"
+        );
+        ShowWindow(hWnd, nCmdShow);
+        UpdateWindow(hWnd);
+        ScheduleBlink(hWnd, GetTickCount64());
+        g_console.ShowClock(true); // plant über StartClock den Sekundentakt der Uhr
+        ArmSchedulerTimer(hWnd);
+        CoverSecondaryMonitors(hWnd);
+    }
+    return hWnd;
+}
+
+/**
+ * Stellt den Win32-Timer auf den nächsten Termin des Schedulers. Das Fenster wacht so nur auf,
+ * wenn sich tatsächlich etwas ändert (Blinkwechsel, Countdown-Sekunde), statt alle 50 ms.
+ */
+void ArmSchedulerTimer(HWND hWnd) {
+    uint64_t next = g_timers.NextDeadline();
+    if (next == TimerWheel::NO_DEADLINE) {
+        KillTimer(hWnd, SCHEDULER_TIMER_ID);
+        return;
+    }
+    ULONGLONG now = GetTickCount64();
+    ULONGLONG delay = next > now ? std::min<ULONGLONG>(next - now, USER_TIMER_MAXIMUM) : 0;
+    SetTimer(hWnd, SCHEDULER_TIMER_ID, std::max<UINT>(static_cast<UINT>(delay), USER_TIMER_MINIMUM), NULL);
+}
+
+// Nächster Blinkwechsel des Cursors; derselbe Takt wie in RenderFrame
+void ScheduleBlink(HWND hWnd, ULONGLONG now) {
+    g_timers.Schedule(NextBoundary(now, CURSOR_BLINK_MS), [hWnd](uint64_t due) {
+        if (g_console.ShowsCursor()) {
+            UpdateClockDisplay(hWnd);
+        }
+        ScheduleBlink(hWnd, due);
+    });
+}
+
+// Uhr: Termin kurz nach dem Sekundenwechsel der Systemuhr (nicht von GetTickCount64), damit die
+// Anzeige nicht hinterherhinkt. Endet, sobald die Uhr per CLOCK OFF ausgeschaltet wurde.
+void ScheduleClockTick(HWND hWnd, ULONGLONG now) {
+    g_clockTimer = g_timers.Schedule(now + ClockFormatter::MillisToNextSecond() + 1, [hWnd](uint64_t) {
+        g_clockTimer = TimerWheel::INVALID_TIMER;
+        if (g_console.TickClock()) {
+            ScheduleClockTick(hWnd, GetTickCount64());
+        }
+    });
+}
+
+// Countdown-Sekunden auf festen Terminen ab dem EXIT-Befehl, ohne Drift durch spätes Aufwachen
+void ScheduleCountdownTick(HWND hWnd, ULONGLONG deadline) {
+    g_timers.Schedule(deadline, [hWnd, deadline](uint64_t) {
+        if (g_console.TickCountdown()) {
+            DestroyWindow(hWnd);
+            return;
+        }
+        ScheduleCountdownTick(hWnd, deadline + COUNTDOWN_STEP_MS);
+    });
+}
+
+/**
+ * Fordert einen neuen Frame an. Mehrere Aufrufe vor dessen Verarbeitung (z.B. viele WM_CHAR
+ * beim Einfügen) werden zu einem einzigen Frame zusammengefasst.
+ */
+void UpdateClockDisplay(HWND hWnd) {
+    if (!g_framePending) {
+        g_framePending = true;
+        PostMessageW(hWnd, WM_APP_RENDER, 0, 0);
+    }
+}
+
+void DestroyBackBuffer() {
+    if (g_backDC) {
+        g_frame.Detach();
+        SelectObject(g_backDC, g_oldBackBitmap);
+        DeleteObject(g_backBitmap);
+        DeleteDC(g_backDC);
+        g_backDC = NULL;
+        g_backBitmap = NULL;
+    }
+}
+
+/**
+ * Rastert Zeichen der Fensterschrift per GDI in eine zellgroße DIB-Section. Wird nur beim
+ * Befüllen des Glyphen-Atlas benutzt, nicht beim Zeichnen eines Frames.
+ */
+class GdiGlyphRasterizer : public GlyphRasterizer {
+public:
+    explicit GdiGlyphRasterizer(HFONT font) {
+        m_dc = CreateCompatibleDC(NULL);
+        m_oldFont = (HFONT)SelectObject(m_dc, font);
+
+        TEXTMETRIC tm;
+        GetTextMetrics(m_dc, &tm);
+        m_width = tm.tmAveCharWidth;
+        m_height = tm.tmHeight + tm.tmExternalLeading;
+
+        BITMAPINFO bmi = { 0 };
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = m_width;
+        bmi.bmiHeader.biHeight = -m_height; // von oben nach unten
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        void* bits = NULL;
+        m_bitmap = CreateDIBSection(m_dc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+        m_pixels = static_cast<const uint32_t*>(bits);
+        m_oldBitmap = (HBITMAP)SelectObject(m_dc, m_bitmap);
+
+        SetTextColor(m_dc, RGB(255, 255, 255));
+        SetBkColor(m_dc, RGB(0, 0, 0));
+    }
+
+    ~GdiGlyphRasterizer() override {
+        SelectObject(m_dc, m_oldBitmap);
+        SelectObject(m_dc, m_oldFont);
+        DeleteObject(m_bitmap);
+        DeleteDC(m_dc);
+    }
+
+    int CellWidth() const override { return m_width; }
+    int CellHeight() const override { return m_height; }
+
+    bool Rasterize(wchar_t ch, uint8_t* coverage) override {
+        if (!m_pixels) return false;
+        // Rasterschriften wie "Terminal" liefern hier GDI_ERROR; dann wird einfach gezeichnet
+        WORD index = 0;
+        if (GetGlyphIndicesW(m_dc, &ch, 1, &index, GGI_MARK_NONEXISTING_GLYPHS) != GDI_ERROR && index == 0xFFFF) {
+            return false;
+        }
+        RECT rect = { 0, 0, m_width, m_height };
+        ExtTextOutW(m_dc, 0, 0, ETO_OPAQUE, &rect, &ch, 1, NULL);
+        GdiFlush();
+        for (int i = 0; i < m_width * m_height; ++i) {
+            coverage[i] = static_cast<uint8_t>((m_pixels[i] >> 8) & 0xFF);
+        }
+        return true;
+    }
+
+private:
+    HDC m_dc = NULL;
+    HFONT m_oldFont = NULL;
+    HBITMAP m_bitmap = NULL;
+    HBITMAP m_oldBitmap = NULL;
+    const uint32_t* m_pixels = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+/**
+ * Legt den Hintergrundpuffer in Fenstergröße an bzw. neu an, wenn sich die Größe geändert hat.
+ * Beim ersten Aufruf wird außerdem der Glyphen-Atlas aus der Fensterschrift aufgebaut.
+ */
+void EnsureBackBuffer(HWND hWnd) {
+    RECT clientRect;
+    GetClientRect(hWnd, &clientRect);
+    if (g_backDC && clientRect.right == g_backWidth && clientRect.bottom == g_backHeight) {
+        return;
+    }
+    DestroyBackBuffer();
+
+    if (!g_glyphAtlas) {
+        g_glyphRasterizer = std::make_unique<GdiGlyphRasterizer>(g_hFont ? g_hFont : (HFONT)GetStockObject(OEM_FIXED_FONT));
+        g_glyphAtlas = std::make_unique<GlyphAtlas>(*g_glyphRasterizer);
+        g_renderer = std::make_unique<CellRenderer>(*g_glyphAtlas, g_frame);
+    }
+
+    BITMAPINFO bmi = { 0 };
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = clientRect.right;
+    bmi.bmiHeader.biHeight = -clientRect.bottom; // von oben nach unten, passt zu Framebuffer::Row
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    HDC hdc = GetDC(hWnd);
+    void* bits = NULL;
+    g_backDC = CreateCompatibleDC(hdc);
+    g_backBitmap = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    ReleaseDC(hWnd, hdc);
+    g_oldBackBitmap = (HBITMAP)SelectObject(g_backDC, g_backBitmap);
+    g_backWidth = clientRect.right;
+    g_backHeight = clientRect.bottom;
+
+    // 32-Bit-DIB-Zeilen sind immer DWORD-ausgerichtet: Stride = Breite
+    if (bits) {
+        g_frame.Attach(static_cast<uint32_t*>(bits), g_backWidth, g_backHeight, g_backWidth);
+    }
+    g_frame.Fill({ 0, 0, g_backWidth, g_backHeight }, CellRenderer::DEFAULT_BACKGROUND);
+
+    g_screen.Resize(g_renderer->VisibleRows());
+    InvalidateRect(hWnd, NULL, FALSE);
+}
+
+void InvalidatePixelRect(HWND hWnd, const PixelRect& pixels) {
+    RECT rect = { pixels.left, pixels.top, pixels.right, pixels.bottom };
+    InvalidateRect(hWnd, &rect, FALSE);
+}
+
+/**
+ * Bringt den Hintergrundpuffer auf den aktuellen Stand: der CellRenderer verschiebt den Inhalt
+ * beim Scrollen im Speicher und kopiert nur für geänderte Zeilen bzw. die Cursorzelle Glyphen
+ * aus dem Atlas. Das Fenster wird entsprechend gescrollt und nur in diesen Bereichen invalidiert.
+ */
+void RenderFrame(HWND hWnd) {
+    g_framePending = false;
+    EnsureBackBuffer(hWnd);
+    GdiFlush(); // ausstehende BitBlts aus dem Puffer abschließen, bevor seine Pixel geändert werden
+
+    bool cursorVisible = (GetTickCount64() / CURSOR_BLINK_MS) % 2 == 0;
+    const FrameDamage& damage = g_screen.Update(g_console, cursorVisible);
+    if (damage.Empty()) return;
+
+    const std::vector<PixelRect>& changed = g_renderer->Render(g_screen, g_console, damage);
+    if (damage.scrollRows != 0) {
+        PixelRect area = g_renderer->ScrollArea(g_screen);
+        RECT rect = { area.left, area.top, area.right, area.bottom };
+        ScrollWindowEx(hWnd, 0, -damage.scrollRows * g_glyphAtlas->CellHeight(), &rect, &rect, NULL, NULL, 0);
+    }
+    for (const PixelRect& rect : changed) {
+        InvalidatePixelRect(hWnd, rect);
+    }
+}
+
+/**
+ * Fügt Text aus der Zwischenablage in die Eingabezeile ein (Strg+V).
+ */
+void PasteFromClipboard(HWND hWnd) {
+    if (!OpenClipboard(hWnd)) return;
+    HANDLE hData = GetClipboardData(CF_UNICODETEXT);
+    if (hData) {
+        const wchar_t* text = static_cast<const wchar_t*>(GlobalLock(hData));
+        if (text) {
+            g_console.PasteText(text);
+            GlobalUnlock(hData);
+        }
+    }
+    CloseClipboard();
+}
+
+LRESULT CALLBACK ClockWindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
+    switch (message) {
+    case WM_CREATE:
+        break;
+
+    case WM_ERASEBKGND:
+        return TRUE;
+
+    case WM_CHAR: {
+        // Strg+C (0x03) bricht in HandleChar den laufenden Befehl ab, Strg+R/Strg+F (0x12/0x06)
+        // suchen im Verlauf
+        if (wParam == 0x16) { // Strg+V
+            PasteFromClipboard(hWnd);
+        }
+        else {
+            g_console.HandleChar((wchar_t)wParam);
+        }
+        break;
+    }
+
+    case WM_KEYDOWN: {
+        if (wParam == VK_RETURN) {
+            g_console.SubmitInput();
+        }
+        // NEU: Scroll-Logik
+        else if (wParam == VK_PRIOR) { // Page Up
+            g_console.ScrollPageUp();
+        }
+        else if (wParam == VK_NEXT) { // Page Down
+            g_console.ScrollPageDown();
+        }
+        else {
+            // Eingabezeile: Cursor, Entf und Befehlsverlauf (Pfeil hoch/runter)
+            bool ctrl = (GetKeyState(VK_CONTROL) & 0x8000) != 0;
+            switch (wParam) {
+            case VK_LEFT: g_console.HandleKey(ctrl ? EditKey::WordLeft : EditKey::Left); break;
+            case VK_RIGHT: g_console.HandleKey(ctrl ? EditKey::WordRight : EditKey::Right); break;
+            case VK_HOME: g_console.HandleKey(EditKey::Home); break;
+            case VK_END: g_console.HandleKey(EditKey::End); break;
+            case VK_DELETE: g_console.HandleKey(EditKey::Delete); break;
+            case VK_UP: g_console.HandleKey(EditKey::Up); break;
+            case VK_DOWN: g_console.HandleKey(EditKey::Down); break;
+            }
+        }
+        break;
+    }
+
+    case WM_SYSCOMMAND:
+        if (wParam == SC_CLOSE) {
+            if (!g_console.IsCountdownActive()) {
+                g_console.AddHistory(PROMPT + L"FEHLER: Diese Applikation kann nur durch den 'EXIT'-Befehl beendet werden.");
+                g_console.ClearInput();
+                UpdateClockDisplay(hWnd);
+                return 0;
+            }
+        }
+        break;
+
+    case WM_TIMER:
+        if (wParam == SCHEDULER_TIMER_ID) {
+            g_timers.RunDue(GetTickCount64());
+            // Der Countdown kann das Fenster bereits zerstört haben
+            if (IsWindow(hWnd)) {
+                ArmSchedulerTimer(hWnd);
+            }
+        }
+        break;
+
+    case WM_APP_RENDER:
+        RenderFrame(hWnd);
+        break;
+
+    case WM_APP_JOBS:
+        g_console.PumpJobs();
+        break;
+
+    case WM_APP_INTERACTIVE:
+        g_startup.Mark(StartupTrace::INTERACTIVE);
+        break;
+
+    case WM_PAINT: {
+        // Ausstehende Änderungen zuerst in den Puffer übernehmen, dann nur kopieren
+        if (g_framePending || !g_backDC) {
+            RenderFrame(hWnd);
+        }
+        PAINTSTRUCT ps;
+        HDC hdc = BeginPaint(hWnd, &ps);
+        BitBlt(hdc, ps.rcPaint.left, ps.rcPaint.top,
+            ps.rcPaint.right - ps.rcPaint.left, ps.rcPaint.bottom - ps.rcPaint.top,
+            g_backDC, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+        EndPaint(hWnd, &ps);
+        if (!g_startup.Has(StartupTrace::FIRST_PAINT)) {
+            g_startup.Mark(StartupTrace::FIRST_PAINT);
+            // Eingabebereit, sobald die Schleife nach dem ersten Bild wieder Nachrichten abholt
+            PostMessageW(hWnd, WM_APP_INTERACTIVE, 0, 0);
+        }
+        break;
+    }
+
+    case WM_DESTROY:
+        KillTimer(hWnd, SCHEDULER_TIMER_ID);
+        // Laufende Befehle abbrechen und auf die Arbeitsthreads warten
+        g_console.AttachExecutor(nullptr);
+        g_executor.reset();
+        // Ausstehende Verlaufszeilen noch schreiben
+        g_console.AttachSessionLog(nullptr);
+        g_sessionLog.Close();
+        DestroyBackBuffer();
+        g_renderer.reset();
+        g_glyphAtlas.reset();
+        g_glyphRasterizer.reset();
+        if (g_hFont) {
+            DeleteObject(g_hFont);
+            g_hFont = NULL;
+        }
+        // ICMP-Handles schließen, Winsock nur aufräumen, wenn ein PING es gestartet hat
+        g_network.Shutdown();
+        PostQuitMessage(0);
+        break;
+
+    default:
+        return DefWindowProcW(hWnd, message, wParam, lParam);
+    }
+    return 0;
+}
+
@@ -1,25 +1,30 @@
-#pragma once
-
-// KORREKTUR: Winsock2 MUSS vor windows.h eingebunden werden, um Neudefinitionsfehler zu vermeiden.
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include <windows.h>
-
-#include <string> // Wird für std::wstring benötigt
-
-// Fensterklasse und Timer-IDs
-#define WINDOW_CLASS_NAME L"TimeClockConsoleClass"
-#define BLACKOUT_CLASS_NAME L"BlackoutClass"
-#define CLOCK_TIMER_ID 1
-#define COUNTDOWN_TIMER_ID 2
-
-// Prototypen für gui.cpp
-BOOL RegisterClockWindowClass(HINSTANCE hInstance);
-BOOL RegisterBlackoutWindowClass(HINSTANCE hInstance);
-HWND CreateClockWindow(HINSTANCE hInstance, int nCmdShow);
-LRESULT CALLBACK ClockWindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
-void UpdateClockDisplay(HWND hWnd);
-
-// Deklarationen für die Zeitfunktionen, die in ProcessCommand verwendet werden
-std::wstring GetCurrentTimeString();
-std::wstring GetCurrentDateString();
+#pragma once
+
+// KORREKTUR: Winsock2 MUSS vor windows.h eingebunden werden, um Neudefinitionsfehler zu vermeiden.
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+
+#include <string> // Wird für std::wstring benötigt
+
+// Fensterklasse und Timer-IDs
+#define WINDOW_CLASS_NAME L"TimeClockConsoleClass"
+#define BLACKOUT_CLASS_NAME L"BlackoutClass"
+// Einziger Win32-Timer; er wird jeweils auf den nächsten Termin des Schedulers gestellt
+#define SCHEDULER_TIMER_ID 1
+
+// Wird von UpdateClockDisplay gepostet; zeichnet alle bis dahin angefallenen Änderungen
+#define WM_APP_RENDER (WM_APP + 1)
+
+// Vom CommandExecutor gepostet, sobald Jobs neue Ausgaben oder ihr Ende gemeldet haben
+#define WM_APP_JOBS (WM_APP + 2)
+
+// Nach dem ersten WM_PAINT gepostet; kommt sie an, ist die Nachrichtenschleife frei fuer Eingaben
+#define WM_APP_INTERACTIVE (WM_APP + 3)
+
+// Prototypen für gui.cpp
+BOOL RegisterClockWindowClass(HINSTANCE hInstance);
+BOOL RegisterBlackoutWindowClass(HINSTANCE hInstance);
+HWND CreateClockWindow(HINSTANCE hInstance, int nCmdShow);
+LRESULT CALLBACK ClockWindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+void UpdateClockDisplay(HWND hWnd);
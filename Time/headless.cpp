@@ -0,0 +1,743 @@
+// Headless-Frontend der Konsole: liest Befehle zeilenweise von stdin und schreibt den
+// Verlauf nach stdout. Dient fuer skriptgesteuerte Sitzungen und Profiling ohne Win32-Fenster.
+//
+//   time_headless [--no-banner] [--repeat N] [--scrollback N] [--stats] [--perf]
+//                 [--render bild.ppm] [--screen SPALTENxZEILEN] [--fake-ping] < script.txt
+//
+// --render zeichnet den Bildschirm nach jedem Befehl mit der eingebauten Pixelschrift und
+// speichert den letzten Frame als PPM (Referenzbilder, Renderer-Profiling).
+// PING erreicht ohne ICMP-Rechte nur Loopback-Adressen (UDP-Echo an sich selbst); --fake-ping
+// beantwortet jeden Host mit reproduzierbaren, simulierten Laufzeiten. --perf schaltet die
+// Spuraufzeichnung von Anfang an ein (wie PERF ON).
+
+#include "engine/console.h"
+#include "engine/glyphs.h"
+#include "engine/perf.h"
+#include "engine/renderer.h"
+#include "engine/scheduler.h"
+#include "engine/screen.h"
+#include "engine/utf8.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pwd.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+/**
+ * PING-Ziel ueber Loopback: ein UDP-Socket schickt sich die Anfrage selbst zu. Misst damit den
+ * echten Weg durch den Netzwerkstack (IPv4 und IPv6), ohne Rohsockets bzw. Root-Rechte.
+ */
+class LoopbackPingProber : public PingProber {
+public:
+    ~LoopbackPingProber() override {
+        if (m_socket >= 0) close(m_socket);
+    }
+
+    bool Open(const std::wstring& host, int family, std::wstring& address, std::wstring& error) override {
+        addrinfo hints = {};
+        hints.ai_family = family == 4 ? AF_INET : family == 6 ? AF_INET6 : AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(WideToUtf8(host).c_str(), nullptr, &hints, &result) != 0) {
+            error = L"Host '" + host + L"' konnte nicht aufgeloest werden.";
+            return false;
+        }
+        for (addrinfo* ai = result; ai && m_length == 0; ai = ai->ai_next) {
+            if (IsLoopback(ai->ai_addr)) {
+                memcpy(&m_target, ai->ai_addr, ai->ai_addrlen);
+                m_length = ai->ai_addrlen;
+            }
+        }
+        freeaddrinfo(result);
+        if (m_length == 0) {
+            error = L"Im Headless-Modus sind nur Loopback-Adressen erreichbar (--fake-ping simuliert andere Hosts).";
+            return false;
+        }
+
+        // An einen freien Port binden und die Anfragen an genau diese Adresse schicken
+        m_socket = socket(m_target.ss_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (m_socket < 0 || bind(m_socket, reinterpret_cast<sockaddr*>(&m_target), m_length) != 0
+            || getsockname(m_socket, reinterpret_cast<sockaddr*>(&m_target), &m_length) != 0) {
+            error = L"UDP-Socket fuer Loopback-PING konnte nicht geoeffnet werden.";
+            return false;
+        }
+
+        char text[INET6_ADDRSTRLEN] = {};
+        const void* raw = m_target.ss_family == AF_INET6
+            ? static_cast<const void*>(&reinterpret_cast<const sockaddr_in6*>(&m_target)->sin6_addr)
+            : static_cast<const void*>(&reinterpret_cast<const sockaddr_in*>(&m_target)->sin_addr);
+        inet_ntop(m_target.ss_family, raw, text, sizeof(text));
+        address = Utf8ToWide(text);
+        return true;
+    }
+
+    PingReply Echo(uint32_t payloadBytes, uint32_t timeoutMs) override {
+        // Laufende Nummer vor den Nutzdaten, damit verspaetete Antworten nicht mitzaehlen
+        uint32_t sequence = ++m_sequence;
+        m_request.assign(sizeof(sequence) + payloadBytes, 'a');
+        memcpy(m_request.data(), &sequence, sizeof(sequence));
+        m_response.resize(m_request.size() + 1);
+
+        PingReply reply;
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::milliseconds(timeoutMs);
+        if (sendto(m_socket, m_request.data(), m_request.size(), 0, reinterpret_cast<sockaddr*>(&m_target), m_length) < 0) {
+            reply.status = PingReply::Status::Error;
+            reply.error = L"Senden fehlgeschlagen.";
+            return reply;
+        }
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) return reply; // Timeout
+            pollfd fd = { m_socket, POLLIN, 0 };
+            int wait = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count());
+            if (poll(&fd, 1, wait) <= 0) continue;
+            ssize_t received = recv(m_socket, m_response.data(), m_response.size(), 0);
+            if (received == static_cast<ssize_t>(m_request.size()) && memcmp(m_response.data(), &sequence, sizeof(sequence)) == 0) {
+                reply.status = PingReply::Status::Ok;
+                reply.rttMicros = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+                return reply;
+            }
+        }
+    }
+
+private:
+    static bool IsLoopback(const sockaddr* address) {
+        if (address->sa_family == AF_INET) {
+            return (ntohl(reinterpret_cast<const sockaddr_in*>(address)->sin_addr.s_addr) >> 24) == 127;
+        }
+        return address->sa_family == AF_INET6
+            && IN6_IS_ADDR_LOOPBACK(&reinterpret_cast<const sockaddr_in6*>(address)->sin6_addr);
+    }
+
+    int m_socket = -1;
+    sockaddr_storage m_target = {};
+    socklen_t m_length = 0;
+    uint32_t m_sequence = 0;
+    std::vector<char> m_request;
+    std::vector<char> m_response;
+};
+
+/**
+ * NETSTAT unter Linux: Sockets aus /proc/net/{tcp,tcp6,udp,udp6}, die PID ueber die Inode des
+ * Sockets aus /proc/<pid>/fd. Die fd-Verzeichnisse werden nur durchsucht, wenn ein Stand
+ * Inodes enthaelt, die noch nie gesehen wurden; bei NETSTAT -r also nur fuer neue Sockets.
+ */
+class ProcNetConnectionSource : public ConnectionSource {
+public:
+    bool Snapshot(std::vector<Connection>& connections, std::wstring& error) override {
+        static const struct {
+            const char* path;
+            NetProtocol protocol;
+            uint8_t family;
+        } TABLES[] = {
+            { "/proc/net/tcp", NetProtocol::Tcp, 4 }, { "/proc/net/tcp6", NetProtocol::Tcp, 6 },
+            { "/proc/net/udp", NetProtocol::Udp, 4 }, { "/proc/net/udp6", NetProtocol::Udp, 6 },
+        };
+        connections.clear();
+        m_inodes.clear();
+        size_t readable = 0;
+        for (const auto& table : TABLES) {
+            if (!ReadFile(table.path)) continue; // z.B. ohne IPv6
+            if (!ParseProcNet(m_text, table.protocol, table.family, connections, m_inodes)) {
+                error = L"Unerwartetes Format in " + Utf8ToWide(table.path) + L".";
+                return false;
+            }
+            ++readable;
+        }
+        if (readable == 0) {
+            error = L"Socket-Tabellen in /proc/net konnten nicht gelesen werden.";
+            return false;
+        }
+
+        bool unknown = std::any_of(m_inodes.begin(), m_inodes.end(), [this](uint64_t inode) {
+            return inode != 0 && !m_owners.count(inode) && !m_unowned.count(inode);
+        });
+        if (unknown) ScanOwners();
+        for (size_t i = 0; i < connections.size(); ++i) {
+            auto owner = m_owners.find(m_inodes[i]);
+            if (owner != m_owners.end()) {
+                connections[i].pid = owner->second;
+            }
+            else if (m_inodes[i] != 0) {
+                m_unowned.insert(m_inodes[i]); // Prozess eines anderen Benutzers oder schon beendet
+            }
+        }
+        return true;
+    }
+
+private:
+    bool ReadFile(const char* path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        m_text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // Ordnet alle lesbaren Socket-Deskriptoren ("socket:[inode]") ihrem Prozess zu.
+    void ScanOwners() {
+        m_owners.clear();
+        std::error_code ec;
+        char target[64];
+        for (const fs::directory_entry& process : fs::directory_iterator("/proc", ec)) {
+            std::string id = process.path().filename().string();
+            if (id.empty() || id.find_first_not_of("0123456789") != std::string::npos) continue;
+            uint32_t pid = static_cast<uint32_t>(std::stoul(id));
+            std::error_code fdError;
+            for (const fs::directory_entry& fd : fs::directory_iterator(process.path() / "fd", fdError)) {
+                ssize_t length = readlink(fd.path().c_str(), target, sizeof(target) - 1);
+                if (length <= 8 || memcmp(target, "socket:[", 8) != 0) continue;
+                target[length] = '\0';
+                m_owners.emplace(strtoull(target + 8, nullptr, 10), pid);
+            }
+        }
+        m_unowned.clear();
+    }
+
+    std::string m_text;
+    std::vector<uint64_t> m_inodes;
+    std::unordered_map<uint64_t, uint32_t> m_owners;
+    std::unordered_set<uint64_t> m_unowned;
+};
+
+/**
+ * TOP unter Linux: ein Durchlauf ueber /proc, je Prozess nur /proc/<pid>/stat (ein read in einen
+ * wiederverwendeten Puffer, kein Stream, keine Speicheranforderung pro Prozess). Handles gibt es
+ * nicht; die Spalte bleibt leer.
+ */
+class ProcStatSampler : public ProcessSampler {
+public:
+    ProcStatSampler()
+        : m_ticks(static_cast<uint64_t>(std::max(sysconf(_SC_CLK_TCK), 1L)))
+        , m_pageSize(static_cast<uint64_t>(std::max(sysconf(_SC_PAGESIZE), 1L))) {}
+
+    bool Sample(std::vector<ProcessSample>& samples, std::wstring& error) override {
+        samples.clear();
+        DIR* proc = opendir("/proc");
+        if (!proc) {
+            error = L"/proc konnte nicht gelesen werden.";
+            return false;
+        }
+        char path[sizeof(dirent::d_name) + 8]; // "<pid>/stat"
+        while (dirent* entry = readdir(proc)) {
+            const char* id = entry->d_name;
+            if (*id < '1' || *id > '9' || id[strspn(id, "0123456789")] != '\0') continue;
+            snprintf(path, sizeof(path), "%s/stat", id);
+            int fd = openat(dirfd(proc), path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue; // inzwischen beendet
+            ssize_t length = read(fd, m_buffer, sizeof(m_buffer) - 1);
+            close(fd);
+            if (length <= 0) continue;
+            m_buffer[length] = '\0';
+            ProcessSample sample;
+            sample.pid = static_cast<uint32_t>(strtoul(id, nullptr, 10));
+            if (Parse(m_buffer, static_cast<size_t>(length), sample)) samples.push_back(sample);
+        }
+        closedir(proc);
+        if (samples.empty()) {
+            error = L"Keine Prozesse in /proc gefunden.";
+            return false;
+        }
+        return true;
+    }
+
+private:
+    // "pid (comm) state ppid ...": comm darf Leerzeichen und Klammern enthalten, endet also an
+    // der letzten ')'. Danach folgen die Felder 3 bis 52 (proc(5)).
+    bool Parse(const char* text, size_t length, ProcessSample& sample) const {
+        const char* open = static_cast<const char*>(memchr(text, '(', length));
+        const char* close = nullptr;
+        for (const char* p = text + length; p > text; --p) {
+            if (p[-1] == ')') {
+                close = p - 1;
+                break;
+            }
+        }
+        if (!open || !close || close < open) return false;
+        wchar_t name[ProcessSample::NAME_LENGTH];
+        size_t nameLength = 0;
+        for (const char* p = open + 1; p < close && nameLength < ProcessSample::NAME_LENGTH; ++p) {
+            name[nameLength++] = static_cast<wchar_t>(static_cast<unsigned char>(*p)); // comm ist ASCII
+        }
+        sample.SetName(name, nameLength);
+
+        // Felder ab 3 (state); gebraucht: utime 14, stime 15, num_threads 20, starttime 22, rss 24
+        uint64_t fields[22] = {};
+        const char* p = close + 1;
+        for (int field = 3; field <= 24; ++field) {
+            while (*p == ' ') ++p;
+            if (!*p) return false;
+            char* end = nullptr;
+            fields[field - 3] = strtoull(p, &end, 10); // state ist kein Zahlenfeld
+            p = end != p ? end : p + strcspn(p, " ");
+        }
+        sample.cpuMicros = (fields[14 - 3] + fields[15 - 3]) * 1000000 / m_ticks;
+        sample.threads = static_cast<uint32_t>(fields[20 - 3]);
+        sample.startTime = fields[22 - 3];
+        sample.workingSetBytes = fields[24 - 3] * m_pageSize;
+        return true;
+    }
+
+    uint64_t m_ticks;
+    uint64_t m_pageSize;
+    char m_buffer[1024];
+};
+
+/**
+ * Systembefehle fuer POSIX-Systeme. Befehle ohne Entsprechung melden einen Fehler im Verlauf.
+ */
+class HeadlessConsoleHost : public ConsoleHost {
+public:
+    bool exitRequested = false;
+    bool fakePing = false;
+
+    std::unique_ptr<PingProber> CreatePingProber() override {
+        if (fakePing) return std::make_unique<FakePingProber>(800, 400, 2); // mit 2 % Verlust
+        return std::make_unique<LoopbackPingProber>();
+    }
+
+    std::unique_ptr<ConnectionSource> CreateConnectionSource() override {
+        return std::make_unique<ProcNetConnectionSource>();
+    }
+
+    std::unique_ptr<ProcessSampler> CreateProcessSampler() override {
+        return std::make_unique<ProcStatSampler>();
+    }
+
+    std::unique_ptr<SystemSampler> CreateSystemSampler() override {
+#ifdef __linux__
+        return CreateProcSystemSampler();
+#else
+        return nullptr;
+#endif
+    }
+
+    std::unique_ptr<NetConfigSource> CreateNetConfigSource() override {
+#ifdef __linux__
+        return CreateNetlinkConfigSource();
+#else
+        return nullptr;
+#endif
+    }
+
+    void SystemInfo(ConsoleEngine& console) override {
+        struct utsname uts;
+        uname(&uts);
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        unsigned long long ram = static_cast<unsigned long long>(sysconf(_SC_PHYS_PAGES))
+            * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE));
+
+        auto table = std::make_shared<ResultTable>(ResultTable::Layout::List);
+        table->AddCaption(L"Systeminformationen:");
+        table->SetIndent(2);
+        size_t os = table->AddTextColumn(L"Betriebssystem");
+        size_t cpu = table->AddTextColumn(L"Prozessortyp");
+        size_t count = table->AddNumberColumn(L"Anzahl der Prozessoren");
+        size_t memory = table->AddNumberColumn(L"Speicher (RAM)", L" MB");
+        table->AddRow();
+        table->Set(os, Utf8ToWide(uts.sysname) + L" (Version " + Utf8ToWide(uts.release) + L")");
+        table->Set(cpu, Utf8ToWide(uts.machine));
+        table->Set(count, static_cast<uint64_t>(cpus));
+        table->Set(memory, ram / (1024 * 1024));
+        console.AddTable(std::move(table));
+    }
+
+    void TaskList(JobContext& job) override {
+        auto table = std::make_shared<ResultTable>();
+        size_t name = table->AddTextColumn(L"Abbildname");
+        size_t pid = table->AddNumberColumn(L"PID");
+
+        std::error_code ec;
+        std::string comm;
+        for (const fs::directory_entry& entry : fs::directory_iterator("/proc", ec)) {
+            if (job.Cancelled()) return;
+            std::string id = entry.path().filename().string();
+            if (id.empty() || id.find_first_not_of("0123456789") != std::string::npos) continue;
+
+            std::ifstream file(entry.path() / "comm");
+            if (!std::getline(file, comm)) continue;
+
+            table->AddRow();
+            table->Set(name, Utf8ToWide(comm));
+            table->Set(pid, static_cast<uint64_t>(std::stoull(id)));
+        }
+        job.AddTable(std::move(table));
+    }
+
+    void Vol(ConsoleEngine& console) override {
+        NotAvailable(console, L"VOL");
+    }
+
+    std::wstring WorkingDirectory() override {
+        std::error_code ec;
+        fs::path path = fs::current_path(ec);
+        return ec ? std::wstring(L".") : Utf8ToWide(path.string());
+    }
+
+    void Type(ConsoleEngine& console, const std::wstring& filename) override {
+        console.ViewFile(filename, filename);
+    }
+
+    void Hostname(ConsoleEngine& console) override {
+        char name[256] = { 0 };
+        if (gethostname(name, sizeof(name) - 1) == 0) {
+            console.AddHistory(Utf8ToWide(name));
+        }
+        else {
+            console.AddError(L"FEHLER: Computername konnte nicht abgerufen werden.");
+        }
+    }
+
+    void Whoami(ConsoleEngine& console) override {
+        struct passwd* pw = getpwuid(geteuid());
+        if (pw && pw->pw_name) {
+            console.AddHistory(Utf8ToWide(pw->pw_name));
+        }
+        else {
+            console.AddError(L"FEHLER: Benutzername konnte nicht abgerufen werden.");
+        }
+    }
+
+    bool ProcessMemory(uint64_t& residentBytes, uint64_t& privateBytes) override {
+        // Seiten: gesamt, resident, davon geteilt (Bibliotheken, Programmdatei)
+        std::ifstream file("/proc/self/statm");
+        uint64_t size = 0, resident = 0, shared = 0;
+        if (!(file >> size >> resident >> shared)) return false;
+        uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        residentBytes = resident * page;
+        privateBytes = (resident > shared ? resident - shared : 0) * page;
+        return true;
+    }
+
+    void Uptime(ConsoleEngine& console) override {
+        std::ifstream file("/proc/uptime");
+        double uptime = 0.0;
+        if (!(file >> uptime)) {
+            console.AddError(L"FEHLER: Systemlaufzeit konnte nicht abgerufen werden.");
+            return;
+        }
+        unsigned long long seconds = static_cast<unsigned long long>(uptime);
+        unsigned long long minutes = seconds / 60;
+        unsigned long long hours = minutes / 60;
+        unsigned long long days = hours / 24;
+
+        std::wstringstream ss;
+        ss << L"System-Uptime: " << days << L" Tage, "
+            << hours % 24 << L" Stunden, "
+            << minutes % 60 << L" Minuten, "
+            << seconds % 60 << L" Sekunden";
+        console.AddHistory(ss.str());
+    }
+
+    bool CheckForUpdate(ConsoleEngine& console) override {
+        NotAvailable(console, L"UPDATE");
+        return false;
+    }
+
+    void PerformUpdate(ConsoleEngine& console) override {
+        NotAvailable(console, L"UPDATE");
+    }
+
+    void StartCountdown() override {
+        exitRequested = true;
+    }
+
+private:
+    // Fuer ConsoleEngine und JobContext (beide mit AddError)
+    template <typename Output>
+    static void NotAvailable(Output& console, const wchar_t* command) {
+        console.AddError(std::wstring(L"FEHLER: ") + command + L" ist im Headless-Modus nicht verfuegbar.");
+    }
+};
+
+/**
+ * Schreibt alle seit dem letzten Aufruf hinzugekommenen Verlaufszeilen nach stdout.
+ * printed ist die fortlaufende Nummer der naechsten auszugebenden Zeile.
+ */
+static void FlushHistory(const ConsoleEngine& console, uint64_t& printed) {
+    const Scrollback& history = console.History();
+    uint64_t first = history.TotalLines() - history.Size();
+    if (printed < first) printed = first; // bereits verdraengt oder per CLS geloescht
+    std::wstring scratch;
+    for (; printed < history.TotalLines(); ++printed) {
+        std::string line = WideToUtf8(history.Line(static_cast<size_t>(printed - first), scratch));
+        line += '\n';
+        fwrite(line.data(), 1, line.size(), stdout);
+    }
+}
+
+/**
+ * TYPE ohne Fenster: die Dateianzeige Seite fuer Seite nach stdout schreiben und wieder
+ * schliessen. Dekodiert ist dabei immer nur eine Seite, der Verlauf waechst nicht.
+ */
+static void PrintViewer(ConsoleEngine& console, int pageRows, bool echo) {
+    FileViewer* viewer = console.Viewer();
+    viewer->WaitForIndex();
+    uint64_t lines = viewer->KnownLines();
+    std::string out;
+    for (uint64_t first = 0; echo && first < lines; first += pageRows) {
+        viewer->Materialize(first, pageRows);
+        out.clear();
+        for (size_t i = 0; i < viewer->MaterializedLines(); ++i) {
+            out += WideToUtf8(viewer->Line(first + i));
+            out += '\n';
+        }
+        fwrite(out.data(), 1, out.size(), stdout);
+    }
+    console.CloseViewer();
+}
+
+/**
+ * Laesst den EXIT-Countdown mit einer virtuellen Uhr ablaufen: gleiche Termine wie im Fenster
+ * (eine Sekunde ab EXIT), aber ohne zu warten.
+ */
+static void RunCountdown(ConsoleEngine& console) {
+    const uint64_t step = 1000;
+    TimerWheel timers;
+    bool finished = false;
+    std::function<void(uint64_t)> tick = [&](uint64_t now) {
+        if (console.TickCountdown()) finished = true;
+        else timers.Schedule(now + step, tick);
+    };
+    timers.Schedule(step, tick);
+    while (!finished && timers.Pending() > 0) {
+        timers.RunDue(timers.NextDeadline());
+    }
+    console.AddLine(console.BottomLine(false));
+}
+
+struct SessionOptions {
+    bool banner = true;
+    bool echo = true;
+    size_t scrollback = 0;
+    bool stats = false;
+    std::string renderPath; // leer = nicht rendern
+    int columns = 80;
+    int rows = 25;
+    bool fakePing = false;
+    std::string sessionPath; // leer = kein Sitzungsprotokoll
+};
+
+/**
+ * Bildschirm des Headless-Frontends: gleicher Zeichenpfad wie im Fenster (ScreenModel,
+ * Glyphen-Atlas, CellRenderer), nur mit eingebauter Schrift und eigenem Pixelpuffer.
+ */
+class HeadlessScreen {
+public:
+    HeadlessScreen(int columns, int rows)
+        : m_atlas(m_font), m_renderer(m_atlas, m_frame) {
+        m_frame.Allocate(CellRenderer::DEFAULT_X_PADDING + columns * m_atlas.CellWidth(), (rows + 1) * m_atlas.CellHeight());
+        m_screen.Resize(rows);
+    }
+
+    void Render(ConsoleEngine& console) {
+        console.TickClock(); // Sekundentakt der Uhr (CLOCK), im Fenster per Timer
+        m_renderer.Render(m_screen, console, m_screen.Update(console, true));
+    }
+
+    const Framebuffer& Frame() const { return m_frame; }
+
+private:
+    BuiltinFont m_font;
+    GlyphAtlas m_atlas;
+    Framebuffer m_frame;
+    CellRenderer m_renderer;
+    ScreenModel m_screen;
+};
+
+/**
+ * Wartet auf den Vordergrundbefehl (bzw. mit all auch auf alle Hintergrundbefehle) und
+ * uebernimmt dabei laufend dessen Ausgaben, wie es die Nachrichtenschleife im Fenster tut.
+ */
+static void WaitForJobs(ConsoleEngine& console, CommandExecutor& executor, bool all) {
+    while (console.IsBusy() || (all && executor.ActiveJobs() > 0)) {
+        executor.WaitForEvents(std::chrono::milliseconds(100));
+        console.PumpJobs();
+    }
+    console.PumpJobs();
+}
+
+/**
+ * Fuehrt eine vollstaendige Sitzung mit den gegebenen Befehlen aus.
+ */
+static bool RunSession(const std::vector<std::wstring>& script, const SessionOptions& options, CommandExecutor& executor) {
+    StartupTrace startup; // ab Beginn der Sitzung; STARTUP und --stats
+    HeadlessConsoleHost host;
+    host.fakePing = options.fakePing;
+    ConsoleEngine console(host);
+    console.AttachExecutor(&executor);
+    console.SetStartupTrace(&startup);
+    uint64_t printed = 0;
+    std::unique_ptr<HeadlessScreen> screen;
+    if (!options.renderPath.empty()) {
+        screen = std::make_unique<HeadlessScreen>(options.columns, options.rows);
+    }
+
+    if (options.scrollback > 0) console.SetScrollbackLimit(options.scrollback);
+
+    // Verlauf frueherer Sitzungen wiederherstellen; das Banner nur, wenn es keinen gibt
+    SessionLog log;
+    if (!options.sessionPath.empty()) {
+        std::wstring error;
+        if (!log.Open(Utf8ToWide(options.sessionPath), error)) {
+            fprintf(stderr, "FEHLER: %s\n", WideToUtf8(error).c_str());
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        RestoredSession restored;
+        log.Replay(console.History().MaxLines(), ConsoleEngine::MAX_COMMAND_HISTORY, restored);
+        console.RestoreSession(restored);
+        if (options.stats) {
+            fprintf(stderr, "Wiederhergestellt: %zu Zeilen, %zu Befehle in %.2f ms\n", restored.lines.size(), restored.commands.size(),
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        console.AttachSessionLog(&log);
+    }
+    if (options.banner && console.History().Empty()) console.PrintBanner();
+    startup.Mark(L"Verlauf bereit");
+    if (options.echo) FlushHistory(console, printed);
+    if (screen) {
+        screen->Render(console);
+        startup.Mark(StartupTrace::FIRST_PAINT);
+    }
+    startup.Mark(StartupTrace::INTERACTIVE);
+
+    for (const std::wstring& command : script) {
+        console.ProcessCommand(command);
+        WaitForJobs(console, executor, false);
+        if (console.IsViewing()) {
+            if (options.echo) FlushHistory(console, printed);
+            if (screen) screen->Render(console);
+            PrintViewer(console, std::max(options.rows - 1, 1), options.echo);
+        }
+        if (host.exitRequested) {
+            RunCountdown(console);
+        }
+        if (options.echo) FlushHistory(console, printed);
+        if (screen) screen->Render(console);
+        if (host.exitRequested) break;
+    }
+
+    // Hintergrundbefehle (START) zu Ende laufen lassen
+    WaitForJobs(console, executor, true);
+    if (options.echo) FlushHistory(console, printed);
+
+    if (options.stats) {
+        fprintf(stderr, "%s", WideToUtf8(startup.Format()).c_str());
+        const Scrollback& history = console.History();
+        fprintf(stderr, "Verlauf: %zu Zeilen, %llu verdraengt, %zu Chunks, %zu Bytes belegt, %zu Bytes Text\n",
+            history.Size(), static_cast<unsigned long long>(history.EvictedLines()), history.ChunkCount(),
+            history.ResidentBytes(), history.TextBytes());
+    }
+
+    if (log.IsOpen()) {
+        console.AttachSessionLog(nullptr);
+        log.Close();
+        if (options.stats) {
+            fprintf(stderr, "Protokoll: %llu Eintraege, %llu Bytes in %llu Schreibvorgaengen, %zu Segmente\n",
+                static_cast<unsigned long long>(log.WrittenRecords()), static_cast<unsigned long long>(log.WrittenBytes()),
+                static_cast<unsigned long long>(log.Batches()), log.Segments());
+        }
+    }
+
+    if (screen && !WritePpm(screen->Frame(), options.renderPath)) {
+        fprintf(stderr, "FEHLER: %s konnte nicht geschrieben werden.\n", options.renderPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SessionOptions options;
+    long repeat = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--no-banner") == 0) {
+            options.banner = false;
+        }
+        else if (strcmp(argv[i], "--stats") == 0) {
+            options.stats = true;
+        }
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = strtol(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--scrollback") == 0 && i + 1 < argc) {
+            options.scrollback = strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+            options.renderPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--screen") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &options.columns, &options.rows) != 2 || options.columns <= 0 || options.rows <= 0) {
+                fprintf(stderr, "FEHLER: --screen erwartet SPALTENxZEILEN, z.B. 80x25.\n");
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "--perf") == 0) {
+            Perf::Enable(true);
+        }
+        else if (strcmp(argv[i], "--fake-ping") == 0) {
+            options.fakePing = true;
+        }
+        else if (strcmp(argv[i], "--session") == 0 && i + 1 < argc) {
+            options.sessionPath = argv[++i];
+        }
+        else {
+            fprintf(stderr, "Aufruf: %s [--no-banner] [--repeat N] [--scrollback N] [--stats] [--perf] [--render bild.ppm] [--screen SPALTENxZEILEN] [--fake-ping] [--session verzeichnis] < script.txt\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Perf::SetThreadName(L"UI");
+    std::vector<std::wstring> script;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        script.push_back(Utf8ToWide(line));
+    }
+
+    CommandExecutor executor(2);
+    if (repeat <= 0) {
+        return RunSession(script, options, executor) ? 0 : 1;
+    }
+
+    // Benchmark-Modus: N unabhaengige Sitzungen ohne Ausgabe
+    auto start = std::chrono::steady_clock::now();
+    options.echo = false;
+    const bool stats = options.stats;
+    for (long i = 0; i < repeat; ++i) {
+        options.stats = stats && i == repeat - 1;
+        if (!RunSession(script, options, executor)) return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%ld Sitzungen in %.3f s (%.0f Sitzungen/s)\n", repeat, seconds,
+        seconds > 0.0 ? repeat / seconds : 0.0);
+    return 0;
+}
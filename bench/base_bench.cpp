@@ -0,0 +1,114 @@
+// Benchmark der Zahlenumwandlung (HEX/DEC/BASE):
+//  - 64-Bit-Werte: frueherer Weg ueber std::stoll / std::wstringstream gegen BigInteger
+//  - grosse Zahlen: Teile-und-herrsche-Umwandlung gegen die quadratische Schulmethode
+//    (Horner beim Einlesen, fortgesetzte Division durch 10^9 beim Ausgeben)
+//
+//   base_bench [Durchlaeufe]
+
+#include "engine/bignum.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Die frueheren Befehle HEX und DEC ohne Ausgabe
+std::wstring LegacyHex(const std::wstring& dec) {
+    long long value = std::stoll(dec);
+    std::wstringstream ss;
+    ss << std::hex << std::uppercase << value;
+    return ss.str();
+}
+
+std::wstring LegacyDec(const std::wstring& hex) {
+    long long value;
+    std::wstringstream ss;
+    ss << std::hex << hex;
+    ss >> value;
+    return std::to_wstring(value);
+}
+
+std::vector<uint32_t> SchoolParse(const std::wstring& digits) {
+    std::vector<uint32_t> value;
+    for (wchar_t c : digits) {
+        uint64_t carry = static_cast<uint64_t>(c - L'0');
+        for (uint32_t& limb : value) {
+            uint64_t t = static_cast<uint64_t>(limb) * 10 + carry;
+            limb = static_cast<uint32_t>(t);
+            carry = t >> 32;
+        }
+        if (carry) value.push_back(static_cast<uint32_t>(carry));
+    }
+    return value;
+}
+
+std::wstring SchoolToDecimal(std::vector<uint32_t> value) {
+    std::wstring digits;
+    while (!value.empty()) {
+        uint64_t remainder = 0;
+        for (size_t i = value.size(); i-- > 0;) {
+            uint64_t current = remainder << 32 | value[i];
+            value[i] = static_cast<uint32_t>(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        while (!value.empty() && value.back() == 0) value.pop_back();
+        for (int i = 0; i < 9; ++i) {
+            digits += static_cast<wchar_t>(L'0' + remainder % 10);
+            remainder /= 10;
+        }
+    }
+    while (digits.size() > 1 && digits.back() == L'0') digits.pop_back();
+    return std::wstring(digits.rbegin(), digits.rend());
+}
+
+template <typename Function>
+double MillisPerCall(long runs, Function function) {
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < runs; ++i) sink = sink + function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long runs = argc > 1 ? strtol(argv[1], nullptr, 10) : 100000;
+    if (runs <= 0) runs = 100000;
+
+    const std::wstring dec = L"9223372036854775807";
+    const std::wstring hex = L"7FFFFFFFFFFFFFFF";
+    BigInteger value;
+    printf("64 Bit             %14s %14s\n", "bisher ns", "BigInteger ns");
+    printf("HEX %-14ls %14.1f %14.1f\n", dec.c_str(),
+        MillisPerCall(runs, [&] { return LegacyHex(dec).size(); }) * 1e6,
+        MillisPerCall(runs, [&] { BigInteger::Parse(dec, 10, value); return value.ToString(16).size(); }) * 1e6);
+    printf("DEC %-14ls %14.1f %14.1f\n", hex.c_str(),
+        MillisPerCall(runs, [&] { return LegacyDec(hex).size(); }) * 1e6,
+        MillisPerCall(runs, [&] { BigInteger::Parse(hex, 16, value); return value.ToString(10).size(); }) * 1e6);
+
+    printf("\n%-10s %12s %12s %12s %12s\n", "Stellen", "ein D&C ms", "ein Schule", "aus D&C ms", "aus Schule");
+    std::mt19937 random(42);
+    for (size_t length : { 100, 1000, 10000, 100000 }) {
+        std::wstring digits(length, L'0');
+        for (wchar_t& c : digits) c = static_cast<wchar_t>(L'0' + random() % 10);
+        digits[0] = L'7';
+        long repeat = std::max(1L, static_cast<long>(2000000 / (length * length / 100 + 1)));
+
+        BigInteger::Parse(digits, 10, value);
+        if (value.ToString(10) != digits || SchoolToDecimal(value.Magnitude()) != digits) {
+            printf("Fehler: Umwandlung mit %zu Stellen stimmt nicht\n", length);
+            return 1;
+        }
+        printf("%-10zu %12.3f %12.3f %12.3f %12.3f\n", length,
+            MillisPerCall(repeat, [&] { BigInteger::Parse(digits, 10, value); return value.BitLength(); }),
+            MillisPerCall(repeat, [&] { return SchoolParse(digits).size(); }),
+            MillisPerCall(repeat, [&] { return value.ToString(10).size(); }),
+            MillisPerCall(repeat, [&] { return SchoolToDecimal(value.Magnitude()).size(); }));
+    }
+    return 0;
+}
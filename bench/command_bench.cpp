@@ -0,0 +1,94 @@
+// Mikro-Benchmark der Befehlszuordnung: Kosten pro Befehl fuer Zerlegung und Suche in der
+// Befehlstabelle, im Vergleich mit der frueheren Zuordnung (ToUpper-Kopie, zwei
+// std::wstringstream, if/else-Kette), sowie ein kompletter ProcessCommand-Durchlauf.
+//
+//   command_bench [Durchlaeufe]
+
+#include "engine/commands.h"
+#include "engine/console.h"
+#include "null_host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Die frueheren Vergleiche in ihrer Reihenfolge; unbekannte Namen liefen bis zum Ende durch
+const wchar_t* const LEGACY_ORDER[] = {
+    L"HELP", L"DATE", L"TIME", L"CLEAR", L"CLS", L"UPDATE", L"EXIT", L"PING", L"IPCONFIG", L"SYSTEMINFO",
+    L"TASKLIST", L"NETSTAT", L"VOL", L"DIR", L"START", L"JOBS", L"STOP", L"TYPE", L"HOSTNAME", L"WHOAMI",
+    L"UPTIME", L"VER", L"ECHO", L"HEX", L"DEC", L"SQRT", L"POW", L"LOG", L"LOG10", L"SIN", L"COS", L"TAN",
+};
+
+size_t LegacyDispatch(const std::wstring& command) {
+    std::wstring upperCommand = ToUpper(command);
+    std::wstringstream iss(upperCommand);
+    std::wstringstream orig_iss(command);
+    std::wstring cmd, arg1, arg2;
+    iss >> cmd >> arg1 >> arg2;
+    for (size_t i = 0; i < std::size(LEGACY_ORDER); ++i) {
+        if (cmd == LEGACY_ORDER[i]) return i;
+    }
+    return std::size(LEGACY_ORDER);
+}
+
+size_t Dispatch(const std::wstring& command) {
+    CommandLine line(command);
+    const CommandSpec* spec = ConsoleEngine::Commands().Find(line.Name());
+    return spec ? static_cast<size_t>(spec - ConsoleEngine::Commands().begin()) + line.ArgCount() : 0;
+}
+
+template <typename Function>
+double NanosPerCall(long runs, const std::wstring& command, Function function) {
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < runs; ++i) {
+        sink = sink + function(command);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long runs = argc > 1 ? strtol(argv[1], nullptr, 10) : 200000;
+    if (runs <= 0) runs = 200000;
+
+    std::vector<std::wstring> commands;
+    for (const CommandSpec& spec : ConsoleEngine::Commands()) {
+        commands.push_back(std::wstring(spec.name) + (spec.minArgs ? L" 42 7" : L""));
+    }
+    commands.push_back(L"echo Hallo Welt");
+    commands.push_back(L"UNBEKANNT foo");
+
+    printf("%-16s %14s %14s\n", "Befehl", "Tabelle ns", "bisher ns");
+    double table = 0.0;
+    double legacy = 0.0;
+    for (const std::wstring& command : commands) {
+        double t = NanosPerCall(runs, command, Dispatch);
+        double l = NanosPerCall(runs, command, LegacyDispatch);
+        table += t;
+        legacy += l;
+        printf("%-16ls %14.1f %14.1f\n", command.c_str(), t, l);
+    }
+    printf("%-16s %14.1f %14.1f\n", "Mittel", table / commands.size(), legacy / commands.size());
+
+    // Kompletter Durchlauf inkl. Echo der Eingabe im Verlauf
+    NullHost host;
+    ConsoleEngine console(host);
+    console.SetScrollbackLimit(1000);
+    for (const wchar_t* command : { L"VER", L"ECHO Hallo Welt", L"HEX 255", L"SQRT 2", L"UNBEKANNT" }) {
+        std::wstring line = command;
+        double ns = NanosPerCall(runs, line, [&console](const std::wstring& text) {
+            console.ProcessCommand(text);
+            return size_t(0);
+        });
+        printf("ProcessCommand %-16ls %10.1f ns\n", command, ns);
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Benchmark von FIND/FINDSTR: Durchsatz in GB/s ueber eine grosse, eingeblendete Protokolldatei
+// bei warmem Dateicache, jeweils bester von drei Laeufen. Zum Vergleich memchr und
+// std::string_view::find; die Trefferzahlen muessen fuer Literal und Vergleich gleich sein.
+//
+//   find_bench [megabyte]   Testdatei im Temp-Verzeichnis anlegen (Standard 256), messen, loeschen
+//   find_bench --file <pfad>   vorhandene Datei durchsuchen (Muster passen dann evtl. nicht)
+
+#include "engine/line_index.h"
+#include "engine/mapped_file.h"
+#include "engine/search.h"
+#include "engine/utf8.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class NullJob : public JobContext {
+public:
+    void AddHistory(const std::wstring&) override {}
+    void SetLiveLine(uint32_t, const std::wstring&) override {}
+    void AddTable(std::shared_ptr<ResultTable>) override {}
+    bool Cancelled() const override { return false; }
+    bool Sleep(uint32_t) override { return true; }
+};
+
+// Summiert die Zaehlerstaende von FIND /C ("---------- name: 12")
+class CountJob : public NullJob {
+public:
+    void AddHistory(const std::wstring& text) override {
+        for (size_t pos = text.find(L": "); pos != std::wstring::npos; pos = text.find(L": ", pos + 1)) {
+            total += wcstoull(text.c_str() + pos + 2, nullptr, 10);
+        }
+    }
+
+    uint64_t total = 0;
+};
+
+// Zeilen wie in einem Anwendungsprotokoll; "Timeout" ist selten, "INFO" haeufig
+void CreateLog(const fs::path& path, long megabytes) {
+    static const char* const messages[] = {
+        "INFO  Verbindung zu 10.0.0.%d hergestellt",
+        "DEBUG Cache-Treffer fuer Schluessel user:%d",
+        "INFO  Anfrage GET /api/v1/items/%d beantwortet in 12 ms",
+        "WARN  Langsame Antwort von Dienst %d",
+        "INFO  Sitzung %d beendet",
+    };
+    std::ofstream out(path, std::ios::binary);
+    std::string line;
+    char buffer[160];
+    const uint64_t target = static_cast<uint64_t>(megabytes) << 20;
+    uint64_t written = 0;
+    for (unsigned long n = 0; written < target; ++n) {
+        int length = n % 9973 == 0
+            ? snprintf(buffer, sizeof(buffer), "2024-03-01 12:%02lu:%02lu ERROR Timeout beim Lesen von Port %lu\r\n", n / 60 % 60, n % 60, n % 65536)
+            : snprintf(buffer, sizeof(buffer), "2024-03-01 12:%02lu:%02lu ", n / 60 % 60, n % 60);
+        line.assign(buffer, static_cast<size_t>(length));
+        if (n % 9973 != 0) {
+            length = snprintf(buffer, sizeof(buffer), messages[n % 5], static_cast<int>(n % 1000));
+            line.append(buffer, static_cast<size_t>(length));
+            line += "\r\n";
+        }
+        out << line;
+        written += line.size();
+    }
+}
+
+double Measure(const std::function<uint64_t()>& run, uint64_t& hits) {
+    double best = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        hits = run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+void Report(const char* name, uint64_t bytes, const std::function<uint64_t()>& run) {
+    uint64_t hits = 0;
+    double seconds = Measure(run, hits);
+    printf("%-40s %8.2f GB/s %10.1f ms %12llu\n", name, bytes / seconds / 1e9, seconds * 1000.0, static_cast<unsigned long long>(hits));
+}
+
+uint64_t ScanPattern(const MappedFile& file, const wchar_t* pattern, bool regex, bool ignoreCase, bool lineNumbers) {
+    std::vector<TextPattern> patterns(1);
+    std::wstring error;
+    if (!patterns[0].Compile(pattern, regex, ignoreCase, error)) return 0;
+    LineScanner scanner(patterns, false, lineNumbers);
+    return scanner.Scan(file.Data(), file.Data() + file.Size(), [](uint64_t, const char*, const char*) {});
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    fs::path path;
+    bool created = false;
+    if (argc > 2 && strcmp(argv[1], "--file") == 0) {
+        path = argv[2];
+    }
+    else {
+        long megabytes = argc > 1 ? strtol(argv[1], nullptr, 10) : 256;
+        if (megabytes <= 0) megabytes = 256;
+        path = fs::temp_directory_path() / "find_bench.log";
+        auto start = std::chrono::steady_clock::now();
+        CreateLog(path, megabytes);
+        printf("Testdatei %s: %ld MB in %.1f s angelegt\n", path.string().c_str(), megabytes,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        created = true;
+    }
+
+    MappedFile file;
+    std::wstring error;
+    if (!file.Open(Utf8ToWide(path.string()), error)) {
+        fprintf(stderr, "FEHLER: %s\n", WideToUtf8(error).c_str());
+        return 1;
+    }
+    const char* data = file.Data();
+    const uint64_t size = file.Size();
+    volatile uint64_t sink = CountNewlines(data, data + size); // Dateicache und Seiten fuellen
+    (void)sink;
+
+    printf("%-40s %13s %13s %12s\n", "Suche", "Durchsatz", "Zeit", "Treffer");
+    Report("Zeilen zaehlen (CountNewlines)", size, [&] { return CountNewlines(data, data + size); });
+    Report("memchr '\\n' (Vergleich)", size, [&] {
+        uint64_t lines = 0;
+        for (const char* p = data; (p = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(data + size - p)))) != nullptr; ++p) ++lines;
+        return lines;
+    });
+    Report("string_view::find (Vergleich)", size, [&] {
+        std::string_view text(data, static_cast<size_t>(size));
+        uint64_t found = 0;
+        for (size_t pos = text.find("Timeout"); pos != std::string_view::npos; pos = text.find("Timeout", pos + 1)) ++found;
+        return found;
+    });
+    Report("FIND \"Timeout\"", size, [&] { return ScanPattern(file, L"Timeout", false, false, false); });
+    Report("FIND /N \"Timeout\"", size, [&] { return ScanPattern(file, L"Timeout", false, false, true); });
+    Report("FIND /I \"timeout\"", size, [&] { return ScanPattern(file, L"timeout", false, true, false); });
+    Report("FIND \"INFO\" (haeufig)", size, [&] { return ScanPattern(file, L"INFO", false, false, false); });
+    Report("FINDSTR \"ERROR.*Port 1[0-9]*\"", size, [&] { return ScanPattern(file, L"ERROR.*Port 1[0-9]*", true, false, false); });
+    Report("FINDSTR \"^2024.*ms$\" (jede Zeile)", size, [&] { return ScanPattern(file, L"^2024.*ms$", true, false, false); });
+    Report("FINDSTR \"[EW][AR]R\" (ohne Literal)", size, [&] { return ScanPattern(file, L"[EW][AR]R", true, false, false); });
+
+    // Ganzer Befehl mit mehreren Dateien (hier viermal dieselbe), je Datei ein Thread
+    SearchOptions options;
+    options.count = true;
+    options.patterns = { L"Timeout" };
+    options.files.assign(4, Utf8ToWide(path.string()));
+    Report("FIND /C \"Timeout\" (4 Dateien, parallel)", size * 4, [&] {
+        CountJob job;
+        RunSearch(job, L".", options);
+        return job.total;
+    });
+
+    if (created) fs::remove(path);
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Benchmark der Verlaufssuche (Strg+R/Strg+F, HISTORY /FIND): Kosten des Index je angehaengter
+// Zeile und Dauer einer Suche vom Ende des Verlaufs, fuer seltene, fehlende und haeufige
+// Suchtexte, jeweils Median von 21 Laeufen.
+//
+//   history_search_bench [zeilen]   Standard 1000000
+
+#include "engine/scrollback.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+double MicrosSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Gemischte Ausgaben wie im Alltag: PING, DIR, TASKLIST
+std::wstring SampleLine(long i) {
+    switch (i % 4) {
+    case 0: return L"Antwort von 192.168.0." + std::to_wstring(i % 255) + L": Bytes=32 Zeit=" + std::to_wstring(i % 17) + L"ms TTL=128";
+    case 1: return L"17.10.2026  12:" + std::to_wstring(10 + i % 50) + L"    " + std::to_wstring(i * 37 % 100000) + L" datei" + std::to_wstring(i) + L".txt";
+    case 2: return L"svchost.exe                 " + std::to_wstring(1000 + i % 9000) + L" Services                   0     12.345 K";
+    default: return L"C:\\> PING 192.168.0.1";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long lines = argc > 1 ? strtol(argv[1], nullptr, 10) : 1000000;
+    if (lines <= 0) lines = 1000000;
+
+    Scrollback history(static_cast<size_t>(lines));
+    std::vector<std::wstring> texts;
+    texts.reserve(4096);
+    for (long i = 0; i < 4096; ++i) texts.push_back(SampleLine(i));
+
+    // Anhaengen mit Index; ein Treffer kurz nach dem Anfang, damit fast alles zu durchsuchen ist
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lines; ++i) {
+        history.AppendLine(i == lines / 100 ? std::wstring(L"FEHLER: Zeitueberschreitung der Anforderung.") : texts[static_cast<size_t>(i) % texts.size()]);
+    }
+    double append = MicrosSince(start);
+    printf("Anhaengen:   %ld Zeilen in %.1f ms (%.0f ns je Zeile), Verlauf %.1f MB\n", lines, append / 1000,
+        append * 1000 / lines, history.ResidentBytes() / 1048576.0);
+
+    struct Case {
+        const wchar_t* label;
+        const wchar_t* text;
+    };
+    const Case cases[] = {
+        { L"selten", L"zeitueberschreitung" },
+        { L"selten, 3 Zeichen", L"fehl" },
+        { L"fehlt", L"host unreachable" },
+        { L"haeufig", L"svchost" },
+    };
+    for (const Case& c : cases) {
+        HistoryIndex::Query query = HistoryIndex::Prepare(c.text);
+        std::vector<double> times;
+        Scrollback::Match match{};
+        bool found = false;
+        for (int run = 0; run < 21; ++run) {
+            start = std::chrono::steady_clock::now();
+            found = history.Find(query, history.Size() - 1, true, match);
+            times.push_back(MicrosSince(start));
+        }
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        printf("Suche %-20ls %9.1f us   %ls\n", (std::wstring(L"(") + c.label + L"):").c_str(), times[times.size() / 2],
+            found ? (L"Zeile " + std::to_wstring(match.line + 1)).c_str() : L"kein Treffer");
+    }
+
+    // Alle Treffer zaehlen wie HISTORY /FIND
+    HistoryIndex::Query query = HistoryIndex::Prepare(L"192.168.0.17:");
+    start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    Scrollback::Match match{};
+    size_t from = history.Size() - 1;
+    while (history.Find(query, from, true, match)) {
+        count++;
+        if (match.line == 0) break;
+        from = match.line - 1;
+    }
+    printf("Alle Treffer zaehlen:      %9.1f us   %zu Treffer\n", MicrosSince(start), count);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "engine/console.h"
+
+#include <memory>
+#include <string>
+
+/**
+ * Host ohne Systembefehle; die Benchmarks nutzen nur Verlauf, Eingabezeile und Befehlszuordnung.
+ */
+class NullHost : public ConsoleHost {
+public:
+    void TaskList(JobContext&) override {}
+    std::unique_ptr<PingProber> CreatePingProber() override { return nullptr; }
+    std::unique_ptr<ConnectionSource> CreateConnectionSource() override { return nullptr; }
+    std::unique_ptr<ProcessSampler> CreateProcessSampler() override { return nullptr; }
+    std::unique_ptr<NetConfigSource> CreateNetConfigSource() override { return nullptr; }
+    std::unique_ptr<SystemSampler> CreateSystemSampler() override { return nullptr; }
+    std::wstring WorkingDirectory() override { return L"."; }
+    void SystemInfo(ConsoleEngine&) override {}
+    void Vol(ConsoleEngine&) override {}
+    void Type(ConsoleEngine&, const std::wstring&) override {}
+    void Hostname(ConsoleEngine&) override {}
+    void Whoami(ConsoleEngine&) override {}
+    void Uptime(ConsoleEngine&) override {}
+    bool CheckForUpdate(ConsoleEngine&) override { return false; }
+    void PerformUpdate(ConsoleEngine&) override {}
+};
@@ -0,0 +1,144 @@
+// Benchmark von Pipelines und CALL: Durchsatz in Zeilen/s von "quelle | FIND" und
+// "quelle | FIND | SORT" (jede Stufe auf eigenem Thread, begrenzte Warteschlangen), dazu ein
+// langsamer Leser, an dem der Gegendruck sichtbar wird. Fuer CALL die Kosten des Uebersetzens
+// einer Batchdatei gegenueber einem Treffer im Inhalts-Cache, jeweils Median von 21 Laeufen.
+//
+//   pipeline_bench [zeilen]   Standard 1000000
+
+#include "engine/batch.h"
+#include "engine/pipeline.h"
+#include "engine/search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Zaehlt ausgegebene Zeilen, zeigt nichts an
+class CountJob : public JobContext {
+public:
+    void AddHistory(const std::wstring& text) override {
+        lines += 1 + static_cast<uint64_t>(std::count(text.begin(), text.end(), L'\n'));
+        last = text.substr(text.rfind(L'\n') + 1);
+    }
+    void SetLiveLine(uint32_t, const std::wstring&) override {}
+    void AddTable(std::shared_ptr<ResultTable>) override {}
+    bool Cancelled() const override { return false; }
+    bool Sleep(uint32_t) override { return true; }
+
+    uint64_t lines = 0;
+    std::wstring last;
+};
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double MicrosSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Ausgabe wie TASKLIST, schubweise ueber OutputBlock
+PipeSource TaskListSource(long lines, std::atomic<long>* produced) {
+    return [lines, produced](JobContext& job) {
+        OutputBlock out(job);
+        for (long i = 0; i < lines && !job.Cancelled(); ++i) {
+            out.Add((i % 3 == 0 ? L"svchost.exe" : L"explorer.exe") + std::wstring(20, L' ') + std::to_wstring(1000 + i * 7 % 90000) + L" Services   0   12.345 K");
+            if (produced) produced->store(i + 1, std::memory_order_relaxed);
+        }
+    };
+}
+
+PipeFilter Find(const wchar_t* pattern, bool count) {
+    SearchOptions options;
+    std::wstring error;
+    ParseFindArguments(std::wstring(count ? L"/C " : L"") + L"\"" + pattern + L"\"", options, error, true);
+    return [options](JobContext& job, RecordQueue& in, RecordSink& out) { FilterLines(job, in, out, options); };
+}
+
+double MedianMicros(const std::function<void()>& run) {
+    std::vector<double> times;
+    for (int i = 0; i < 21; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        times.push_back(MicrosSince(start));
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long lines = argc > 1 ? strtol(argv[1], nullptr, 10) : 1000000;
+    if (lines <= 0) lines = 1000000;
+
+    auto run = [lines](const char* label, std::vector<PipeFilter> filters) {
+        CountJob job;
+        auto start = std::chrono::steady_clock::now();
+        RunPipeline(job, TaskListSource(lines, nullptr), filters);
+        double seconds = SecondsSince(start);
+        printf("%-28s %ld Zeilen in %7.1f ms (%5.1f Mio. Zeilen/s), Ausgabe %llu Zeilen\n", label, lines, seconds * 1000,
+            lines / seconds / 1e6, static_cast<unsigned long long>(job.lines));
+    };
+    run("TASKLIST | FIND /C:", { Find(L"svchost", true) });
+    run("TASKLIST | FIND:", { Find(L"svchost", false) });
+    SortOptions sort;
+    run("TASKLIST | FIND | SORT:", { Find(L"svchost", false),
+        [&sort](JobContext& job, RecordQueue& in, RecordSink& out) { SortLines(job, in, out, sort); } });
+
+    // Gegendruck: ein Leser, der nach jedem Schub wartet, haelt die Quelle auf wenige Schuebe
+    // Vorsprung (RecordQueue::MAX_BATCHES), statt sie alles in den Speicher schreiben zu lassen
+    {
+        CountJob job;
+        std::atomic<long> produced{ 0 };
+        long maxAhead = 0;
+        long consumed = 0;
+        PipeFilter slow = [&](JobContext&, RecordQueue& in, RecordSink&) {
+            RecordBatch batch;
+            while (in.Read(batch)) {
+                consumed += static_cast<long>(batch.size());
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                maxAhead = std::max(maxAhead, produced.load(std::memory_order_relaxed) - consumed);
+            }
+        };
+        RunPipeline(job, TaskListSource(std::min(lines, 200000L), &produced), { slow });
+        printf("Gegendruck: Quelle hoechstens %ld Zeilen vor dem Leser (Grenze %zu Schuebe zu je bis %zu Zeilen)\n",
+            maxAhead, RecordQueue::MAX_BATCHES, OutputBlock::MAX_LINES);
+    }
+
+    // CALL: Batchdatei mit 300 Anweisungen und 100 Sprungmarken, uebersetzen gegenueber Cache-Treffer
+    fs::path script = fs::temp_directory_path() / "pipeline_bench.bat";
+    {
+        std::ofstream out(script, std::ios::binary);
+        out << "@ECHO OFF\r\nREM Kiosk-Pruefung\r\n";
+        for (int i = 0; i < 100; ++i) {
+            out << ":schritt" << i << "\r\nECHO Schritt " << i << " fuer %1\r\nPING -n 1 %1\r\nTASKLIST | FIND /C \"svchost\"\r\n";
+        }
+        out << "GOTO schritt0\r\n";
+    }
+    std::wstring path = script.wstring();
+    std::wstring error;
+    double compile = MedianMicros([&] {
+        ScriptCache fresh;
+        if (!fresh.Load(path, error)) printf("FEHLER: %ls\n", error.c_str());
+    });
+    ScriptCache cache;
+    cache.Load(path, error);
+    double cached = MedianMicros([&] { cache.Load(path, error); });
+    printf("CALL: Uebersetzen %.1f us, Cache-Treffer (Lesen + Hash) %.1f us, Treffer %llu von %llu\n", compile, cached,
+        static_cast<unsigned long long>(cache.Hits()), static_cast<unsigned long long>(cache.Hits() + cache.Misses()));
+    fs::remove(script);
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Mikro-Benchmark des Zellrenderers: Kosten pro Frame fuer vollstaendiges Neuzeichnen,
+// Tastendruck, neue Ausgabezeile (Scrollen), Cursor-Blinken und Sekundenwechsel der Uhr (CLOCK)
+// auf einem 1920x1080-Puffer.
+//
+//   render_bench [Frames]
+
+#include "engine/console.h"
+#include "engine/glyphs.h"
+#include "engine/renderer.h"
+#include "engine/screen.h"
+#include "null_host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+static void Measure(const char* name, long frames, const std::function<void(long)>& frame) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < frames; ++i) {
+        frame(i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-22s %10.2f us/Frame %12.0f Frames/s\n", name, seconds * 1e6 / frames, frames / seconds);
+}
+
+int main(int argc, char** argv) {
+    long frames = argc > 1 ? strtol(argv[1], nullptr, 10) : 2000;
+    if (frames <= 0) frames = 2000;
+
+    NullHost host;
+    ConsoleEngine console(host);
+    console.PrintBanner();
+    for (int i = 0; i < 200; ++i) {
+        console.AddHistory(L"Zeile " + std::to_wstring(i) + L": The quick brown fox jumps over the lazy dog 0123456789");
+    }
+
+    BuiltinFont font(2);
+    GlyphAtlas atlas(font);
+    Framebuffer frame;
+    frame.Allocate(1920, 1080);
+    CellRenderer renderer(atlas, frame);
+    ScreenModel screen;
+    screen.Resize(renderer.VisibleRows());
+    renderer.Render(screen, console, screen.Update(console, true));
+
+    printf("Puffer %dx%d, Zelle %dx%d, %d Zeilen, Atlas %zu Glyphen / %zu Bytes\n",
+        frame.Width(), frame.Height(), atlas.CellWidth(), atlas.CellHeight(), screen.Rows(),
+        atlas.GlyphCount(), atlas.ResidentBytes());
+
+    Measure("Vollbild", frames, [&](long) {
+        screen.InvalidateAll();
+        renderer.Render(screen, console, screen.Update(console, true));
+    });
+
+    Measure("Tastendruck", frames, [&](long i) {
+        if (console.InputBuffer().size() > 60) console.ClearInput();
+        console.HandleChar(static_cast<wchar_t>(L'a' + i % 26));
+        renderer.Render(screen, console, screen.Update(console, true));
+    });
+
+    Measure("Neue Zeile (Scrollen)", frames, [&](long i) {
+        console.AddHistory(L"Ausgabe " + std::to_wstring(i));
+        renderer.Render(screen, console, screen.Update(console, true));
+    });
+
+    Measure("Cursor-Blinken", frames, [&](long i) {
+        renderer.Render(screen, console, screen.Update(console, i % 2 == 0));
+    });
+
+    // Uhr mit virtueller Zeit: jeder Frame ist eine neue Sekunde
+    console.ShowClock(true);
+    console.TickClock(0);
+    renderer.Render(screen, console, screen.Update(console, true));
+    Measure("Uhr (Sekunde)", frames, [&](long i) {
+        console.TickClock(i + 1);
+        renderer.Render(screen, console, screen.Update(console, true));
+    });
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Benchmark des Sitzungsprotokolls: Kosten je Verlaufszeile auf dem UI-Thread (nur Einreihen),
+// Schreibdurchsatz des Hintergrundthreads und Dauer der Wiederherstellung beim Start
+// (Replay plus Uebernahme in den Scrollback), jeweils bester von drei Laeufen.
+//
+//   session_bench [zeilen]   Standard 100000; Protokoll im Temp-Verzeichnis, wird geloescht
+
+#include "engine/scrollback.h"
+#include "engine/session_log.h"
+#include "engine/utf8.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+double MillisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long lines = argc > 1 ? strtol(argv[1], nullptr, 10) : 100000;
+    if (lines <= 0) lines = 100000;
+    fs::path root = fs::temp_directory_path() / "session_bench";
+    fs::remove_all(root);
+    std::wstring directory = Utf8ToWide(root.string());
+
+    // Zeilen in typischer Laenge, wie sie DIR, PING oder TASKLIST erzeugen
+    std::vector<std::wstring> texts;
+    for (long i = 0; i < 64; ++i) {
+        texts.push_back(L"Antwort von 192.168.0." + std::to_wstring(i) + L": Bytes=32 Zeit=" + std::to_wstring(i % 17) + L"ms TTL=128");
+    }
+
+    // Schreiben: Einreihen auf dem aufrufenden Thread, danach warten, bis alles auf der Platte ist
+    SessionLog::Options options;
+    options.maxBytes = 1ull << 30; // nichts loeschen, das Replay soll alle Zeilen finden
+    SessionLog log(options);
+    std::wstring error;
+    if (!log.Open(directory, error)) {
+        fprintf(stderr, "FEHLER: %s\n", WideToUtf8(error).c_str());
+        return 1;
+    }
+    log.Begin(0);
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lines; ++i) {
+        if (i % 50 == 0) log.AppendCommand(L"PING 192.168.0.1");
+        log.AppendLine(static_cast<uint64_t>(i), texts[static_cast<size_t>(i) % texts.size()]);
+    }
+    double enqueue = MillisSince(start);
+    log.Flush();
+    double written = MillisSince(start);
+    log.Close();
+    printf("Einreihen:   %ld Zeilen in %.1f ms (%.0f ns je Zeile auf dem UI-Thread)\n", lines, enqueue, enqueue * 1e6 / lines);
+    printf("Schreiben:   %.1f ms, %.1f MB in %llu Schreibvorgaengen, %zu Segmente, %llu verworfen\n", written,
+        log.WrittenBytes() / 1e6, static_cast<unsigned long long>(log.Batches()), log.Segments(),
+        static_cast<unsigned long long>(log.DroppedRecords()));
+
+    // Wiederherstellen wie beim Programmstart
+    double best = 0.0;
+    double bestReplay = 0.0;
+    size_t restoredLines = 0;
+    size_t restoredCommands = 0;
+    for (int run = 0; run < 3; ++run) {
+        SessionLog reader(options);
+        if (!reader.Open(directory, error)) return 1;
+        start = std::chrono::steady_clock::now();
+        RestoredSession restored;
+        reader.Replay(static_cast<size_t>(lines), 100, restored);
+        double replay = MillisSince(start);
+        Scrollback history(static_cast<size_t>(lines));
+        for (size_t i = 0; i < restored.lines.size(); ++i) history.AppendLine(restored.Line(i));
+        double total = MillisSince(start);
+        if (run == 0 || total < best) {
+            best = total;
+            bestReplay = replay;
+        }
+        restoredLines = history.Size();
+        restoredCommands = restored.commands.size();
+    }
+    printf("Wiederherstellen: %zu Zeilen, %zu Befehle in %.2f ms (Replay %.2f ms)%s\n", restoredLines, restoredCommands,
+        best, bestReplay, restoredLines + log.DroppedRecords() != static_cast<size_t>(lines) ? "  ABWEICHUNG" : "");
+
+    fs::remove_all(root);
+    return 0;
+}
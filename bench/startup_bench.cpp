@@ -0,0 +1,125 @@
+// Startzeit-Benchmark: alles, was vor dem ersten Bild geschieht und nicht an Win32 haengt -
+// Konsole anlegen, Sitzung aus dem Protokoll wiederherstellen (bzw. Banner), Schrift, Atlas,
+// 1920x1080-Puffer und das erste vollstaendige Rendern. Gemeldet wird der Median je Schritt;
+// liegt das erste Bild ueber dem Budget, endet der Benchmark mit Exitcode 1.
+//
+//   startup_bench [--runs N] [--lines N] [--budget-ms MS]
+//
+// --lines 0 startet ohne Sitzungsprotokoll (nur Banner), Standard sind 10000 Zeilen.
+
+#include "engine/console.h"
+#include "engine/glyphs.h"
+#include "engine/renderer.h"
+#include "engine/screen.h"
+#include "engine/session_log.h"
+#include "engine/startup.h"
+#include "engine/utf8.h"
+#include "null_host.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const wchar_t* const HISTORY_READY = L"Verlauf bereit";
+const wchar_t* const STEPS[] = { HISTORY_READY, StartupTrace::FIRST_PAINT };
+
+// Ein Programmstart bis zum ersten Bild; ein leeres Verzeichnis bedeutet ohne Protokoll.
+StartupTrace RunOnce(const std::wstring& directory) {
+    StartupTrace trace;
+    NullHost host;
+    ConsoleEngine console(host);
+    console.SetStartupTrace(&trace);
+    SessionLog log;
+    std::wstring error;
+    if (!directory.empty() && log.Open(directory, error)) {
+        RestoredSession restored;
+        log.Replay(console.History().MaxLines(), ConsoleEngine::MAX_COMMAND_HISTORY, restored);
+        console.RestoreSession(restored);
+    }
+    if (console.History().Empty()) console.PrintBanner();
+    trace.Mark(HISTORY_READY);
+
+    BuiltinFont font(2);
+    GlyphAtlas atlas(font);
+    Framebuffer frame;
+    frame.Allocate(1920, 1080);
+    CellRenderer renderer(atlas, frame);
+    ScreenModel screen;
+    screen.Resize(renderer.VisibleRows());
+    renderer.Render(screen, console, screen.Update(console, true));
+    trace.Mark(StartupTrace::FIRST_PAINT);
+    return trace;
+}
+
+double Median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long runs = 21;
+    long lines = 10000;
+    double budget = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) runs = strtol(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--lines") == 0 && i + 1 < argc) lines = strtol(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--budget-ms") == 0 && i + 1 < argc) budget = strtod(argv[++i], nullptr);
+        else {
+            fprintf(stderr, "Aufruf: %s [--runs N] [--lines N] [--budget-ms MS]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (runs <= 0) runs = 21;
+
+    // Protokoll einer frueheren Sitzung anlegen
+    fs::path root = fs::temp_directory_path() / "startup_bench";
+    fs::remove_all(root);
+    std::wstring directory;
+    if (lines > 0) {
+        directory = Utf8ToWide(root.string());
+        SessionLog writer;
+        std::wstring error;
+        if (!writer.Open(directory, error)) {
+            fprintf(stderr, "FEHLER: %s\n", WideToUtf8(error).c_str());
+            return 2;
+        }
+        writer.Begin(0);
+        for (long i = 0; i < lines; ++i) {
+            if (i % 50 == 0) writer.AppendCommand(L"PING 192.168.0.1");
+            writer.AppendLine(static_cast<uint64_t>(i), L"Antwort von 192.168.0." + std::to_wstring(i % 256) + L": Bytes=32 Zeit=" +
+                std::to_wstring(i % 17) + L"ms TTL=128");
+        }
+        writer.Close();
+    }
+
+    RunOnce(directory); // Seiten und Dateicache anwaermen
+    std::vector<std::vector<double>> samples(std::size(STEPS));
+    for (long run = 0; run < runs; ++run) {
+        StartupTrace trace = RunOnce(directory);
+        for (size_t step = 0; step < std::size(STEPS); ++step) samples[step].push_back(trace.Micros(STEPS[step]) / 1000.0);
+    }
+    fs::remove_all(root);
+
+    printf("%ld Laeufe, %ld Protokollzeilen, Median:\n", runs, lines);
+    for (size_t step = 0; step < std::size(STEPS); ++step) {
+        printf("    %-20s %8.2f ms\n", WideToUtf8(STEPS[step]).c_str(), Median(samples[step]));
+    }
+    double firstPaint = Median(samples.back());
+
+    if (firstPaint > budget) {
+        printf("BUDGET UEBERSCHRITTEN: erstes Bild nach %.2f ms, erlaubt sind %.2f ms\n", firstPaint, budget);
+        return 1;
+    }
+    printf("Budget eingehalten: %.2f von %.2f ms\n", firstPaint, budget);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Benchmark des Systemmonitors (SYSTEMINFO /WATCH) mit dem /proc-Sampler: Dauer und CPU-Zeit
+// je Stichprobe (Median), daraus die Last im Standardabstand, und die vom laufenden
+// SystemMonitor selbst gemessene Last bei 100 ms Abstand. Exitcode 1, wenn die Last im
+// Standardabstand ueber 0.5 % liegt.
+//
+//   sysmon_bench [stichproben]   Standard 1000
+
+#include "engine/sysmon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double BUDGET_PERCENT = 0.5;
+
+double Median(std::vector<double>& values) {
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+#ifdef __linux__
+    long count = argc > 1 ? strtol(argv[1], nullptr, 10) : 1000;
+    if (count <= 0) count = 1000;
+
+    std::unique_ptr<SystemSampler> sampler = CreateProcSystemSampler();
+    SystemSample sample;
+    std::wstring error;
+    if (!sampler->Sample(sample, error)) {
+        fprintf(stderr, "FEHLER: %ls\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<double> wall;
+    std::vector<double> cpu;
+    for (long i = 0; i < count; ++i) {
+        uint64_t cpuStart = sampler->ThreadCpuMicros();
+        auto start = std::chrono::steady_clock::now();
+        sampler->Sample(sample, error);
+        wall.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        cpu.push_back(static_cast<double>(sampler->ThreadCpuMicros() - cpuStart));
+    }
+    double wallMicros = Median(wall);
+    double cpuMicros = Median(cpu);
+    double overhead = cpuMicros / (SystemMonitor::DEFAULT_INTERVAL * 10.0);
+    printf("Stichprobe:  %ld mal, Median %.1f us (CPU %.1f us), %zu Kerne\n", count, wallMicros, cpuMicros, sample.cores.size());
+    printf("Last bei %u ms: %.4f %% CPU (Budget %.1f %%)\n", SystemMonitor::DEFAULT_INTERVAL, overhead, BUDGET_PERCENT);
+
+    // Der laufende Monitor misst seine Last selbst (CPU-Zeit des Threads seit dem Start)
+    SystemMonitor monitor(CreateProcSystemSampler(), SystemMonitor::MIN_INTERVAL);
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+    SystemHistory history;
+    monitor.Read(history);
+    printf("Monitor bei %u ms: %llu Stichproben, Last %.4f %% CPU\n", SystemMonitor::MIN_INTERVAL,
+        static_cast<unsigned long long>(history.samples), history.overheadPercent);
+    return overhead <= BUDGET_PERCENT ? 0 : 1;
+#else
+    (void)argc;
+    (void)argv;
+    fprintf(stderr, "sysmon_bench braucht /proc (Linux).\n");
+    return 0;
+#endif
+}
@@ -0,0 +1,124 @@
+// Benchmark des parallelen Verzeichnisdurchlaufs (DIR /S, TREE, DU): Eintraege pro Sekunde mit
+// 1, 2, 4, ... Threads, jeweils bester von drei Laeufen bei warmem Dateicache. Die Summen muessen
+// fuer jede Threadanzahl gleich sein.
+//
+//   walk_bench <pfad>                 vorhandenen Baum durchlaufen (z.B. eine Million Dateien)
+//   walk_bench --create [dateien]     Testbaum im Temp-Verzeichnis anlegen (Standard 100000,
+//                                     100 Dateien je Verzeichnis), messen und wieder loeschen
+
+#include "engine/dirwalk.h"
+#include "engine/utf8.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+class NullJob : public JobContext {
+public:
+    void AddHistory(const std::wstring&) override {}
+    void SetLiveLine(uint32_t, const std::wstring&) override {}
+    void AddTable(std::shared_ptr<ResultTable>) override {}
+    bool Cancelled() const override { return false; }
+    bool Sleep(uint32_t) override { return true; }
+};
+
+// Ungleich tiefe Aeste, damit sich die Arbeit nicht von selbst gleichmaessig verteilt
+void CreateTree(const fs::path& root, long files) {
+    const long perDirectory = 100;
+    long directories = (files + perDirectory - 1) / perDirectory;
+    for (long d = 0; d < directories; ++d) {
+        fs::path dir = root / ("a" + std::to_string(d % 7));
+        for (long level = d % 5; level > 0; --level) dir /= "b" + std::to_string(level);
+        dir /= "d" + std::to_string(d);
+        fs::create_directories(dir);
+        for (long f = 0; f < perDirectory && d * perDirectory + f < files; ++f) {
+            std::ofstream(dir / ("f" + std::to_string(f) + ".txt")) << "inhalt " << f;
+        }
+    }
+}
+
+struct Result {
+    double millis = 0.0;
+    uint64_t entries = 0;
+    uint64_t files = 0;
+    uint64_t bytes = 0;
+    uint64_t steals = 0;
+};
+
+Result Walk(const std::wstring& root, unsigned threads) {
+    NullJob job;
+    DirectoryWalker::Options options;
+    options.threads = threads;
+    auto start = std::chrono::steady_clock::now();
+    DirectoryWalker walker(options);
+    walker.Start(root);
+    WalkStep step;
+    Result result;
+    while (walker.Next(job, step)) {
+        if (step.leave && step.node->depth == 0) {
+            result.files = step.node->totalFiles;
+            result.bytes = step.node->totalBytes;
+        }
+    }
+    result.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.entries = walker.ScannedEntries();
+    result.steals = walker.Steals();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    fs::path root;
+    bool created = false;
+    if (argc > 1 && strcmp(argv[1], "--create") == 0) {
+        long files = argc > 2 ? strtol(argv[2], nullptr, 10) : 100000;
+        if (files <= 0) files = 100000;
+        root = fs::temp_directory_path() / "walk_bench_tree";
+        fs::remove_all(root);
+        auto start = std::chrono::steady_clock::now();
+        CreateTree(root, files);
+        printf("Testbaum %s: %ld Dateien in %.1f s angelegt\n", root.string().c_str(), files,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        created = true;
+    }
+    else if (argc > 1) {
+        root = argv[1];
+    }
+    else {
+        fprintf(stderr, "Aufruf: walk_bench <pfad> | walk_bench --create [dateien]\n");
+        return 1;
+    }
+
+    std::wstring path = Utf8ToWide(root.string());
+    Walk(path, 1); // Dateicache fuellen
+
+    unsigned maxThreads = std::clamp(std::thread::hardware_concurrency(), 1u, DirectoryWalker::MAX_THREADS);
+    printf("%8s %10s %14s %12s %12s\n", "Threads", "ms", "Eintraege/s", "Dateien", "Uebernahmen");
+    Result reference;
+    for (unsigned threads = 1; threads <= DirectoryWalker::MAX_THREADS; threads *= 2) {
+        Result best;
+        for (int run = 0; run < 3; ++run) {
+            Result result = Walk(path, threads);
+            if (run == 0 || result.millis < best.millis) best = result;
+        }
+        if (threads == 1) reference = best;
+        printf("%8u %10.1f %14.0f %12llu %12llu%s\n", threads, best.millis, best.entries / (best.millis / 1000.0),
+            static_cast<unsigned long long>(best.files), static_cast<unsigned long long>(best.steals),
+            best.files != reference.files || best.bytes != reference.bytes ? "  ABWEICHUNG" : "");
+        if (threads >= maxThreads * 2) break;
+    }
+
+    if (created) fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,8 @@
+@ECHO OFF
+REM Smoke-Test fuer CALL
+GOTO weiter
+ECHO uebersprungen
+:weiter
+ECHO Hallo %1
+EXIT /B
+ECHO nach EXIT
@@ -0,0 +1,38 @@
+# Smoke-Test ueber das Headless-Frontend: fuehrt HEADLESS mit TEST.txt als Eingabe aus und prueft,
+# dass die Zeilen aus TEST.expected in dieser Reihenfolge als ganze Zeilen in der Ausgabe stehen.
+# Dazwischen darf anderes stehen (Ausgaben von Hintergrundjobs, Zeitangaben). Eine Zeile mit
+# "!" am Anfang darf dagegen nirgends in der Ausgabe vorkommen.
+#
+#   cmake -DHEADLESS=<time_headless> -DTEST=<pfad/name> [-DARGS=<optionen>] -P smoke.cmake
+
+execute_process(
+    COMMAND ${HEADLESS} --no-banner ${ARGS}
+    INPUT_FILE ${TEST}.txt
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE errors
+    RESULT_VARIABLE result
+    TIMEOUT 60
+)
+string(REPLACE "\r\n" "\n" output "${output}")
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "time_headless endete mit ${result}\n${errors}\n--- Ausgabe ---\n${output}")
+endif()
+
+set(rest "\n${output}\n")
+file(STRINGS ${TEST}.expected expected)
+foreach(line IN LISTS expected)
+    if(line MATCHES "^!(.*)$")
+        string(FIND "\n${output}\n" "\n${CMAKE_MATCH_1}\n" position)
+        if(NOT position EQUAL -1)
+            message(FATAL_ERROR "Unerwartete Zeile: ${CMAKE_MATCH_1}\n--- Ausgabe ---\n${output}")
+        endif()
+        continue()
+    endif()
+    string(FIND "${rest}" "\n${line}\n" position)
+    if(position EQUAL -1)
+        message(FATAL_ERROR "Zeile fehlt oder steht an falscher Stelle: ${line}\n--- Ausgabe ---\n${output}")
+    endif()
+    string(LENGTH "\n${line}" length)
+    math(EXPR position "${position} + ${length}")
+    string(SUBSTRING "${rest}" ${position} -1 rest)
+endforeach()